@@ -0,0 +1,105 @@
+#include "TraceCorpus.h"
+#include <algorithm>
+#include <cstdio>
+#include <random>
+
+namespace ai_debugger {
+
+namespace {
+
+const char* NAMESPACES[] = {"app", "net", "storage", "render", "core"};
+const char* PARAMETERS[] = {"v", "i", "PKcm", "RKSs", "PvS_", "dRi"};
+
+const char* ERROR_MESSAGES[] = {
+    "Program received signal SIGSEGV, Segmentation fault: null pointer dereference.",
+    "Program received signal SIGSEGV, Segmentation fault.",
+    "Program received signal SIGABRT, Aborted.",
+    "Program received signal SIGFPE, Arithmetic exception.",
+    "ERROR: AddressSanitizer: heap-buffer-overflow on address 0x602000000014",
+    "terminate called after throwing an instance of 'std::out_of_range'",
+};
+
+std::string lengthPrefixed(const std::string& name) {
+    return std::to_string(name.size()) + name;
+}
+
+std::string hexAddress(uint64_t base, size_t id) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "0x%016llx", static_cast<unsigned long long>(base + id * 0x40));
+    return buffer;
+}
+
+void appendFrame(std::string& out, CorpusFormat format, size_t index, size_t id, bool mangled) {
+    std::string name = corpusSymbol(id, mangled);
+    std::string file = "file_" + std::to_string(id % 64) + ".cpp";
+    std::string line = std::to_string(10 + id % 500);
+
+    switch (format) {
+        case CorpusFormat::GDB:
+            out += "#" + std::to_string(index) + "  " + hexAddress(0x555555554000, id) + " in " + name +
+                   " (ptr=0x0, size=" + std::to_string(index) + ") at src/" + file + ":" + line + "\n";
+            break;
+        case CorpusFormat::LLDB:
+            out += "  frame #" + std::to_string(index) + ": " + hexAddress(0x100000000, id) + " app`" + name +
+                   " + " + std::to_string(id % 256) + " at " + file + ":" + line + "\n";
+            break;
+        case CorpusFormat::BACKTRACE:
+            out += name + " at /src/" + file + ":" + line + "\n";
+            break;
+        case CorpusFormat::MSVC:
+            out += "c:\\src\\" + file + "(" + line + "): " + name + "\n";
+            break;
+    }
+}
+
+} // namespace
+
+const char* corpusFormatToString(CorpusFormat format) {
+    switch (format) {
+        case CorpusFormat::GDB: return "gdb";
+        case CorpusFormat::LLDB: return "lldb";
+        case CorpusFormat::BACKTRACE: return "backtrace";
+        case CorpusFormat::MSVC: return "msvc";
+        default: return "unknown";
+    }
+}
+
+std::string corpusSymbol(size_t id, bool mangled) {
+    std::string ns = NAMESPACES[id % 5];
+    std::string cls = "Class" + std::to_string(id / 7);
+    std::string method = "method" + std::to_string(id % 7);
+    if (mangled) {
+        return "_ZN" + lengthPrefixed(ns) + lengthPrefixed(cls) + lengthPrefixed(method) + "E" + PARAMETERS[id % 6];
+    }
+    return ns + "::" + cls + "::" + method;
+}
+
+std::vector<std::string> generateTraceCorpus(const CorpusOptions& options, size_t count) {
+    // Draws use the engine directly: mt19937_64 output is fixed by the
+    // standard, the distributions are not.
+    std::mt19937_64 rng(options.seed);
+    size_t symbols = std::max<size_t>(options.symbols, 1);
+    size_t cycle_length = std::max<size_t>(options.recursion_cycle, 1);
+    bool mangled = options.mangled &&
+                   (options.format == CorpusFormat::GDB || options.format == CorpusFormat::LLDB);
+
+    std::vector<std::string> traces;
+    traces.reserve(count);
+    std::vector<size_t> cycle(cycle_length);
+    for (size_t t = 0; t < count; ++t) {
+        std::string text = ERROR_MESSAGES[rng() % (sizeof(ERROR_MESSAGES) / sizeof(ERROR_MESSAGES[0]))];
+        text += "\n";
+
+        for (auto& id : cycle) {
+            id = rng() % symbols;
+        }
+        for (size_t i = 0; i < options.depth; ++i) {
+            size_t id = i < options.recursion_depth ? cycle[i % cycle_length] : rng() % symbols;
+            appendFrame(text, options.format, i, id, mangled);
+        }
+        traces.push_back(std::move(text));
+    }
+    return traces;
+}
+
+} // namespace ai_debugger
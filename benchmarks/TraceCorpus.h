@@ -0,0 +1,50 @@
+#ifndef AI_DEBUGGER_TRACE_CORPUS_H
+#define AI_DEBUGGER_TRACE_CORPUS_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace ai_debugger {
+
+// Output formats StackTraceParser recognizes.
+enum class CorpusFormat {
+    GDB,
+    LLDB,
+    BACKTRACE,  // addr2line / glibc backtrace_symbols
+    MSVC
+};
+
+const char* corpusFormatToString(CorpusFormat format);
+
+struct CorpusOptions {
+    CorpusFormat format;
+    size_t depth;             // frames per trace
+    size_t recursion_depth;   // innermost frames that repeat one cycle of functions
+    size_t recursion_cycle;   // functions in that cycle (1 = direct recursion)
+    size_t symbols;           // distinct function names frames are drawn from
+    bool mangled;             // Itanium-mangled names, for GDB and LLDB
+    uint64_t seed;
+
+    CorpusOptions()
+        : format(CorpusFormat::GDB)
+        , depth(32)
+        , recursion_depth(0)
+        , recursion_cycle(1)
+        , symbols(256)
+        , mangled(false)
+        , seed(1) {}
+};
+
+// Function name for a symbol id, like app::Class12::method3, or mangled like
+// _ZN3app7Class127method3EPKcm.
+std::string corpusSymbol(size_t id, bool mangled);
+
+// Synthetic crash traces. The same options always give the same traces, so
+// runs on different builds parse and analyze identical input.
+std::vector<std::string> generateTraceCorpus(const CorpusOptions& options, size_t count);
+
+} // namespace ai_debugger
+
+#endif // AI_DEBUGGER_TRACE_CORPUS_H
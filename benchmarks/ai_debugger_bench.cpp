@@ -0,0 +1,169 @@
+#include "TraceCorpus.h"
+#include "ai_debugger/AIDebugger.h"
+#include "ai_debugger/DemangleCache.h"
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace ai_debugger;
+
+namespace {
+
+// Traces each benchmark cycles through, so one trace's quirks do not decide
+// the result and caches see more than a single input.
+constexpr size_t CORPUS_SIZE = 64;
+
+std::vector<StackTrace> parseCorpus(const CorpusOptions& options) {
+    StackTraceParser parser;
+    std::vector<StackTrace> traces;
+    for (const auto& text : generateTraceCorpus(options, CORPUS_SIZE)) {
+        if (auto trace = parser.parse(text)) {
+            traces.push_back(std::move(*trace));
+        }
+    }
+    return traces;
+}
+
+std::vector<std::unique_ptr<CallGraphAnalyzer>> buildGraphs(const std::vector<StackTrace>& traces) {
+    std::vector<std::unique_ptr<CallGraphAnalyzer>> graphs;
+    for (const auto& trace : traces) {
+        graphs.push_back(std::make_unique<CallGraphAnalyzer>());
+        graphs.back()->buildFromStackTrace(trace);
+    }
+    return graphs;
+}
+
+// range(0) is the trace depth.
+void BM_Parse(benchmark::State& state, CorpusFormat format, bool mangled) {
+    CorpusOptions options;
+    options.format = format;
+    options.depth = static_cast<size_t>(state.range(0));
+    options.mangled = mangled;
+    auto texts = generateTraceCorpus(options, CORPUS_SIZE);
+
+    StackTraceParser parser;
+    size_t next = 0;
+    int64_t frames = 0;
+    int64_t bytes = 0;
+    for (auto _ : state) {
+        const std::string& text = texts[next++ % texts.size()];
+        auto trace = parser.parse(text);
+        frames += trace ? static_cast<int64_t>(trace->frames.size()) : 0;
+        bytes += static_cast<int64_t>(text.size());
+        benchmark::DoNotOptimize(trace);
+    }
+    state.SetItemsProcessed(frames);
+    state.SetBytesProcessed(bytes);
+}
+
+BENCHMARK_CAPTURE(BM_Parse, gdb, CorpusFormat::GDB, false)->Arg(8)->Arg(64);
+BENCHMARK_CAPTURE(BM_Parse, gdb_mangled, CorpusFormat::GDB, true)->Arg(8)->Arg(64);
+BENCHMARK_CAPTURE(BM_Parse, lldb, CorpusFormat::LLDB, false)->Arg(8)->Arg(64);
+BENCHMARK_CAPTURE(BM_Parse, backtrace, CorpusFormat::BACKTRACE, false)->Arg(8)->Arg(64);
+BENCHMARK_CAPTURE(BM_Parse, msvc, CorpusFormat::MSVC, false)->Arg(8)->Arg(64);
+
+// range(0) is the symbol cardinality. Below the cache capacity lookups hit;
+// far above it most of them demangle.
+void BM_Demangle(benchmark::State& state) {
+    size_t symbols = static_cast<size_t>(state.range(0));
+    std::mt19937_64 rng(1);
+    std::vector<std::string> names(1 << 16);
+    for (auto& name : names) {
+        name = corpusSymbol(rng() % symbols, true);
+    }
+
+    DemangleCache cache;
+    std::string out;
+    size_t next = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(cache.demangle(names[next++ % names.size()], out));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_Demangle)->ArgName("symbols")->Arg(64)->Arg(1 << 20);
+
+// range(0) is the trace depth, range(1) how many innermost frames recurse
+// through a cycle of three functions.
+void BM_BuildCallGraph(benchmark::State& state) {
+    CorpusOptions options;
+    options.depth = static_cast<size_t>(state.range(0));
+    options.recursion_depth = static_cast<size_t>(state.range(1));
+    options.recursion_cycle = 3;
+    auto traces = parseCorpus(options);
+
+    CallGraphAnalyzer graph;
+    size_t next = 0;
+    int64_t frames = 0;
+    for (auto _ : state) {
+        const StackTrace& trace = traces[next++ % traces.size()];
+        graph.buildFromStackTrace(trace);
+        frames += static_cast<int64_t>(trace.frames.size());
+    }
+    state.SetItemsProcessed(frames);
+}
+
+BENCHMARK(BM_BuildCallGraph)
+    ->ArgNames({"depth", "recursion"})
+    ->Args({16, 0})
+    ->Args({256, 0})
+    ->Args({256, 240});
+
+void BM_Predict(benchmark::State& state) {
+    auto traces = parseCorpus(CorpusOptions());
+    auto graphs = buildGraphs(traces);
+
+    RootCausePredictor predictor;
+    size_t next = 0;
+    for (auto _ : state) {
+        size_t i = next++ % traces.size();
+        benchmark::DoNotOptimize(predictor.predict(traces[i], *graphs[i]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_Predict);
+
+void BM_Explain(benchmark::State& state) {
+    auto traces = parseCorpus(CorpusOptions());
+    auto graphs = buildGraphs(traces);
+    RootCausePredictor predictor;
+    std::vector<RootCause> causes;
+    for (size_t i = 0; i < traces.size(); ++i) {
+        causes.push_back(predictor.getMostLikelyCause(traces[i], *graphs[i]));
+    }
+
+    ExplanationGenerator generator;
+    size_t next = 0;
+    for (auto _ : state) {
+        size_t i = next++ % traces.size();
+        benchmark::DoNotOptimize(generator.generate(traces[i], causes[i], *graphs[i]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_Explain);
+
+void BM_GetReport(benchmark::State& state) {
+    AIDebugger debugger;
+    debugger.setSessionDirectory("");
+    debugger.enableDeduplication(false);
+    std::vector<DebugSession> sessions;
+    for (const auto& text : generateTraceCorpus(CorpusOptions(), CORPUS_SIZE)) {
+        sessions.push_back(debugger.analyzeStackTrace(text));
+    }
+
+    size_t next = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(debugger.getReport(sessions[next++ % sessions.size()]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_GetReport);
+
+} // namespace
+
+BENCHMARK_MAIN();
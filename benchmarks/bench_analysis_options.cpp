@@ -0,0 +1,56 @@
+#include "ai_debugger/AIDebugger.h"
+#include "ai_debugger/SessionStore.h"
+#include "TraceCorpus.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace ai_debugger;
+
+// Per-trace cost of a full analysis against a triage-only one that computes
+// root causes and leaves the explanation, fixes and tests for later.
+int main(int argc, char* argv[]) {
+    size_t trace_count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000;
+    int frames = argc > 2 ? std::atoi(argv[2]) : 24;
+    CorpusOptions corpus;
+    corpus.depth = static_cast<size_t>(frames);
+    corpus.symbols = 9973;
+    auto traces = generateTraceCorpus(corpus, trace_count);
+
+    std::cout << trace_count << " traces of " << frames << " frames\n\n"
+              << std::left << std::setw(14) << "options" << std::right
+              << std::setw(14) << "us/trace" << std::setw(18) << "session bytes" << "\n";
+
+    for (auto options : {AnalysisOptions::ALL, AnalysisOptions::ROOT_CAUSES}) {
+        AIDebugger debugger;
+        debugger.setSessionDirectory("");
+        debugger.enableDeduplication(false);
+        debugger.enableTestGeneration(true);
+        debugger.setAnalysisOptions(options);
+
+        std::vector<DebugSession> sessions;
+        sessions.reserve(traces.size());
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& trace : traces) {
+            sessions.push_back(debugger.analyzeStackTrace(trace));
+        }
+        std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+
+        // Serialized size stands in for the memory a session holds.
+        size_t bytes = 0;
+        std::string buffer;
+        for (const auto& session : sessions) {
+            serializeSession(session, buffer);
+            bytes += buffer.size();
+        }
+
+        std::cout << std::left << std::setw(14) << (options == AnalysisOptions::ALL ? "ALL" : "ROOT_CAUSES")
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(14) << elapsed.count() / trace_count
+                  << std::setw(18) << bytes / trace_count << "\n";
+    }
+    return 0;
+}
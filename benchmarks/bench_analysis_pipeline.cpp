@@ -0,0 +1,74 @@
+#include "ai_debugger/AnalysisPipeline.h"
+#include "TraceCorpus.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace ai_debugger;
+
+namespace {
+
+void configure(AIDebugger& debugger) {
+    debugger.setSessionDirectory("");
+    debugger.enableDeduplication(false);
+    debugger.enableTestGeneration(true);
+}
+
+} // namespace
+
+// Throughput of analyzeStackTrace() in a loop against the staged pipeline,
+// with per-stage service times and queue depths.
+int main(int argc, char* argv[]) {
+    size_t trace_count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000;
+    int frames = argc > 2 ? std::atoi(argv[2]) : 24;
+    CorpusOptions corpus;
+    corpus.depth = static_cast<size_t>(frames);
+    corpus.symbols = 97;
+    auto traces = generateTraceCorpus(corpus, trace_count);
+
+    AIDebugger serial;
+    configure(serial);
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& trace : traces) {
+        serial.analyzeStackTrace(trace);
+    }
+    std::chrono::duration<double> serial_time = std::chrono::steady_clock::now() - start;
+
+    AIDebugger staged;
+    configure(staged);
+    size_t delivered = 0;
+    AnalysisPipeline pipeline(staged, [&delivered](DebugSession&&) { ++delivered; });
+    start = std::chrono::steady_clock::now();
+    for (const auto& trace : traces) {
+        pipeline.submit(trace);
+    }
+    pipeline.close();
+    std::chrono::duration<double> pipeline_time = std::chrono::steady_clock::now() - start;
+
+    std::cout << trace_count << " traces of " << frames << " frames\n\n"
+              << std::fixed << std::setprecision(0)
+              << "serial:   " << trace_count / serial_time.count() << " traces/s\n"
+              << "pipeline: " << delivered / pipeline_time.count() << " traces/s\n\n";
+
+    std::cout << std::left << std::setw(12) << "stage" << std::right
+              << std::setw(10) << "p50 us" << std::setw(10) << "p99 us"
+              << std::setw(12) << "mean depth" << std::setw(11) << "max depth" << "\n";
+    for (size_t s = 0; s < PIPELINE_STAGE_COUNT; ++s) {
+        auto stage = static_cast<PipelineStage>(s);
+        const Histogram& latency = pipeline.latencyHistogram(stage);
+        const Histogram& depth = pipeline.queueDepthHistogram(stage);
+        std::cout << std::left << std::setw(12) << pipelineStageToString(stage) << std::right
+                  << std::setprecision(1)
+                  << std::setw(10) << latency.percentile(50) / 1000.0
+                  << std::setw(10) << latency.percentile(99) / 1000.0
+                  << std::setw(12) << depth.mean()
+                  << std::setw(11) << depth.max() << "\n";
+    }
+    const Histogram& total = pipeline.totalLatencyHistogram();
+    std::cout << "\nsubmit to delivery: p50 " << total.percentile(50) / 1000.0 << " us, p99 "
+              << total.percentile(99) / 1000.0 << " us\n";
+    return 0;
+}
@@ -0,0 +1,49 @@
+#include "ai_debugger/AIDebugger.h"
+#include "TraceCorpus.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ai_debugger;
+
+int main(int argc, char* argv[]) {
+    size_t trace_count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000;
+    int frames = argc > 2 ? std::atoi(argv[2]) : 24;
+    int max_threads = argc > 3
+        ? std::atoi(argv[3])
+        : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+    CorpusOptions corpus;
+    corpus.depth = static_cast<size_t>(frames);
+    corpus.symbols = 97;
+    auto traces = generateTraceCorpus(corpus, trace_count);
+
+    std::cout << "analyzeBatch over " << trace_count << " traces of " << frames << " frames\n\n";
+    std::cout << std::setw(8) << "threads" << std::setw(16) << "traces/s"
+              << std::setw(10) << "speedup" << "\n";
+
+    double baseline = 0.0;
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        AIDebugger debugger;
+        debugger.setMaxParallelTasks(threads);
+
+        auto start = std::chrono::steady_clock::now();
+        auto sessions = debugger.analyzeBatch(traces);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        double rate = static_cast<double>(sessions.size()) / elapsed.count();
+        if (threads == 1) {
+            baseline = rate;
+        }
+        std::cout << std::setw(8) << threads
+                  << std::setw(16) << std::fixed << std::setprecision(0) << rate
+                  << std::setw(9) << std::setprecision(2) << (rate / baseline) << "x\n";
+    }
+
+    return 0;
+}
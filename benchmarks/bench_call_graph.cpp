@@ -0,0 +1,63 @@
+#include "ai_debugger/CallGraphAnalyzer.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace ai_debugger;
+
+namespace {
+
+// A stack overflow: `cycle_length` functions calling each other in a ring for
+// most of the trace, below a run of distinct non-recursive callers.
+StackTrace makeRecursiveTrace(int frames, int cycle_length) {
+    StackTrace trace;
+    trace.frames.reserve(frames);
+    int recursive_frames = frames * 9 / 10;
+    for (int i = 0; i < frames; ++i) {
+        StackFrame frame;
+        if (i < recursive_frames) {
+            frame.function_name = "ns::recurse_" + std::to_string(i % cycle_length);
+        } else {
+            frame.function_name = "ns::caller_" + std::to_string(i);
+        }
+        frame.location.file = "src/recurse.cpp";
+        frame.location.line = 10 + i % cycle_length;
+        trace.frames.push_back(std::move(frame));
+    }
+    return trace;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 20;
+
+    std::cout << "CallGraphAnalyzer::buildFromStackTrace on recursive traces ("
+              << iterations << " iterations)\n\n";
+    std::cout << std::setw(10) << "frames" << std::setw(8) << "cycle"
+              << std::setw(14) << "ms/build" << std::setw(12) << "patterns" << "\n";
+
+    CallGraphAnalyzer analyzer;
+    for (int frames : {10000, 100000}) {
+        for (int cycle : {1, 3, 64}) {
+            StackTrace trace = makeRecursiveTrace(frames, cycle);
+
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < iterations; ++i) {
+                analyzer.buildFromStackTrace(trace);
+            }
+            std::chrono::duration<double, std::milli> elapsed =
+                std::chrono::steady_clock::now() - start;
+
+            std::cout << std::setw(10) << frames << std::setw(8) << cycle
+                      << std::setw(14) << std::fixed << std::setprecision(3)
+                      << elapsed.count() / iterations
+                      << std::setw(12) << analyzer.detectPatterns().size() << "\n";
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,114 @@
+#include "ai_debugger/CrashClusterer.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace ai_debugger;
+
+namespace {
+
+struct Corpus {
+    std::vector<std::vector<std::string>> bases;
+    std::vector<std::string> helpers;
+};
+
+// `crash_sites` distinct crashes, each a stack of 10-24 frames drawn from a
+// shared symbol pool so unrelated crashes still overlap somewhat.
+Corpus makeCorpus(size_t crash_sites, std::mt19937& rng) {
+    Corpus corpus;
+    std::uniform_int_distribution<int> depth(10, 24);
+    std::uniform_int_distribution<int> symbol(0, 20000);
+
+    for (size_t c = 0; c < crash_sites; ++c) {
+        std::vector<std::string> frames;
+        int frames_in_stack = depth(rng);
+        for (int i = 0; i < frames_in_stack; ++i) {
+            frames.push_back("app::module_" + std::to_string(symbol(rng) % 300) +
+                             "::function_" + std::to_string(symbol(rng)));
+        }
+        corpus.bases.push_back(std::move(frames));
+    }
+    for (int i = 0; i < 64; ++i) {
+        corpus.helpers.push_back("app::inline_helper_" + std::to_string(i));
+    }
+    return corpus;
+}
+
+// A near-duplicate of a base crash: sometimes one inlined frame appears or a
+// frame is missing, and line numbers always vary.
+void mutate(const Corpus& corpus, size_t base, std::mt19937& rng, StackTrace& trace) {
+    const auto& frames = corpus.bases[base];
+    std::uniform_int_distribution<int> coin(0, 9);
+    std::uniform_int_distribution<size_t> position(0, frames.size() - 1);
+    std::uniform_int_distribution<size_t> helper(0, corpus.helpers.size() - 1);
+
+    int mutation = coin(rng);
+    size_t at = position(rng);
+
+    trace.frames.clear();
+    for (size_t i = 0; i < frames.size(); ++i) {
+        if (mutation < 3 && i == at) {
+            StackFrame inlined;
+            inlined.function_name = corpus.helpers[helper(rng)];
+            inlined.location.file = "src/helpers.h";
+            trace.frames.push_back(std::move(inlined));
+        }
+        if (mutation >= 3 && mutation < 5 && i == at && i != 0) {
+            continue;
+        }
+        StackFrame frame;
+        frame.function_name = frames[i];
+        frame.location.file = "src/module.cpp";
+        frame.location.line = static_cast<int>(rng() % 2000);
+        trace.frames.push_back(std::move(frame));
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t trace_count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    size_t crash_sites = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 5000;
+
+    std::mt19937 rng(7);
+    Corpus corpus = makeCorpus(crash_sites, rng);
+    std::uniform_int_distribution<size_t> pick(0, crash_sites - 1);
+
+    CrashClusterer clusterer;
+    // cluster -> (crash site of its first trace); used to measure purity.
+    std::unordered_map<uint32_t, size_t> cluster_site;
+    size_t misassigned = 0;
+
+    StackTrace trace;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < trace_count; ++i) {
+        size_t site = pick(rng);
+        mutate(corpus, site, rng, trace);
+
+        auto assignment = clusterer.add(trace);
+        auto inserted = cluster_site.emplace(assignment.cluster_id, site);
+        if (!inserted.second && inserted.first->second != site) {
+            ++misassigned;
+        }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout << "CrashClusterer over " << trace_count << " traces from " << crash_sites
+              << " crash sites\n\n"
+              << std::fixed << std::setprecision(0)
+              << "traces/s:        " << trace_count / elapsed.count() << "\n"
+              << std::setprecision(2)
+              << "us/trace:        " << elapsed.count() * 1e6 / trace_count << "\n"
+              << "clusters:        " << clusterer.clusterCount() << "\n"
+              << "clusters/site:   "
+              << static_cast<double>(clusterer.clusterCount()) / crash_sites << "\n"
+              << "misassigned:     " << std::setprecision(4)
+              << 100.0 * misassigned / trace_count << "%\n";
+
+    return 0;
+}
@@ -0,0 +1,152 @@
+#include "ai_debugger/AnalysisServer.h"
+#include "TraceCorpus.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fcntl.h>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace ai_debugger;
+
+namespace {
+
+void printLatency(const char* label, std::vector<double>& samples) {
+    std::sort(samples.begin(), samples.end());
+    double median = samples[samples.size() / 2];
+    double p99 = samples[std::min(samples.size() - 1, samples.size() * 99 / 100)];
+    std::cout << std::left << std::setw(28) << label << std::right
+              << "median " << std::setw(9) << median << " us   p99 " << std::setw(9) << p99 << " us\n";
+}
+
+double elapsedMicros(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Runs `cli_tool trace_file` in `directory`, so it opens the default
+// session store there, with its output discarded.
+bool runCliTool(const std::string& cli_tool, const std::string& directory, const std::string& trace_file) {
+    pid_t pid = ::fork();
+    if (pid < 0) {
+        return false;
+    }
+    if (pid == 0) {
+        int null_fd = ::open("/dev/null", O_WRONLY);
+        if (null_fd < 0 || ::chdir(directory.c_str()) != 0) {
+            ::_exit(127);
+        }
+        ::dup2(null_fd, STDOUT_FILENO);
+        ::dup2(null_fd, STDERR_FILENO);
+        ::execl(cli_tool.c_str(), cli_tool.c_str(), trace_file.c_str(), static_cast<char*>(nullptr));
+        ::_exit(127);
+    }
+    int status = 0;
+    while (::waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+    }
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+} // namespace
+
+// Per-crash latency of a crash hook: a fresh cli_tool process, which also
+// opens the session store, and an AIDebugger built in-process, against a
+// request to a warm AnalysisServer. Every request is a different trace and
+// deduplication is off, so no side answers from its duplicate cache.
+//
+// Usage: bench_daemon [count] [cli_tool]
+int main(int argc, char* argv[]) {
+    size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200;
+#ifdef CLI_TOOL_PATH
+    std::string cli_tool = argc > 2 ? argv[2] : CLI_TOOL_PATH;
+#else
+    std::string cli_tool = argc > 2 ? argv[2] : "";
+#endif
+    std::cout << std::fixed << std::setprecision(1);
+
+    CorpusOptions corpus;
+    corpus.depth = 8;
+    corpus.symbols = 9973;
+    auto traces = generateTraceCorpus(corpus, count);
+
+    auto directory = std::filesystem::temp_directory_path() / ("bench_daemon." + std::to_string(::getpid()));
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+
+    std::vector<double> process;
+    if (!cli_tool.empty()) {
+        std::vector<std::string> trace_files;
+        for (size_t i = 0; i < count; ++i) {
+            trace_files.push_back((directory / ("trace_" + std::to_string(i) + ".txt")).string());
+            std::ofstream(trace_files.back()) << traces[i];
+        }
+        auto cli_directory = directory / "cli";
+        std::filesystem::create_directories(cli_directory);
+        for (size_t i = 0; i < count; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            if (!runCliTool(cli_tool, cli_directory.string(), trace_files[i])) {
+                std::cerr << "Error: " << cli_tool << " failed on " << trace_files[i] << "\n";
+                std::filesystem::remove_all(directory);
+                return 1;
+            }
+            process.push_back(elapsedMicros(start));
+        }
+    }
+
+    std::vector<double> cold;
+    for (size_t i = 0; i < count; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        AIDebugger debugger;
+        debugger.setSessionDirectory("");
+        debugger.enableDeduplication(false);
+        debugger.getReport(debugger.analyzeStackTrace(traces[i]));
+        cold.push_back(elapsedMicros(start));
+    }
+
+    // The daemon saves sessions like cli_tool does.
+    std::string session_directory = (directory / "daemon").string();
+    AnalysisServerOptions options;
+    options.socket_path = (directory / "daemon.sock").string();
+    options.threads = 1;
+    AnalysisServer server(options, [&session_directory] {
+        auto debugger = std::make_unique<AIDebugger>();
+        debugger->setSessionDirectory(session_directory);
+        debugger->enableDeduplication(false);
+        return debugger;
+    });
+    std::string error;
+    AnalysisClient client;
+    if (!server.start(&error) || !client.connect(options.socket_path, &error)) {
+        std::cerr << "Error: " << error << "\n";
+        std::filesystem::remove_all(directory);
+        return 1;
+    }
+
+    std::string report;
+    std::vector<double> warm;
+    for (size_t i = 0; i < count; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        if (!client.report(traces[i], report, &error)) {
+            std::cerr << "Error: " << error << "\n";
+            std::filesystem::remove_all(directory);
+            return 1;
+        }
+        warm.push_back(elapsedMicros(start));
+    }
+    client.close();
+    server.stop();
+    std::filesystem::remove_all(directory);
+
+    std::cout << "Analysis latency, " << count << " distinct crashes\n\n";
+    if (!process.empty()) {
+        printLatency("cold (cli_tool process):", process);
+    }
+    printLatency("cold (new AIDebugger):", cold);
+    printLatency("warm (daemon round trip):", warm);
+    return 0;
+}
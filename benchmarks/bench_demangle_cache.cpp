@@ -0,0 +1,122 @@
+#include "ai_debugger/StackTraceParser.h"
+#include "ai_debugger/DemangleCache.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace ai_debugger;
+
+namespace {
+
+std::string lengthPrefixed(const std::string& name) {
+    return std::to_string(name.size()) + name;
+}
+
+// Itanium-mangled member functions such as
+// _ZN3app7service8Class12method7EPKcm, with a mix of parameter lists.
+std::vector<std::string> makeSymbols(int count) {
+    static const char* params[] = {
+        "v", "i", "PKcm", "RKNSt7__cxx1112basic_stringIcSt11char_traitsIcESaIcEEE",
+        "PvS_", "St6vectorIiSaIiEE", "dRi",
+    };
+    static const char* namespaces[] = {"app", "net", "storage", "render", "core"};
+
+    std::vector<std::string> symbols;
+    symbols.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        symbols.push_back("_ZN" + lengthPrefixed(namespaces[i % 5]) +
+                          lengthPrefixed("Class" + std::to_string(i / 7)) +
+                          lengthPrefixed("method" + std::to_string(i % 7)) + "E" +
+                          params[i % 7]);
+    }
+    return symbols;
+}
+
+// Production crash streams are dominated by a few hot symbols; draw frames
+// from a Zipf(s) distribution over the symbol pool.
+std::vector<size_t> zipfSample(size_t symbols, size_t draws, double s, unsigned seed) {
+    std::vector<double> weights(symbols);
+    for (size_t i = 0; i < symbols; ++i) {
+        weights[i] = 1.0 / std::pow(static_cast<double>(i + 1), s);
+    }
+    std::discrete_distribution<size_t> dist(weights.begin(), weights.end());
+    std::mt19937 rng(seed);
+
+    std::vector<size_t> sample(draws);
+    for (auto& index : sample) {
+        index = dist(rng);
+    }
+    return sample;
+}
+
+std::vector<std::string> makeTraces(const std::vector<std::string>& symbols,
+                                    const std::vector<size_t>& sample,
+                                    size_t frames_per_trace) {
+    std::vector<std::string> traces;
+    std::string text;
+    for (size_t i = 0; i < sample.size(); ++i) {
+        text += symbols[sample[i]] + " at /src/file_" + std::to_string(sample[i] % 13) +
+                ".cpp:" + std::to_string(10 + i % 500) + "\n";
+        if ((i + 1) % frames_per_trace == 0) {
+            traces.push_back(std::move(text));
+            text.clear();
+        }
+    }
+    return traces;
+}
+
+double framesPerSecond(StackTraceParser& parser, const std::vector<std::string>& traces) {
+    size_t frames = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& text : traces) {
+        auto trace = parser.parse(text);
+        if (trace) {
+            frames += trace->frames.size();
+        }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return static_cast<double>(frames) / elapsed.count();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int symbol_count = argc > 1 ? std::atoi(argv[1]) : 5000;
+    size_t frame_count = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 500000;
+    double skew = argc > 3 ? std::atof(argv[3]) : 1.1;
+
+    auto symbols = makeSymbols(symbol_count);
+    auto traces = makeTraces(symbols, zipfSample(symbols.size(), frame_count, skew, 42), 32);
+
+    StackTraceParser uncached;
+    uncached.setDemangleCache(nullptr);
+
+    auto cache = std::make_shared<DemangleCache>();
+    StackTraceParser cached;
+    cached.setDemangleCache(cache);
+
+    double uncached_rate = framesPerSecond(uncached, traces);
+    double cached_rate = framesPerSecond(cached, traces);
+    DemangleCacheStats stats = cache->stats();
+
+    std::cout << "Demangling " << frame_count << " frames over " << symbol_count
+              << " symbols (zipf s=" << skew << ")\n\n";
+    std::cout << std::fixed << std::setprecision(0)
+              << "uncached frames/s: " << uncached_rate << "\n"
+              << "cached frames/s:   " << cached_rate << "\n"
+              << std::setprecision(1)
+              << "speedup:           " << (cached_rate / uncached_rate) << "x\n"
+              << "hit rate:          "
+              << (100.0 * stats.hits / std::max<uint64_t>(stats.hits + stats.misses, 1)) << "%\n"
+              << "entries:           " << stats.entries << "\n"
+              << "evictions:         " << stats.evictions << "\n"
+              << "arena bytes:       " << stats.bytes_reserved << "\n";
+
+    return 0;
+}
@@ -0,0 +1,69 @@
+#include "ai_debugger/AIDebugger.h"
+#include "TraceCorpus.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace ai_debugger;
+
+namespace {
+
+double analyzeAll(AIDebugger& debugger, const std::vector<std::string>& traces) {
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& trace : traces) {
+        debugger.analyzeStackTrace(trace);
+    }
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / static_cast<double>(traces.size());
+}
+
+} // namespace
+
+// Per-trace cost of analysis with instrumentation off and on, then where the
+// time went by stage. Rounds alternate so drift hits both sides alike.
+int main(int argc, char* argv[]) {
+    size_t trace_count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000;
+    int rounds = argc > 2 ? std::atoi(argv[2]) : 5;
+    CorpusOptions corpus;
+    corpus.depth = 24;
+    corpus.symbols = 9973;
+    auto traces = generateTraceCorpus(corpus, trace_count);
+
+    AIDebugger debugger;
+    debugger.setSessionDirectory("");
+    debugger.enableDeduplication(false);
+    debugger.enableTestGeneration(true);
+    auto instrumentation = debugger.getInstrumentation();
+
+    std::vector<double> off;
+    std::vector<double> on;
+    for (int round = 0; round < rounds; ++round) {
+        instrumentation->setEnabled(false);
+        off.push_back(analyzeAll(debugger, traces));
+        instrumentation->setEnabled(true);
+        on.push_back(analyzeAll(debugger, traces));
+    }
+    std::sort(off.begin(), off.end());
+    std::sort(on.begin(), on.end());
+
+    std::cout << trace_count << " traces x " << rounds << " rounds, median us/trace\n"
+              << std::fixed << std::setprecision(1)
+              << "  instrumentation off  " << off[off.size() / 2] << "\n"
+              << "  instrumentation on   " << on[on.size() / 2] << "\n\n";
+
+    auto snapshot = instrumentation->snapshot();
+    std::cout << std::left << std::setw(12) << "stage" << std::right
+              << std::setw(12) << "mean us" << std::setw(12) << "p99 us" << "\n";
+    for (size_t i = 0; i < TIMED_STAGE_COUNT; ++i) {
+        const TimerStats& stats = snapshot.timers[i];
+        double mean = stats.count ? static_cast<double>(stats.total_ns) / stats.count / 1000.0 : 0.0;
+        std::cout << std::left << std::setw(12) << timedStageToString(static_cast<TimedStage>(i))
+                  << std::right << std::setw(12) << mean
+                  << std::setw(12) << stats.p99_ns / 1000.0 << "\n";
+    }
+    return 0;
+}
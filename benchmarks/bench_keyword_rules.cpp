@@ -0,0 +1,156 @@
+#include "ai_debugger/HeuristicRules.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace ai_debugger;
+
+namespace {
+
+const char* WORDS[] = {
+    "segmentation", "fault", "heap", "corruption", "double", "free", "assertion",
+    "failed", "timeout", "socket", "buffer", "overflow", "stack", "smashing",
+    "detected", "invalid", "pointer", "abort", "allocation", "exhausted", "lock",
+    "deadlock", "divide", "zero", "bounds", "index", "vector", "range", "null",
+};
+constexpr size_t WORD_COUNT = sizeof(WORDS) / sizeof(WORDS[0]);
+
+std::string randomWord(std::mt19937& rng) {
+    // Suffix with a number so most generated keywords are distinct.
+    return std::string(WORDS[rng() % WORD_COUNT]) + "_" + std::to_string(rng() % 50);
+}
+
+// Rules shaped like the defaults: one or two groups of two to three
+// alternatives, occasionally an exclusion.
+std::vector<KeywordRule> makeRules(size_t count, std::mt19937& rng) {
+    std::vector<KeywordRule> rules = defaultHeuristicRules();
+    while (rules.size() < count) {
+        KeywordRule rule;
+        RuleField field = rng() % 8 == 0 ? RuleField::FUNCTION_NAME : RuleField::ERROR_MESSAGE;
+        rule.all_of.resize(1 + rng() % 2);
+        for (auto& group : rule.all_of) {
+            group.field = field;
+            for (size_t i = 0, n = 2 + rng() % 2; i < n; ++i) {
+                group.keywords.push_back(randomWord(rng));
+            }
+        }
+        if (rng() % 4 == 0) {
+            rule.none_of.emplace_back(field, std::vector<std::string>{randomWord(rng)});
+        }
+        rule.category = static_cast<BugCategory>(rng() % 13);
+        rule.score = 0.5;
+        rules.push_back(rule);
+    }
+    return rules;
+}
+
+std::string makeMessage(std::mt19937& rng) {
+    std::string message;
+    for (size_t i = 0, n = 8 + rng() % 8; i < n; ++i) {
+        message += (rng() % 2 ? randomWord(rng) : WORDS[rng() % WORD_COUNT]);
+        message += ' ';
+    }
+    return message;
+}
+
+bool containsAny(const std::string& text, const std::vector<std::string>& keywords) {
+    for (const auto& keyword : keywords) {
+        if (text.find(keyword) != std::string::npos) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// The previous approach: lowercase copies, then one find() per keyword per rule.
+size_t naiveMatch(const std::vector<KeywordRule>& rules, const PredictionFeatures& features) {
+    auto lower = [](std::string_view text) {
+        std::string out(text);
+        std::transform(out.begin(), out.end(), out.begin(), ::tolower);
+        return out;
+    };
+
+    std::string message = lower(features.error_message);
+    std::vector<std::string> names;
+    for (std::string_view name : features.function_names) {
+        names.push_back(lower(name));
+    }
+
+    size_t fired = 0;
+    for (const auto& rule : rules) {
+        auto matches = [&](const KeywordGroup& group) {
+            if (group.field == RuleField::ERROR_MESSAGE) {
+                return containsAny(message, group.keywords);
+            }
+            return std::any_of(names.begin(), names.end(), [&](const std::string& name) {
+                return containsAny(name, group.keywords);
+            });
+        };
+        bool all = !rule.all_of.empty() && std::all_of(rule.all_of.begin(), rule.all_of.end(), matches);
+        fired += all && std::none_of(rule.none_of.begin(), rule.none_of.end(), matches);
+    }
+    return fired;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t rule_count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 500;
+    const size_t trace_count = 2000;
+    const size_t rounds = 5;
+
+    std::mt19937 rng(11);
+    std::vector<KeywordRule> rules = makeRules(rule_count, rng);
+
+    auto start = std::chrono::steady_clock::now();
+    RuleSet compiled(rules);
+    std::chrono::duration<double, std::milli> compile_time = std::chrono::steady_clock::now() - start;
+
+    std::vector<PredictionFeatures> inputs(trace_count);
+    for (auto& input : inputs) {
+        input.error_message = makeMessage(rng);
+        for (size_t f = 0; f < 16; ++f) {
+            input.function_names.push_back("ns::Class" + std::to_string(rng() % 100) + "::" + randomWord(rng));
+        }
+    }
+    // The predictor matches views into the trace, so time those.
+    std::vector<PredictionFeaturesView> views(inputs.begin(), inputs.end());
+
+    size_t naive_fired = 0;
+    start = std::chrono::steady_clock::now();
+    for (size_t round = 0; round < rounds; ++round) {
+        for (const auto& features : inputs) {
+            naive_fired += naiveMatch(rules, features);
+        }
+    }
+    std::chrono::duration<double, std::micro> naive_time = std::chrono::steady_clock::now() - start;
+
+    size_t compiled_fired = 0;
+    std::vector<uint32_t> fired;
+    start = std::chrono::steady_clock::now();
+    for (size_t round = 0; round < rounds; ++round) {
+        for (const auto& features : views) {
+            fired.clear();
+            compiled.match(features, fired);
+            compiled_fired += fired.size();
+        }
+    }
+    std::chrono::duration<double, std::micro> compiled_time = std::chrono::steady_clock::now() - start;
+
+    double naive_us = naive_time.count() / (rounds * trace_count);
+    double compiled_us = compiled_time.count() / (rounds * trace_count);
+
+    std::cout << "Keyword rules, " << rules.size() << " rules, 16 frames per trace\n\n"
+              << std::fixed << std::setprecision(2)
+              << "compile:             " << compile_time.count() << " ms\n"
+              << "find() chain:        " << naive_us << " us/trace\n"
+              << "compiled automaton:  " << compiled_us << " us/trace\n"
+              << "speedup:             " << naive_us / compiled_us << "x\n"
+              << "rules fired agree:   " << (naive_fired == compiled_fired ? "yes" : "NO") << "\n";
+    return naive_fired == compiled_fired ? 0 : 1;
+}
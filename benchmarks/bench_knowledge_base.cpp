@@ -0,0 +1,68 @@
+#include "ai_debugger/KnowledgeBase.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace ai_debugger;
+
+int main(int argc, char* argv[]) {
+    size_t entries = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 500000;
+    std::string path = argc > 2 ? argv[2] : "bench_knowledge_base.kb";
+
+    std::mt19937_64 rng(11);
+    std::vector<uint64_t> keys(entries);
+    KnowledgeBaseBuilder builder;
+    for (size_t i = 0; i < entries; ++i) {
+        keys[i] = rng();
+        RootCause cause;
+        cause.category = static_cast<BugCategory>(i % static_cast<size_t>(BugCategory::UNKNOWN));
+        cause.description = "Known issue #" + std::to_string(i % 2000) + ": see tracker";
+        cause.location.file = "src/module_" + std::to_string(i % 500) + ".cpp";
+        cause.location.line = static_cast<int>(i % 4000);
+        cause.confidence = 0.5 + (i % 50) / 100.0;
+        builder.add(keys[i], cause);
+    }
+    if (!builder.save(path)) {
+        std::cerr << "failed to write " << path << "\n";
+        return 1;
+    }
+
+    const int runs = 5;
+    double best_open = 1e9;
+    KnowledgeBase knowledge_base;
+    for (int run = 0; run < runs; ++run) {
+        auto start = std::chrono::steady_clock::now();
+        bool ok = knowledge_base.open(path);
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        if (!ok) {
+            std::cerr << "failed to open " << path << "\n";
+            return 1;
+        }
+        best_open = std::min(best_open, elapsed.count());
+    }
+
+    const size_t lookups = 1000000;
+    std::vector<RootCause> causes;
+    size_t found = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < lookups; ++i) {
+        causes.clear();
+        found += knowledge_base.lookup(keys[(i * 7919) % entries], causes);
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout << "KnowledgeBase with " << knowledge_base.size() << " entries\n\n"
+              << std::fixed << std::setprecision(2)
+              << "open (best of " << runs << "):  " << best_open << " ms\n"
+              << std::setprecision(0)
+              << "lookups/s:         " << lookups / elapsed.count() << "\n"
+              << "found:             " << found << "\n";
+
+    std::remove(path.c_str());
+    return 0;
+}
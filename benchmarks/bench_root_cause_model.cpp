@@ -0,0 +1,125 @@
+#include "ai_debugger/RootCausePredictor.h"
+#include "ai_debugger/LinearClassifier.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace ai_debugger;
+
+namespace {
+
+StackTrace makeTrace(std::mt19937& rng, BugCategory category) {
+    static const char* modules[] = {"net", "db", "cache", "render", "auth", "io", "sched",
+                                    "codec", "store", "ui", "rpc", "log", "gpu"};
+    StackTrace trace;
+    trace.error_message = std::string("worker ") + std::to_string(rng() % 64) + " failed in " +
+                          modules[static_cast<size_t>(category) % 13] + " at 0x" + std::to_string(rng());
+    int depth = 8 + static_cast<int>(rng() % 16);
+    for (int i = 0; i < depth; ++i) {
+        StackFrame frame;
+        frame.function_name = std::string(modules[(static_cast<size_t>(category) + i) % 13]) +
+                              "::Handler" + std::to_string(rng() % 40) + "::process_item";
+        frame.location.file = "src/module.cpp";
+        frame.location.line = static_cast<int>(rng() % 1000);
+        trace.frames.push_back(frame);
+    }
+    return trace;
+}
+
+double timePredict(RootCausePredictor& predictor, const std::vector<StackTrace>& traces,
+                   const std::vector<CallGraphAnalyzer>& graphs, size_t rounds) {
+    auto start = std::chrono::steady_clock::now();
+    size_t causes = 0;
+    for (size_t round = 0; round < rounds; ++round) {
+        for (size_t i = 0; i < traces.size(); ++i) {
+            causes += predictor.predict(traces[i], graphs[i]).size();
+        }
+    }
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    if (causes == static_cast<size_t>(-1)) {
+        std::cout << causes;
+    }
+    return elapsed.count() / (rounds * traces.size());
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t train_count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 5000;
+    size_t test_count = 1000;
+
+    std::mt19937 rng(3);
+    auto category = [&]() { return static_cast<BugCategory>(rng() % (BUG_CATEGORY_COUNT - 1)); };
+
+    std::vector<std::pair<StackTrace, RootCause>> examples;
+    for (size_t i = 0; i < train_count; ++i) {
+        RootCause cause;
+        cause.category = category();
+        examples.emplace_back(makeTrace(rng, cause.category), cause);
+    }
+
+    RootCausePredictor trainer;
+    auto start = std::chrono::steady_clock::now();
+    trainer.trainFromExamples(examples);
+    std::string error;
+    if (!trainer.trainModel(&error)) {
+        std::cerr << "Cannot train: " << error << "\n";
+        return 1;
+    }
+    std::chrono::duration<double> train_time = std::chrono::steady_clock::now() - start;
+
+    // Only the model, not the trained knowledge base entries.
+    RootCausePredictor baseline;
+    RootCausePredictor with_model;
+    with_model.setModel(trainer.getModel());
+
+    std::vector<StackTrace> traces;
+    std::vector<BugCategory> labels;
+    std::vector<CallGraphAnalyzer> graphs(test_count);
+    for (size_t i = 0; i < test_count; ++i) {
+        labels.push_back(category());
+        traces.push_back(makeTrace(rng, labels.back()));
+        graphs[i].buildFromStackTrace(traces.back());
+    }
+
+    size_t correct = 0;
+    for (size_t i = 0; i < test_count; ++i) {
+        auto causes = with_model.predict(traces[i], graphs[i]);
+        for (const auto& cause : causes) {
+            if (cause.description.rfind("Classifier", 0) == 0) {
+                correct += cause.category == labels[i];
+                break;
+            }
+        }
+    }
+
+    double base_us = timePredict(baseline, traces, graphs, 20);
+    double model_us = timePredict(with_model, traces, graphs, 20);
+
+    FeatureVectorizer vectorizer;
+    SparseFeatures features;
+    size_t feature_count = 0;
+    start = std::chrono::steady_clock::now();
+    for (size_t round = 0; round < 20; ++round) {
+        for (const auto& trace : traces) {
+            vectorizer.vectorize(trace, features);
+            feature_count += features.size();
+        }
+    }
+    std::chrono::duration<double, std::micro> vectorize_time = std::chrono::steady_clock::now() - start;
+
+    std::cout << "Root cause classifier, " << train_count << " training traces\n\n"
+              << std::fixed << std::setprecision(2)
+              << "training time:        " << train_time.count() << " s\n"
+              << "held-out accuracy:    " << 100.0 * correct / test_count << "%\n"
+              << "predict() w/o model:  " << base_us << " us/trace\n"
+              << "predict() with model: " << model_us << " us/trace\n"
+              << "model overhead:       " << model_us - base_us << " us/trace\n"
+              << "vectorize():          " << vectorize_time.count() / (20 * test_count) << " us/trace, "
+              << feature_count / (20 * test_count) << " features\n";
+    return 0;
+}
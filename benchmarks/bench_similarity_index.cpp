@@ -0,0 +1,111 @@
+#include "ai_debugger/SimilarityIndex.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace ai_debugger;
+
+namespace {
+
+// Crashes come in families: each item keeps about 90% of its family's
+// features, so members are roughly 0.8 cosine-similar to each other.
+SparseFeatures makeItem(std::mt19937& rng, const std::vector<uint32_t>& family) {
+    SparseFeatures features;
+    for (uint32_t index : family) {
+        features.add(rng() % 10 == 0 ? rng() % 65536 : index, 1.0f);
+    }
+    return features;
+}
+
+int distance(const SimilarityIndex::Signature& a, const SimilarityIndex::Signature& b) {
+    int bits = 0;
+    for (size_t w = 0; w < a.size(); ++w) {
+        bits += __builtin_popcountll(a[w] ^ b[w]);
+    }
+    return bits;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t item_count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    size_t query_count = 1000;
+    size_t family_count = item_count / 20 + 1;
+    const size_t k = 5;
+
+    // Usage: bench_similarity_index [items [bands band_bits [max_candidates]]]
+    SimilarityOptions options;
+    if (argc > 3) {
+        options.bands = std::strtoul(argv[2], nullptr, 10);
+        options.band_bits = std::strtoul(argv[3], nullptr, 10);
+    }
+    if (argc > 4) {
+        options.max_candidates = std::strtoul(argv[4], nullptr, 10);
+    }
+
+    std::mt19937 rng(5);
+    std::vector<std::vector<uint32_t>> families(family_count);
+    for (auto& family : families) {
+        for (int i = 0; i < 48; ++i) {
+            family.push_back(rng() % 65536);
+        }
+    }
+
+    std::vector<SimilarityIndex::Signature> signatures;
+    signatures.reserve(item_count);
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < item_count; ++i) {
+        signatures.push_back(SimilarityIndex::signature(makeItem(rng, families[rng() % family_count])));
+    }
+    std::chrono::duration<double, std::micro> signature_time = std::chrono::steady_clock::now() - start;
+
+    SimilarityIndex index(options);
+    start = std::chrono::steady_clock::now();
+    for (const auto& signature : signatures) {
+        index.add(signature);
+    }
+    std::chrono::duration<double, std::micro> insert_time = std::chrono::steady_clock::now() - start;
+
+    std::vector<SimilarityIndex::Signature> queries;
+    for (size_t i = 0; i < query_count; ++i) {
+        queries.push_back(SimilarityIndex::signature(makeItem(rng, families[rng() % family_count])));
+    }
+
+    std::vector<std::vector<Neighbor>> results;
+    start = std::chrono::steady_clock::now();
+    for (const auto& query : queries) {
+        results.push_back(index.query(query, k));
+    }
+    std::chrono::duration<double, std::micro> query_time = std::chrono::steady_clock::now() - start;
+
+    // Recall@k against an exhaustive scan of the same signatures; ties at
+    // the k-th distance count as hits.
+    size_t hits = 0;
+    start = std::chrono::steady_clock::now();
+    for (size_t q = 0; q < query_count; ++q) {
+        std::vector<int> distances(signatures.size());
+        for (size_t i = 0; i < signatures.size(); ++i) {
+            distances[i] = distance(queries[q], signatures[i]);
+        }
+        std::nth_element(distances.begin(), distances.begin() + (k - 1), distances.end());
+        int kth = distances[k - 1];
+        for (const auto& neighbor : results[q]) {
+            hits += distance(queries[q], signatures[neighbor.id]) <= kth;
+        }
+    }
+    std::chrono::duration<double, std::micro> scan_time = std::chrono::steady_clock::now() - start;
+
+    std::cout << "Similarity index, " << item_count << " items, " << query_count << " queries, k=" << k
+              << "\n\n"
+              << std::fixed << std::setprecision(2)
+              << "signature():     " << signature_time.count() / item_count << " us/item\n"
+              << "add():           " << insert_time.count() / item_count << " us/item\n"
+              << "query():         " << query_time.count() / query_count << " us/query\n"
+              << "exhaustive scan: " << scan_time.count() / query_count << " us/query\n"
+              << "recall@" << k << ":        " << 100.0 * hits / (k * query_count) << "%\n";
+    return 0;
+}
@@ -0,0 +1,106 @@
+#include "ai_debugger/StackTraceParser.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace ai_debugger;
+
+namespace {
+
+std::string makeGDBTrace(int frames) {
+    std::string text = "Program received signal SIGSEGV, Segmentation fault.\n";
+    for (int i = 0; i < frames; ++i) {
+        text += "#" + std::to_string(i) + "  0x00005555555552" + std::to_string(10 + i % 90) +
+                " in module::function_" + std::to_string(i % 37) +
+                " (ptr=0x0, size=" + std::to_string(i) + ") at src/file_" +
+                std::to_string(i % 11) + ".cpp:" + std::to_string(100 + i) + "\n";
+    }
+    return text;
+}
+
+std::string makeLLDBTrace(int frames) {
+    std::string text = "* thread #1, stop reason = EXC_BAD_ACCESS (code=1, address=0x0)\n";
+    for (int i = 0; i < frames; ++i) {
+        text += "  frame #" + std::to_string(i) + ": 0x0000000100000f" + std::to_string(10 + i % 90) +
+                " app`function_" + std::to_string(i % 37) + " + " + std::to_string(i * 4) +
+                " at file_" + std::to_string(i % 11) + ".cpp:" + std::to_string(100 + i) + "\n";
+    }
+    return text;
+}
+
+std::string makeBacktrace(int frames) {
+    std::string text;
+    for (int i = 0; i < frames; ++i) {
+        text += "function_" + std::to_string(i % 37) + " at /src/file_" +
+                std::to_string(i % 11) + ".cpp:" + std::to_string(100 + i) + "\n";
+    }
+    return text;
+}
+
+std::string makeMSVCTrace(int frames) {
+    std::string text;
+    for (int i = 0; i < frames; ++i) {
+        text += "c:\\src\\file_" + std::to_string(i % 11) + ".cpp(" + std::to_string(100 + i) +
+                "): Module::function_" + std::to_string(i % 37) + "\n";
+    }
+    return text;
+}
+
+double framesPerSecond(StackTraceParser& parser, const std::string& text, int iterations) {
+    size_t frames = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        auto trace = parser.parse(text);
+        if (trace) {
+            frames += trace->frames.size();
+        }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return static_cast<double>(frames) / elapsed.count();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int frames_per_trace = argc > 1 ? std::atoi(argv[1]) : 64;
+    int iterations = argc > 2 ? std::atoi(argv[2]) : 200;
+
+    struct Corpus {
+        const char* name;
+        std::string text;
+    };
+
+    std::vector<Corpus> corpora = {
+        {"gdb", makeGDBTrace(frames_per_trace)},
+        {"lldb", makeLLDBTrace(frames_per_trace)},
+        {"addr2line", makeBacktrace(frames_per_trace)},
+        {"msvc", makeMSVCTrace(frames_per_trace)},
+    };
+
+    StackTraceParser scanner;
+    StackTraceParser reference;
+    reference.setParseEngine(ParseEngine::REGEX);
+
+    std::cout << "StackTraceParser throughput (" << frames_per_trace << " frames x "
+              << iterations << " iterations)\n\n";
+    std::cout << std::left << std::setw(12) << "format"
+              << std::right << std::setw(18) << "regex frames/s"
+              << std::setw(20) << "scanner frames/s"
+              << std::setw(10) << "speedup" << "\n";
+
+    for (const auto& corpus : corpora) {
+        double regex_rate = framesPerSecond(reference, corpus.text, iterations);
+        double scanner_rate = framesPerSecond(scanner, corpus.text, iterations);
+
+        std::cout << std::left << std::setw(12) << corpus.name
+                  << std::right << std::fixed << std::setprecision(0)
+                  << std::setw(18) << regex_rate
+                  << std::setw(20) << scanner_rate
+                  << std::setw(9) << std::setprecision(1) << (scanner_rate / regex_rate) << "x\n";
+    }
+
+    return 0;
+}
@@ -1,9 +1,23 @@
 #include "ai_debugger/AIDebugger.h"
+#include "ai_debugger/AnalysisServer.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <string>
 #include <cstring>
+#include <csignal>
+#include <chrono>
+#include <thread>
+
+namespace {
+
+volatile std::sig_atomic_t stop_requested = 0;
+
+void requestStop(int) {
+    stop_requested = 1;
+}
+
+} // namespace
 
 void printUsage(const char* program_name) {
     std::cout << "AI Debugger CLI Tool\n";
@@ -17,8 +31,18 @@ void printUsage(const char* program_name) {
     std::cout << "  --auto-fix              Automatically apply best fix\n";
     std::cout << "  --generate-tests        Generate regression tests\n";
     std::cout << "  --framework FRAMEWORK   Test framework (gtest, catch2, boost)\n";
+    std::cout << "  --stream                Analyze every trace in a concatenated crash log\n";
+    std::cout << "  --knowledge-base FILE   Load a knowledge base (see train_model)\n";
+    std::cout << "  --model FILE            Load a root cause classifier (see train_model)\n";
+    std::cout << "  --rules FILE            Load heuristic rules; reloaded on change in --stream and --daemon mode\n";
+    std::cout << "  --daemon SOCKET         Serve analyses on a Unix socket until interrupted\n";
+    std::cout << "  --threads N             Daemon worker threads (default: one per core)\n";
+    std::cout << "  --connect SOCKET        Have a running daemon analyze <trace_file>\n";
+    std::cout << "  --stats                 Print stage timings and counters as JSON to stderr on exit\n";
     std::cout << "\nExample:\n";
     std::cout << "  " << program_name << " -v --generate-tests stacktrace.txt\n";
+    std::cout << "  " << program_name << " --daemon /tmp/ai_debugger.sock --rules heuristics.rules &\n";
+    std::cout << "  " << program_name << " --connect /tmp/ai_debugger.sock stacktrace.txt\n";
 }
 
 int main(int argc, char* argv[]) {
@@ -31,9 +55,17 @@ int main(int argc, char* argv[]) {
     std::string output_file;
     std::string source_dir;
     std::string framework = "gtest";
+    std::string knowledge_base;
+    std::string model;
+    std::string rules;
+    std::string daemon_socket;
+    std::string connect_socket;
+    size_t threads = 0;
     bool verbose = false;
     bool auto_fix = false;
     bool generate_tests = false;
+    bool stream = false;
+    bool stats = false;
 
     for (int i = 1; i < argc; ++i) {
         std::string arg = argv[i];
@@ -55,6 +87,34 @@ int main(int argc, char* argv[]) {
             auto_fix = true;
         } else if (arg == "--generate-tests") {
             generate_tests = true;
+        } else if (arg == "--stream") {
+            stream = true;
+        } else if (arg == "--stats") {
+            stats = true;
+        } else if (arg == "--knowledge-base") {
+            if (i + 1 < argc) {
+                knowledge_base = argv[++i];
+            }
+        } else if (arg == "--model") {
+            if (i + 1 < argc) {
+                model = argv[++i];
+            }
+        } else if (arg == "--rules") {
+            if (i + 1 < argc) {
+                rules = argv[++i];
+            }
+        } else if (arg == "--daemon") {
+            if (i + 1 < argc) {
+                daemon_socket = argv[++i];
+            }
+        } else if (arg == "--connect") {
+            if (i + 1 < argc) {
+                connect_socket = argv[++i];
+            }
+        } else if (arg == "--threads") {
+            if (i + 1 < argc) {
+                threads = std::strtoul(argv[++i], nullptr, 10);
+            }
         } else if (arg == "--framework") {
             if (i + 1 < argc) {
                 framework = argv[++i];
@@ -64,7 +124,45 @@ int main(int argc, char* argv[]) {
         }
     }
 
-    if (trace_file.empty()) {
+    if (!connect_socket.empty()) {
+        if (trace_file.empty() || stream || auto_fix || generate_tests || stats) {
+            std::cerr << "Error: --connect takes one trace file and no --stream, --auto-fix, --generate-tests or --stats\n";
+            return 1;
+        }
+        std::ifstream input(trace_file, std::ios::binary);
+        if (!input.is_open()) {
+            std::cerr << "Error: Cannot open " << trace_file << "\n";
+            return 1;
+        }
+        std::ostringstream text;
+        text << input.rdbuf();
+
+        ai_debugger::AnalysisClient client;
+        std::string error;
+        std::string report;
+        if (!client.connect(connect_socket, &error) || !client.report(text.str(), report, &error)) {
+            std::cerr << "Error: " << error << "\n";
+            return 1;
+        }
+        if (output_file.empty()) {
+            std::cout << report;
+        } else {
+            std::ofstream output(output_file);
+            if (!(output << report)) {
+                std::cerr << "Error: Failed to save report\n";
+                return 1;
+            }
+            std::cout << "Report saved to: " << output_file << "\n";
+        }
+        return 0;
+    }
+
+    if (!daemon_socket.empty() && auto_fix) {
+        std::cerr << "Error: --daemon does not apply fixes; drop --auto-fix\n";
+        return 1;
+    }
+
+    if (trace_file.empty() && daemon_socket.empty()) {
         std::cerr << "Error: No trace file specified\n";
         printUsage(argv[0]);
         return 1;
@@ -76,16 +174,125 @@ int main(int argc, char* argv[]) {
     debugger.enableAutoFix(auto_fix);
     debugger.enableTestGeneration(generate_tests);
 
+    // Shared with the daemon's workers, so it covers every analysis.
+    auto instrumentation = debugger.getInstrumentation();
+    instrumentation->setEnabled(stats);
+    auto printStats = [&]() {
+        if (stats) {
+            std::cerr << instrumentation->snapshot().toJSON() << "\n";
+        }
+    };
+
     if (!source_dir.empty()) {
         debugger.setSourceDirectory(source_dir);
     }
 
+    std::string store_error;
+    if (!debugger.openSessionStore(&store_error)) {
+        std::cerr << "Warning: Sessions will not be saved: " << store_error << "\n";
+    }
+
+    if (!knowledge_base.empty() && !debugger.loadKnowledgeBase(knowledge_base)) {
+        std::cerr << "Error: Cannot load knowledge base " << knowledge_base << "\n";
+        return 1;
+    }
+
+    if (!model.empty() && !debugger.loadModel(model)) {
+        std::cerr << "Error: Cannot load model " << model << "\n";
+        return 1;
+    }
+
+    std::string rules_error;
+    if (!rules.empty() && !debugger.loadRules(rules, &rules_error)) {
+        std::cerr << "Error: Cannot load rules: " << rules_error << "\n";
+        return 1;
+    }
+
+    ai_debugger::TestFramework test_framework = ai_debugger::TestFramework::GTEST;
     if (framework == "catch2") {
-        debugger.setTestFramework(ai_debugger::TestFramework::CATCH2);
+        test_framework = ai_debugger::TestFramework::CATCH2;
     } else if (framework == "boost") {
-        debugger.setTestFramework(ai_debugger::TestFramework::BOOST_TEST);
-    } else {
-        debugger.setTestFramework(ai_debugger::TestFramework::GTEST);
+        test_framework = ai_debugger::TestFramework::BOOST_TEST;
+    }
+    debugger.setTestFramework(test_framework);
+
+    if (!daemon_socket.empty()) {
+        // Every worker gets a debugger set up like this one, sharing its
+        // crash history, knowledge base, model and rules.
+        ai_debugger::AnalysisServerOptions options;
+        options.socket_path = daemon_socket;
+        options.threads = threads;
+        ai_debugger::AnalysisServer server(options, [&]() {
+            auto worker = std::make_unique<ai_debugger::AIDebugger>();
+            worker->setVerbose(verbose);
+            worker->enableTestGeneration(generate_tests);
+            worker->setTestFramework(test_framework);
+            worker->setCrashHistory(debugger.getCrashHistory());
+            worker->setKnowledgeBase(debugger.getKnowledgeBase());
+            worker->setModel(debugger.getModel());
+            worker->setRuleEngine(debugger.getRuleEngine());
+            worker->setInstrumentation(instrumentation);
+            if (!source_dir.empty()) {
+                worker->setSourceDirectory(source_dir);
+            }
+            return worker;
+        });
+
+        std::string error;
+        if (!server.start(&error)) {
+            std::cerr << "Error: " << error << "\n";
+            return 1;
+        }
+        std::signal(SIGINT, requestStop);
+        std::signal(SIGTERM, requestStop);
+        std::cout << "Listening on " << daemon_socket << "\n";
+
+        while (!stop_requested) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(250));
+            if (rules.empty()) {
+                continue;
+            }
+            if (!debugger.reloadRulesIfChanged(&rules_error) && !rules_error.empty()) {
+                std::cerr << "Warning: Rules not reloaded: " << rules_error << "\n";
+                rules_error.clear();
+            }
+        }
+
+        server.stop();
+        std::cout << "Served " << server.requestCount() << " request(s)\n";
+        printStats();
+        return 0;
+    }
+
+    if (stream) {
+        std::ifstream input(trace_file);
+        if (!input.is_open()) {
+            std::cerr << "Error: Cannot open " << trace_file << "\n";
+            return 1;
+        }
+
+        std::ofstream output;
+        if (!output_file.empty()) {
+            output.open(output_file);
+            if (!output.is_open()) {
+                std::cerr << "Error: Failed to save report\n";
+                return 1;
+            }
+        }
+        std::ostream& out = output_file.empty() ? std::cout : output;
+
+        size_t count = debugger.analyzeStream(input, [&](ai_debugger::DebugSession&& session) {
+            out << debugger.getReport(session) << "\n";
+            // Long-running logs pick up rule edits; a broken edit keeps the old rules.
+            if (!rules.empty() && !debugger.reloadRulesIfChanged(&rules_error) && !rules_error.empty()) {
+                std::cerr << "Warning: Rules not reloaded: " << rules_error << "\n";
+                rules_error.clear();
+            }
+        });
+
+        std::cout << "Analyzed " << count << " stack trace(s) from: " << trace_file << "\n";
+        printStats();
+        return count > 0 ? 0 : 1;
     }
 
     std::cout << "Analyzing stack trace from: " << trace_file << "\n";
@@ -134,5 +341,6 @@ int main(int argc, char* argv[]) {
         }
     }
 
+    printStats();
     return 0;
 }
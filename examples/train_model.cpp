@@ -0,0 +1,130 @@
+#include "ai_debugger/StackTraceParser.h"
+#include "ai_debugger/RootCausePredictor.h"
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Labeled examples are stack traces, each preceded by a header line:
+//
+//   === Null Pointer Dereference | Config loaded before init
+//   Program received signal SIGSEGV, Segmentation fault.
+//   #0  0x000055555555513d in Config::get (this=0x0) at config.cpp:42
+//   ...
+//
+// The category is a bugCategoryToString() name; the description after '|'
+// is optional and is what the knowledge base reports for matching crashes.
+
+void printUsage(const char* program_name) {
+    std::cout << "Usage: " << program_name << " <examples_file> <model_out> [--knowledge-base FILE]\n\n";
+    std::cout << "Trains the root cause classifier from labeled stack traces and\n";
+    std::cout << "optionally writes the examples as a knowledge base.\n";
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::string examples_file = argv[1];
+    std::string model_file = argv[2];
+    std::string knowledge_base_file;
+    for (int i = 3; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--knowledge-base" && i + 1 < argc) {
+            knowledge_base_file = argv[++i];
+        }
+    }
+
+    std::ifstream input(examples_file);
+    if (!input.is_open()) {
+        std::cerr << "Error: Cannot open " << examples_file << "\n";
+        return 1;
+    }
+
+    ai_debugger::StackTraceParser parser;
+    std::vector<std::pair<ai_debugger::StackTrace, ai_debugger::RootCause>> examples;
+    size_t skipped = 0;
+
+    ai_debugger::RootCause cause;
+    std::string trace_text;
+    bool in_example = false;
+
+    auto finishExample = [&]() {
+        if (!in_example) {
+            return;
+        }
+        auto trace = parser.parse(trace_text);
+        if (trace && !trace->frames.empty()) {
+            examples.emplace_back(std::move(*trace), cause);
+        } else {
+            ++skipped;
+        }
+        trace_text.clear();
+    };
+
+    std::string line;
+    while (std::getline(input, line)) {
+        if (line.compare(0, 4, "=== ") != 0) {
+            trace_text += line;
+            trace_text += '\n';
+            continue;
+        }
+
+        finishExample();
+
+        std::string header = line.substr(4);
+        std::string description;
+        size_t bar = header.find('|');
+        if (bar != std::string::npos) {
+            description = header.substr(bar + 1);
+            header.erase(bar);
+        }
+        auto trim = [](std::string& text) {
+            text.erase(0, text.find_first_not_of(" \t"));
+            text.erase(text.find_last_not_of(" \t\r") + 1);
+        };
+        trim(header);
+        trim(description);
+
+        cause = ai_debugger::RootCause();
+        cause.category = ai_debugger::stringToBugCategory(header);
+        cause.description = description.empty() ? header : description;
+        cause.confidence = 0.9;
+        in_example = true;
+    }
+    finishExample();
+
+    if (examples.empty()) {
+        std::cerr << "Error: No labeled traces in " << examples_file << "\n";
+        return 1;
+    }
+
+    ai_debugger::RootCausePredictor predictor;
+    predictor.trainFromExamples(examples);
+
+    std::string error;
+    if (!predictor.trainModel(&error)) {
+        std::cerr << "Error: Cannot train a model: " << error << "\n";
+        return 1;
+    }
+    if (!predictor.saveModel(model_file)) {
+        std::cerr << "Error: Failed to write " << model_file << "\n";
+        return 1;
+    }
+    if (!knowledge_base_file.empty() && !predictor.saveKnowledgeBase(knowledge_base_file)) {
+        std::cerr << "Error: Failed to write " << knowledge_base_file << "\n";
+        return 1;
+    }
+
+    std::cout << "Trained on " << examples.size() << " example(s)";
+    if (skipped > 0) {
+        std::cout << ", skipped " << skipped << " unparseable";
+    }
+    std::cout << "\nModel written to: " << model_file << "\n";
+    if (!knowledge_base_file.empty()) {
+        std::cout << "Knowledge base written to: " << knowledge_base_file << "\n";
+    }
+    return 0;
+}
@@ -7,22 +7,81 @@
 #include "ExplanationGenerator.h"
 #include "FixSuggester.h"
 #include "TestGenerator.h"
+#include "CrashHistory.h"
+#include "Instrumentation.h"
 
 #include <string>
 #include <memory>
 #include <vector>
+#include <optional>
+#include <functional>
+#include <istream>
+#include <cstdint>
 
 namespace ai_debugger {
 
+class SessionStore;
+class AnalysisPipeline;
+enum class PipelineStage;
+struct SessionCompleter;
+
+// Parts of a DebugSession an analysis computes, combined with |. Root causes
+// are always computed; explanation, fixes and tests left out are produced on
+// first use by the DebugSession get functions.
+enum class AnalysisOptions : uint32_t {
+    ROOT_CAUSES = 0,
+    SIMILAR_CRASHES = 1u << 0,
+    EXPLANATION = 1u << 1,
+    FIXES = 1u << 2,
+    REGRESSION_TESTS = 1u << 3,  // eager only with enableTestGeneration(true)
+    ALL = (1u << 4) - 1
+};
+
+constexpr AnalysisOptions operator|(AnalysisOptions a, AnalysisOptions b) {
+    return static_cast<AnalysisOptions>(static_cast<uint32_t>(a) | static_cast<uint32_t>(b));
+}
+
+constexpr AnalysisOptions operator&(AnalysisOptions a, AnalysisOptions b) {
+    return static_cast<AnalysisOptions>(static_cast<uint32_t>(a) & static_cast<uint32_t>(b));
+}
+
+constexpr AnalysisOptions operator~(AnalysisOptions a) {
+    return static_cast<AnalysisOptions>(~static_cast<uint32_t>(a) & static_cast<uint32_t>(AnalysisOptions::ALL));
+}
+
+constexpr bool hasOption(AnalysisOptions options, AnalysisOptions option) {
+    return (static_cast<uint32_t>(options) & static_cast<uint32_t>(option)) != 0;
+}
+
 struct DebugSession {
     StackTrace trace;
     std::vector<RootCause> root_causes;
     Explanation explanation;
     std::vector<CodeFix> suggested_fixes;
     TestSuite regression_tests;
+    std::vector<SimilarCrash> similar_crashes;  // earlier crashes most like this one
 
     std::string session_id;
     std::string timestamp;
+
+    uint64_t fingerprint;       // crashFingerprint() of the trace, 0 if none
+    uint64_t occurrence_count;  // times this crash has been analyzed
+    bool root_cause_confirmed;  // root_causes[0] was set by confirmRootCause()
+
+    // Parts the analysis left out, and the analyzing debugger's generators
+    // that compute them. The get functions fill the fields on first call.
+    AnalysisOptions pending;
+    std::shared_ptr<SessionCompleter> completer;
+
+    DebugSession()
+        : fingerprint(0)
+        , occurrence_count(1)
+        , root_cause_confirmed(false)
+        , pending(AnalysisOptions::ROOT_CAUSES) {}
+
+    const Explanation& getExplanation();
+    const std::vector<CodeFix>& getSuggestedFixes();
+    const TestSuite& getRegressionTests();
 };
 
 class AIDebugger {
@@ -33,11 +92,81 @@ public:
     DebugSession analyzeStackTrace(const std::string& trace_text);
     DebugSession analyzeFromFile(const std::string& trace_file);
 
+    // Analyzes every trace in a concatenated crash log as it is read.
+    size_t analyzeStream(std::istream& input, const std::function<void(DebugSession&&)>& on_session);
+
+    // Analyzes traces in parallel on a work-stealing pool sized by
+    // setMaxParallelTasks() (default one worker per hardware thread).
+    // Results are returned in input order; concurrent calls run one after
+    // another.
+    std::vector<DebugSession> analyzeBatch(const std::vector<std::string>& traces);
+
     void setSourceDirectory(const std::string& src_dir);
+    // Sessions are kept in a SessionStore in this directory, opened on first
+    // use (default ".ai_debugger/sessions"). An empty directory keeps none.
+    void setSessionDirectory(const std::string& directory);
+    void setSessionStore(std::shared_ptr<SessionStore> store);
+    std::shared_ptr<SessionStore> getSessionStore() const;
+    // Opens the session directory now instead of on first use. False, with
+    // the reason, when it cannot be opened, e.g. while another process holds
+    // it; sessions are then not saved.
+    bool openSessionStore(std::string* error = nullptr);
+    // Sessions are saved by a background SessionWriter; returns once all
+    // sessions analyzed so far are on disk, and the crash history restored.
+    // listSessions() and loadSession() flush first.
+    bool flushSessions();
     void setTestFramework(TestFramework framework);
     void setVerbose(bool verbose);
     void enableAutoFix(bool enable);
     void enableTestGeneration(bool enable);
+    void setMaxParallelTasks(int max_tasks);
+    // Parts of each session computed during analysis (default ALL). A
+    // triage-only caller can ask for ROOT_CAUSES and skip the rest.
+    void setAnalysisOptions(AnalysisOptions options);
+
+    // Maps a knowledge base file (see KnowledgeBase) shared by all pipelines.
+    bool loadKnowledgeBase(const std::string& kb_path);
+    void setKnowledgeBase(std::shared_ptr<const KnowledgeBase> knowledge_base);
+    std::shared_ptr<const KnowledgeBase> getKnowledgeBase() const;
+    // Loads a category classifier (see LinearClassifier) shared by all pipelines.
+    bool loadModel(const std::string& model_path);
+    void setModel(std::shared_ptr<const LinearClassifier> model);
+    std::shared_ptr<const LinearClassifier> getModel() const;
+    // Replaces the heuristic rules with a rule file (see parseRules). Reloads
+    // swap the rules under running analyses without blocking them, and drop
+    // sessions cached for deduplication.
+    bool loadRules(const std::string& rules_path, std::string* error = nullptr);
+    bool reloadRulesIfChanged(std::string* error = nullptr);
+    // Debuggers given the same engine all see its loads and reloads.
+    void setRuleEngine(std::shared_ptr<RuleEngine> engine);
+    std::shared_ptr<RuleEngine> getRuleEngine() const;
+
+    // Repeats of an already analyzed crash (same crashFingerprint, signal,
+    // exception type and normalized error message) reuse the cached analysis
+    // with occurrence_count bumped instead of running the pipeline again;
+    // they still get their own session id and timestamp. On by default.
+    void enableDeduplication(bool enable);
+    void setDeduplicationCapacity(size_t max_sessions);
+
+    // Every analyzed crash is recorded in a CrashHistory with its predicted
+    // cause; sessions list the most similar earlier crashes. Confirmed causes
+    // are also used by the predictor as evidence for similar new crashes.
+    void setSimilarCrashCount(size_t count);
+    std::vector<SimilarCrash> findSimilarSessions(const StackTrace& trace, size_t k = 5) const;
+    // Records the verified cause of an analyzed session, in this or an
+    // earlier run. Returns false for unknown session ids. Sessions in the
+    // session directory are added to the history in the background, once per
+    // store and history, after openSessionStore() or the first analysis.
+    bool confirmRootCause(const std::string& session_id, const RootCause& cause);
+    // Debuggers given the same history see each other's crashes.
+    void setCrashHistory(std::shared_ptr<CrashHistory> history);
+    std::shared_ptr<CrashHistory> getCrashHistory() const;
+
+    // Stage timings and counters of this debugger's analyses, disabled until
+    // Instrumentation::setEnabled(true). Debuggers given the same
+    // instrumentation add up into it.
+    void setInstrumentation(std::shared_ptr<Instrumentation> instrumentation);
+    std::shared_ptr<Instrumentation> getInstrumentation() const;
 
     std::string getReport(const DebugSession& session) const;
     bool saveReport(const DebugSession& session, const std::string& output_path) const;
@@ -51,29 +180,70 @@ public:
     DebugSession loadSession(const std::string& session_id) const;
 
 private:
+    friend class AnalysisPipeline;
+
+    // One full set of analysis components. The debugger's own pipeline serves
+    // the single-trace entry points; analyzeBatch and AnalysisPipeline give
+    // every worker its own so workers never share mutable component state.
+    struct Pipeline {
+        StackTraceParser parser;
+        CallGraphAnalyzer graph_analyzer;
+        RootCausePredictor predictor;
+        ExplanationGenerator explanation_gen;
+        FixSuggester fix_suggester;
+        TestGenerator test_gen;
+    };
+
     struct Impl;
     std::unique_ptr<Impl> impl_;
 
+    DebugSession analyzeTrace(std::optional<StackTrace> trace, Pipeline& pipeline);
+    // The steps of analyzeTrace(), which AnalysisPipeline runs on separate
+    // threads. beginAnalysis() returns true when the session is already
+    // complete (a repeated crash, or no trace) and needs no further stages.
+    bool beginAnalysis(std::optional<StackTrace> trace, DebugSession& session, uint64_t& rules_generation);
+    void analyzeStage(PipelineStage stage, DebugSession& session, CallGraphAnalyzer& graph, Pipeline& pipeline);
+    void finishAnalysis(const DebugSession& session, uint64_t rules_generation);
+    std::unique_ptr<Pipeline> makePipeline() const;
+    std::optional<StackTrace> parseTrace(const std::string& trace_text, Pipeline& pipeline);
     std::string generateSessionId() const;
     void saveSession(const DebugSession& session);
 };
 
+// knowledge_base_path, model_path and rules_path record what the load
+// functions last loaded; nothing reads the files from a Config, so callers
+// restoring one call loadKnowledgeBase(), loadModel() and loadRules().
+// fromFile() does not parse a file yet and returns the defaults.
 struct Config {
     std::string source_directory;
     std::string test_output_directory;
     std::string knowledge_base_path;
+    std::string model_path;
+    std::string rules_path;
+    std::string session_directory;
     TestFramework test_framework;
     bool verbose;
     bool auto_fix;
     bool auto_test;
     int detail_level;
+    int max_parallel_tasks;  // 0 = one worker per hardware thread
+    bool deduplicate;
+    size_t dedupe_capacity;  // cached sessions kept for deduplication
+    size_t similar_crashes;  // similar past crashes listed per session, 0 = off
+    AnalysisOptions analysis_options;
 
     Config()
-        : test_framework(TestFramework::GTEST)
+        : session_directory(".ai_debugger/sessions")
+        , test_framework(TestFramework::GTEST)
         , verbose(false)
         , auto_fix(false)
         , auto_test(false)
-        , detail_level(2) {}
+        , detail_level(2)
+        , max_parallel_tasks(0)
+        , deduplicate(true)
+        , dedupe_capacity(4096)
+        , similar_crashes(5)
+        , analysis_options(AnalysisOptions::ALL) {}
 
     static Config fromFile(const std::string& config_path);
     bool save(const std::string& config_path) const;
@@ -0,0 +1,72 @@
+#ifndef AI_DEBUGGER_AGGREGATE_CALL_GRAPH_H
+#define AI_DEBUGGER_AGGREGATE_CALL_GRAPH_H
+
+#include "StackTraceParser.h"
+#include <string>
+#include <vector>
+#include <utility>
+#include <memory>
+#include <cstdint>
+
+namespace ai_debugger {
+
+struct AggregateEdge {
+    std::string caller;
+    std::string callee;
+    uint64_t count;  // traces containing this call
+    int64_t first_seen;
+    int64_t last_seen;
+    std::vector<std::pair<int, uint64_t>> signals;  // signal number -> traces
+
+    AggregateEdge() : count(0), first_seen(0), last_seen(0) {}
+};
+
+struct CrashPath {
+    std::vector<std::string> functions;  // crashing frame first
+    uint64_t count;
+    uint64_t error;  // count may overestimate the true frequency by up to this
+
+    CrashPath() : count(0), error(0) {}
+};
+
+struct AggregateLimits {
+    size_t max_edges;  // compaction keeps the heaviest half once exceeded
+    size_t max_paths;  // heavy-hitter counters for topPaths()
+    size_t path_depth; // frames from the crash site that identify a path
+
+    AggregateLimits() : max_edges(1 << 20), max_paths(4096), path_depth(8) {}
+};
+
+// Weighted call graph accumulated over many traces. Memory stays bounded:
+// edges are compacted to the most frequent ones and crash paths are tracked
+// with a Space-Saving heavy-hitter summary. Not synchronized; ingest into one
+// graph per thread or shard and merge() them.
+class AggregateCallGraph {
+public:
+    explicit AggregateCallGraph(const AggregateLimits& limits = AggregateLimits());
+    ~AggregateCallGraph();
+
+    AggregateCallGraph(AggregateCallGraph&&) noexcept;
+    AggregateCallGraph& operator=(AggregateCallGraph&&) noexcept;
+
+    // `timestamp` is caller-defined, typically seconds since the epoch.
+    void add(const StackTrace& trace, int64_t timestamp);
+    void add(const StackTrace& trace);
+    void merge(const AggregateCallGraph& other);
+
+    std::vector<AggregateEdge> topEdges(size_t k) const;
+    std::vector<CrashPath> topPaths(size_t k) const;
+
+    uint64_t traceCount() const;
+    size_t edgeCount() const;
+
+    void clear();
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace ai_debugger
+
+#endif // AI_DEBUGGER_AGGREGATE_CALL_GRAPH_H
@@ -0,0 +1,81 @@
+#ifndef AI_DEBUGGER_ANALYSIS_PIPELINE_H
+#define AI_DEBUGGER_ANALYSIS_PIPELINE_H
+
+#include "AIDebugger.h"
+#include "Histogram.h"
+#include <array>
+#include <string>
+#include <memory>
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+
+namespace ai_debugger {
+
+enum class PipelineStage {
+    PARSE,       // StackTraceParser, then the deduplication lookup
+    CALL_GRAPH,  // CallGraphAnalyzer
+    PREDICT,     // RootCausePredictor and the crash history
+    EXPLAIN,     // ExplanationGenerator
+    FIX,         // FixSuggester
+    TEST         // TestGenerator, then the session is saved and delivered
+};
+
+constexpr size_t PIPELINE_STAGE_COUNT = static_cast<size_t>(PipelineStage::TEST) + 1;
+
+const char* pipelineStageToString(PipelineStage stage);
+
+struct PipelineOptions {
+    size_t queue_capacity;  // traces waiting in front of each stage
+    std::array<size_t, PIPELINE_STAGE_COUNT> workers;  // threads per stage
+
+    PipelineOptions() : queue_capacity(256) {
+        workers.fill(1);
+    }
+};
+
+// Runs AIDebugger analysis as a chain of stages, each on its own threads and
+// with its own components, joined by BoundedQueues. Stages work on different
+// traces at once, so throughput is set by the slowest stage rather than the
+// whole chain, and a full queue holds back submit(). Deduplication, crash
+// history and session saving behave as in analyzeStackTrace().
+//
+// Sessions are passed to `on_session` one at a time from the last stage; they
+// arrive in submission order unless a stage has more than one worker.
+// Configure the debugger before creating the pipeline, and keep it alive
+// until the pipeline is closed.
+class AnalysisPipeline {
+public:
+    AnalysisPipeline(AIDebugger& debugger, std::function<void(DebugSession&&)> on_session,
+                     const PipelineOptions& options = PipelineOptions());
+    ~AnalysisPipeline();
+
+    AnalysisPipeline(const AnalysisPipeline&) = delete;
+    AnalysisPipeline& operator=(const AnalysisPipeline&) = delete;
+
+    // Blocks while the first stage's queue is full. False once closed.
+    bool submit(std::string trace_text);
+    // Finishes every submitted trace and stops the stage threads. Call it
+    // once no other thread is inside submit().
+    void close();
+
+    uint64_t submitted() const;
+    uint64_t completed() const;
+
+    // Traces waiting in front of `stage` right now.
+    size_t queueDepth(PipelineStage stage) const;
+    // Queue depth in front of `stage`, sampled as each trace is enqueued.
+    const Histogram& queueDepthHistogram(PipelineStage stage) const;
+    // Time in nanoseconds `stage` spent on each trace.
+    const Histogram& latencyHistogram(PipelineStage stage) const;
+    // Nanoseconds from submit() to delivery.
+    const Histogram& totalLatencyHistogram() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace ai_debugger
+
+#endif // AI_DEBUGGER_ANALYSIS_PIPELINE_H
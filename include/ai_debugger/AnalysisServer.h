@@ -0,0 +1,103 @@
+#ifndef AI_DEBUGGER_ANALYSIS_SERVER_H
+#define AI_DEBUGGER_ANALYSIS_SERVER_H
+
+#include "AIDebugger.h"
+#include <string>
+#include <memory>
+#include <functional>
+#include <cstdint>
+
+namespace ai_debugger {
+
+// Wire protocol: every message is a frame of
+//   type     uint32, MessageType
+//   size     uint32, payload bytes
+//   payload
+// in native byte order (the socket is local). A connection carries any
+// number of request/response pairs.
+enum class MessageType : uint32_t {
+    PING = 1,         // empty; answered with PONG
+    ANALYZE = 2,      // trace text; answered with SESSION, parts pending on the server computed
+    REPORT = 3,       // trace text; answered with REPORT_TEXT
+    PONG = 16,
+    SESSION = 17,     // serializeSession() bytes
+    REPORT_TEXT = 18, // AIDebugger::getReport() of the session
+    FAILURE = 31      // error message
+};
+
+struct AnalysisServerOptions {
+    std::string socket_path;
+    size_t threads;              // 0 = one per hardware thread
+    uint32_t max_frame_size;     // larger requests are refused
+    uint32_t idle_timeout_ms;    // connections idle this long are closed; 0 = never
+    uint32_t request_timeout_ms; // limit on each read of a request and write of its reply; 0 = none
+
+    AnalysisServerOptions()
+        : threads(0)
+        , max_frame_size(64u << 20)
+        , idle_timeout_ms(60000)
+        , request_timeout_ms(10000) {}
+};
+
+// Long-running analysis service on a Unix domain socket. Every pool worker
+// owns a warm AIDebugger, built once by `make_debugger`, so requests skip
+// parser, rule and model setup. Idle connections wait in the acceptor's
+// poll set; each request that arrives is handed to a free worker, so any
+// number of open connections share the pool. Not available on Windows.
+class AnalysisServer {
+public:
+    AnalysisServer(const AnalysisServerOptions& options,
+                   std::function<std::unique_ptr<AIDebugger>()> make_debugger);
+    ~AnalysisServer();
+
+    AnalysisServer(const AnalysisServer&) = delete;
+    AnalysisServer& operator=(const AnalysisServer&) = delete;
+
+    // Binds the socket and starts accepting. The socket file is guarded by
+    // an flock on socket_path + ".lock": a stale file is replaced, one owned
+    // by another running server is not.
+    bool start(std::string* error = nullptr);
+    // Closes open connections, waits for running requests and removes the
+    // socket file.
+    void stop();
+    bool isRunning() const;
+
+    uint64_t requestCount() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+struct AnalysisClientOptions {
+    uint32_t max_reply_size; // larger replies fail the request and close the connection
+
+    AnalysisClientOptions()
+        : max_reply_size(64u << 20) {}
+};
+
+// Blocking client for AnalysisServer.
+class AnalysisClient {
+public:
+    explicit AnalysisClient(const AnalysisClientOptions& options = AnalysisClientOptions());
+    ~AnalysisClient();
+
+    AnalysisClient(const AnalysisClient&) = delete;
+    AnalysisClient& operator=(const AnalysisClient&) = delete;
+
+    bool connect(const std::string& socket_path, std::string* error = nullptr);
+    void close();
+    bool isConnected() const;
+
+    bool ping(std::string* error = nullptr);
+    bool analyze(const std::string& trace_text, DebugSession& out, std::string* error = nullptr);
+    bool report(const std::string& trace_text, std::string& out, std::string* error = nullptr);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace ai_debugger
+
+#endif // AI_DEBUGGER_ANALYSIS_SERVER_H
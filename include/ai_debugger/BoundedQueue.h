@@ -0,0 +1,198 @@
+#ifndef AI_DEBUGGER_BOUNDED_QUEUE_H
+#define AI_DEBUGGER_BOUNDED_QUEUE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace ai_debugger {
+
+// Bounded multi-producer multi-consumer FIFO on a ring of sequenced cells
+// (Vyukov). tryPush() and tryPop() are lock-free. The blocking push() and
+// pop() spin briefly, then park on a condition variable; the mutex is only
+// touched when a thread is parked, so a queue kept busy never locks.
+// Capacity is rounded up to a power of two.
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity)
+        : mask_(roundUp(capacity) - 1)
+        , cells_(new Cell[mask_ + 1])
+        , enqueue_pos_(0)
+        , dequeue_pos_(0)
+        , closed_(false) {
+        for (size_t i = 0; i <= mask_; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    // Moves from `value` only on success.
+    bool tryPush(T& value) {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells_[pos & mask_];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(sequence - pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = std::move(value);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    wake(consumers_);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool tryPop(T& out) {
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells_[pos & mask_];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(sequence - (pos + 1));
+            if (diff == 0) {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    out = std::move(cell.value);
+                    cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+                    wake(producers_);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Blocks while the queue is full. Returns false once closed.
+    bool push(T value) {
+        bool pushed = false;
+        wait(producers_, [&] { return closed_.load() || (pushed = tryPush(value)); });
+        return pushed;
+    }
+
+    // Blocks while the queue is empty. Returns false once closed and drained.
+    bool pop(T& out) {
+        bool popped = false;
+        wait(consumers_, [&] { return (popped = tryPop(out)) || closed_.load(); });
+        return popped;
+    }
+
+    // Wakes every blocked thread; later pushes fail and pops drain what is
+    // left. Must not race with push().
+    void close() {
+        closed_.store(true);
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (Waiters* waiters : {&producers_, &consumers_}) {
+            ++waiters->epoch;
+            waiters->condition.notify_all();
+        }
+    }
+
+    bool isClosed() const {
+        return closed_.load();
+    }
+
+    // Approximate while other threads push or pop.
+    size_t size() const {
+        size_t head = dequeue_pos_.load(std::memory_order_relaxed);
+        size_t tail = enqueue_pos_.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+    size_t capacity() const {
+        return mask_ + 1;
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    static size_t roundUp(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        return size;
+    }
+
+    // Threads parked in push() or pop(). `epoch` changes under the mutex
+    // whenever they are woken, so a wake between a sleeper's last check and
+    // its wait is not lost.
+    struct Waiters {
+        std::atomic<size_t> count{0};
+        uint64_t epoch = 0;
+        std::condition_variable condition;
+    };
+
+    static constexpr int SPIN_LIMIT = 64;
+
+    void wake(Waiters& waiters) {
+        // Pairs with the fence in wait(): either the sleeper sees our update
+        // on its last check or we see it registered.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters.count.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++waiters.epoch;
+            waiters.condition.notify_all();
+        }
+    }
+
+    // `ready` runs without the mutex held, since it may wake the other side.
+    template <typename Ready>
+    void wait(Waiters& waiters, Ready ready) {
+        for (int spin = 0; spin < SPIN_LIMIT; ++spin) {
+            if (ready()) {
+                return;
+            }
+            std::this_thread::yield();
+        }
+
+        while (true) {
+            uint64_t epoch;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                waiters.count.fetch_add(1);
+                epoch = waiters.epoch;
+            }
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            bool done = ready();
+            if (!done) {
+                std::unique_lock<std::mutex> lock(mutex_);
+                waiters.condition.wait(lock, [&] { return waiters.epoch != epoch; });
+            }
+            waiters.count.fetch_sub(1);
+            if (done) {
+                return;
+            }
+        }
+    }
+
+    const size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+    alignas(64) std::atomic<size_t> enqueue_pos_;
+    alignas(64) std::atomic<size_t> dequeue_pos_;
+    alignas(64) std::atomic<bool> closed_;
+    std::mutex mutex_;
+    Waiters producers_;
+    Waiters consumers_;
+};
+
+} // namespace ai_debugger
+
+#endif // AI_DEBUGGER_BOUNDED_QUEUE_H
@@ -35,9 +35,14 @@ public:
     CallGraphAnalyzer();
     ~CallGraphAnalyzer();
 
+    // Each build replaces the previous graph. Node storage is kept between
+    // builds, so reusing one analyzer avoids reallocating it per trace.
     void buildFromStackTrace(const StackTrace& trace);
+    void buildFromStackTrace(const StackTraceView& trace);
     void buildFromSource(const std::string& source_path);
 
+    void reset();
+
     std::vector<CallGraphNode> getNodes() const;
     std::optional<CallGraphNode> getNode(const std::string& function) const;
 
@@ -54,6 +59,9 @@ private:
     struct Impl;
     std::unique_ptr<Impl> impl_;
 
+    template <typename Trace>
+    void buildFrom(const Trace& trace);
+
     void analyzeRecursion();
     void detectCommonPatterns();
     void classifyFunctions();
@@ -0,0 +1,72 @@
+#ifndef AI_DEBUGGER_CRASH_CLUSTERER_H
+#define AI_DEBUGGER_CRASH_CLUSTERER_H
+
+#include "StackTraceParser.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <optional>
+#include <cstdint>
+
+namespace ai_debugger {
+
+struct ClusterOptions {
+    size_t num_hashes;           // MinHash signature length
+    size_t bands;                // LSH bands; must divide num_hashes
+    size_t shingle_size;         // consecutive frames per shingle
+    size_t max_frames;           // user frames considered from the crash site
+    double similarity_threshold; // minimum estimated Jaccard to join a cluster
+
+    ClusterOptions()
+        : num_hashes(64)
+        , bands(32)
+        , shingle_size(2)
+        , max_frames(24)
+        , similarity_threshold(0.5) {}
+};
+
+struct ClusterAssignment {
+    uint32_t cluster_id;
+    double similarity;  // estimated Jaccard similarity to the cluster
+    bool created;       // true if the trace started a new cluster
+
+    ClusterAssignment() : cluster_id(0), similarity(0.0), created(false) {}
+};
+
+struct CrashCluster {
+    uint32_t id;
+    uint64_t size;
+    std::vector<std::string> frames;  // normalized frames of the first member
+
+    CrashCluster() : id(0), size(0) {}
+};
+
+// Groups near-duplicate crashes: traces whose normalized user frames differ
+// by an inlined frame or two land in the same cluster. Each cluster is
+// represented by the MinHash signature of its first trace, indexed in LSH
+// band buckets, so assigning a trace only compares it against the clusters
+// sharing a bucket rather than against every cluster.
+class CrashClusterer {
+public:
+    explicit CrashClusterer(const ClusterOptions& options = ClusterOptions());
+    ~CrashClusterer();
+
+    ClusterAssignment add(const StackTrace& trace);
+
+    // Closest existing cluster above the threshold, without adding the trace.
+    std::optional<ClusterAssignment> find(const StackTrace& trace) const;
+
+    size_t clusterCount() const;
+    std::optional<CrashCluster> getCluster(uint32_t id) const;
+    std::vector<CrashCluster> largestClusters(size_t k) const;
+
+    void clear();
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace ai_debugger
+
+#endif // AI_DEBUGGER_CRASH_CLUSTERER_H
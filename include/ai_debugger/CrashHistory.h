@@ -0,0 +1,63 @@
+#ifndef AI_DEBUGGER_CRASH_HISTORY_H
+#define AI_DEBUGGER_CRASH_HISTORY_H
+
+#include "RootCausePredictor.h"
+#include "SimilarityIndex.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+namespace ai_debugger {
+
+struct SimilarCrash {
+    std::string session_id;
+    double similarity;     // estimated cosine similarity of the traces' features
+    RootCause root_cause;  // confirmed cause, or the one predicted at the time
+    bool confirmed;
+
+    SimilarCrash() : similarity(0.0), confirmed(false) {}
+};
+
+// Past crashes and their root causes, searchable by trace similarity (see
+// SimilarityIndex). Entries recorded from analyses carry the predicted
+// cause; confirm() replaces it with the verified one. RootCausePredictor
+// only takes confirmed neighbors as evidence, so its own guesses are never
+// fed back to it; confirmed entries have an index of their own so predicted
+// ones cannot crowd them out. Past max_entries the oldest predicted entries
+// are dropped. Safe to use from any thread; queries run concurrently.
+class CrashHistory {
+public:
+    static constexpr size_t DEFAULT_MAX_ENTRIES = 100000;
+
+    explicit CrashHistory(const SimilarityOptions& options = SimilarityOptions(),
+                          size_t max_entries = DEFAULT_MAX_ENTRIES);
+    ~CrashHistory();
+
+    // `features` come from FeatureVectorizer with DEFAULT_DIMENSION.
+    void record(const SparseFeatures& features, const std::string& session_id,
+                const RootCause& cause, bool confirmed);
+    void record(const StackTrace& trace, const std::string& session_id,
+                const RootCause& cause, bool confirmed);
+
+    // Returns false if no entry was recorded under session_id.
+    bool confirm(const std::string& session_id, const RootCause& cause);
+
+    // At most k crashes at least min_similarity alike, most similar first.
+    std::vector<SimilarCrash> nearest(const SparseFeatures& features, size_t k,
+                                      double min_similarity = 0.0, bool confirmed_only = false) const;
+    std::vector<SimilarCrash> nearest(const StackTrace& trace, size_t k,
+                                      double min_similarity = 0.0, bool confirmed_only = false) const;
+
+    size_t size() const;
+    size_t confirmedCount() const;
+    void clear();
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace ai_debugger
+
+#endif // AI_DEBUGGER_CRASH_HISTORY_H
@@ -0,0 +1,38 @@
+#ifndef AI_DEBUGGER_CRASH_SIGNATURE_H
+#define AI_DEBUGGER_CRASH_SIGNATURE_H
+
+#include "StackTraceParser.h"
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+namespace ai_debugger {
+
+// Standard library, runtime and system frames; the rule CallGraphAnalyzer
+// uses for CallGraphNode::is_library_function.
+bool isLibraryFunction(std::string_view function, std::string_view file);
+
+// Writes `name` to `out` without addresses, "+ offset" suffixes and compiler
+// clone suffixes (.isra.0, .constprop.1, .part.2, .cold, ...), so the same
+// function matches across builds and load addresses.
+void normalizeFunctionName(std::string_view name, std::string& out);
+
+// Writes a lowercased `message` to `out` with every number (decimal, hex,
+// 0x-prefixed) replaced by '#' and whitespace collapsed, so messages that
+// differ only in addresses, PIDs or sizes normalize identically.
+void normalizeErrorMessage(std::string_view message, std::string& out);
+
+// 64-bit FNV-1a; stable across processes and platforms, unlike std::hash.
+uint64_t fnv1a(std::string_view data, uint64_t hash = 14695981039346656037ull);
+
+// Hash of the normalized names of the top `max_frames` user frames (all
+// frames if every frame is a library frame). Line numbers and addresses do
+// not contribute. Returns 0 for a trace without frames.
+uint64_t crashFingerprint(const StackTrace& trace, size_t max_frames = 5);
+
+// fnv1a() of the normalized error message; the knowledge base key.
+uint64_t errorMessageKey(std::string_view message);
+
+} // namespace ai_debugger
+
+#endif // AI_DEBUGGER_CRASH_SIGNATURE_H
@@ -0,0 +1,53 @@
+#ifndef AI_DEBUGGER_DEMANGLE_CACHE_H
+#define AI_DEBUGGER_DEMANGLE_CACHE_H
+
+#include <string>
+#include <string_view>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+namespace ai_debugger {
+
+struct DemangleCacheStats {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    size_t entries;
+    size_t bytes_reserved;
+
+    DemangleCacheStats() : hits(0), misses(0), evictions(0), entries(0), bytes_reserved(0) {}
+};
+
+// Thread-safe cache of __cxa_demangle results keyed on the mangled name.
+// Keys and results are stored in per-shard arenas. Each shard holds two
+// generations: when the current one fills up it becomes the previous one and
+// the old previous generation is dropped, so entries that are still being
+// looked up survive and memory stays bounded by `capacity`.
+class DemangleCache {
+public:
+    explicit DemangleCache(size_t capacity = 16384, size_t shard_count = 16);
+    ~DemangleCache();
+
+    DemangleCache(const DemangleCache&) = delete;
+    DemangleCache& operator=(const DemangleCache&) = delete;
+
+    // Writes the demangled form of `mangled` to `out` and returns true when it
+    // differs from the input; returns false (leaving `out` untouched) for
+    // names that are not mangled or fail to demangle.
+    bool demangle(std::string_view mangled, std::string& out);
+
+    DemangleCacheStats stats() const;
+    void clear();
+
+    // Process-wide instance used by StackTraceParser unless overridden.
+    static std::shared_ptr<DemangleCache> shared();
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace ai_debugger
+
+#endif // AI_DEBUGGER_DEMANGLE_CACHE_H
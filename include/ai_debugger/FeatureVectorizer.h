@@ -0,0 +1,66 @@
+#ifndef AI_DEBUGGER_FEATURE_VECTORIZER_H
+#define AI_DEBUGGER_FEATURE_VECTORIZER_H
+
+#include "StackTraceParser.h"
+#include <vector>
+#include <cstdint>
+
+namespace ai_debugger {
+
+// Hashed feature vector: parallel index/value arrays, indices below the
+// producer's dimension. Repeated indices add up.
+struct SparseFeatures {
+    std::vector<uint32_t> indices;
+    std::vector<float> values;
+
+    void clear() {
+        indices.clear();
+        values.clear();
+    }
+
+    void add(uint32_t index, float value) {
+        indices.push_back(index);
+        values.push_back(value);
+    }
+
+    size_t size() const { return indices.size(); }
+};
+
+// Turns a trace into a fixed-width SparseFeatures vector in one pass over
+// its frames, without allocating once `out` has grown to a typical size:
+//
+//   - function name tokens (lowercased identifier parts) and whole names,
+//     with numeric tokens such as addresses and clone numbers dropped
+//   - whole names of the top CRASH_SITE_FRAMES frames, as separate features
+//   - module and source file basenames
+//   - signal number, exception type and a log2 stack depth bucket
+//   - error message word unigrams, bigrams and trigrams, with numbers
+//     folded into a single token as in normalizeErrorMessage()
+class FeatureVectorizer {
+public:
+    static constexpr uint32_t DEFAULT_DIMENSION = 1u << 16;
+    static constexpr uint32_t MAX_DIMENSION = 1u << 31;
+    static constexpr size_t CRASH_SITE_FRAMES = 3;
+
+    // The power of two at or above `dimension`, at most MAX_DIMENSION.
+    static uint32_t roundDimension(uint32_t dimension);
+
+    // `dimension` is rounded up to a power of two, at most MAX_DIMENSION.
+    explicit FeatureVectorizer(uint32_t dimension = DEFAULT_DIMENSION, size_t max_frames = 64);
+
+    uint32_t dimension() const { return dimension_; }
+
+    void vectorize(const StackTrace& trace, SparseFeatures& out) const;
+    void vectorize(const StackTraceView& trace, SparseFeatures& out) const;
+
+private:
+    template <typename Trace>
+    void vectorizeTrace(const Trace& trace, SparseFeatures& out) const;
+
+    uint32_t dimension_;
+    size_t max_frames_;
+};
+
+} // namespace ai_debugger
+
+#endif // AI_DEBUGGER_FEATURE_VECTORIZER_H
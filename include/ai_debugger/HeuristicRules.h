@@ -0,0 +1,129 @@
+#ifndef AI_DEBUGGER_HEURISTIC_RULES_H
+#define AI_DEBUGGER_HEURISTIC_RULES_H
+
+#include "RootCausePredictor.h"
+#include "KeywordMatcher.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <istream>
+#include <cstdint>
+
+namespace ai_debugger {
+
+enum class RuleField {
+    ERROR_MESSAGE,
+    FUNCTION_NAME,
+    MODULE
+};
+
+// Alternative keywords looked up in one field. They match case-insensitively
+// anywhere in the text; FUNCTION_NAME and MODULE groups match if any frame
+// contains one of them.
+struct KeywordGroup {
+    RuleField field;
+    std::vector<std::string> keywords;
+
+    KeywordGroup() : field(RuleField::ERROR_MESSAGE) {}
+    KeywordGroup(RuleField f, std::vector<std::string> k)
+        : field(f), keywords(std::move(k)) {}
+};
+
+// Fires when every all_of group matches, no none_of group matches and, if
+// signals is non-empty, the trace's signal is one of them. A rule needs at
+// least one all_of group or signal to fire; at most 32 groups are considered.
+struct KeywordRule {
+    std::vector<KeywordGroup> all_of;
+    std::vector<KeywordGroup> none_of;
+    std::vector<int> signals;
+    BugCategory category;
+    double score;
+    std::string description;
+
+    KeywordRule() : category(BugCategory::UNKNOWN), score(0.0) {}
+};
+
+// Rules compiled into one KeywordMatcher per field, so evaluating a trace
+// scans the message, each function name and each module once regardless of
+// rule count. Immutable once built.
+class RuleSet {
+public:
+    explicit RuleSet(std::vector<KeywordRule> rules);
+
+    const std::vector<KeywordRule>& rules() const { return rules_; }
+
+    // Appends the indices of firing rules to `fired`, in rule order.
+    void match(const PredictionFeatures& features, std::vector<uint32_t>& fired) const;
+    void match(const PredictionFeaturesView& features, std::vector<uint32_t>& fired) const;
+
+private:
+    static constexpr uint32_t EXCLUDE = 32;
+    static constexpr size_t FIELDS = 3;
+
+    struct Slot {
+        uint32_t rule;
+        uint32_t group;  // all_of group index, or EXCLUDE for none_of
+    };
+
+    std::vector<KeywordRule> rules_;
+    std::vector<uint32_t> required_;  // bitmask of all_of groups per rule
+
+    // Per field: keyword id -> slots[offsets[id], offsets[id + 1]).
+    KeywordMatcher matchers_[FIELDS];
+    std::vector<uint32_t> slot_offsets_[FIELDS];
+    std::vector<Slot> slots_[FIELDS];
+};
+
+// The built-in heuristics for segfaults, double frees, heap corruption,
+// threading and assertions.
+std::vector<KeywordRule> defaultHeuristicRules();
+std::shared_ptr<const RuleSet> defaultRuleSet();
+
+// Rule files are line based; '#' starts a comment line:
+//
+//   [rule]
+//   category = Null Pointer Dereference
+//   score = 0.85
+//   description = Null pointer dereference detected from segmentation fault
+//   message = segmentation fault | sigsegv
+//   message = null | 0x0
+//
+// Each message, function or module line is an all_of group of '|'-separated
+// alternatives; not_message, not_function and not_module lines veto the
+// rule. signal lists signal numbers or names (SIGSEGV | SIGBUS). category is
+// a bugCategoryToString() name; score defaults to 0.5. On failure `error`
+// gets the offending line and nothing is appended to `rules`.
+bool parseRules(std::istream& input, std::vector<KeywordRule>& rules, std::string* error = nullptr);
+bool loadRuleFile(const std::string& path, std::vector<KeywordRule>& rules, std::string* error = nullptr);
+
+// Holds the active RuleSet and swaps it atomically on reload. Analyses take
+// a snapshot with current() and keep it for their duration, so a reload never
+// waits for them and they never see a half-loaded rule set. A failed load
+// keeps the previous rules. Safe to use from any thread.
+class RuleEngine {
+public:
+    // Starts with defaultRuleSet().
+    RuleEngine();
+    ~RuleEngine();
+
+    std::shared_ptr<const RuleSet> current() const;
+    void set(std::shared_ptr<const RuleSet> rules);
+
+    bool load(const std::string& path, std::string* error = nullptr);
+    // Loads the last loaded path again; reloadIfChanged() only when the file's
+    // modification time or size changed since, returning whether it swapped.
+    bool reload(std::string* error = nullptr);
+    bool reloadIfChanged(std::string* error = nullptr);
+
+    std::string path() const;
+    // Incremented by every successful set() or load().
+    uint64_t generation() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace ai_debugger
+
+#endif // AI_DEBUGGER_HEURISTIC_RULES_H
@@ -0,0 +1,53 @@
+#ifndef AI_DEBUGGER_HISTOGRAM_H
+#define AI_DEBUGGER_HISTOGRAM_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace ai_debugger {
+
+// Log-linear histogram of non-negative integers (latencies in nanoseconds,
+// queue depths). Values below 16 are counted exactly; above that every power
+// of two is split into 16 buckets, so percentiles are within about 6% of the
+// true value. record() is wait-free and may run on any number of threads.
+class Histogram {
+public:
+    static constexpr size_t SUB_BUCKET_BITS = 4;
+    static constexpr size_t SUB_BUCKETS = size_t(1) << SUB_BUCKET_BITS;
+    static constexpr size_t BUCKET_COUNT = SUB_BUCKETS * (64 - SUB_BUCKET_BITS + 1);
+
+    Histogram();
+
+    Histogram(const Histogram&) = delete;
+    Histogram& operator=(const Histogram&) = delete;
+
+    void record(uint64_t value);
+    // Adds the values recorded in `other`.
+    void merge(const Histogram& other);
+    void reset();
+
+    uint64_t count() const;
+    uint64_t sum() const;
+    uint64_t max() const;
+    double mean() const;
+    // Upper bound of the bucket holding the p-th percentile (0 <= p <= 100);
+    // 0 when empty.
+    uint64_t percentile(double p) const;
+
+    static size_t bucketIndex(uint64_t value);
+    static uint64_t bucketUpperBound(size_t index);
+
+private:
+    void raiseMax(uint64_t value);
+
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets_;
+    std::atomic<uint64_t> count_;
+    std::atomic<uint64_t> sum_;
+    std::atomic<uint64_t> max_;
+};
+
+} // namespace ai_debugger
+
+#endif // AI_DEBUGGER_HISTOGRAM_H
@@ -0,0 +1,143 @@
+#ifndef AI_DEBUGGER_INSTRUMENTATION_H
+#define AI_DEBUGGER_INSTRUMENTATION_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+namespace ai_debugger {
+
+// Timed steps of an analysis. The first six match PipelineStage.
+enum class TimedStage {
+    PARSE,       // StackTraceParser
+    CALL_GRAPH,  // CallGraphAnalyzer
+    PREDICT,     // RootCausePredictor and the crash history
+    EXPLAIN,     // ExplanationGenerator, also when computed on demand
+    FIX,         // FixSuggester, also when computed on demand
+    TEST,        // TestGenerator, also when computed on demand
+    PERSIST      // handing the session to the SessionWriter
+};
+
+constexpr size_t TIMED_STAGE_COUNT = static_cast<size_t>(TimedStage::PERSIST) + 1;
+
+enum class Counter {
+    TRACES_ANALYZED,
+    FRAMES_PARSED,
+    BYTES_CONSUMED,  // trace text given to the parser; not counted for streams
+    CACHE_HITS,      // repeated crashes served from the deduplication cache
+    CACHE_MISSES
+};
+
+constexpr size_t COUNTER_COUNT = static_cast<size_t>(Counter::CACHE_MISSES) + 1;
+
+const char* timedStageToString(TimedStage stage);
+const char* counterToString(Counter counter);
+
+struct TimerStats {
+    uint64_t count;
+    uint64_t total_ns;
+    uint64_t p50_ns;
+    uint64_t p90_ns;
+    uint64_t p99_ns;
+    uint64_t max_ns;
+
+    TimerStats() : count(0), total_ns(0), p50_ns(0), p90_ns(0), p99_ns(0), max_ns(0) {}
+};
+
+struct InstrumentationSnapshot {
+    std::array<TimerStats, TIMED_STAGE_COUNT> timers;
+    std::array<uint64_t, COUNTER_COUNT> counters;
+
+    InstrumentationSnapshot() {
+        counters.fill(0);
+    }
+
+    const TimerStats& timer(TimedStage stage) const {
+        return timers[static_cast<size_t>(stage)];
+    }
+    uint64_t counter(Counter counter) const {
+        return counters[static_cast<size_t>(counter)];
+    }
+
+    std::string toJSON() const;
+};
+
+// Stage timings and counters of the analyses that share it. Every recording
+// thread gets its own histograms and counters, so recording never contends;
+// snapshot() merges them. Off by default: a disabled timer or counter costs
+// one relaxed load and a branch, and no clock is read.
+class Instrumentation {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    Instrumentation();
+    ~Instrumentation();
+
+    Instrumentation(const Instrumentation&) = delete;
+    Instrumentation& operator=(const Instrumentation&) = delete;
+
+    void setEnabled(bool enabled) {
+        enabled_.store(enabled, std::memory_order_relaxed);
+    }
+    bool isEnabled() const {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    void add(Counter counter, uint64_t n = 1) {
+        if (isEnabled()) {
+            addCounter(counter, n);
+        }
+    }
+    // Records unconditionally; callers check isEnabled() before timing.
+    void recordTime(TimedStage stage, uint64_t nanoseconds);
+
+    // Approximate while other threads record.
+    InstrumentationSnapshot snapshot() const;
+    void reset();
+
+    // Times its scope into `stage` if instrumentation was enabled when it
+    // started.
+    class ScopedTimer {
+    public:
+        ScopedTimer(Instrumentation& instrumentation, TimedStage stage)
+            : instrumentation_(instrumentation.isEnabled() ? &instrumentation : nullptr)
+            , stage_(stage) {
+            if (instrumentation_) {
+                start_ = Clock::now();
+            }
+        }
+
+        ~ScopedTimer() {
+            if (instrumentation_) {
+                instrumentation_->recordTime(stage_, static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start_).count()));
+            }
+        }
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    private:
+        Instrumentation* instrumentation_;
+        TimedStage stage_;
+        Clock::time_point start_;
+    };
+
+private:
+    struct Shard;
+    struct Impl;
+
+    void addCounter(Counter counter, uint64_t n);
+    Shard& localShard();
+
+    std::atomic<bool> enabled_;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace ai_debugger
+
+#endif // AI_DEBUGGER_INSTRUMENTATION_H
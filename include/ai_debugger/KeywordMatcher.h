@@ -0,0 +1,76 @@
+#ifndef AI_DEBUGGER_KEYWORD_MATCHER_H
+#define AI_DEBUGGER_KEYWORD_MATCHER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace ai_debugger {
+
+// ASCII case-insensitive Aho-Corasick automaton. Keywords are added, then
+// compile() builds a dense transition table over the byte classes that occur
+// in keywords, so scanning costs one table lookup per input byte no matter
+// how many keywords there are.
+class KeywordMatcher {
+public:
+    KeywordMatcher();
+
+    // Returns the keyword's id: ids are dense and assigned in insertion order,
+    // and adding a keyword twice returns the first id. Invalidates compile().
+    uint32_t add(std::string_view keyword);
+    void compile();
+
+    bool compiled() const { return compiled_; }
+    size_t size() const { return keywords_.size(); }
+    const std::string& keyword(uint32_t id) const { return keywords_[id]; }
+
+    // Calls visit(id, begin, end) for every occurrence of every keyword,
+    // ordered by end offset. Requires compile().
+    template <typename Visit>
+    void scan(std::string_view text, Visit visit) const {
+        uint32_t state = 0;
+        for (size_t i = 0; i < text.size(); ++i) {
+            state = next_[state * classes_ + byte_class_[static_cast<unsigned char>(text[i])]];
+            for (uint32_t o = output_offsets_[state]; o < output_offsets_[state + 1]; ++o) {
+                uint32_t id = outputs_[o];
+                visit(id, i + 1 - keywords_[id].size(), i + 1);
+            }
+        }
+    }
+
+    // True if any keyword occurs in `text`.
+    bool contains(std::string_view text) const;
+
+private:
+    std::vector<std::string> keywords_;  // lowercased
+
+    // Trie built by add(): children as (lowercased byte, child) pairs, and
+    // the ids of keywords ending at each node.
+    std::vector<std::vector<std::pair<uint8_t, uint32_t>>> trie_;
+    std::vector<std::vector<uint32_t>> terminal_;
+
+    bool compiled_;
+    uint8_t byte_class_[256];
+    uint32_t classes_;
+    std::vector<uint32_t> next_;            // state * classes_ + class -> state
+    std::vector<uint32_t> output_offsets_;  // state s outputs: outputs_[offsets[s], offsets[s + 1])
+    std::vector<uint32_t> outputs_;
+};
+
+// Keyword classes of a function name, from a single automaton scan.
+enum FunctionKeyword : uint32_t {
+    ALLOCATES = 1u << 0,    // contains malloc, new or alloc
+    DEALLOCATES = 1u << 1,  // contains free or delete
+    THREADING = 1u << 2,    // contains thread, mutex or lock
+    LOCKING = 1u << 3,      // contains lock or mutex
+    ALLOCATOR = 1u << 4,    // is malloc, calloc, new or new[]
+    DEALLOCATOR = 1u << 5   // is free, delete or delete[]
+};
+
+uint32_t functionKeywords(std::string_view function_name);
+
+} // namespace ai_debugger
+
+#endif // AI_DEBUGGER_KEYWORD_MATCHER_H
@@ -0,0 +1,80 @@
+#ifndef AI_DEBUGGER_KNOWLEDGE_BASE_H
+#define AI_DEBUGGER_KNOWLEDGE_BASE_H
+
+#include "RootCausePredictor.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <cstdint>
+
+namespace ai_debugger {
+
+// Known root causes keyed by errorMessageKey(), read from a compact binary
+// file. The file is memory-mapped and queried in place: opening validates
+// the header and record table in one pass and allocates nothing per entry.
+//
+// Layout (version 1, native byte order):
+//   header   magic "AIKB", version, byte-order mark, record size,
+//            record count, string table size
+//   records  fixed-size, sorted by key: key, description and file as
+//            (offset, size) into the string table, line, category, confidence
+//   strings  deduplicated, unterminated
+class KnowledgeBase {
+public:
+    static constexpr uint32_t VERSION = 1;
+
+    KnowledgeBase();
+    ~KnowledgeBase();
+
+    KnowledgeBase(const KnowledgeBase&) = delete;
+    KnowledgeBase& operator=(const KnowledgeBase&) = delete;
+
+    // False if the file is missing, truncated, from another version or byte
+    // order, or has out-of-range records.
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const;
+    size_t size() const;
+
+    // Appends the causes stored under `key` to `out`; returns how many.
+    size_t lookup(uint64_t key, std::vector<RootCause>& out) const;
+    std::vector<RootCause> lookup(std::string_view error_message) const;
+
+    void forEach(const std::function<void(uint64_t key, const RootCause& cause)>& visit) const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+// Collects entries and writes them in KnowledgeBase format. Only category,
+// description, location file/line and confidence are stored.
+class KnowledgeBaseBuilder {
+public:
+    KnowledgeBaseBuilder();
+    ~KnowledgeBaseBuilder();
+
+    // False, adding nothing, once the string table would pass the 4 GiB the
+    // format's 32-bit offsets address.
+    bool add(uint64_t key, const RootCause& cause);
+    bool add(std::string_view error_message, const RootCause& cause);
+    bool add(const KnowledgeBase& knowledge_base);
+
+    size_t size() const;
+    void clear();
+
+    // Writes to a temporary file next to `path` and renames it into place.
+    // Fails if an add() was refused since the last clear().
+    bool save(const std::string& path) const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace ai_debugger
+
+#endif // AI_DEBUGGER_KNOWLEDGE_BASE_H
@@ -0,0 +1,74 @@
+#ifndef AI_DEBUGGER_LINEAR_CLASSIFIER_H
+#define AI_DEBUGGER_LINEAR_CLASSIFIER_H
+
+#include "RootCausePredictor.h"
+#include "FeatureVectorizer.h"
+#include <string>
+#include <vector>
+#include <array>
+#include <memory>
+#include <utility>
+#include <cstdint>
+
+namespace ai_debugger {
+
+constexpr size_t BUG_CATEGORY_COUNT = static_cast<size_t>(BugCategory::UNKNOWN) + 1;
+
+struct TrainingOptions {
+    int epochs;
+    double learning_rate;
+    double l2;
+    uint32_t seed;
+
+    TrainingOptions()
+        : epochs(20)
+        , learning_rate(0.5)
+        , l2(1e-6)
+        , seed(1) {}
+};
+
+using CategoryProbabilities = std::array<double, BUG_CATEGORY_COUNT>;
+
+// Multinomial logistic regression over hashed features, one output per
+// BugCategory. Weights are stored feature-major so a sparse feature touches
+// one contiguous row; inference is a few hundred multiply-adds per trace.
+//
+// Model file (native byte order): magic "AILC", version, byte-order mark,
+// dimension, class count, then float biases and weights. Version 2 models
+// expect FeatureVectorizer features.
+class LinearClassifier {
+public:
+    static constexpr uint32_t VERSION = 2;
+    static constexpr uint32_t DEFAULT_DIMENSION = FeatureVectorizer::DEFAULT_DIMENSION;
+
+    // `dimension` is rounded up to a power of two, at most
+    // FeatureVectorizer::MAX_DIMENSION.
+    explicit LinearClassifier(uint32_t dimension = DEFAULT_DIMENSION);
+    ~LinearClassifier();
+
+    LinearClassifier(const LinearClassifier&) = delete;
+    LinearClassifier& operator=(const LinearClassifier&) = delete;
+
+    uint32_t dimension() const;
+    bool isTrained() const;
+
+    // Fits from scratch with shuffled SGD; replaces any previous weights.
+    void train(const std::vector<std::pair<SparseFeatures, BugCategory>>& examples,
+               const TrainingOptions& options = TrainingOptions());
+
+    void predict(const SparseFeatures& features, CategoryProbabilities& probabilities) const;
+    BugCategory classify(const SparseFeatures& features, double* probability = nullptr) const;
+
+    // False if the file is missing, truncated, or from another version or
+    // byte order; the current model is kept in that case.
+    bool load(const std::string& path);
+    bool save(const std::string& path) const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace ai_debugger
+
+#endif // AI_DEBUGGER_LINEAR_CLASSIFIER_H
@@ -0,0 +1,39 @@
+#ifndef AI_DEBUGGER_MAPPED_FILE_H
+#define AI_DEBUGGER_MAPPED_FILE_H
+
+#include <string>
+#include <string_view>
+#include <memory>
+
+namespace ai_debugger {
+
+// Read-only view of a file's contents. Regular files are memory-mapped with a
+// sequential access hint; pipes, character devices and other non-seekable
+// inputs fall back to a single buffered read.
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(MappedFile&&) noexcept;
+    MappedFile& operator=(MappedFile&&) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const;
+    bool isMapped() const;
+
+    std::string_view data() const;
+    size_t size() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace ai_debugger
+
+#endif // AI_DEBUGGER_MAPPED_FILE_H
@@ -4,12 +4,19 @@
 #include "StackTraceParser.h"
 #include "CallGraphAnalyzer.h"
 #include <string>
+#include <string_view>
 #include <vector>
 #include <map>
 #include <memory>
 
 namespace ai_debugger {
 
+class KnowledgeBase;
+class LinearClassifier;
+class RuleEngine;
+class CrashHistory;
+struct SparseFeatures;
+
 enum class BugCategory {
     MEMORY_ERROR,
     NULL_POINTER,
@@ -41,19 +48,47 @@ struct RootCause {
 struct PredictionFeatures {
     std::string error_message;
     std::vector<std::string> function_names;
+    std::vector<std::string> modules;  // per frame, adjacent repeats dropped
     std::vector<std::string> variable_patterns;
     bool has_allocation;
     bool has_deallocation;
     bool has_pointer_arithmetic;
     bool has_threading;
     int stack_depth;
+    int signal_number;
 
     PredictionFeatures()
         : has_allocation(false)
         , has_deallocation(false)
         , has_pointer_arithmetic(false)
         , has_threading(false)
-        , stack_depth(0) {}
+        , stack_depth(0)
+        , signal_number(0) {}
+};
+
+// Non-owning counterpart of PredictionFeatures, which the predictor extracts
+// without copying the trace's strings. Only valid while the trace or
+// PredictionFeatures it views is alive.
+struct PredictionFeaturesView {
+    std::string_view error_message;
+    std::vector<std::string_view> function_names;
+    std::vector<std::string_view> modules;
+    bool has_allocation;
+    bool has_deallocation;
+    bool has_pointer_arithmetic;
+    bool has_threading;
+    int stack_depth;
+    int signal_number;
+
+    PredictionFeaturesView()
+        : has_allocation(false)
+        , has_deallocation(false)
+        , has_pointer_arithmetic(false)
+        , has_threading(false)
+        , stack_depth(0)
+        , signal_number(0) {}
+
+    explicit PredictionFeaturesView(const PredictionFeatures& features);
 };
 
 class RootCausePredictor {
@@ -66,25 +101,70 @@ public:
         const CallGraphAnalyzer& graph_analyzer
     );
 
+    std::vector<RootCause> predict(
+        const StackTraceView& trace,
+        const CallGraphAnalyzer& graph_analyzer
+    );
+
     RootCause getMostLikelyCause(
         const StackTrace& trace,
         const CallGraphAnalyzer& graph_analyzer
     );
 
-    void loadKnowledgeBase(const std::string& kb_path);
+    // Maps a KnowledgeBase file; predict() then adds the causes recorded for
+    // the trace's normalized error message.
+    bool loadKnowledgeBase(const std::string& kb_path);
+    void setKnowledgeBase(std::shared_ptr<const KnowledgeBase> knowledge_base);
+    std::shared_ptr<const KnowledgeBase> getKnowledgeBase() const;
+
+    // Category classifier consulted by predict() (see LinearClassifier).
+    bool loadModel(const std::string& model_path);
+    bool saveModel(const std::string& model_path) const;
+    void setModel(std::shared_ptr<const LinearClassifier> model);
+    std::shared_ptr<const LinearClassifier> getModel() const;
+
+    // Heuristic rules (see RuleEngine), built-in ones until a rule file is
+    // loaded. Predictors sharing an engine all see its reloads.
+    bool loadRules(const std::string& rules_path, std::string* error = nullptr);
+    void setRuleEngine(std::shared_ptr<RuleEngine> engine);
+    std::shared_ptr<RuleEngine> getRuleEngine() const;
+
+    // Confirmed root causes of the most similar past crashes (see
+    // CrashHistory) are added by predict(), weighted by similarity. Training
+    // examples are recorded in the history as confirmed.
+    void setCrashHistory(std::shared_ptr<CrashHistory> history);
+    std::shared_ptr<CrashHistory> getCrashHistory() const;
+
+    // Examples are keyed by errorMessageKey() and consulted alongside the
+    // loaded knowledge base; saveKnowledgeBase() writes both. They are also
+    // kept for trainModel(); the current model is left alone.
     void trainFromExamples(const std::vector<std::pair<StackTrace, RootCause>>& examples);
+    bool saveKnowledgeBase(const std::string& kb_path) const;
+    // Fits a new classifier on every example seen so far and makes it the
+    // model. Fails, keeping the current model, with fewer than
+    // MIN_TRAINING_EXAMPLES examples or only one category among them.
+    bool trainModel(std::string* error = nullptr);
+
+    static constexpr size_t MIN_TRAINING_EXAMPLES = 8;
 
 private:
     struct Impl;
     std::unique_ptr<Impl> impl_;
 
-    PredictionFeatures extractFeatures(const StackTrace& trace, const CallGraphAnalyzer& graph);
+    template <typename Trace>
+    std::vector<RootCause> predictFrom(const Trace& trace, const CallGraphAnalyzer& graph_analyzer);
+
+    PredictionFeaturesView extractFeatures(const StackTrace& trace, const CallGraphAnalyzer& graph);
+    PredictionFeaturesView extractFeatures(const StackTraceView& trace, const CallGraphAnalyzer& graph);
 
-    std::vector<RootCause> applyHeuristics(const PredictionFeatures& features);
+    std::vector<RootCause> applyHeuristics(const PredictionFeaturesView& features);
     std::vector<RootCause> applyPatternMatching(const StackTrace& trace);
-    std::vector<RootCause> applyMLModel(const PredictionFeatures& features);
+    std::vector<RootCause> applyPatternMatching(const StackTraceView& trace);
+    std::vector<RootCause> applyKnowledgeBase(const PredictionFeaturesView& features);
+    std::vector<RootCause> applyMLModel(const SparseFeatures& features);
+    std::vector<RootCause> applyCrashHistory(const SparseFeatures& features);
 
-    double calculateConfidence(const RootCause& cause, const PredictionFeatures& features);
+    double calculateConfidence(const RootCause& cause, const PredictionFeaturesView& features);
     void rankCauses(std::vector<RootCause>& causes);
 };
 
@@ -0,0 +1,99 @@
+#ifndef AI_DEBUGGER_SESSION_STORE_H
+#define AI_DEBUGGER_SESSION_STORE_H
+
+#include "AIDebugger.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <cstdint>
+#include <ctime>
+
+namespace ai_debugger {
+
+struct SessionStoreOptions {
+    uint64_t segment_size;  // bytes written before rolling to a new segment
+    bool sync_writes;       // fsync after every put/erase, not just on sync()
+    double compact_ratio;   // compact() rewrites segments with less live data than this
+
+    SessionStoreOptions()
+        : segment_size(64ull << 20)
+        , sync_writes(false)
+        , compact_ratio(0.5) {}
+};
+
+// Append-only store of DebugSessions in a directory of log segments.
+//
+// Every put() or erase() appends one record to the newest segment:
+//   header  CRC-32 of the rest of the record, type, timestamp (seconds),
+//           id size, body size
+//   body    session id, then serializeSession() bytes (none for erasures)
+// Segments start with magic "AISS", version and a byte-order mark, and are
+// named by a sequence number. Opening replays them oldest first; a torn or
+// corrupt tail left by a crash is truncated away.
+//
+// Only an index entry (id hash to segment and offset) is kept in memory per
+// live session; sessions are read back from disk by get() and scan(). Older
+// versions of rewritten or erased sessions stay on disk until compact()
+// copies the live records out of mostly dead segments. One process at a
+// time may open a directory. Safe to use from any thread.
+class SessionStore {
+public:
+    static constexpr uint32_t VERSION = 1;
+
+    explicit SessionStore(const SessionStoreOptions& options = SessionStoreOptions());
+    ~SessionStore();
+
+    SessionStore(const SessionStore&) = delete;
+    SessionStore& operator=(const SessionStore&) = delete;
+
+    // Creates the directory if needed. False if it is locked by another
+    // process or a segment cannot be read.
+    bool open(const std::string& directory, std::string* error = nullptr);
+    void close();
+    bool isOpen() const;
+    std::string directory() const;
+
+    // A session with an existing id replaces it. Sessions are indexed by a
+    // 64-bit hash of their id; put() fails rather than replace a session
+    // whose different id has the same hash.
+    bool put(const DebugSession& session);
+    bool get(const std::string& session_id, DebugSession& out) const;
+    bool contains(const std::string& session_id) const;
+    bool erase(const std::string& session_id);
+
+    size_t size() const;
+    std::vector<std::string> sessionIds() const;
+
+    // Visits sessions with timestamps in [from, to), in write order, and
+    // returns how many were visited.
+    size_t scan(std::time_t from, std::time_t to, const std::function<void(DebugSession&&)>& visit) const;
+    // Like scan(), with sessions decoded by deserializeSessionSummary().
+    size_t scanSummaries(std::time_t from, std::time_t to,
+                         const std::function<void(DebugSession&&)>& visit) const;
+
+    // Flushes and fsyncs the active segment.
+    bool sync();
+    bool compact();
+    uint64_t diskSize() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+// Self-contained binary encoding of a whole session, in native byte order.
+void serializeSession(const DebugSession& session, std::string& out);
+bool deserializeSession(std::string_view data, DebugSession& out);
+// Only the id, timestamp, fingerprint, trace, root causes and confirmation;
+// the rest of the record is skipped, not decoded.
+bool deserializeSessionSummary(std::string_view data, DebugSession& out);
+
+// Seconds since the epoch of a DebugSession::timestamp ("%Y-%m-%d %H:%M:%S",
+// local time), or -1 if it does not parse.
+std::time_t parseSessionTimestamp(const std::string& timestamp);
+
+} // namespace ai_debugger
+
+#endif // AI_DEBUGGER_SESSION_STORE_H
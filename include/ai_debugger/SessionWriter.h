@@ -0,0 +1,65 @@
+#ifndef AI_DEBUGGER_SESSION_WRITER_H
+#define AI_DEBUGGER_SESSION_WRITER_H
+
+#include "SessionStore.h"
+#include <memory>
+#include <functional>
+#include <cstdint>
+
+namespace ai_debugger {
+
+struct SessionWriterOptions {
+    size_t queue_capacity;  // sessions queued before write() blocks
+    size_t max_batch;       // sessions written per store sync
+    bool sync;              // fsync the store after every batch
+
+    SessionWriterOptions()
+        : queue_capacity(1024)
+        , max_batch(256)
+        , sync(true) {}
+};
+
+// Writes sessions to a SessionStore on a background thread. write() only
+// queues the session; the writer takes everything queued at once, puts it
+// and syncs the store once per batch, so under load many sessions share one
+// fsync. When the queue is full write() blocks until the writer catches up.
+//
+// The store is obtained from `store` on the writer thread before every
+// batch, so opening it is off the callers' threads too; sessions are
+// dropped (and counted as failed) while it returns null.
+class SessionWriter {
+public:
+    explicit SessionWriter(std::function<std::shared_ptr<SessionStore>()> store,
+                           const SessionWriterOptions& options = SessionWriterOptions());
+    explicit SessionWriter(std::shared_ptr<SessionStore> store,
+                           const SessionWriterOptions& options = SessionWriterOptions());
+    // Writes what is queued, then stops.
+    ~SessionWriter();
+
+    SessionWriter(const SessionWriter&) = delete;
+    SessionWriter& operator=(const SessionWriter&) = delete;
+
+    // False once the writer is closed.
+    bool write(DebugSession session);
+
+    // Has the writer thread obtain the store now rather than before its
+    // next batch, without waiting; flush() waits for it like for a write.
+    void open();
+
+    // Returns once every session queued before the call is written and
+    // synced; false if any write since the last flush failed.
+    bool flush();
+    void close();
+
+    size_t pending() const;
+    uint64_t written() const;
+    uint64_t failed() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace ai_debugger
+
+#endif // AI_DEBUGGER_SESSION_WRITER_H
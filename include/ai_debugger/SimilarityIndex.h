@@ -0,0 +1,76 @@
+#ifndef AI_DEBUGGER_SIMILARITY_INDEX_H
+#define AI_DEBUGGER_SIMILARITY_INDEX_H
+
+#include "FeatureVectorizer.h"
+#include <array>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+namespace ai_debugger {
+
+struct SimilarityOptions {
+    size_t bands;            // LSH bands; bands * band_bits <= SIGNATURE_BITS
+    size_t band_bits;        // signature bits per band
+    size_t max_bucket_size;  // newest ids kept per bucket
+    size_t max_candidates;   // candidates ranked per query
+
+    SimilarityOptions()
+        : bands(21)
+        , band_bits(12)
+        , max_bucket_size(256)
+        , max_candidates(4096) {}
+};
+
+struct Neighbor {
+    uint32_t id;
+    double similarity;  // estimated cosine similarity
+
+    Neighbor() : id(0), similarity(0.0) {}
+    Neighbor(uint32_t i, double s) : id(i), similarity(s) {}
+};
+
+// Approximate k-nearest-neighbor index over SparseFeatures by cosine
+// similarity. Each vector is reduced to a 256-bit SimHash signature (signs of
+// random hyperplane projections, generated by hashing, so nothing is stored
+// per dimension); similarity is estimated from the Hamming distance between
+// signatures. Signatures are bucketed by LSH bands, so a query only ranks
+// the items sharing a band rather than the whole index. Vectors are not
+// kept, only 32 bytes of signature and the bucket entries per item.
+//
+// Buckets keep their newest max_bucket_size ids, which bounds query time
+// when many near-identical crashes pile into one bucket. Not thread-safe.
+class SimilarityIndex {
+public:
+    static constexpr size_t SIGNATURE_BITS = 256;
+    using Signature = std::array<uint64_t, SIGNATURE_BITS / 64>;
+
+    explicit SimilarityIndex(const SimilarityOptions& options = SimilarityOptions());
+    ~SimilarityIndex();
+
+    static Signature signature(const SparseFeatures& features);
+    static double similarity(const Signature& a, const Signature& b);
+
+    // Ids are dense, assigned in insertion order.
+    uint32_t add(const SparseFeatures& features);
+    uint32_t add(const Signature& signature);
+
+    // Up to k items by decreasing similarity, at least min_similarity, and
+    // for which accept(id) holds when given.
+    std::vector<Neighbor> query(const SparseFeatures& features, size_t k, double min_similarity = 0.0,
+                                const std::function<bool(uint32_t)>& accept = nullptr) const;
+    std::vector<Neighbor> query(const Signature& signature, size_t k, double min_similarity = 0.0,
+                                const std::function<bool(uint32_t)>& accept = nullptr) const;
+
+    size_t size() const;
+    void clear();
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace ai_debugger
+
+#endif // AI_DEBUGGER_SIMILARITY_INDEX_H
@@ -2,10 +2,15 @@
 #define AI_DEBUGGER_STACK_TRACE_PARSER_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
 #include <optional>
-#include <regex>
+#include <functional>
+#include <istream>
+#include <cstdint>
+#include "StringArena.h"
+#include "DemangleCache.h"
 
 namespace ai_debugger {
 
@@ -39,6 +44,67 @@ struct StackTrace {
     StackTrace() : signal_number(0) {}
 };
 
+struct SourceLocationView {
+    std::string_view file;
+    int line;
+    int column;
+
+    SourceLocationView() : line(0), column(0) {}
+
+    SourceLocation materialize() const;
+};
+
+struct StackFrameView {
+    std::string_view function_name;
+    std::string_view mangled_name;
+    SourceLocationView location;
+    std::string_view module;
+    uintptr_t address;
+    std::string_view parameter_list;
+
+    StackFrameView() : address(0) {}
+
+    StackFrame materialize() const;
+};
+
+// Non-owning counterpart of StackTrace: every field points into the parsed
+// text, except demangled names that differ from the input, which live in the
+// view's own arena. The text is kept alive by `owner` (or by the caller when
+// no owner is given). Move-only, since frames point into the arena.
+class StackTraceView {
+public:
+    StackTraceView();
+    explicit StackTraceView(std::string text);
+    StackTraceView(std::string_view text, std::shared_ptr<const void> owner);
+
+    StackTraceView(StackTraceView&&) noexcept = default;
+    StackTraceView& operator=(StackTraceView&&) noexcept = default;
+    StackTraceView(const StackTraceView&) = delete;
+    StackTraceView& operator=(const StackTraceView&) = delete;
+
+    std::string_view text() const { return text_; }
+    std::string_view intern(std::string_view value) { return arena_.store(value); }
+
+    StackTrace materialize() const;
+
+    std::vector<StackFrameView> frames;
+    std::string_view error_message;
+    std::string_view exception_type;
+    int signal_number;
+
+private:
+    std::shared_ptr<const void> owner_;
+    std::string_view text_;
+    StringArena arena_;
+};
+
+// SCANNER is the default hand-written single-pass frame scanner; REGEX keeps
+// the original std::regex patterns around as a reference implementation.
+enum class ParseEngine {
+    SCANNER,
+    REGEX
+};
+
 class StackTraceParser {
 public:
     StackTraceParser();
@@ -51,15 +117,39 @@ public:
     std::optional<StackTrace> parseBacktrace(const std::string& bt_output);
     std::optional<StackTrace> parseMSVC(const std::string& msvc_output);
 
+    std::optional<StackTraceView> parseView(std::string trace_text);
+    std::optional<StackTraceView> parseView(std::string_view trace_text, std::shared_ptr<const void> owner);
+
+    // Splits a log holding many traces at blank lines, signal banners,
+    // thread headers and frame numbering restarting at #0, calling on_trace
+    // as soon as each trace is complete. Once gdb or lldb frames appear only
+    // their numbering splits traces, so a banner and stop line stay with the
+    // frames below them. Only the current trace is buffered: frames past
+    // setMaxTraceBytes() are dropped, as is the tail of any longer line.
+    // Returns the number of traces emitted.
+    size_t parseStream(std::istream& input, const std::function<void(StackTrace&&)>& on_trace);
+
     void setVerbose(bool verbose);
+    void setParseEngine(ParseEngine engine);
+    ParseEngine getParseEngine() const;
+    void setMaxTraceBytes(size_t max_bytes);
+
+    // Defaults to DemangleCache::shared(); nullptr demangles every frame.
+    void setDemangleCache(std::shared_ptr<DemangleCache> cache);
+    std::shared_ptr<DemangleCache> getDemangleCache() const;
 
 private:
     struct Impl;
     std::unique_ptr<Impl> impl_;
 
-    bool parseGDBFrame(const std::string& line, StackFrame& frame);
-    bool parseLLDBFrame(const std::string& line, StackFrame& frame);
+    bool parseFrames(StackTraceView& trace);
+    bool parseGDBFrames(StackTraceView& trace);
+    bool parseLLDBFrames(StackTraceView& trace);
+    bool parseBacktraceFrames(StackTraceView& trace);
+    bool parseMSVCFrames(StackTraceView& trace);
+
     std::string demangle(const std::string& mangled);
+    std::string_view demangle(std::string_view mangled, StackTraceView& trace);
     std::optional<SourceLocation> extractLocation(const std::string& text);
 };
 
@@ -0,0 +1,43 @@
+#ifndef AI_DEBUGGER_STRING_ARENA_H
+#define AI_DEBUGGER_STRING_ARENA_H
+
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+namespace ai_debugger {
+
+// Append-only character storage. Views returned by store() stay valid until
+// clear() or destruction; clear() keeps the allocated blocks for reuse.
+class StringArena {
+public:
+    explicit StringArena(size_t block_size = 4096);
+
+    StringArena(StringArena&&) noexcept = default;
+    StringArena& operator=(StringArena&&) noexcept = default;
+    StringArena(const StringArena&) = delete;
+    StringArena& operator=(const StringArena&) = delete;
+
+    std::string_view store(std::string_view value);
+    void clear();
+
+    size_t bytesUsed() const { return bytes_used_; }
+    size_t bytesReserved() const;
+
+private:
+    struct Block {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+
+    std::vector<Block> blocks_;
+    size_t block_size_;
+    size_t current_block_;
+    size_t offset_;
+    size_t bytes_used_;
+};
+
+} // namespace ai_debugger
+
+#endif // AI_DEBUGGER_STRING_ARENA_H
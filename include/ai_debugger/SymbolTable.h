@@ -0,0 +1,40 @@
+#ifndef AI_DEBUGGER_SYMBOL_TABLE_H
+#define AI_DEBUGGER_SYMBOL_TABLE_H
+
+#include "StringArena.h"
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace ai_debugger {
+
+// Interns strings to dense 32-bit ids, assigned in first-seen order. Names are
+// copied into an arena; clear() forgets them but keeps all storage.
+class SymbolTable {
+public:
+    static constexpr uint32_t npos = 0xFFFFFFFFu;
+
+    SymbolTable();
+
+    uint32_t intern(std::string_view name);
+    uint32_t find(std::string_view name) const;
+
+    std::string_view name(uint32_t id) const { return names_[id]; }
+    size_t size() const { return names_.size(); }
+    bool empty() const { return names_.empty(); }
+
+    void clear();
+
+private:
+    void rehash(size_t slot_count);
+
+    StringArena arena_;
+    std::vector<std::string_view> names_;
+    std::vector<size_t> hashes_;
+    std::vector<uint32_t> slots_;  // open addressing, power-of-two size
+};
+
+} // namespace ai_debugger
+
+#endif // AI_DEBUGGER_SYMBOL_TABLE_H
@@ -0,0 +1,46 @@
+#ifndef AI_DEBUGGER_THREAD_POOL_H
+#define AI_DEBUGGER_THREAD_POOL_H
+
+#include <functional>
+#include <memory>
+#include <cstddef>
+
+namespace ai_debugger {
+
+// Fixed-size pool where every worker owns a task deque. Workers pop their own
+// deque from the back and steal from the front of the others when it runs
+// dry. Tasks receive the index of the worker running them, so callers can
+// keep per-worker state without locking.
+class ThreadPool {
+public:
+    using Task = std::function<void(size_t worker)>;
+
+    // thread_count == 0 uses std::thread::hardware_concurrency().
+    explicit ThreadPool(size_t thread_count = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const;
+
+    void submit(Task task);
+
+    // Blocks until every submitted task has finished. Rethrows the first
+    // exception thrown by a task since the last wait(). A task of this pool
+    // would wait for itself, so calling it from one throws std::logic_error.
+    void wait();
+
+    // Splits [0, count) into chunks spread over all workers and waits for
+    // them; body(begin, end, worker) runs once per chunk. Called from a task
+    // of this pool, the whole range runs inline on that worker.
+    void parallelFor(size_t count, const std::function<void(size_t, size_t, size_t)>& body);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace ai_debugger
+
+#endif // AI_DEBUGGER_THREAD_POOL_H
@@ -1,41 +1,518 @@
 #include "ai_debugger/AIDebugger.h"
+#include "ai_debugger/AnalysisPipeline.h"
+#include "ai_debugger/MappedFile.h"
+#include "ai_debugger/ThreadPool.h"
+#include "ai_debugger/CrashSignature.h"
+#include "ai_debugger/HeuristicRules.h"
+#include "ai_debugger/SessionWriter.h"
 #include <fstream>
 #include <sstream>
 #include <chrono>
 #include <iomanip>
+#include <iostream>
 #include <filesystem>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <ctime>
+#include <limits>
+#include <list>
+#include <thread>
+#include <unordered_map>
 
 namespace ai_debugger {
 
-struct AIDebugger::Impl {
-    StackTraceParser parser;
+// Generators shared by a debugger's sessions for the parts their analysis
+// left out. Sessions from any thread may use it, hence the mutex.
+struct SessionCompleter {
+    std::mutex mutex;
     CallGraphAnalyzer graph_analyzer;
-    RootCausePredictor predictor;
     ExplanationGenerator explanation_gen;
     FixSuggester fix_suggester;
     TestGenerator test_gen;
+    std::shared_ptr<Instrumentation> instrumentation;
+};
+
+namespace {
+
+// Repeats share an analysis only if the same frames failed the same way; the
+// same crash site hit by a different signal or message is analyzed anew.
+uint64_t duplicateKey(const StackTrace& trace, uint64_t fingerprint) {
+    uint64_t key = fnv1a(std::string_view(reinterpret_cast<const char*>(&fingerprint), sizeof(fingerprint)));
+    int32_t signal = trace.signal_number;
+    key = fnv1a(std::string_view(reinterpret_cast<const char*>(&signal), sizeof(signal)), key);
+    key = fnv1a(trace.exception_type, key);
+    uint64_t message = errorMessageKey(trace.error_message);
+    return fnv1a(std::string_view(reinterpret_cast<const char*>(&message), sizeof(message)), key);
+}
+
+std::string currentTimestamp() {
+    auto now = std::chrono::system_clock::now();
+    auto time = std::chrono::system_clock::to_time_t(now);
+    std::tm local_time{};
+#ifdef _WIN32
+    localtime_s(&local_time, &time);
+#else
+    localtime_r(&time, &local_time);
+#endif
+    std::ostringstream oss;
+    oss << std::put_time(&local_time, "%Y-%m-%d %H:%M:%S");
+    return oss.str();
+}
+
+} // namespace
+
+struct AIDebugger::Impl {
+    Pipeline pipeline;
 
     Config config;
-    std::vector<DebugSession> sessions;
+
+    // Opened on first use from config.session_directory. The writer thread
+    // restores the history from it, asked to by the first analysis so that
+    // is not delayed by it.
+    std::shared_ptr<SessionStore> store;
+    bool store_failed = false;
+    std::string store_error;
+    std::mutex store_mutex;
+    std::atomic<bool> restore_requested{false};
+
+    // Batches take turns on the pool and its worker pipelines.
+    std::mutex batch_mutex;
+    std::unique_ptr<ThreadPool> pool;
+    std::vector<std::unique_ptr<Pipeline>> worker_pipelines;
+
+    // Analyzed sessions by duplicateKey(), most recently used first. The
+    // cached copies drop their trace; a hit takes the caller's trace instead.
+    struct CachedSession {
+        uint64_t key;
+        DebugSession session;
+    };
+    std::list<CachedSession> dedupe_lru;
+    std::unordered_map<uint64_t, std::list<CachedSession>::iterator> dedupe_index;
+    std::mutex dedupe_mutex;
+
+    // Shared by every pipeline's predictor, so a reload reaches all of them.
+    std::shared_ptr<RuleEngine> rules = pipeline.predictor.getRuleEngine();
+    uint64_t dedupe_generation = 0;  // rules generation the cache was filled under
+
+    std::shared_ptr<CrashHistory> history = std::make_shared<CrashHistory>();
+    std::shared_ptr<Instrumentation> instrumentation = std::make_shared<Instrumentation>();
+
+    // Replaced when its configuration changes; sessions keep the one they
+    // were analyzed with.
+    std::shared_ptr<SessionCompleter> completer;
+
+    void resetCompleter() {
+        completer = std::make_shared<SessionCompleter>();
+        if (!config.source_directory.empty()) {
+            completer->fix_suggester.setSourceRoot(config.source_directory);
+        }
+        completer->test_gen.setFramework(config.test_framework);
+        completer->instrumentation = instrumentation;
+    }
+
+    // Cached sessions predate a rule reload; drop them. Requires dedupe_mutex.
+    void syncRulesGeneration() {
+        uint64_t generation = rules->generation();
+        if (generation != dedupe_generation) {
+            dedupe_lru.clear();
+            dedupe_index.clear();
+            dedupe_generation = generation;
+        }
+    }
+
+    std::optional<DebugSession> findDuplicate(uint64_t key, StackTrace& trace) {
+        std::lock_guard<std::mutex> lock(dedupe_mutex);
+        syncRulesGeneration();
+        auto it = dedupe_index.find(key);
+        if (it == dedupe_index.end()) {
+            return std::nullopt;
+        }
+
+        ++it->second->session.occurrence_count;
+        dedupe_lru.splice(dedupe_lru.begin(), dedupe_lru, it->second);
+
+        DebugSession session = it->second->session;
+        session.trace = std::move(trace);
+        return session;
+    }
+
+    // `generation` is the rules generation the session was analyzed under.
+    void rememberSession(const DebugSession& session, uint64_t generation) {
+        uint64_t key = duplicateKey(session.trace, session.fingerprint);
+        std::lock_guard<std::mutex> lock(dedupe_mutex);
+        syncRulesGeneration();
+        if (generation != dedupe_generation || dedupe_index.count(key) || config.dedupe_capacity == 0) {
+            return;
+        }
+
+        dedupe_lru.push_front(CachedSession{key, session});
+        dedupe_lru.front().session.trace = StackTrace();
+        dedupe_index[key] = dedupe_lru.begin();
+        trimDuplicates();
+    }
+
+    // Requires dedupe_mutex.
+    void trimDuplicates() {
+        while (dedupe_lru.size() > config.dedupe_capacity) {
+            dedupe_index.erase(dedupe_lru.back().key);
+            dedupe_lru.pop_back();
+        }
+    }
+
+    void clearDuplicates() {
+        std::lock_guard<std::mutex> lock(dedupe_mutex);
+        dedupe_lru.clear();
+        dedupe_index.clear();
+    }
+
+    std::shared_ptr<SessionStore> sessionStore();
+
+    void requestRestore() {
+        restore_requested = true;
+        writer->open();
+    }
+
+    // Saves sessions off the analysis threads. Declared last so it drains
+    // before anything it uses is destroyed.
+    std::unique_ptr<SessionWriter> writer;
+
+    std::unique_ptr<Pipeline> makePipeline() const {
+        auto worker = std::make_unique<Pipeline>();
+        worker->parser.setVerbose(config.verbose);
+        worker->parser.setDemangleCache(pipeline.parser.getDemangleCache());
+        worker->predictor.setKnowledgeBase(pipeline.predictor.getKnowledgeBase());
+        worker->predictor.setModel(pipeline.predictor.getModel());
+        worker->predictor.setRuleEngine(rules);
+        worker->predictor.setCrashHistory(history);
+        if (!config.source_directory.empty()) {
+            worker->fix_suggester.setSourceRoot(config.source_directory);
+        }
+        worker->test_gen.setFramework(config.test_framework);
+        return worker;
+    }
 };
 
-AIDebugger::AIDebugger() : impl_(std::make_unique<Impl>()) {}
+namespace {
+
+std::atomic<uint64_t> session_sequence{0};
+
+} // namespace
+
+namespace {
+
+constexpr double MIN_SIMILAR_CRASH_SIMILARITY = 0.6;
+
+static_assert(static_cast<size_t>(TimedStage::TEST) + 1 == PIPELINE_STAGE_COUNT,
+              "analyzeStage() times each PipelineStage as the TimedStage of the same value");
+
+// A directory can only be opened by one SessionStore at a time, so
+// debuggers in one process share the store of each directory.
+std::shared_ptr<SessionStore> openSharedStore(const std::string& directory, std::string* error) {
+    static std::mutex mutex;
+    static std::unordered_map<std::string, std::weak_ptr<SessionStore>> stores;
+
+    std::error_code ec;
+    std::string key = std::filesystem::weakly_canonical(directory, ec).string();
+    if (ec) {
+        key = directory;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (auto store = stores[key].lock()) {
+        return store;
+    }
+    auto store = std::make_shared<SessionStore>();
+    if (!store->open(directory, error)) {
+        return nullptr;
+    }
+    stores[key] = store;
+    return store;
+}
+
+// Records the sessions of `store` in `history` unless that was done for the
+// pair already, so debuggers sharing both restore them once. Callers for the
+// same pair wait until it is done. Runs on writer threads.
+void restoreHistoryOnce(const std::shared_ptr<SessionStore>& store, const std::shared_ptr<CrashHistory>& history) {
+    struct Restore {
+        std::weak_ptr<SessionStore> store;
+        std::weak_ptr<CrashHistory> history;
+        std::once_flag once;
+    };
+    static std::mutex mutex;
+    static std::vector<std::shared_ptr<Restore>> restores;
+
+    auto same = [](const auto& weak, const auto& shared) {
+        return !weak.owner_before(shared) && !shared.owner_before(weak);
+    };
+
+    std::shared_ptr<Restore> restore;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        restores.erase(std::remove_if(restores.begin(), restores.end(), [](const std::shared_ptr<Restore>& r) {
+            return r->store.expired() || r->history.expired();
+        }), restores.end());
+        for (const auto& r : restores) {
+            if (same(r->store, store) && same(r->history, history)) {
+                restore = r;
+                break;
+            }
+        }
+        if (!restore) {
+            restore = std::make_shared<Restore>();
+            restore->store = store;
+            restore->history = history;
+            restores.push_back(restore);
+        }
+    }
+
+    std::call_once(restore->once, [&] {
+        store->scanSummaries(std::numeric_limits<std::time_t>::min(), std::numeric_limits<std::time_t>::max(),
+                             [&](DebugSession&& session) {
+            history->record(session.trace, session.session_id,
+                            session.root_causes.empty() ? RootCause() : session.root_causes[0],
+                            session.root_cause_confirmed);
+        });
+    });
+}
+
+} // namespace
+
+std::shared_ptr<SessionStore> AIDebugger::Impl::sessionStore() {
+    std::lock_guard<std::mutex> lock(store_mutex);
+    if (!store && !store_failed && !config.session_directory.empty()) {
+        store = openSharedStore(config.session_directory, &store_error);
+        store_failed = !store;
+        if (store_failed && config.verbose) {
+            std::cerr << "Sessions will not be saved: " << store_error << "\n";
+        }
+    }
+    return store;
+}
+
+AIDebugger::AIDebugger() : impl_(std::make_unique<Impl>()) {
+    impl_->pipeline.predictor.setCrashHistory(impl_->history);
+    impl_->resetCompleter();
+    Impl* impl = impl_.get();
+    impl_->writer = std::make_unique<SessionWriter>([impl] {
+        auto store = impl->sessionStore();
+        if (store) {
+            restoreHistoryOnce(store, impl->history);
+        }
+        return store;
+    });
+}
 
 AIDebugger::~AIDebugger() = default;
 
 void AIDebugger::setSourceDirectory(const std::string& src_dir) {
     impl_->config.source_directory = src_dir;
-    impl_->fix_suggester.setSourceRoot(src_dir);
+    impl_->pipeline.fix_suggester.setSourceRoot(src_dir);
+    impl_->resetCompleter();
+    impl_->worker_pipelines.clear();
+    impl_->clearDuplicates();
 }
 
 void AIDebugger::setTestFramework(TestFramework framework) {
     impl_->config.test_framework = framework;
-    impl_->test_gen.setFramework(framework);
+    impl_->pipeline.test_gen.setFramework(framework);
+    impl_->resetCompleter();
+    impl_->worker_pipelines.clear();
+    impl_->clearDuplicates();
+}
+
+void AIDebugger::setSessionDirectory(const std::string& directory) {
+    impl_->writer->flush();
+    std::lock_guard<std::mutex> lock(impl_->store_mutex);
+    impl_->config.session_directory = directory;
+    impl_->store.reset();
+    impl_->store_failed = false;
+    impl_->store_error.clear();
+    impl_->restore_requested = false;
+}
+
+void AIDebugger::setSessionStore(std::shared_ptr<SessionStore> store) {
+    impl_->writer->flush();
+    std::lock_guard<std::mutex> lock(impl_->store_mutex);
+    impl_->store = std::move(store);
+    impl_->store_failed = !impl_->store;
+    impl_->store_error = impl_->store ? "" : "no session store";
+    impl_->restore_requested = false;
+    if (impl_->store) {
+        impl_->config.session_directory = impl_->store->directory();
+    }
+}
+
+std::shared_ptr<SessionStore> AIDebugger::getSessionStore() const {
+    return impl_->sessionStore();
+}
+
+bool AIDebugger::openSessionStore(std::string* error) {
+    if (impl_->sessionStore()) {
+        impl_->requestRestore();
+        return true;
+    }
+    if (error) {
+        std::lock_guard<std::mutex> lock(impl_->store_mutex);
+        *error = impl_->config.session_directory.empty() ? "no session directory" : impl_->store_error;
+    }
+    return false;
+}
+
+bool AIDebugger::flushSessions() {
+    return impl_->writer->flush();
 }
 
 void AIDebugger::setVerbose(bool verbose) {
     impl_->config.verbose = verbose;
-    impl_->parser.setVerbose(verbose);
+    impl_->pipeline.parser.setVerbose(verbose);
+    impl_->worker_pipelines.clear();
+}
+
+void AIDebugger::setMaxParallelTasks(int max_tasks) {
+    impl_->config.max_parallel_tasks = std::max(max_tasks, 0);
+}
+
+void AIDebugger::setAnalysisOptions(AnalysisOptions options) {
+    impl_->config.analysis_options = options;
+    impl_->clearDuplicates();
+}
+
+bool AIDebugger::loadKnowledgeBase(const std::string& kb_path) {
+    if (!impl_->pipeline.predictor.loadKnowledgeBase(kb_path)) {
+        return false;
+    }
+    impl_->config.knowledge_base_path = kb_path;
+    impl_->worker_pipelines.clear();
+    impl_->clearDuplicates();
+    return true;
+}
+
+void AIDebugger::setKnowledgeBase(std::shared_ptr<const KnowledgeBase> knowledge_base) {
+    impl_->pipeline.predictor.setKnowledgeBase(std::move(knowledge_base));
+    impl_->worker_pipelines.clear();
+    impl_->clearDuplicates();
+}
+
+std::shared_ptr<const KnowledgeBase> AIDebugger::getKnowledgeBase() const {
+    return impl_->pipeline.predictor.getKnowledgeBase();
+}
+
+bool AIDebugger::loadModel(const std::string& model_path) {
+    if (!impl_->pipeline.predictor.loadModel(model_path)) {
+        return false;
+    }
+    impl_->config.model_path = model_path;
+    impl_->worker_pipelines.clear();
+    impl_->clearDuplicates();
+    return true;
+}
+
+void AIDebugger::setModel(std::shared_ptr<const LinearClassifier> model) {
+    impl_->pipeline.predictor.setModel(std::move(model));
+    impl_->worker_pipelines.clear();
+    impl_->clearDuplicates();
+}
+
+std::shared_ptr<const LinearClassifier> AIDebugger::getModel() const {
+    return impl_->pipeline.predictor.getModel();
+}
+
+bool AIDebugger::loadRules(const std::string& rules_path, std::string* error) {
+    if (!impl_->rules->load(rules_path, error)) {
+        return false;
+    }
+    impl_->config.rules_path = rules_path;
+    return true;
+}
+
+bool AIDebugger::reloadRulesIfChanged(std::string* error) {
+    return impl_->rules->reloadIfChanged(error);
+}
+
+void AIDebugger::setRuleEngine(std::shared_ptr<RuleEngine> engine) {
+    impl_->pipeline.predictor.setRuleEngine(std::move(engine));
+    impl_->rules = impl_->pipeline.predictor.getRuleEngine();
+    impl_->worker_pipelines.clear();
+    impl_->clearDuplicates();
+}
+
+std::shared_ptr<RuleEngine> AIDebugger::getRuleEngine() const {
+    return impl_->rules;
+}
+
+void AIDebugger::enableDeduplication(bool enable) {
+    impl_->config.deduplicate = enable;
+    if (!enable) {
+        impl_->clearDuplicates();
+    }
+}
+
+void AIDebugger::setDeduplicationCapacity(size_t max_sessions) {
+    std::lock_guard<std::mutex> lock(impl_->dedupe_mutex);
+    impl_->config.dedupe_capacity = max_sessions;
+    impl_->trimDuplicates();
+}
+
+void AIDebugger::setSimilarCrashCount(size_t count) {
+    impl_->config.similar_crashes = count;
+    impl_->clearDuplicates();
+}
+
+std::vector<SimilarCrash> AIDebugger::findSimilarSessions(const StackTrace& trace, size_t k) const {
+    return impl_->history->nearest(trace, k, MIN_SIMILAR_CRASH_SIMILARITY);
+}
+
+bool AIDebugger::confirmRootCause(const std::string& session_id, const RootCause& cause) {
+    // The restored history decides whether the session is already known.
+    impl_->requestRestore();
+    impl_->writer->flush();
+    auto store = impl_->sessionStore();
+    DebugSession session;
+    bool stored = store && store->get(session_id, session);
+
+    // A history set after the store opened may not know older sessions.
+    if (!impl_->history->confirm(session_id, cause)) {
+        if (!stored) {
+            return false;
+        }
+        impl_->history->record(session.trace, session_id, cause, true);
+    }
+
+    if (stored) {
+        auto& causes = session.root_causes;
+        causes.erase(std::remove_if(causes.begin(), causes.end(), [&](const RootCause& c) {
+            return c.category == cause.category;
+        }), causes.end());
+        causes.insert(causes.begin(), cause);
+        causes.front().confidence = 1.0;
+        session.root_cause_confirmed = true;
+        store->put(session);
+    }
+    return true;
+}
+
+void AIDebugger::setCrashHistory(std::shared_ptr<CrashHistory> history) {
+    // The writer thread restores into the history; let it go idle first.
+    impl_->writer->flush();
+    impl_->history = history ? std::move(history) : std::make_shared<CrashHistory>();
+    impl_->restore_requested = false;
+    impl_->pipeline.predictor.setCrashHistory(impl_->history);
+    impl_->worker_pipelines.clear();
+    impl_->clearDuplicates();
+}
+
+std::shared_ptr<CrashHistory> AIDebugger::getCrashHistory() const {
+    return impl_->history;
+}
+
+void AIDebugger::setInstrumentation(std::shared_ptr<Instrumentation> instrumentation) {
+    impl_->instrumentation = instrumentation ? std::move(instrumentation) : std::make_shared<Instrumentation>();
+    impl_->resetCompleter();
+}
+
+std::shared_ptr<Instrumentation> AIDebugger::getInstrumentation() const {
+    return impl_->instrumentation;
 }
 
 void AIDebugger::enableAutoFix(bool enable) {
@@ -44,68 +521,269 @@ void AIDebugger::enableAutoFix(bool enable) {
 
 void AIDebugger::enableTestGeneration(bool enable) {
     impl_->config.auto_test = enable;
+    impl_->clearDuplicates();
 }
 
 DebugSession AIDebugger::analyzeStackTrace(const std::string& trace_text) {
-    DebugSession session;
-    session.session_id = generateSessionId();
+    return analyzeTrace(parseTrace(trace_text, impl_->pipeline), impl_->pipeline);
+}
 
-    auto now = std::chrono::system_clock::now();
-    auto time = std::chrono::system_clock::to_time_t(now);
-    std::ostringstream oss;
-    oss << std::put_time(std::localtime(&time), "%Y-%m-%d %H:%M:%S");
-    session.timestamp = oss.str();
+std::optional<StackTrace> AIDebugger::parseTrace(const std::string& trace_text, Pipeline& pipeline) {
+    Instrumentation& instrumentation = *impl_->instrumentation;
+    instrumentation.add(Counter::BYTES_CONSUMED, trace_text.size());
+    Instrumentation::ScopedTimer timer(instrumentation, TimedStage::PARSE);
+    return pipeline.parser.parse(trace_text);
+}
+
+std::vector<DebugSession> AIDebugger::analyzeBatch(const std::vector<std::string>& traces) {
+    std::lock_guard<std::mutex> lock(impl_->batch_mutex);
+    size_t threads = impl_->config.max_parallel_tasks > 0
+        ? static_cast<size_t>(impl_->config.max_parallel_tasks)
+        : std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    if (!impl_->pool || impl_->pool->size() != threads) {
+        impl_->pool = std::make_unique<ThreadPool>(threads);
+    }
+    impl_->worker_pipelines.resize(std::min(impl_->worker_pipelines.size(), threads));
+    while (impl_->worker_pipelines.size() < threads) {
+        impl_->worker_pipelines.push_back(impl_->makePipeline());
+    }
 
-    auto trace_opt = impl_->parser.parse(trace_text);
-    if (!trace_opt) {
+    std::vector<DebugSession> results(traces.size());
+    impl_->pool->parallelFor(traces.size(), [&](size_t begin, size_t end, size_t worker) {
+        Pipeline& pipeline = *impl_->worker_pipelines[worker];
+        for (size_t i = begin; i < end; ++i) {
+            results[i] = analyzeTrace(parseTrace(traces[i], pipeline), pipeline);
+        }
+    });
+    return results;
+}
+
+size_t AIDebugger::analyzeStream(
+    std::istream& input,
+    const std::function<void(DebugSession&&)>& on_session
+) {
+    // The parser runs between callbacks, so that is the time it took.
+    Instrumentation& instrumentation = *impl_->instrumentation;
+    auto resumed = Instrumentation::Clock::now();
+    return impl_->pipeline.parser.parseStream(input, [&](StackTrace&& trace) {
+        if (instrumentation.isEnabled()) {
+            instrumentation.recordTime(TimedStage::PARSE, static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(Instrumentation::Clock::now() - resumed).count()));
+        }
+        on_session(analyzeTrace(std::move(trace), impl_->pipeline));
+        if (instrumentation.isEnabled()) {
+            resumed = Instrumentation::Clock::now();
+        }
+    });
+}
+
+DebugSession AIDebugger::analyzeTrace(std::optional<StackTrace> trace, Pipeline& pipeline) {
+    DebugSession session;
+    uint64_t rules_generation = 0;
+    if (beginAnalysis(std::move(trace), session, rules_generation)) {
         return session;
     }
+    for (auto stage : {PipelineStage::CALL_GRAPH, PipelineStage::PREDICT, PipelineStage::EXPLAIN,
+                       PipelineStage::FIX, PipelineStage::TEST}) {
+        analyzeStage(stage, session, pipeline.graph_analyzer, pipeline);
+    }
+    finishAnalysis(session, rules_generation);
+    return session;
+}
 
-    session.trace = *trace_opt;
+bool AIDebugger::beginAnalysis(std::optional<StackTrace> trace, DebugSession& session, uint64_t& rules_generation) {
+    Instrumentation& instrumentation = *impl_->instrumentation;
+    instrumentation.add(Counter::TRACES_ANALYZED);
+    if (trace) {
+        instrumentation.add(Counter::FRAMES_PARSED, trace->frames.size());
+    }
 
-    impl_->graph_analyzer.buildFromStackTrace(session.trace);
+    if (!impl_->restore_requested.exchange(true)) {
+        impl_->writer->open();
+    }
 
-    auto root_causes = impl_->predictor.predict(session.trace, impl_->graph_analyzer);
-    session.root_causes = root_causes;
+    uint64_t fingerprint = trace ? crashFingerprint(*trace) : 0;
+    rules_generation = impl_->rules->generation();
+    if (fingerprint != 0 && impl_->config.deduplicate) {
+        if (auto duplicate = impl_->findDuplicate(duplicateKey(*trace, fingerprint), *trace)) {
+            instrumentation.add(Counter::CACHE_HITS);
+            // A session of its own that reuses the cached analysis, saved and
+            // recorded like any other so it can be loaded and confirmed.
+            session = std::move(*duplicate);
+            session.session_id = generateSessionId();
+            session.timestamp = currentTimestamp();
+            impl_->history->record(session.trace, session.session_id,
+                                   session.root_causes.empty() ? RootCause() : session.root_causes[0], false);
+            saveSession(session);
+            return true;
+        }
+        instrumentation.add(Counter::CACHE_MISSES);
+    }
 
-    if (!root_causes.empty()) {
-        session.explanation = impl_->explanation_gen.generate(
-            session.trace,
-            root_causes[0],
-            impl_->graph_analyzer
-        );
+    session.session_id = generateSessionId();
+    session.timestamp = currentTimestamp();
+    session.fingerprint = fingerprint;
 
-        session.suggested_fixes = impl_->fix_suggester.suggestFixes(
-            root_causes[0],
-            session.trace
-        );
+    if (!trace) {
+        return true;
+    }
+    session.trace = std::move(*trace);
+
+    // Tests need the fixes, so they wait whenever the fixes do.
+    AnalysisOptions lazy = AnalysisOptions::EXPLANATION | AnalysisOptions::FIXES |
+                           AnalysisOptions::REGRESSION_TESTS;
+    session.pending = ~impl_->config.analysis_options & lazy;
+    if (!impl_->config.auto_test || hasOption(session.pending, AnalysisOptions::FIXES)) {
+        session.pending = session.pending | AnalysisOptions::REGRESSION_TESTS;
+    }
+    session.completer = impl_->completer;
+    return false;
+}
 
-        if (impl_->config.auto_test && !session.suggested_fixes.empty()) {
-            session.regression_tests = impl_->test_gen.generateRegressionTests(
-                root_causes[0],
-                session.suggested_fixes[0],
-                session.trace
-            );
+void AIDebugger::analyzeStage(
+    PipelineStage stage,
+    DebugSession& session,
+    CallGraphAnalyzer& graph,
+    Pipeline& pipeline
+) {
+    Instrumentation::ScopedTimer timer(*impl_->instrumentation, static_cast<TimedStage>(stage));
+    switch (stage) {
+        case PipelineStage::PARSE:
+            break;
+
+        case PipelineStage::CALL_GRAPH:
+            graph.buildFromStackTrace(session.trace);
+            break;
+
+        case PipelineStage::PREDICT: {
+            session.root_causes = pipeline.predictor.predict(session.trace, graph);
+
+            // Looked up before this crash is recorded, so it never lists itself.
+            SparseFeatures features;
+            FeatureVectorizer().vectorize(session.trace, features);
+            if (impl_->config.similar_crashes > 0 &&
+                hasOption(impl_->config.analysis_options, AnalysisOptions::SIMILAR_CRASHES)) {
+                session.similar_crashes = impl_->history->nearest(
+                    features, impl_->config.similar_crashes, MIN_SIMILAR_CRASH_SIMILARITY);
+            }
+            impl_->history->record(features, session.session_id,
+                                   session.root_causes.empty() ? RootCause() : session.root_causes[0], false);
+            break;
         }
+
+        case PipelineStage::EXPLAIN:
+            if (!session.root_causes.empty() && !hasOption(session.pending, AnalysisOptions::EXPLANATION)) {
+                session.explanation = pipeline.explanation_gen.generate(
+                    session.trace,
+                    session.root_causes[0],
+                    graph
+                );
+            }
+            break;
+
+        case PipelineStage::FIX:
+            if (!session.root_causes.empty() && !hasOption(session.pending, AnalysisOptions::FIXES)) {
+                session.suggested_fixes = pipeline.fix_suggester.suggestFixes(
+                    session.root_causes[0],
+                    session.trace
+                );
+            }
+            break;
+
+        case PipelineStage::TEST:
+            if (!hasOption(session.pending, AnalysisOptions::REGRESSION_TESTS) &&
+                !session.root_causes.empty() && !session.suggested_fixes.empty()) {
+                session.regression_tests = pipeline.test_gen.generateRegressionTests(
+                    session.root_causes[0],
+                    session.suggested_fixes[0],
+                    session.trace
+                );
+            }
+            break;
     }
+}
 
-    saveSession(session);
+void AIDebugger::finishAnalysis(const DebugSession& session, uint64_t rules_generation) {
+    {
+        Instrumentation::ScopedTimer timer(*impl_->instrumentation, TimedStage::PERSIST);
+        saveSession(session);
+    }
 
-    return session;
+    if (session.fingerprint != 0 && impl_->config.deduplicate) {
+        impl_->rememberSession(session, rules_generation);
+    }
+}
+
+std::unique_ptr<AIDebugger::Pipeline> AIDebugger::makePipeline() const {
+    return impl_->makePipeline();
 }
 
 DebugSession AIDebugger::analyzeFromFile(const std::string& trace_file) {
-    std::ifstream file(trace_file);
-    if (!file.is_open()) {
+    auto file = std::make_shared<MappedFile>();
+    if (!file->open(trace_file)) {
         return DebugSession();
     }
 
-    std::ostringstream oss;
-    oss << file.rdbuf();
-    return analyzeStackTrace(oss.str());
+    // The parser reads straight out of the mapping; only the extracted
+    // frames are copied out when the view is materialized.
+    std::optional<StackTrace> trace;
+    {
+        Instrumentation& instrumentation = *impl_->instrumentation;
+        instrumentation.add(Counter::BYTES_CONSUMED, file->data().size());
+        Instrumentation::ScopedTimer timer(instrumentation, TimedStage::PARSE);
+        if (auto view = impl_->pipeline.parser.parseView(file->data(), file)) {
+            trace = view->materialize();
+        }
+    }
+    return analyzeTrace(std::move(trace), impl_->pipeline);
+}
+
+const Explanation& DebugSession::getExplanation() {
+    if (hasOption(pending, AnalysisOptions::EXPLANATION)) {
+        if (completer && !root_causes.empty()) {
+            Instrumentation::ScopedTimer timer(*completer->instrumentation, TimedStage::EXPLAIN);
+            std::lock_guard<std::mutex> lock(completer->mutex);
+            completer->graph_analyzer.buildFromStackTrace(trace);
+            explanation = completer->explanation_gen.generate(trace, root_causes[0], completer->graph_analyzer);
+        }
+        pending = pending & ~AnalysisOptions::EXPLANATION;
+    }
+    return explanation;
+}
+
+const std::vector<CodeFix>& DebugSession::getSuggestedFixes() {
+    if (hasOption(pending, AnalysisOptions::FIXES)) {
+        if (completer && !root_causes.empty()) {
+            Instrumentation::ScopedTimer timer(*completer->instrumentation, TimedStage::FIX);
+            std::lock_guard<std::mutex> lock(completer->mutex);
+            suggested_fixes = completer->fix_suggester.suggestFixes(root_causes[0], trace);
+        }
+        pending = pending & ~AnalysisOptions::FIXES;
+    }
+    return suggested_fixes;
+}
+
+const TestSuite& DebugSession::getRegressionTests() {
+    if (hasOption(pending, AnalysisOptions::REGRESSION_TESTS)) {
+        getSuggestedFixes();
+        if (completer && !root_causes.empty() && !suggested_fixes.empty()) {
+            Instrumentation::ScopedTimer timer(*completer->instrumentation, TimedStage::TEST);
+            std::lock_guard<std::mutex> lock(completer->mutex);
+            regression_tests = completer->test_gen.generateRegressionTests(root_causes[0], suggested_fixes[0], trace);
+        }
+        pending = pending & ~AnalysisOptions::REGRESSION_TESTS;
+    }
+    return regression_tests;
 }
 
 std::string AIDebugger::getReport(const DebugSession& session) const {
+    if (hasOption(session.pending, AnalysisOptions::EXPLANATION | AnalysisOptions::FIXES)) {
+        DebugSession complete = session;
+        complete.getExplanation();
+        complete.getSuggestedFixes();
+        return getReport(complete);
+    }
+
     std::ostringstream oss;
 
     oss << "=================================================\n";
@@ -136,6 +814,17 @@ std::string AIDebugger::getReport(const DebugSession& session) const {
         }
     }
 
+    if (!session.similar_crashes.empty()) {
+        oss << "SIMILAR PAST CRASHES\n";
+        oss << "--------------------\n";
+        for (const auto& crash : session.similar_crashes) {
+            oss << "- " << crash.session_id << " (" << static_cast<int>(crash.similarity * 100)
+                << "% similar): " << bugCategoryToString(crash.root_cause.category)
+                << (crash.confirmed ? " [confirmed]" : "") << "\n";
+        }
+        oss << "\n";
+    }
+
     oss << "\n" << session.explanation.toPlainText() << "\n";
 
     if (!session.suggested_fixes.empty()) {
@@ -167,6 +856,12 @@ bool AIDebugger::saveReport(const DebugSession& session, const std::string& outp
 }
 
 FixApplication AIDebugger::applyBestFix(const DebugSession& session) {
+    if (hasOption(session.pending, AnalysisOptions::FIXES)) {
+        DebugSession complete = session;
+        complete.getSuggestedFixes();
+        return applyBestFix(complete);
+    }
+
     if (session.suggested_fixes.empty()) {
         FixApplication app;
         app.success = false;
@@ -174,60 +869,71 @@ FixApplication AIDebugger::applyBestFix(const DebugSession& session) {
         return app;
     }
 
-    return impl_->fix_suggester.applyFix(session.suggested_fixes[0], true);
+    return impl_->pipeline.fix_suggester.applyFix(session.suggested_fixes[0], true);
 }
 
 std::vector<FixApplication> AIDebugger::applyAllFixes(const DebugSession& session) {
-    return impl_->fix_suggester.applyAllFixes(session.suggested_fixes, true);
+    if (hasOption(session.pending, AnalysisOptions::FIXES)) {
+        DebugSession complete = session;
+        complete.getSuggestedFixes();
+        return applyAllFixes(complete);
+    }
+    return impl_->pipeline.fix_suggester.applyAllFixes(session.suggested_fixes, true);
 }
 
 bool AIDebugger::generateTests(const DebugSession& session) {
+    if (hasOption(session.pending, AnalysisOptions::FIXES)) {
+        DebugSession complete = session;
+        complete.getSuggestedFixes();
+        return generateTests(complete);
+    }
+
     if (!session.regression_tests.test_cases.empty()) {
-        return impl_->test_gen.writeTestFile(session.regression_tests);
+        return impl_->pipeline.test_gen.writeTestFile(session.regression_tests);
     }
 
     if (!session.root_causes.empty() && !session.suggested_fixes.empty()) {
-        auto test_suite = impl_->test_gen.generateRegressionTests(
+        auto test_suite = impl_->pipeline.test_gen.generateRegressionTests(
             session.root_causes[0],
             session.suggested_fixes[0],
             session.trace
         );
-        return impl_->test_gen.writeTestFile(test_suite);
+        return impl_->pipeline.test_gen.writeTestFile(test_suite);
     }
 
     return false;
 }
 
 std::vector<std::string> AIDebugger::listSessions() const {
-    std::vector<std::string> session_ids;
-    for (const auto& session : impl_->sessions) {
-        session_ids.push_back(session.session_id);
-    }
-    return session_ids;
+    impl_->writer->flush();
+    auto store = impl_->sessionStore();
+    return store ? store->sessionIds() : std::vector<std::string>();
 }
 
 DebugSession AIDebugger::loadSession(const std::string& session_id) const {
-    for (const auto& session : impl_->sessions) {
-        if (session.session_id == session_id) {
-            return session;
-        }
+    impl_->writer->flush();
+    DebugSession session;
+    auto store = impl_->sessionStore();
+    if (!store || !store->get(session_id, session)) {
+        return DebugSession();
     }
-    return DebugSession();
+    if (session.pending != AnalysisOptions::ROOT_CAUSES) {
+        session.completer = impl_->completer;
+    }
+    return session;
 }
 
 std::string AIDebugger::generateSessionId() const {
     auto now = std::chrono::system_clock::now();
     auto duration = now.time_since_epoch();
     auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
-    return "session_" + std::to_string(millis);
+    // Batches create many sessions per millisecond; the sequence keeps ids unique.
+    uint64_t sequence = session_sequence.fetch_add(1, std::memory_order_relaxed);
+    return "session_" + std::to_string(millis) + "_" + std::to_string(sequence);
 }
 
 void AIDebugger::saveSession(const DebugSession& session) {
-    impl_->sessions.push_back(session);
-
-    std::filesystem::create_directories(".ai_debugger/sessions");
-    std::string path = ".ai_debugger/sessions/" + session.session_id + ".txt";
-    saveReport(session, path);
+    impl_->writer->write(session);
 }
 
 Config Config::fromFile(const std::string& config_path) {
@@ -243,10 +949,19 @@ bool Config::save(const std::string& config_path) const {
 
     file << "source_directory=" << source_directory << "\n";
     file << "test_output_directory=" << test_output_directory << "\n";
+    file << "knowledge_base_path=" << knowledge_base_path << "\n";
+    file << "model_path=" << model_path << "\n";
+    file << "rules_path=" << rules_path << "\n";
+    file << "session_directory=" << session_directory << "\n";
     file << "test_framework=" << testFrameworkToString(test_framework) << "\n";
     file << "verbose=" << (verbose ? "true" : "false") << "\n";
     file << "auto_fix=" << (auto_fix ? "true" : "false") << "\n";
     file << "auto_test=" << (auto_test ? "true" : "false") << "\n";
+    file << "max_parallel_tasks=" << max_parallel_tasks << "\n";
+    file << "deduplicate=" << (deduplicate ? "true" : "false") << "\n";
+    file << "dedupe_capacity=" << dedupe_capacity << "\n";
+    file << "similar_crashes=" << similar_crashes << "\n";
+    file << "analysis_options=" << static_cast<uint32_t>(analysis_options) << "\n";
 
     return true;
 }
@@ -0,0 +1,338 @@
+#include "ai_debugger/AggregateCallGraph.h"
+#include "ai_debugger/SymbolTable.h"
+#include <algorithm>
+#include <chrono>
+#include <set>
+#include <unordered_map>
+
+namespace ai_debugger {
+
+namespace {
+
+struct EdgeStats {
+    uint64_t count = 0;
+    int64_t first_seen = 0;
+    int64_t last_seen = 0;
+    std::vector<std::pair<int, uint64_t>> signals;
+};
+
+struct PathCounter {
+    uint64_t count = 0;
+    uint64_t error = 0;
+};
+
+uint64_t edgeKey(uint32_t caller, uint32_t callee) {
+    return (static_cast<uint64_t>(caller) << 32) | callee;
+}
+
+uint32_t callerOf(uint64_t key) {
+    return static_cast<uint32_t>(key >> 32);
+}
+
+uint32_t calleeOf(uint64_t key) {
+    return static_cast<uint32_t>(key & 0xFFFFFFFFu);
+}
+
+void addSignal(std::vector<std::pair<int, uint64_t>>& signals, int signal, uint64_t count) {
+    for (auto& entry : signals) {
+        if (entry.first == signal) {
+            entry.second += count;
+            return;
+        }
+    }
+    signals.emplace_back(signal, count);
+}
+
+void mergeStats(EdgeStats& into, const EdgeStats& from) {
+    if (into.count == 0) {
+        into.first_seen = from.first_seen;
+        into.last_seen = from.last_seen;
+    } else {
+        into.first_seen = std::min(into.first_seen, from.first_seen);
+        into.last_seen = std::max(into.last_seen, from.last_seen);
+    }
+    into.count += from.count;
+    for (const auto& entry : from.signals) {
+        addSignal(into.signals, entry.first, entry.second);
+    }
+}
+
+} // namespace
+
+struct AggregateCallGraph::Impl {
+    AggregateLimits limits;
+
+    SymbolTable symbols;
+    std::unordered_map<uint64_t, EdgeStats> edges;
+    uint64_t traces = 0;
+
+    // Space-Saving summary over crash paths. Keys are the path's frame names
+    // joined by '\n', which stays valid across compaction and between shards
+    // whose symbol ids differ. `by_count` orders counters for eviction.
+    std::unordered_map<std::string, PathCounter> paths;
+    std::set<std::pair<uint64_t, const std::string*>> by_count;
+
+    std::vector<uint64_t> trace_edges;
+    std::string path_key;
+
+    explicit Impl(const AggregateLimits& l) : limits(l) {
+        limits.max_edges = std::max<size_t>(limits.max_edges, 2);
+        limits.max_paths = std::max<size_t>(limits.max_paths, 1);
+        limits.path_depth = std::max<size_t>(limits.path_depth, 1);
+    }
+
+    uint64_t minPathCount() const {
+        return paths.size() >= limits.max_paths ? by_count.begin()->first : 0;
+    }
+
+    void countPath(const std::string& key, uint64_t count, uint64_t error) {
+        auto it = paths.find(key);
+        if (it != paths.end()) {
+            by_count.erase({it->second.count, &it->first});
+            it->second.count += count;
+            it->second.error += error;
+            by_count.insert({it->second.count, &it->first});
+            return;
+        }
+
+        if (paths.size() >= limits.max_paths) {
+            // Replace the smallest counter; the newcomer inherits its count
+            // as the bound on how much it may be overestimated.
+            auto smallest = by_count.begin();
+            uint64_t floor = smallest->first;
+            std::string evicted = *smallest->second;
+            by_count.erase(smallest);
+            paths.erase(evicted);
+            count += floor;
+            error += floor;
+        }
+
+        auto inserted = paths.emplace(key, PathCounter{count, error}).first;
+        by_count.insert({count, &inserted->first});
+    }
+
+    // Keeps the heaviest half of the edges and rebuilds the symbol table so
+    // names only referenced by dropped edges are released too.
+    void compact() {
+        if (edges.size() <= limits.max_edges) {
+            return;
+        }
+
+        std::vector<std::pair<uint64_t, uint64_t>> ranked;
+        ranked.reserve(edges.size());
+        for (const auto& entry : edges) {
+            ranked.emplace_back(entry.second.count, entry.first);
+        }
+        size_t keep = limits.max_edges / 2;
+        std::nth_element(ranked.begin(), ranked.begin() + keep, ranked.end(),
+                         [](const auto& a, const auto& b) { return a.first > b.first; });
+        ranked.resize(keep);
+
+        SymbolTable compacted;
+        std::unordered_map<uint64_t, EdgeStats> kept;
+        kept.reserve(keep);
+        for (const auto& entry : ranked) {
+            uint32_t caller = compacted.intern(symbols.name(callerOf(entry.second)));
+            uint32_t callee = compacted.intern(symbols.name(calleeOf(entry.second)));
+            kept.emplace(edgeKey(caller, callee), std::move(edges[entry.second]));
+        }
+
+        symbols = std::move(compacted);
+        edges = std::move(kept);
+    }
+};
+
+AggregateCallGraph::AggregateCallGraph(const AggregateLimits& limits)
+    : impl_(std::make_unique<Impl>(limits)) {}
+
+AggregateCallGraph::~AggregateCallGraph() = default;
+
+AggregateCallGraph::AggregateCallGraph(AggregateCallGraph&&) noexcept = default;
+
+AggregateCallGraph& AggregateCallGraph::operator=(AggregateCallGraph&&) noexcept = default;
+
+void AggregateCallGraph::add(const StackTrace& trace) {
+    auto now = std::chrono::system_clock::now();
+    add(trace, std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count());
+}
+
+void AggregateCallGraph::add(const StackTrace& trace, int64_t timestamp) {
+    ++impl_->traces;
+
+    // Edges are counted once per trace, so deep recursion does not swamp
+    // the weights.
+    impl_->trace_edges.clear();
+    for (size_t i = 0; i + 1 < trace.frames.size(); ++i) {
+        uint32_t caller = impl_->symbols.intern(trace.frames[i + 1].function_name);
+        uint32_t callee = impl_->symbols.intern(trace.frames[i].function_name);
+        impl_->trace_edges.push_back(edgeKey(caller, callee));
+    }
+    std::sort(impl_->trace_edges.begin(), impl_->trace_edges.end());
+    impl_->trace_edges.erase(
+        std::unique(impl_->trace_edges.begin(), impl_->trace_edges.end()),
+        impl_->trace_edges.end());
+
+    for (uint64_t key : impl_->trace_edges) {
+        EdgeStats& stats = impl_->edges[key];
+        if (stats.count == 0 || timestamp < stats.first_seen) {
+            stats.first_seen = timestamp;
+        }
+        if (stats.count == 0 || timestamp > stats.last_seen) {
+            stats.last_seen = timestamp;
+        }
+        ++stats.count;
+        if (trace.signal_number != 0) {
+            addSignal(stats.signals, trace.signal_number, 1);
+        }
+    }
+    impl_->compact();
+
+    if (!trace.frames.empty()) {
+        impl_->path_key.clear();
+        size_t depth = std::min(trace.frames.size(), impl_->limits.path_depth);
+        for (size_t i = 0; i < depth; ++i) {
+            if (i > 0) {
+                impl_->path_key += '\n';
+            }
+            impl_->path_key += trace.frames[i].function_name;
+        }
+        impl_->countPath(impl_->path_key, 1, 0);
+    }
+}
+
+void AggregateCallGraph::merge(const AggregateCallGraph& other) {
+    if (&other == this) {
+        return;
+    }
+
+    impl_->traces += other.impl_->traces;
+
+    for (const auto& entry : other.impl_->edges) {
+        uint32_t caller = impl_->symbols.intern(other.impl_->symbols.name(callerOf(entry.first)));
+        uint32_t callee = impl_->symbols.intern(other.impl_->symbols.name(calleeOf(entry.first)));
+        mergeStats(impl_->edges[edgeKey(caller, callee)], entry.second);
+    }
+    impl_->compact();
+
+    // Mergeable Space-Saving: a path missing from one summary may have been
+    // evicted there with up to that summary's minimum count.
+    uint64_t own_min = impl_->minPathCount();
+    uint64_t other_min = other.impl_->minPathCount();
+
+    std::vector<std::pair<std::string, PathCounter>> combined;
+    combined.reserve(impl_->paths.size() + other.impl_->paths.size());
+    for (const auto& entry : impl_->paths) {
+        PathCounter counter = entry.second;
+        auto match = other.impl_->paths.find(entry.first);
+        if (match != other.impl_->paths.end()) {
+            counter.count += match->second.count;
+            counter.error += match->second.error;
+        } else {
+            counter.count += other_min;
+            counter.error += other_min;
+        }
+        combined.emplace_back(entry.first, counter);
+    }
+    for (const auto& entry : other.impl_->paths) {
+        if (impl_->paths.count(entry.first) == 0) {
+            PathCounter counter = entry.second;
+            counter.count += own_min;
+            counter.error += own_min;
+            combined.emplace_back(entry.first, counter);
+        }
+    }
+
+    if (combined.size() > impl_->limits.max_paths) {
+        std::nth_element(combined.begin(), combined.begin() + impl_->limits.max_paths, combined.end(),
+                         [](const auto& a, const auto& b) { return a.second.count > b.second.count; });
+        combined.resize(impl_->limits.max_paths);
+    }
+
+    impl_->paths.clear();
+    impl_->by_count.clear();
+    for (auto& entry : combined) {
+        auto inserted = impl_->paths.emplace(std::move(entry.first), entry.second).first;
+        impl_->by_count.insert({inserted->second.count, &inserted->first});
+    }
+}
+
+std::vector<AggregateEdge> AggregateCallGraph::topEdges(size_t k) const {
+    std::vector<std::pair<uint64_t, uint64_t>> ranked;
+    ranked.reserve(impl_->edges.size());
+    for (const auto& entry : impl_->edges) {
+        ranked.emplace_back(entry.second.count, entry.first);
+    }
+
+    k = std::min(k, ranked.size());
+    // Ties are ordered by name so shards and merged graphs agree.
+    const SymbolTable& symbols = impl_->symbols;
+    std::partial_sort(ranked.begin(), ranked.begin() + k, ranked.end(),
+                      [&symbols](const auto& a, const auto& b) {
+                          if (a.first != b.first) {
+                              return a.first > b.first;
+                          }
+                          auto a_caller = symbols.name(callerOf(a.second));
+                          auto b_caller = symbols.name(callerOf(b.second));
+                          if (a_caller != b_caller) {
+                              return a_caller < b_caller;
+                          }
+                          return symbols.name(calleeOf(a.second)) < symbols.name(calleeOf(b.second));
+                      });
+
+    std::vector<AggregateEdge> result;
+    result.reserve(k);
+    for (size_t i = 0; i < k; ++i) {
+        const EdgeStats& stats = impl_->edges.at(ranked[i].second);
+        AggregateEdge edge;
+        edge.caller = impl_->symbols.name(callerOf(ranked[i].second));
+        edge.callee = impl_->symbols.name(calleeOf(ranked[i].second));
+        edge.count = stats.count;
+        edge.first_seen = stats.first_seen;
+        edge.last_seen = stats.last_seen;
+        edge.signals = stats.signals;
+        std::sort(edge.signals.begin(), edge.signals.end());
+        result.push_back(std::move(edge));
+    }
+    return result;
+}
+
+std::vector<CrashPath> AggregateCallGraph::topPaths(size_t k) const {
+    std::vector<CrashPath> result;
+    for (auto it = impl_->by_count.rbegin(); it != impl_->by_count.rend() && result.size() < k; ++it) {
+        const std::string& key = *it->second;
+        const PathCounter& counter = impl_->paths.at(key);
+
+        CrashPath path;
+        size_t start = 0;
+        while (true) {
+            size_t end = key.find('\n', start);
+            path.functions.push_back(key.substr(start, end - start));
+            if (end == std::string::npos) {
+                break;
+            }
+            start = end + 1;
+        }
+        path.count = counter.count;
+        path.error = counter.error;
+        result.push_back(std::move(path));
+    }
+    return result;
+}
+
+uint64_t AggregateCallGraph::traceCount() const {
+    return impl_->traces;
+}
+
+size_t AggregateCallGraph::edgeCount() const {
+    return impl_->edges.size();
+}
+
+void AggregateCallGraph::clear() {
+    impl_->symbols.clear();
+    impl_->edges.clear();
+    impl_->traces = 0;
+    impl_->paths.clear();
+    impl_->by_count.clear();
+}
+
+} // namespace ai_debugger
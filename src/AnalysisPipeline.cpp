@@ -0,0 +1,206 @@
+#include "ai_debugger/AnalysisPipeline.h"
+#include "ai_debugger/BoundedQueue.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ai_debugger {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+uint64_t nanosecondsSince(Clock::time_point start) {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+}
+
+// One trace on its way through the stages. The call graph travels with the
+// trace because PREDICT and EXPLAIN read the graph CALL_GRAPH built. Jobs
+// are recycled, so graph and string storage is reused like in a Pipeline.
+struct Job {
+    std::string text;
+    DebugSession session;
+    CallGraphAnalyzer graph;
+    uint64_t rules_generation = 0;
+    bool complete = false;  // remaining stages pass it through untouched
+    Clock::time_point submitted;
+};
+
+using JobQueue = BoundedQueue<std::unique_ptr<Job>>;
+
+} // namespace
+
+const char* pipelineStageToString(PipelineStage stage) {
+    switch (stage) {
+        case PipelineStage::PARSE: return "parse";
+        case PipelineStage::CALL_GRAPH: return "call_graph";
+        case PipelineStage::PREDICT: return "predict";
+        case PipelineStage::EXPLAIN: return "explain";
+        case PipelineStage::FIX: return "fix";
+        case PipelineStage::TEST: return "test";
+        default: return "unknown";
+    }
+}
+
+struct AnalysisPipeline::Impl {
+    AIDebugger* debugger = nullptr;
+    std::function<void(DebugSession&&)> on_session;
+    std::mutex deliver_mutex;
+
+    std::vector<std::unique_ptr<JobQueue>> queues;  // queues[s] feeds stage s
+    std::unique_ptr<JobQueue> spare_jobs;
+    std::vector<std::unique_ptr<AIDebugger::Pipeline>> components;  // one per worker
+    std::vector<std::thread> threads;
+    std::array<std::atomic<size_t>, PIPELINE_STAGE_COUNT> running;  // workers left per stage
+    std::once_flag closed;
+
+    std::atomic<uint64_t> submitted{0};
+    std::atomic<uint64_t> completed{0};
+    std::array<Histogram, PIPELINE_STAGE_COUNT> latency;
+    std::array<Histogram, PIPELINE_STAGE_COUNT> depth;
+    Histogram total_latency;
+
+    void process(PipelineStage stage, Job& job, AIDebugger::Pipeline& worker) {
+        if (stage == PipelineStage::PARSE) {
+            job.complete = debugger->beginAnalysis(debugger->parseTrace(job.text, worker), job.session,
+                                                   job.rules_generation);
+            return;
+        }
+        if (job.complete) {
+            return;
+        }
+        debugger->analyzeStage(stage, job.session, job.graph, worker);
+        if (stage == PipelineStage::TEST) {
+            debugger->finishAnalysis(job.session, job.rules_generation);
+        }
+    }
+
+    void run(size_t stage, AIDebugger::Pipeline& worker) {
+        std::unique_ptr<Job> job;
+        while (queues[stage]->pop(job)) {
+            auto start = Clock::now();
+            try {
+                process(static_cast<PipelineStage>(stage), *job, worker);
+            } catch (const std::exception&) {
+                // Delivered as far as it got rather than stalling the stage.
+                job->complete = true;
+            }
+            latency[stage].record(nanosecondsSince(start));
+
+            if (stage + 1 < PIPELINE_STAGE_COUNT) {
+                depth[stage + 1].record(queues[stage + 1]->size());
+                queues[stage + 1]->push(std::move(job));
+            } else {
+                deliver(std::move(job));
+            }
+        }
+
+        // The last worker out lets the next stage drain and stop.
+        if (running[stage].fetch_sub(1) == 1 && stage + 1 < PIPELINE_STAGE_COUNT) {
+            queues[stage + 1]->close();
+        }
+    }
+
+    void deliver(std::unique_ptr<Job> job) {
+        total_latency.record(nanosecondsSince(job->submitted));
+        {
+            std::lock_guard<std::mutex> lock(deliver_mutex);
+            if (on_session) {
+                on_session(std::move(job->session));
+            }
+        }
+        ++completed;
+
+        job->text.clear();
+        job->session = DebugSession();
+        job->complete = false;
+        spare_jobs->tryPush(job);
+    }
+};
+
+AnalysisPipeline::AnalysisPipeline(
+    AIDebugger& debugger,
+    std::function<void(DebugSession&&)> on_session,
+    const PipelineOptions& options
+) : impl_(std::make_unique<Impl>()) {
+    impl_->debugger = &debugger;
+    impl_->on_session = std::move(on_session);
+
+    size_t in_flight = 0;
+    for (size_t stage = 0; stage < PIPELINE_STAGE_COUNT; ++stage) {
+        impl_->queues.push_back(std::make_unique<JobQueue>(std::max<size_t>(options.queue_capacity, 1)));
+        in_flight += impl_->queues.back()->capacity() + std::max<size_t>(options.workers[stage], 1);
+    }
+    impl_->spare_jobs = std::make_unique<JobQueue>(in_flight);
+
+    for (size_t stage = 0; stage < PIPELINE_STAGE_COUNT; ++stage) {
+        size_t workers = std::max<size_t>(options.workers[stage], 1);
+        impl_->running[stage] = workers;
+        for (size_t w = 0; w < workers; ++w) {
+            impl_->components.push_back(debugger.makePipeline());
+            AIDebugger::Pipeline* worker = impl_->components.back().get();
+            impl_->threads.emplace_back([this, stage, worker] { impl_->run(stage, *worker); });
+        }
+    }
+}
+
+AnalysisPipeline::~AnalysisPipeline() {
+    close();
+}
+
+bool AnalysisPipeline::submit(std::string trace_text) {
+    std::unique_ptr<Job> job;
+    if (!impl_->spare_jobs->tryPop(job)) {
+        job = std::make_unique<Job>();
+    }
+    job->text = std::move(trace_text);
+    job->submitted = Clock::now();
+
+    ++impl_->submitted;
+    impl_->depth[0].record(impl_->queues[0]->size());
+    if (!impl_->queues[0]->push(std::move(job))) {
+        --impl_->submitted;
+        return false;
+    }
+    return true;
+}
+
+void AnalysisPipeline::close() {
+    std::call_once(impl_->closed, [this] {
+        impl_->queues[0]->close();
+        for (auto& thread : impl_->threads) {
+            thread.join();
+        }
+    });
+}
+
+uint64_t AnalysisPipeline::submitted() const {
+    return impl_->submitted;
+}
+
+uint64_t AnalysisPipeline::completed() const {
+    return impl_->completed;
+}
+
+size_t AnalysisPipeline::queueDepth(PipelineStage stage) const {
+    return impl_->queues[static_cast<size_t>(stage)]->size();
+}
+
+const Histogram& AnalysisPipeline::queueDepthHistogram(PipelineStage stage) const {
+    return impl_->depth[static_cast<size_t>(stage)];
+}
+
+const Histogram& AnalysisPipeline::latencyHistogram(PipelineStage stage) const {
+    return impl_->latency[static_cast<size_t>(stage)];
+}
+
+const Histogram& AnalysisPipeline::totalLatencyHistogram() const {
+    return impl_->total_latency;
+}
+
+} // namespace ai_debugger
@@ -0,0 +1,532 @@
+#include "ai_debugger/AnalysisServer.h"
+#include "ai_debugger/SessionStore.h"
+#include "ai_debugger/ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/file.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace ai_debugger {
+
+namespace {
+
+struct FrameHeader {
+    uint32_t type;
+    uint32_t size;
+};
+
+static_assert(sizeof(FrameHeader) == 8, "frame header layout changed");
+
+bool setError(std::string* error, const std::string& message) {
+    if (error) {
+        *error = message;
+    }
+    return false;
+}
+
+#ifndef _WIN32
+#ifdef MSG_NOSIGNAL
+const int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+const int SEND_FLAGS = 0;
+#endif
+
+bool sendAll(int fd, const void* data, size_t size) {
+    const char* in = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t n = ::send(fd, in, size, SEND_FLAGS);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        in += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool receiveAll(int fd, void* data, size_t size) {
+    char* out = static_cast<char*>(data);
+    while (size > 0) {
+        ssize_t n = ::recv(fd, out, size, 0);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        out += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool sendFrame(int fd, MessageType type, const std::string& payload) {
+    FrameHeader header{static_cast<uint32_t>(type), static_cast<uint32_t>(payload.size())};
+    return sendAll(fd, &header, sizeof(header)) && sendAll(fd, payload.data(), payload.size());
+}
+
+// False at end of stream or on a frame over max_size, which sets too_large.
+bool receiveFrame(int fd, uint32_t max_size, MessageType& type, std::string& payload,
+                  bool* too_large = nullptr) {
+    FrameHeader header;
+    if (!receiveAll(fd, &header, sizeof(header))) {
+        return false;
+    }
+    if (header.size > max_size) {
+        if (too_large) {
+            *too_large = true;
+        }
+        return false;
+    }
+    type = static_cast<MessageType>(header.type);
+    payload.resize(header.size);
+    return receiveAll(fd, &payload[0], payload.size());
+}
+
+int openSocket() {
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+#if !defined(MSG_NOSIGNAL) && defined(SO_NOSIGPIPE)
+    if (fd >= 0) {
+        int on = 1;
+        ::setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+    }
+#endif
+    if (fd >= 0) {
+        ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+    return fd;
+}
+
+bool socketAddress(const std::string& path, sockaddr_un& address, std::string* error) {
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        return setError(error, "invalid socket path '" + path + "'");
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
+
+bool connectTo(int fd, const sockaddr_un& address) {
+    while (::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        if (errno != EINTR) {
+            return false;
+        }
+    }
+    return true;
+}
+#endif
+
+} // namespace
+
+struct AnalysisServer::Impl {
+    using Clock = std::chrono::steady_clock;
+
+    AnalysisServerOptions options;
+    std::function<std::unique_ptr<AIDebugger>()> make_debugger;
+
+    std::vector<std::unique_ptr<AIDebugger>> debuggers;  // one per pool worker
+    std::unique_ptr<ThreadPool> pool;
+    std::thread acceptor;
+    std::atomic<bool> running{false};
+    std::atomic<uint64_t> requests{0};
+
+    int listen_fd = -1;
+    int lock_fd = -1;  // flock on socket_path + ".lock", held while listening
+    int wake_fds[2] = {-1, -1};  // written by stop() and by workers returning a connection
+
+    // Connections waiting for their next request are polled by the acceptor,
+    // keyed to when they last finished one; a worker only holds a connection
+    // while it serves a request.
+    std::mutex connections_mutex;
+    std::unordered_map<int, Clock::time_point> idle;
+    std::unordered_set<int> busy;
+
+#ifndef _WIN32
+    void wake() {
+        char byte = 1;
+        while (::write(wake_fds[1], &byte, 1) < 0 && errno == EINTR) {
+        }
+    }
+
+    void acceptLoop() {
+        std::vector<pollfd> fds;
+        while (running) {
+            fds.assign({{listen_fd, POLLIN, 0}, {wake_fds[0], POLLIN, 0}});
+            int timeout = pollIdleConnections(fds);
+            if (::poll(fds.data(), fds.size(), timeout) < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                break;
+            }
+            if (fds[1].revents) {
+                char drain[64];
+                while (::read(wake_fds[0], drain, sizeof(drain)) > 0) {
+                }
+                if (!running) {
+                    break;
+                }
+            }
+            for (size_t i = 2; i < fds.size(); ++i) {
+                if (fds[i].revents) {
+                    dispatch(fds[i].fd);
+                }
+            }
+            if (fds[0].revents & POLLIN) {
+                acceptConnection();
+            }
+        }
+    }
+
+    // Closes connections idle past the timeout and adds the others to `fds`.
+    // Returns the poll timeout until the next one expires.
+    int pollIdleConnections(std::vector<pollfd>& fds) {
+        auto now = Clock::now();
+        auto limit = std::chrono::milliseconds(options.idle_timeout_ms);
+        int timeout = -1;
+        std::lock_guard<std::mutex> lock(connections_mutex);
+        for (auto it = idle.begin(); it != idle.end();) {
+            if (options.idle_timeout_ms > 0 && now - it->second >= limit) {
+                ::close(it->first);
+                it = idle.erase(it);
+                continue;
+            }
+            fds.push_back({it->first, POLLIN, 0});
+            if (options.idle_timeout_ms > 0) {
+                auto left = std::chrono::duration_cast<std::chrono::milliseconds>(it->second + limit - now);
+                int ms = static_cast<int>(left.count()) + 1;
+                timeout = timeout < 0 ? ms : std::min(timeout, ms);
+            }
+            ++it;
+        }
+        return timeout;
+    }
+
+    void acceptConnection() {
+        int fd = ::accept(listen_fd, nullptr, nullptr);
+        if (fd < 0) {
+            return;
+        }
+        ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+        if (options.request_timeout_ms > 0) {
+            timeval limit;
+            limit.tv_sec = static_cast<time_t>(options.request_timeout_ms / 1000);
+            limit.tv_usec = static_cast<suseconds_t>(options.request_timeout_ms % 1000 * 1000);
+            ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &limit, sizeof(limit));
+            ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &limit, sizeof(limit));
+        }
+        std::lock_guard<std::mutex> lock(connections_mutex);
+        idle[fd] = Clock::now();
+    }
+
+    // Hands a connection with a request (or a hangup) waiting to a worker.
+    void dispatch(int fd) {
+        {
+            std::lock_guard<std::mutex> lock(connections_mutex);
+            idle.erase(fd);
+            busy.insert(fd);
+        }
+        pool->submit([this, fd](size_t worker) {
+            bool keep = serve(fd, *debuggers[worker]);
+            std::lock_guard<std::mutex> lock(connections_mutex);
+            busy.erase(fd);
+            if (keep && running) {
+                idle[fd] = Clock::now();
+                wake();
+            } else {
+                ::close(fd);
+            }
+        });
+    }
+
+    // Answers one request. False when the connection is done: closed by the
+    // client, timed out, broken, or sent a request that is too large.
+    bool serve(int fd, AIDebugger& debugger) {
+        MessageType type;
+        std::string payload;
+        std::string response;
+        bool too_large = false;
+        if (!receiveFrame(fd, options.max_frame_size, type, payload, &too_large)) {
+            if (too_large) {
+                sendFrame(fd, MessageType::FAILURE,
+                          "request exceeds " + std::to_string(options.max_frame_size) + " bytes");
+            }
+            return false;
+        }
+
+        ++requests;
+        MessageType reply = MessageType::FAILURE;
+        try {
+            switch (type) {
+            case MessageType::PING:
+                reply = MessageType::PONG;
+                break;
+            case MessageType::ANALYZE: {
+                // The client has no generators to fill in pending parts, so
+                // they are computed here and the session arrives complete.
+                DebugSession session = debugger.analyzeStackTrace(payload);
+                session.getExplanation();
+                session.getSuggestedFixes();
+                session.getRegressionTests();
+                serializeSession(session, response);
+                reply = MessageType::SESSION;
+                break;
+            }
+            case MessageType::REPORT:
+                response = debugger.getReport(debugger.analyzeStackTrace(payload));
+                reply = MessageType::REPORT_TEXT;
+                break;
+            default:
+                response = "unknown request type " + std::to_string(static_cast<uint32_t>(type));
+                break;
+            }
+        } catch (const std::exception& e) {
+            reply = MessageType::FAILURE;
+            response = std::string("analysis failed: ") + e.what();
+        }
+        return sendFrame(fd, reply, response);
+    }
+#endif
+};
+
+AnalysisServer::AnalysisServer(
+    const AnalysisServerOptions& options,
+    std::function<std::unique_ptr<AIDebugger>()> make_debugger
+) : impl_(std::make_unique<Impl>()) {
+    impl_->options = options;
+    impl_->make_debugger = std::move(make_debugger);
+}
+
+AnalysisServer::~AnalysisServer() {
+    stop();
+}
+
+bool AnalysisServer::start(std::string* error) {
+#ifdef _WIN32
+    return setError(error, "the analysis server needs Unix domain sockets");
+#else
+    if (impl_->running) {
+        return setError(error, "already running");
+    }
+
+    sockaddr_un address;
+    if (!socketAddress(impl_->options.socket_path, address, error)) {
+        return false;
+    }
+
+    // Whoever holds the lock owns the socket file, so a file found while
+    // holding it is stale and can be replaced without racing another start.
+    std::string lock_path = impl_->options.socket_path + ".lock";
+    int lock_fd = ::open(lock_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (lock_fd < 0) {
+        return setError(error, "cannot open " + lock_path + ": " + std::strerror(errno));
+    }
+    if (::flock(lock_fd, LOCK_EX | LOCK_NB) != 0) {
+        ::close(lock_fd);
+        return setError(error, "a server is already listening on " + impl_->options.socket_path);
+    }
+    ::unlink(address.sun_path);
+
+    int fd = openSocket();
+    if (fd < 0 || ::bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(fd, SOMAXCONN) != 0) {
+        std::string reason = std::strerror(errno);
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        ::close(lock_fd);
+        return setError(error, "cannot listen on " + impl_->options.socket_path + ": " + reason);
+    }
+    if (::pipe(impl_->wake_fds) != 0) {
+        ::close(fd);
+        ::unlink(address.sun_path);
+        ::close(lock_fd);
+        return setError(error, "cannot create wake pipe");
+    }
+    for (int wake_fd : impl_->wake_fds) {
+        ::fcntl(wake_fd, F_SETFL, ::fcntl(wake_fd, F_GETFL) | O_NONBLOCK);
+        ::fcntl(wake_fd, F_SETFD, FD_CLOEXEC);
+    }
+    impl_->listen_fd = fd;
+    impl_->lock_fd = lock_fd;
+
+    impl_->pool = std::make_unique<ThreadPool>(impl_->options.threads);
+    while (impl_->debuggers.size() < impl_->pool->size()) {
+        impl_->debuggers.push_back(impl_->make_debugger());
+    }
+
+    impl_->running = true;
+    impl_->acceptor = std::thread([this] { impl_->acceptLoop(); });
+    return true;
+#endif
+}
+
+void AnalysisServer::stop() {
+#ifndef _WIN32
+    if (!impl_->running.exchange(false)) {
+        return;
+    }
+
+    impl_->wake();
+    impl_->acceptor.join();
+
+    ::close(impl_->listen_fd);
+    ::unlink(impl_->options.socket_path.c_str());
+    impl_->listen_fd = -1;
+    // The lock file itself stays: unlinking it would let a later start lock
+    // a fresh file while another still holds the old one.
+    ::close(impl_->lock_fd);
+    impl_->lock_fd = -1;
+
+    // Idle connections are closed here; ones being served are cut short and
+    // closed by their worker.
+    {
+        std::lock_guard<std::mutex> lock(impl_->connections_mutex);
+        for (const auto& connection : impl_->idle) {
+            ::close(connection.first);
+        }
+        impl_->idle.clear();
+        for (int fd : impl_->busy) {
+            ::shutdown(fd, SHUT_RDWR);
+        }
+    }
+    impl_->pool.reset();
+
+    ::close(impl_->wake_fds[0]);
+    ::close(impl_->wake_fds[1]);
+    impl_->wake_fds[0] = impl_->wake_fds[1] = -1;
+#endif
+}
+
+bool AnalysisServer::isRunning() const {
+    return impl_->running;
+}
+
+uint64_t AnalysisServer::requestCount() const {
+    return impl_->requests;
+}
+
+struct AnalysisClient::Impl {
+    AnalysisClientOptions options;
+    int fd = -1;
+
+    bool request(MessageType type, const std::string& payload, MessageType expected,
+                 std::string& response, std::string* error) {
+#ifdef _WIN32
+        return setError(error, "the analysis server needs Unix domain sockets");
+#else
+        if (fd < 0) {
+            return setError(error, "not connected");
+        }
+        // A send can fail because the server refused the request and hung up
+        // mid-frame; its FAILURE reply is then already waiting to be read.
+        MessageType reply;
+        bool too_large = false;
+        bool sent = sendFrame(fd, type, payload);
+        bool received = receiveFrame(fd, options.max_reply_size, reply, response, &too_large);
+        if (!sent || !received) {
+            ::close(fd);
+            fd = -1;
+            if (too_large) {
+                return setError(error, "reply exceeds " + std::to_string(options.max_reply_size) + " bytes");
+            }
+            if (!received || reply != MessageType::FAILURE) {
+                return setError(error, "connection to the analysis server lost");
+            }
+        }
+        if (reply == MessageType::FAILURE) {
+            return setError(error, response);
+        }
+        if (reply != expected) {
+            return setError(error, "unexpected response type " + std::to_string(static_cast<uint32_t>(reply)));
+        }
+        return true;
+#endif
+    }
+};
+
+AnalysisClient::AnalysisClient(const AnalysisClientOptions& options) : impl_(std::make_unique<Impl>()) {
+    impl_->options = options;
+}
+
+AnalysisClient::~AnalysisClient() {
+    close();
+}
+
+bool AnalysisClient::connect(const std::string& socket_path, std::string* error) {
+    close();
+#ifdef _WIN32
+    return setError(error, "the analysis server needs Unix domain sockets");
+#else
+    sockaddr_un address;
+    if (!socketAddress(socket_path, address, error)) {
+        return false;
+    }
+    int fd = openSocket();
+    if (fd < 0 || !connectTo(fd, address)) {
+        std::string reason = std::strerror(errno);
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        return setError(error, "cannot connect to " + socket_path + ": " + reason);
+    }
+    impl_->fd = fd;
+    return true;
+#endif
+}
+
+void AnalysisClient::close() {
+#ifndef _WIN32
+    if (impl_->fd >= 0) {
+        ::close(impl_->fd);
+    }
+#endif
+    impl_->fd = -1;
+}
+
+bool AnalysisClient::isConnected() const {
+    return impl_->fd >= 0;
+}
+
+bool AnalysisClient::ping(std::string* error) {
+    std::string response;
+    return impl_->request(MessageType::PING, std::string(), MessageType::PONG, response, error);
+}
+
+bool AnalysisClient::analyze(const std::string& trace_text, DebugSession& out, std::string* error) {
+    std::string response;
+    if (!impl_->request(MessageType::ANALYZE, trace_text, MessageType::SESSION, response, error)) {
+        return false;
+    }
+    if (!deserializeSession(response, out)) {
+        return setError(error, "malformed session from the analysis server");
+    }
+    return true;
+}
+
+bool AnalysisClient::report(const std::string& trace_text, std::string& out, std::string* error) {
+    return impl_->request(MessageType::REPORT, trace_text, MessageType::REPORT_TEXT, out, error);
+}
+
+} // namespace ai_debugger
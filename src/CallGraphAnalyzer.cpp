@@ -1,46 +1,270 @@
 #include "ai_debugger/CallGraphAnalyzer.h"
+#include "ai_debugger/SymbolTable.h"
+#include "ai_debugger/CrashSignature.h"
+#include "ai_debugger/KeywordMatcher.h"
 #include <algorithm>
-#include <queue>
-#include <set>
 #include <sstream>
 
 namespace ai_debugger {
 
+namespace {
+
+struct IdRange {
+    const uint32_t* first;
+    const uint32_t* last;
+
+    const uint32_t* begin() const { return first; }
+    const uint32_t* end() const { return last; }
+};
+
+// Compressed sparse row adjacency: the neighbours of node n are
+// targets[offsets[n] .. offsets[n + 1]).
+struct Adjacency {
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> targets;
+
+    IdRange of(uint32_t node) const {
+        return {targets.data() + offsets[node], targets.data() + offsets[node + 1]};
+    }
+
+    void clear() {
+        offsets.clear();
+        targets.clear();
+    }
+};
+
+} // namespace
+
 struct CallGraphAnalyzer::Impl {
-    std::map<std::string, CallGraphNode> nodes;
+    // All storage is rewound, not freed, between builds, so rebuilding graphs
+    // of similar size allocates nothing once warmed up.
+    struct NodeInfo {
+        std::string_view file;
+        int line;
+        int column;
+        int depth;  // -1 until the node's own frame has been seen
+        bool is_library_function;
+    };
+
+    SymbolTable symbols;
+    std::vector<NodeInfo> nodes;
+    StringArena files;
+
+    // (caller, callee) pairs gathered while walking frames, then compacted
+    // into deduplicated CSR form by finalize().
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+    Adjacency callees;
+    Adjacency callers;
+
+    // Node ids in name order, so iteration matches the old std::map layout.
+    std::vector<uint32_t> order;
+
     std::vector<CallPattern> patterns;
     std::string intent_summary;
 
-    void addEdge(const std::string& from, const std::string& to) {
-        if (nodes.find(from) == nodes.end()) {
-            nodes[from] = CallGraphNode();
-            nodes[from].function_name = from;
-        }
-        if (nodes.find(to) == nodes.end()) {
-            nodes[to] = CallGraphNode();
-            nodes[to].function_name = to;
+    // Strongly connected components of the callee graph.
+    std::vector<uint32_t> component;
+    std::vector<char> cyclic;
+
+    // Scratch for findComponents() and findCycle(), kept between builds.
+    std::vector<uint32_t> index;
+    std::vector<uint32_t> lowlink;
+    std::vector<char> on_stack;
+    std::vector<uint32_t> tarjan_stack;
+    std::vector<std::pair<uint32_t, uint32_t>> call_stack;
+    std::vector<uint32_t> parent;
+    std::vector<uint32_t> queue;
+    std::vector<uint32_t> chain;
+    std::vector<char> reported;
+
+    size_t nodeCount() const {
+        return symbols.size();
+    }
+
+    void reset() {
+        symbols.clear();
+        nodes.clear();
+        files.clear();
+        edges.clear();
+        callees.clear();
+        callers.clear();
+        order.clear();
+        component.clear();
+        cyclic.clear();
+        patterns.clear();
+        intent_summary.clear();
+    }
+
+    uint32_t find(std::string_view name) const {
+        return symbols.find(name);
+    }
+
+    uint32_t intern(std::string_view name) {
+        uint32_t id = symbols.intern(name);
+        if (id == nodes.size()) {
+            nodes.push_back(NodeInfo{std::string_view(), 0, 0, -1, false});
         }
+        return id;
+    }
 
-        nodes[from].callees.push_back(to);
-        nodes[to].callers.push_back(from);
+    void addEdge(uint32_t from, uint32_t to) {
+        edges.emplace_back(from, to);
     }
 
-    bool hasPath(const std::string& from, const std::string& to, std::set<std::string>& visited) {
-        if (from == to) return true;
-        if (visited.count(from)) return false;
+    void finalize() {
+        std::sort(edges.begin(), edges.end());
+        edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
 
-        visited.insert(from);
+        size_t count = nodeCount();
+        callees.offsets.assign(count + 1, 0);
+        callers.offsets.assign(count + 1, 0);
+        for (const auto& edge : edges) {
+            ++callees.offsets[edge.first + 1];
+            ++callers.offsets[edge.second + 1];
+        }
+        for (size_t n = 0; n < count; ++n) {
+            callees.offsets[n + 1] += callees.offsets[n];
+            callers.offsets[n + 1] += callers.offsets[n];
+        }
+
+        // Edges are sorted by caller, so callee lists fill in order; caller
+        // lists are scattered using a running cursor per callee.
+        callees.targets.resize(edges.size());
+        callers.targets.resize(edges.size());
+        for (size_t e = 0; e < edges.size(); ++e) {
+            callees.targets[e] = edges[e].second;
+        }
+        order.assign(callers.offsets.begin(), callers.offsets.end() - 1);
+        for (const auto& edge : edges) {
+            callers.targets[order[edge.second]++] = edge.first;
+        }
+
+        order.resize(count);
+        for (uint32_t id = 0; id < count; ++id) {
+            order[id] = id;
+        }
+        std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+            return symbols.name(a) < symbols.name(b);
+        });
+    }
 
-        auto it = nodes.find(from);
-        if (it == nodes.end()) return false;
+    CallGraphNode materialize(uint32_t id) const {
+        const NodeInfo& info = nodes[id];
+        CallGraphNode node;
+        node.function_name = symbols.name(id);
+        node.location.file = info.file;
+        node.location.line = info.line;
+        node.location.column = info.column;
+        node.depth = std::max(info.depth, 0);
+        node.is_library_function = info.is_library_function;
+        for (uint32_t caller : callers.of(id)) {
+            node.callers.emplace_back(symbols.name(caller));
+        }
+        for (uint32_t callee : callees.of(id)) {
+            node.callees.emplace_back(symbols.name(callee));
+        }
+        return node;
+    }
 
-        for (const auto& callee : it->second.callees) {
-            if (hasPath(callee, to, visited)) {
-                return true;
+    // Tarjan's algorithm, iteratively so deep traces cannot overflow the
+    // stack. Fills `component` and marks components that contain a cycle:
+    // more than one node, or a single node calling itself.
+    void findComponents() {
+        size_t count = nodeCount();
+        index.assign(count, SymbolTable::npos);
+        lowlink.resize(count);
+        on_stack.assign(count, 0);
+        component.assign(count, SymbolTable::npos);
+        cyclic.clear();
+        tarjan_stack.clear();
+        call_stack.clear();
+
+        uint32_t next_index = 0;
+        auto visit = [&](uint32_t node) {
+            index[node] = lowlink[node] = next_index++;
+            tarjan_stack.push_back(node);
+            on_stack[node] = 1;
+            call_stack.emplace_back(node, callees.offsets[node]);
+        };
+
+        for (uint32_t root = 0; root < count; ++root) {
+            if (index[root] != SymbolTable::npos) {
+                continue;
+            }
+            visit(root);
+
+            while (!call_stack.empty()) {
+                uint32_t node = call_stack.back().first;
+                uint32_t& edge = call_stack.back().second;
+
+                if (edge < callees.offsets[node + 1]) {
+                    uint32_t callee = callees.targets[edge++];
+                    if (index[callee] == SymbolTable::npos) {
+                        visit(callee);
+                    } else if (on_stack[callee]) {
+                        lowlink[node] = std::min(lowlink[node], index[callee]);
+                    }
+                    continue;
+                }
+
+                call_stack.pop_back();
+                if (!call_stack.empty()) {
+                    uint32_t parent = call_stack.back().first;
+                    lowlink[parent] = std::min(lowlink[parent], lowlink[node]);
+                }
+
+                if (lowlink[node] == index[node]) {
+                    uint32_t id = static_cast<uint32_t>(cyclic.size());
+                    size_t size = 0;
+                    uint32_t member;
+                    do {
+                        member = tarjan_stack.back();
+                        tarjan_stack.pop_back();
+                        on_stack[member] = 0;
+                        component[member] = id;
+                        ++size;
+                    } while (member != node);
+
+                    IdRange own = callees.of(node);
+                    cyclic.push_back(size > 1 || std::binary_search(own.begin(), own.end(), node));
+                }
             }
         }
+    }
 
-        return false;
+    bool isRecursive(uint32_t id) const {
+        return id < component.size() && cyclic[component[id]];
+    }
+
+    // Shortest cycle from `start` back to itself, found by a BFS confined to
+    // start's component. `parent` must hold npos for every node of that
+    // component on entry.
+    void findCycle(uint32_t start, std::vector<uint32_t>& parent,
+                   std::vector<uint32_t>& queue, std::vector<uint32_t>& chain) const {
+        chain.clear();
+        queue.clear();
+        queue.push_back(start);
+        parent[start] = start;
+
+        uint32_t scc = component[start];
+        for (size_t head = 0; head < queue.size(); ++head) {
+            uint32_t node = queue[head];
+            for (uint32_t callee : callees.of(node)) {
+                if (callee == start) {
+                    for (uint32_t step = node; step != start; step = parent[step]) {
+                        chain.push_back(step);
+                    }
+                    chain.push_back(start);
+                    std::reverse(chain.begin(), chain.end());
+                    chain.push_back(start);
+                    return;
+                }
+                if (component[callee] == scc && parent[callee] == SymbolTable::npos) {
+                    parent[callee] = node;
+                    queue.push_back(callee);
+                }
+            }
+        }
     }
 };
 
@@ -48,50 +272,69 @@ CallGraphAnalyzer::CallGraphAnalyzer() : impl_(std::make_unique<Impl>()) {}
 
 CallGraphAnalyzer::~CallGraphAnalyzer() = default;
 
-void CallGraphAnalyzer::buildFromStackTrace(const StackTrace& trace) {
-    for (size_t i = 0; i < trace.frames.size(); ++i) {
-        const auto& frame = trace.frames[i];
-
-        CallGraphNode node;
-        node.function_name = frame.function_name;
-        node.location = frame.location;
-        node.depth = static_cast<int>(i);
+void CallGraphAnalyzer::reset() {
+    impl_->reset();
+}
 
-        node.is_library_function =
-            frame.function_name.find("std::") == 0 ||
-            frame.function_name.find("__") == 0 ||
-            frame.location.file.find("/usr/") == 0 ||
-            frame.location.file.find("C:\\Program Files") == 0;
+template <typename Trace>
+void CallGraphAnalyzer::buildFrom(const Trace& trace) {
+    impl_->reset();
 
-        impl_->nodes[frame.function_name] = node;
+    for (size_t i = 0; i < trace.frames.size(); ++i) {
+        const auto& frame = trace.frames[i];
+        uint32_t id = impl_->intern(frame.function_name);
+
+        // The innermost frame of a repeated function provides its location.
+        auto& node = impl_->nodes[id];
+        if (node.depth < 0) {
+            node.file = impl_->files.store(frame.location.file);
+            node.line = frame.location.line;
+            node.column = frame.location.column;
+            node.depth = static_cast<int>(i);
+
+            node.is_library_function =
+                isLibraryFunction(frame.function_name, frame.location.file);
+        }
 
         if (i + 1 < trace.frames.size()) {
-            const auto& caller_frame = trace.frames[i + 1];
-            impl_->addEdge(caller_frame.function_name, frame.function_name);
+            uint32_t caller = impl_->intern(trace.frames[i + 1].function_name);
+            impl_->addEdge(caller, id);
         }
     }
 
+    impl_->finalize();
+
     analyzeRecursion();
     detectCommonPatterns();
     classifyFunctions();
 }
 
+void CallGraphAnalyzer::buildFromStackTrace(const StackTrace& trace) {
+    buildFrom(trace);
+}
+
+void CallGraphAnalyzer::buildFromStackTrace(const StackTraceView& trace) {
+    buildFrom(trace);
+}
+
 void CallGraphAnalyzer::buildFromSource(const std::string& source_path) {
+    impl_->reset();
     impl_->intent_summary = "Source analysis requires LLVM/Clang integration";
 }
 
 std::vector<CallGraphNode> CallGraphAnalyzer::getNodes() const {
     std::vector<CallGraphNode> result;
-    for (const auto& pair : impl_->nodes) {
-        result.push_back(pair.second);
+    result.reserve(impl_->order.size());
+    for (uint32_t id : impl_->order) {
+        result.push_back(impl_->materialize(id));
     }
     return result;
 }
 
 std::optional<CallGraphNode> CallGraphAnalyzer::getNode(const std::string& function) const {
-    auto it = impl_->nodes.find(function);
-    if (it != impl_->nodes.end()) {
-        return it->second;
+    uint32_t id = impl_->find(function);
+    if (id != SymbolTable::npos) {
+        return impl_->materialize(id);
     }
     return std::nullopt;
 }
@@ -102,71 +345,43 @@ std::vector<CallPattern> CallGraphAnalyzer::detectPatterns() const {
 
 std::vector<std::string> CallGraphAnalyzer::findCriticalPath() const {
     std::vector<std::string> path;
-    for (const auto& pair : impl_->nodes) {
-        if (!pair.second.is_library_function) {
-            path.push_back(pair.first);
+    for (uint32_t id : impl_->order) {
+        if (!impl_->nodes[id].is_library_function) {
+            path.emplace_back(impl_->symbols.name(id));
         }
     }
     return path;
 }
 
 int CallGraphAnalyzer::getCallDepth(const std::string& function) const {
-    auto it = impl_->nodes.find(function);
-    if (it != impl_->nodes.end()) {
-        return it->second.depth;
+    uint32_t id = impl_->find(function);
+    if (id != SymbolTable::npos) {
+        return std::max(impl_->nodes[id].depth, 0);
     }
     return -1;
 }
 
 bool CallGraphAnalyzer::isRecursive(const std::string& function) const {
-    std::set<std::string> visited;
-    auto it = impl_->nodes.find(function);
-    if (it == impl_->nodes.end()) return false;
-
-    for (const auto& callee : it->second.callees) {
-        visited.clear();
-        if (impl_->hasPath(callee, function, visited)) {
-            return true;
-        }
-    }
-
-    return false;
+    uint32_t id = impl_->find(function);
+    return id != SymbolTable::npos && impl_->isRecursive(id);
 }
 
 std::vector<std::string> CallGraphAnalyzer::getRecursionChain(const std::string& function) const {
     std::vector<std::string> chain;
 
-    if (!isRecursive(function)) {
+    uint32_t start = impl_->find(function);
+    if (start == SymbolTable::npos || !impl_->isRecursive(start)) {
         return chain;
     }
 
-    std::set<std::string> visited;
-    std::queue<std::vector<std::string>> paths;
-    paths.push({function});
-
-    while (!paths.empty()) {
-        auto current_path = paths.front();
-        paths.pop();
+    std::vector<uint32_t> parent(impl_->nodeCount(), SymbolTable::npos);
+    std::vector<uint32_t> queue;
+    std::vector<uint32_t> cycle;
+    impl_->findCycle(start, parent, queue, cycle);
 
-        std::string current = current_path.back();
-
-        if (current_path.size() > 1 && current == function) {
-            return current_path;
-        }
-
-        if (visited.count(current)) continue;
-        visited.insert(current);
-
-        auto it = impl_->nodes.find(current);
-        if (it != impl_->nodes.end()) {
-            for (const auto& callee : it->second.callees) {
-                auto new_path = current_path;
-                new_path.push_back(callee);
-                paths.push(new_path);
-            }
-        }
+    for (uint32_t id : cycle) {
+        chain.emplace_back(impl_->symbols.name(id));
     }
-
     return chain;
 }
 
@@ -176,11 +391,11 @@ std::string CallGraphAnalyzer::getIntentSummary() const {
     }
 
     std::ostringstream oss;
-    oss << "Call graph contains " << impl_->nodes.size() << " functions. ";
+    oss << "Call graph contains " << impl_->nodeCount() << " functions. ";
 
     int user_functions = 0;
-    for (const auto& pair : impl_->nodes) {
-        if (!pair.second.is_library_function) {
+    for (size_t id = 0; id < impl_->nodeCount(); ++id) {
+        if (!impl_->nodes[id].is_library_function) {
             user_functions++;
         }
     }
@@ -191,28 +406,42 @@ std::string CallGraphAnalyzer::getIntentSummary() const {
 }
 
 void CallGraphAnalyzer::analyzeRecursion() {
-    for (const auto& pair : impl_->nodes) {
-        if (isRecursive(pair.first)) {
-            CallPattern pattern;
-            pattern.pattern_type = "RECURSION";
-            pattern.functions = getRecursionChain(pair.first);
-            pattern.confidence = 0.9;
-            pattern.description = "Recursive call pattern detected in " + pair.first;
-            impl_->patterns.push_back(pattern);
+    impl_->findComponents();
+    impl_->parent.assign(impl_->nodeCount(), SymbolTable::npos);
+    impl_->reported.assign(impl_->cyclic.size(), 0);
+
+    // One pattern per recursive component, reported at its first function in
+    // name order. Each BFS stays inside its component, so the whole pass is
+    // linear in the size of the graph.
+    for (uint32_t id : impl_->order) {
+        uint32_t scc = impl_->component[id];
+        if (!impl_->cyclic[scc] || impl_->reported[scc]) {
+            continue;
         }
+        impl_->reported[scc] = 1;
+
+        impl_->findCycle(id, impl_->parent, impl_->queue, impl_->chain);
+
+        std::string name(impl_->symbols.name(id));
+        CallPattern pattern;
+        pattern.pattern_type = "RECURSION";
+        for (uint32_t step : impl_->chain) {
+            pattern.functions.emplace_back(impl_->symbols.name(step));
+        }
+        pattern.confidence = 0.9;
+        pattern.description = "Recursive call pattern detected in " + name;
+        impl_->patterns.push_back(pattern);
     }
 }
 
 void CallGraphAnalyzer::detectCommonPatterns() {
-    std::set<std::string> alloc_functions = {"malloc", "calloc", "new", "new[]"};
-    std::set<std::string> dealloc_functions = {"free", "delete", "delete[]"};
-
     bool has_alloc = false;
     bool has_dealloc = false;
 
-    for (const auto& pair : impl_->nodes) {
-        if (alloc_functions.count(pair.first)) has_alloc = true;
-        if (dealloc_functions.count(pair.first)) has_dealloc = true;
+    for (uint32_t id : impl_->order) {
+        uint32_t keywords = functionKeywords(impl_->symbols.name(id));
+        has_alloc |= (keywords & ALLOCATOR) != 0;
+        has_dealloc |= (keywords & DEALLOCATOR) != 0;
     }
 
     if (has_alloc && !has_dealloc) {
@@ -225,14 +454,13 @@ void CallGraphAnalyzer::detectCommonPatterns() {
 }
 
 void CallGraphAnalyzer::classifyFunctions() {
-    for (auto& pair : impl_->nodes) {
-        auto& node = pair.second;
+    for (uint32_t id : impl_->order) {
+        std::string_view name = impl_->symbols.name(id);
 
-        if (node.function_name.find("lock") != std::string::npos ||
-            node.function_name.find("mutex") != std::string::npos) {
+        if (functionKeywords(name) & LOCKING) {
             CallPattern pattern;
             pattern.pattern_type = "SYNCHRONIZATION";
-            pattern.functions.push_back(node.function_name);
+            pattern.functions.emplace_back(name);
             pattern.confidence = 0.8;
             pattern.description = "Synchronization primitive usage detected";
             impl_->patterns.push_back(pattern);
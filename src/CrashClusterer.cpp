@@ -0,0 +1,230 @@
+#include "ai_debugger/CrashClusterer.h"
+#include "ai_debugger/CrashSignature.h"
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+
+namespace ai_debugger {
+
+namespace {
+
+uint64_t splitmix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+struct Scratch {
+    std::string normalized;
+    std::vector<uint64_t> frame_hashes;
+    std::vector<uint64_t> shingles;
+    std::vector<uint32_t> signature;
+    std::vector<uint32_t> candidates;
+};
+
+struct ClusterRecord {
+    uint64_t size = 0;
+    std::vector<std::string> frames;
+};
+
+} // namespace
+
+struct CrashClusterer::Impl {
+    ClusterOptions options;
+    size_t rows;
+
+    // Multiply-shift hash family: h_i(x) = (a_i * x + b_i) >> 32.
+    std::vector<uint64_t> multipliers;
+    std::vector<uint64_t> offsets;
+
+    std::vector<ClusterRecord> clusters;
+    std::vector<uint32_t> signatures;  // clusters.size() * num_hashes
+    std::unordered_map<uint64_t, std::vector<uint32_t>> buckets;
+
+    Scratch scratch;
+
+    explicit Impl(const ClusterOptions& opts) : options(opts) {
+        options.num_hashes = std::max<size_t>(options.num_hashes, 1);
+        options.bands = std::clamp<size_t>(options.bands, 1, options.num_hashes);
+        options.shingle_size = std::max<size_t>(options.shingle_size, 1);
+        rows = options.num_hashes / options.bands;
+
+        multipliers.resize(options.num_hashes);
+        offsets.resize(options.num_hashes);
+        for (size_t i = 0; i < options.num_hashes; ++i) {
+            multipliers[i] = splitmix64(2 * i + 1) | 1;
+            offsets[i] = splitmix64(2 * i + 2);
+        }
+    }
+
+    // Fills scratch.signature for the trace's user frames and, if `frames` is
+    // given, their normalized names.
+    void sign(const StackTrace& trace, Scratch& work, std::vector<std::string>* frames) const {
+        bool has_user_frame = std::any_of(trace.frames.begin(), trace.frames.end(), [](const StackFrame& f) {
+            return !isLibraryFunction(f.function_name, f.location.file);
+        });
+
+        work.frame_hashes.clear();
+        for (const auto& frame : trace.frames) {
+            if (work.frame_hashes.size() == options.max_frames) {
+                break;
+            }
+            if (has_user_frame && isLibraryFunction(frame.function_name, frame.location.file)) {
+                continue;
+            }
+            normalizeFunctionName(frame.function_name, work.normalized);
+            work.frame_hashes.push_back(fnv1a(work.normalized));
+            if (frames && frames->size() < 8) {
+                frames->push_back(work.normalized);
+            }
+        }
+
+        work.shingles.clear();
+        size_t k = std::min(options.shingle_size, std::max<size_t>(work.frame_hashes.size(), 1));
+        for (size_t i = 0; i + k <= work.frame_hashes.size(); ++i) {
+            uint64_t shingle = k;
+            for (size_t j = 0; j < k; ++j) {
+                shingle = splitmix64(shingle ^ work.frame_hashes[i + j]);
+            }
+            work.shingles.push_back(shingle);
+        }
+
+        work.signature.assign(options.num_hashes, std::numeric_limits<uint32_t>::max());
+        for (uint64_t shingle : work.shingles) {
+            for (size_t h = 0; h < options.num_hashes; ++h) {
+                uint32_t value = static_cast<uint32_t>((multipliers[h] * shingle + offsets[h]) >> 32);
+                work.signature[h] = std::min(work.signature[h], value);
+            }
+        }
+    }
+
+    uint64_t bandKey(const std::vector<uint32_t>& signature, size_t band) const {
+        uint64_t key = splitmix64(band);
+        for (size_t r = 0; r < rows; ++r) {
+            key = splitmix64(key ^ signature[band * rows + r]);
+        }
+        return key;
+    }
+
+    double similarity(const std::vector<uint32_t>& signature, uint32_t cluster) const {
+        const uint32_t* other = signatures.data() + static_cast<size_t>(cluster) * options.num_hashes;
+        size_t equal = 0;
+        for (size_t h = 0; h < options.num_hashes; ++h) {
+            equal += signature[h] == other[h];
+        }
+        return static_cast<double>(equal) / options.num_hashes;
+    }
+
+    std::optional<ClusterAssignment> nearest(Scratch& work) const {
+        work.candidates.clear();
+        for (size_t band = 0; band < options.bands; ++band) {
+            auto it = buckets.find(bandKey(work.signature, band));
+            if (it != buckets.end()) {
+                work.candidates.insert(work.candidates.end(), it->second.begin(), it->second.end());
+            }
+        }
+        std::sort(work.candidates.begin(), work.candidates.end());
+        work.candidates.erase(std::unique(work.candidates.begin(), work.candidates.end()),
+                              work.candidates.end());
+
+        std::optional<ClusterAssignment> best;
+        for (uint32_t cluster : work.candidates) {
+            double score = similarity(work.signature, cluster);
+            if (score >= options.similarity_threshold && (!best || score > best->similarity)) {
+                ClusterAssignment assignment;
+                assignment.cluster_id = cluster;
+                assignment.similarity = score;
+                best = assignment;
+            }
+        }
+        return best;
+    }
+
+    CrashCluster materialize(uint32_t id) const {
+        CrashCluster cluster;
+        cluster.id = id;
+        cluster.size = clusters[id].size;
+        cluster.frames = clusters[id].frames;
+        return cluster;
+    }
+};
+
+CrashClusterer::CrashClusterer(const ClusterOptions& options)
+    : impl_(std::make_unique<Impl>(options)) {}
+
+CrashClusterer::~CrashClusterer() = default;
+
+ClusterAssignment CrashClusterer::add(const StackTrace& trace) {
+    Scratch& work = impl_->scratch;
+    impl_->sign(trace, work, nullptr);
+
+    if (auto match = impl_->nearest(work)) {
+        ++impl_->clusters[match->cluster_id].size;
+        return *match;
+    }
+
+    uint32_t id = static_cast<uint32_t>(impl_->clusters.size());
+    impl_->clusters.emplace_back();
+    impl_->clusters.back().size = 1;
+    // Re-sign to capture the representative's frames; only new clusters pay.
+    impl_->sign(trace, work, &impl_->clusters.back().frames);
+
+    impl_->signatures.insert(impl_->signatures.end(), work.signature.begin(), work.signature.end());
+    for (size_t band = 0; band < impl_->options.bands; ++band) {
+        impl_->buckets[impl_->bandKey(work.signature, band)].push_back(id);
+    }
+
+    ClusterAssignment assignment;
+    assignment.cluster_id = id;
+    assignment.similarity = 1.0;
+    assignment.created = true;
+    return assignment;
+}
+
+std::optional<ClusterAssignment> CrashClusterer::find(const StackTrace& trace) const {
+    Scratch work;
+    impl_->sign(trace, work, nullptr);
+    return impl_->nearest(work);
+}
+
+size_t CrashClusterer::clusterCount() const {
+    return impl_->clusters.size();
+}
+
+std::optional<CrashCluster> CrashClusterer::getCluster(uint32_t id) const {
+    if (id >= impl_->clusters.size()) {
+        return std::nullopt;
+    }
+    return impl_->materialize(id);
+}
+
+std::vector<CrashCluster> CrashClusterer::largestClusters(size_t k) const {
+    std::vector<uint32_t> ids(impl_->clusters.size());
+    for (uint32_t id = 0; id < ids.size(); ++id) {
+        ids[id] = id;
+    }
+
+    k = std::min(k, ids.size());
+    std::partial_sort(ids.begin(), ids.begin() + k, ids.end(), [this](uint32_t a, uint32_t b) {
+        if (impl_->clusters[a].size != impl_->clusters[b].size) {
+            return impl_->clusters[a].size > impl_->clusters[b].size;
+        }
+        return a < b;
+    });
+
+    std::vector<CrashCluster> result;
+    result.reserve(k);
+    for (size_t i = 0; i < k; ++i) {
+        result.push_back(impl_->materialize(ids[i]));
+    }
+    return result;
+}
+
+void CrashClusterer::clear() {
+    impl_->clusters.clear();
+    impl_->signatures.clear();
+    impl_->buckets.clear();
+}
+
+} // namespace ai_debugger
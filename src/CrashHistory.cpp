@@ -0,0 +1,210 @@
+#include "ai_debugger/CrashHistory.h"
+#include <algorithm>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace ai_debugger {
+
+namespace {
+
+const SparseFeatures& vectorize(const StackTrace& trace) {
+    thread_local SparseFeatures features;
+    FeatureVectorizer().vectorize(trace, features);
+    return features;
+}
+
+} // namespace
+
+struct CrashHistory::Impl {
+    struct Entry {
+        std::string session_id;
+        SimilarityIndex::Signature signature;
+        RootCause cause;
+        bool confirmed;
+        bool in_confirmed_index;
+    };
+
+    Impl(const SimilarityOptions& options, size_t max_entries)
+        : index(options)
+        , confirmed_index(options)
+        , max_entries(std::max<size_t>(max_entries, 1))
+        , confirmed(0) {}
+
+    mutable std::shared_mutex mutex;
+    // Confirmed entries are indexed on their own as well, so the flood of
+    // predicted ones can never push them out of a bucket.
+    SimilarityIndex index;
+    SimilarityIndex confirmed_index;
+    std::vector<uint32_t> confirmed_ids;  // confirmed_index id -> entry
+    std::vector<Entry> entries;           // by index id
+    std::unordered_map<std::string, uint32_t> by_session;
+    size_t max_entries;
+    size_t confirmed;
+
+    void update(uint32_t id, const RootCause& cause, bool is_confirmed) {
+        Entry& entry = entries[id];
+        if (is_confirmed && !entry.confirmed) {
+            ++confirmed;
+        } else if (!is_confirmed && entry.confirmed) {
+            --confirmed;
+        }
+        entry.cause = cause;
+        entry.cause.relevant_frames.clear();
+        entry.confirmed = is_confirmed;
+        if (is_confirmed && !entry.in_confirmed_index) {
+            confirmed_index.add(entry.signature);
+            confirmed_ids.push_back(id);
+            entry.in_confirmed_index = true;
+        }
+    }
+
+    // Past max_entries, drops the oldest predicted entries (confirmed ones
+    // only once nothing else is left) down to three quarters of the limit,
+    // and rebuilds the indexes, which cannot remove items.
+    void trim() {
+        if (entries.size() <= max_entries) {
+            return;
+        }
+        size_t keep = std::max<size_t>(max_entries * 3 / 4, 1);
+        size_t drop = entries.size() - keep;
+        size_t drop_confirmed = confirmed > keep ? confirmed - keep : 0;
+        size_t drop_predicted = drop - drop_confirmed;
+
+        std::vector<Entry> kept;
+        kept.reserve(keep);
+        for (auto& entry : entries) {
+            size_t& quota = entry.confirmed ? drop_confirmed : drop_predicted;
+            if (quota > 0) {
+                --quota;
+                continue;
+            }
+            kept.push_back(std::move(entry));
+        }
+
+        entries.clear();
+        index.clear();
+        confirmed_index.clear();
+        confirmed_ids.clear();
+        by_session.clear();
+        confirmed = 0;
+        for (auto& entry : kept) {
+            uint32_t id = index.add(entry.signature);
+            if (!entry.session_id.empty()) {
+                by_session.emplace(entry.session_id, id);
+            }
+            bool is_confirmed = entry.confirmed;
+            RootCause cause = std::move(entry.cause);
+            entry.confirmed = false;
+            entry.in_confirmed_index = false;
+            entries.push_back(std::move(entry));
+            update(id, cause, is_confirmed);
+        }
+    }
+};
+
+CrashHistory::CrashHistory(const SimilarityOptions& options, size_t max_entries)
+    : impl_(std::make_unique<Impl>(options, max_entries)) {}
+
+CrashHistory::~CrashHistory() = default;
+
+void CrashHistory::record(const SparseFeatures& features, const std::string& session_id,
+                          const RootCause& cause, bool confirmed) {
+    SimilarityIndex::Signature signature = SimilarityIndex::signature(features);
+
+    std::unique_lock<std::shared_mutex> lock(impl_->mutex);
+    if (!session_id.empty()) {
+        auto existing = impl_->by_session.find(session_id);
+        if (existing != impl_->by_session.end()) {
+            impl_->update(existing->second, cause, confirmed);
+            return;
+        }
+    }
+
+    uint32_t id = impl_->index.add(signature);
+    impl_->entries.push_back(Impl::Entry{session_id, signature, RootCause(), false, false});
+    impl_->update(id, cause, confirmed);
+    if (!session_id.empty()) {
+        impl_->by_session.emplace(session_id, id);
+    }
+    impl_->trim();
+}
+
+void CrashHistory::record(const StackTrace& trace, const std::string& session_id,
+                          const RootCause& cause, bool confirmed) {
+    record(vectorize(trace), session_id, cause, confirmed);
+}
+
+bool CrashHistory::confirm(const std::string& session_id, const RootCause& cause) {
+    std::unique_lock<std::shared_mutex> lock(impl_->mutex);
+    auto it = impl_->by_session.find(session_id);
+    if (it == impl_->by_session.end()) {
+        return false;
+    }
+    impl_->update(it->second, cause, true);
+    return true;
+}
+
+std::vector<SimilarCrash> CrashHistory::nearest(const SparseFeatures& features, size_t k,
+                                                double min_similarity, bool confirmed_only) const {
+    SimilarityIndex::Signature signature = SimilarityIndex::signature(features);
+
+    std::shared_lock<std::shared_mutex> lock(impl_->mutex);
+    const auto& entries = impl_->entries;
+    const auto& confirmed_ids = impl_->confirmed_ids;
+    if (confirmed_only && impl_->confirmed == 0) {
+        return {};
+    }
+
+    // An entry recorded again as unconfirmed stays in the confirmed index.
+    std::vector<Neighbor> neighbors;
+    if (confirmed_only) {
+        neighbors = impl_->confirmed_index.query(signature, k, min_similarity, [&](uint32_t id) {
+            return entries[confirmed_ids[id]].confirmed;
+        });
+        for (auto& neighbor : neighbors) {
+            neighbor.id = confirmed_ids[neighbor.id];
+        }
+    } else {
+        neighbors = impl_->index.query(signature, k, min_similarity);
+    }
+
+    std::vector<SimilarCrash> crashes;
+    for (const Neighbor& neighbor : neighbors) {
+        const auto& entry = entries[neighbor.id];
+        SimilarCrash crash;
+        crash.session_id = entry.session_id;
+        crash.similarity = neighbor.similarity;
+        crash.root_cause = entry.cause;
+        crash.confirmed = entry.confirmed;
+        crashes.push_back(std::move(crash));
+    }
+    return crashes;
+}
+
+std::vector<SimilarCrash> CrashHistory::nearest(const StackTrace& trace, size_t k,
+                                                double min_similarity, bool confirmed_only) const {
+    return nearest(vectorize(trace), k, min_similarity, confirmed_only);
+}
+
+size_t CrashHistory::size() const {
+    std::shared_lock<std::shared_mutex> lock(impl_->mutex);
+    return impl_->entries.size();
+}
+
+size_t CrashHistory::confirmedCount() const {
+    std::shared_lock<std::shared_mutex> lock(impl_->mutex);
+    return impl_->confirmed;
+}
+
+void CrashHistory::clear() {
+    std::unique_lock<std::shared_mutex> lock(impl_->mutex);
+    impl_->index.clear();
+    impl_->confirmed_index.clear();
+    impl_->confirmed_ids.clear();
+    impl_->entries.clear();
+    impl_->by_session.clear();
+    impl_->confirmed = 0;
+}
+
+} // namespace ai_debugger
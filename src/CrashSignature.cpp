@@ -0,0 +1,193 @@
+#include "ai_debugger/CrashSignature.h"
+#include <algorithm>
+#include <cctype>
+
+namespace ai_debugger {
+
+namespace {
+
+bool isHexDigit(char c) {
+    return std::isxdigit(static_cast<unsigned char>(c)) != 0;
+}
+
+bool isSpace(char c) {
+    return std::isspace(static_cast<unsigned char>(c)) != 0;
+}
+
+void trimTrailing(std::string& text) {
+    while (!text.empty() && isSpace(text.back())) {
+        text.pop_back();
+    }
+}
+
+} // namespace
+
+bool isLibraryFunction(std::string_view function, std::string_view file) {
+    return function.find("std::") == 0 ||
+           function.find("__") == 0 ||
+           file.find("/usr/") == 0 ||
+           file.find("C:\\Program Files") == 0;
+}
+
+void normalizeFunctionName(std::string_view name, std::string& out) {
+    out.clear();
+
+    for (size_t i = 0; i < name.size();) {
+        // Hex addresses anywhere in the name.
+        if (name[i] == '0' && i + 2 < name.size() && (name[i + 1] == 'x' || name[i + 1] == 'X') &&
+            isHexDigit(name[i + 2])) {
+            i += 2;
+            while (i < name.size() && isHexDigit(name[i])) {
+                ++i;
+            }
+            continue;
+        }
+
+        // Offsets such as "main + 42" or "main+0x1a".
+        if (name[i] == '+') {
+            size_t j = i + 1;
+            while (j < name.size() && isSpace(name[j])) {
+                ++j;
+            }
+            size_t digits = j;
+            while (j < name.size() && std::isdigit(static_cast<unsigned char>(name[j]))) {
+                ++j;
+            }
+            bool hex = name.compare(digits, 2, "0x") == 0;
+            if (j > digits || hex) {
+                trimTrailing(out);
+                i = hex ? digits : j;
+                continue;
+            }
+        }
+
+        // Compiler clone suffixes end the symbol proper.
+        if (name[i] == '.') {
+            std::string_view rest = name.substr(i + 1);
+            if (rest.compare(0, 4, "isra") == 0 || rest.compare(0, 9, "constprop") == 0 ||
+                rest.compare(0, 4, "part") == 0 || rest.compare(0, 4, "cold") == 0 ||
+                rest.compare(0, 8, "lto_priv") == 0 || rest.compare(0, 5, "clone") == 0) {
+                break;
+            }
+        }
+
+        out += name[i++];
+    }
+
+    trimTrailing(out);
+    size_t start = 0;
+    while (start < out.size() && isSpace(out[start])) {
+        ++start;
+    }
+    out.erase(0, start);
+}
+
+void normalizeErrorMessage(std::string_view message, std::string& out) {
+    out.clear();
+
+    size_t i = 0;
+    while (i < message.size()) {
+        unsigned char c = static_cast<unsigned char>(message[i]);
+        if (std::isspace(c)) {
+            while (i < message.size() && isSpace(message[i])) {
+                ++i;
+            }
+            if (!out.empty()) {
+                out += ' ';
+            }
+            continue;
+        }
+        if (!std::isalnum(c)) {
+            out += message[i++];
+            continue;
+        }
+
+        size_t end = i;
+        while (end < message.size() && std::isalnum(static_cast<unsigned char>(message[end]))) {
+            ++end;
+        }
+        std::string_view word = message.substr(i, end - i);
+
+        // Whole-word numbers: "0x7ffd", "deadbeef1", "12345".
+        std::string_view digits = word;
+        bool prefixed = digits.size() > 2 && digits[0] == '0' && (digits[1] == 'x' || digits[1] == 'X');
+        if (prefixed) {
+            digits.remove_prefix(2);
+        }
+        bool all_hex = std::all_of(digits.begin(), digits.end(), isHexDigit);
+        bool any_digit = std::any_of(digits.begin(), digits.end(), [](char d) {
+            return std::isdigit(static_cast<unsigned char>(d)) != 0;
+        });
+        if (all_hex && (prefixed || any_digit)) {
+            out += '#';
+            i = end;
+            continue;
+        }
+
+        // Digits embedded in a word, e.g. "worker3".
+        bool in_number = false;
+        for (char w : word) {
+            if (std::isdigit(static_cast<unsigned char>(w))) {
+                if (!in_number) {
+                    out += '#';
+                }
+                in_number = true;
+            } else {
+                out += static_cast<char>(std::tolower(static_cast<unsigned char>(w)));
+                in_number = false;
+            }
+        }
+        i = end;
+    }
+
+    trimTrailing(out);
+}
+
+uint64_t fnv1a(std::string_view data, uint64_t hash) {
+    for (char c : data) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+uint64_t crashFingerprint(const StackTrace& trace, size_t max_frames) {
+    if (trace.frames.empty()) {
+        return 0;
+    }
+
+    bool has_user_frame = false;
+    for (const auto& frame : trace.frames) {
+        if (!isLibraryFunction(frame.function_name, frame.location.file)) {
+            has_user_frame = true;
+            break;
+        }
+    }
+
+    uint64_t hash = fnv1a("");
+    std::string normalized;
+    size_t used = 0;
+    for (const auto& frame : trace.frames) {
+        if (used == max_frames) {
+            break;
+        }
+        if (has_user_frame && isLibraryFunction(frame.function_name, frame.location.file)) {
+            continue;
+        }
+        normalizeFunctionName(frame.function_name, normalized);
+        hash = fnv1a(normalized, hash);
+        hash = fnv1a(std::string_view("\0", 1), hash);
+        ++used;
+    }
+
+    // Reserve 0 for "no fingerprint".
+    return hash == 0 ? 1 : hash;
+}
+
+uint64_t errorMessageKey(std::string_view message) {
+    std::string normalized;
+    normalizeErrorMessage(message, normalized);
+    return fnv1a(normalized);
+}
+
+} // namespace ai_debugger
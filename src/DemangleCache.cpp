@@ -0,0 +1,190 @@
+#include "ai_debugger/DemangleCache.h"
+#include "ai_debugger/StringArena.h"
+#include <unordered_map>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+#include <cstdlib>
+
+#ifdef __GNUG__
+#include <cxxabi.h>
+#endif
+
+namespace ai_debugger {
+
+namespace {
+
+// Per-thread scratch space for __cxa_demangle, which reallocs the buffer it
+// is handed instead of allocating a fresh one on every call.
+struct DemangleBuffer {
+    std::string input;
+    char* buffer = nullptr;
+    size_t capacity = 0;
+
+    ~DemangleBuffer() {
+        free(buffer);
+    }
+};
+
+// Returns false when the name is not a mangled symbol or demangles to itself.
+bool demangleUncached(std::string_view mangled, std::string& out) {
+#ifdef __GNUG__
+    thread_local DemangleBuffer scratch;
+    scratch.input.assign(mangled);
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(
+        scratch.input.c_str(), scratch.buffer, &scratch.capacity, &status);
+    if (status == 0 && demangled) {
+        scratch.buffer = demangled;
+        std::string_view result(demangled);
+        if (result != mangled) {
+            out.assign(result);
+            return true;
+        }
+    }
+#else
+    (void)mangled;
+    (void)out;
+#endif
+    return false;
+}
+
+struct Entry {
+    std::string_view demangled;
+    bool changed;
+};
+
+struct Generation {
+    std::unordered_map<std::string_view, Entry> entries;
+    StringArena arena;
+
+    void clear() {
+        entries.clear();
+        arena.clear();
+    }
+};
+
+struct Shard {
+    std::mutex mutex;
+    Generation current;
+    Generation previous;
+};
+
+} // namespace
+
+struct DemangleCache::Impl {
+    std::vector<std::unique_ptr<Shard>> shards;
+    size_t generation_capacity;
+
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+    std::atomic<uint64_t> evictions{0};
+
+    Shard& shardFor(std::string_view mangled) {
+        return *shards[std::hash<std::string_view>{}(mangled) % shards.size()];
+    }
+
+    // Caller holds the shard lock.
+    void insert(Shard& shard, std::string_view mangled, std::string_view demangled, bool changed) {
+        if (shard.current.entries.size() >= generation_capacity) {
+            evictions.fetch_add(shard.previous.entries.size(), std::memory_order_relaxed);
+            std::swap(shard.current, shard.previous);
+            shard.current.clear();
+        }
+
+        Entry entry;
+        entry.changed = changed;
+        std::string_view key = shard.current.arena.store(mangled);
+        entry.demangled = changed ? shard.current.arena.store(demangled) : std::string_view();
+        shard.current.entries.emplace(key, entry);
+    }
+};
+
+DemangleCache::DemangleCache(size_t capacity, size_t shard_count)
+    : impl_(std::make_unique<Impl>()) {
+    shard_count = std::max<size_t>(shard_count, 1);
+    impl_->shards.reserve(shard_count);
+    for (size_t i = 0; i < shard_count; ++i) {
+        impl_->shards.push_back(std::make_unique<Shard>());
+    }
+    // Two generations per shard share the capacity.
+    impl_->generation_capacity = std::max<size_t>(capacity / (2 * shard_count), 1);
+}
+
+DemangleCache::~DemangleCache() = default;
+
+bool DemangleCache::demangle(std::string_view mangled, std::string& out) {
+    Shard& shard = impl_->shardFor(mangled);
+
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        auto it = shard.current.entries.find(mangled);
+        if (it != shard.current.entries.end()) {
+            impl_->hits.fetch_add(1, std::memory_order_relaxed);
+            if (it->second.changed) {
+                out.assign(it->second.demangled);
+            }
+            return it->second.changed;
+        }
+
+        auto prev = shard.previous.entries.find(mangled);
+        if (prev != shard.previous.entries.end()) {
+            impl_->hits.fetch_add(1, std::memory_order_relaxed);
+            bool changed = prev->second.changed;
+            if (changed) {
+                out.assign(prev->second.demangled);
+            }
+            // Promote from the copy in `out`: inserting may rotate the
+            // generations and recycle the arena `prev` points into.
+            impl_->insert(shard, mangled, changed ? std::string_view(out) : std::string_view(), changed);
+            return changed;
+        }
+    }
+
+    impl_->misses.fetch_add(1, std::memory_order_relaxed);
+
+    // Demangle outside the lock; a racing thread may insert the same key
+    // first, in which case emplace keeps its entry.
+    bool changed = demangleUncached(mangled, out);
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (shard.current.entries.find(mangled) == shard.current.entries.end()) {
+        impl_->insert(shard, mangled, changed ? std::string_view(out) : std::string_view(), changed);
+    }
+    return changed;
+}
+
+DemangleCacheStats DemangleCache::stats() const {
+    DemangleCacheStats result;
+    result.hits = impl_->hits.load(std::memory_order_relaxed);
+    result.misses = impl_->misses.load(std::memory_order_relaxed);
+    result.evictions = impl_->evictions.load(std::memory_order_relaxed);
+
+    for (const auto& shard : impl_->shards) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        result.entries += shard->current.entries.size() + shard->previous.entries.size();
+        result.bytes_reserved += shard->current.arena.bytesReserved() +
+                                 shard->previous.arena.bytesReserved();
+    }
+    return result;
+}
+
+void DemangleCache::clear() {
+    for (auto& shard : impl_->shards) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        shard->current.clear();
+        shard->previous.clear();
+    }
+    impl_->hits = 0;
+    impl_->misses = 0;
+    impl_->evictions = 0;
+}
+
+std::shared_ptr<DemangleCache> DemangleCache::shared() {
+    static std::shared_ptr<DemangleCache> instance = std::make_shared<DemangleCache>();
+    return instance;
+}
+
+} // namespace ai_debugger
@@ -0,0 +1,241 @@
+#include "ai_debugger/FeatureVectorizer.h"
+#include "ai_debugger/CrashSignature.h"
+#include <algorithm>
+
+namespace ai_debugger {
+
+namespace {
+
+constexpr uint64_t FNV_OFFSET = 14695981039346656037ull;
+constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+constexpr uint64_t seed(const char* name) {
+    uint64_t hash = FNV_OFFSET;
+    for (; *name; ++name) {
+        hash = (hash ^ static_cast<unsigned char>(*name)) * FNV_PRIME;
+    }
+    return hash;
+}
+
+// Feature namespaces, so equal strings in different roles do not collide.
+constexpr uint64_t TOKEN = seed("token");
+constexpr uint64_t NAME = seed("name");
+constexpr uint64_t SITE = seed("site");
+constexpr uint64_t MODULE = seed("module");
+constexpr uint64_t FILE = seed("file");
+constexpr uint64_t SIGNAL = seed("signal");
+constexpr uint64_t EXCEPTION = seed("exception");
+constexpr uint64_t DEPTH = seed("depth");
+constexpr uint64_t WORD = seed("word");
+constexpr uint64_t BIGRAM = seed("bigram");
+constexpr uint64_t TRIGRAM = seed("trigram");
+constexpr uint64_t NUMBER = seed("#");
+
+// Compiler clone suffix tokens (see normalizeFunctionName); skipping them
+// keeps "parse.isra.0" and "parse" on the same features.
+constexpr uint64_t CLONE_TOKENS[] = {
+    seed("isra"), seed("constprop"), seed("part"), seed("cold"),
+    seed("lto"), seed("priv"), seed("clone"),
+};
+
+uint64_t mix(uint64_t a, uint64_t b) {
+    uint64_t x = (a ^ b) * 0x9E3779B97F4A7C15ull;
+    return x ^ (x >> 32);
+}
+
+uint32_t featureIndex(uint64_t hash, uint32_t mask) {
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDull;
+    hash ^= hash >> 33;
+    return static_cast<uint32_t>(hash) & mask;
+}
+
+enum CharKind : uint8_t {
+    SEPARATOR,
+    LETTER,
+    HEX_LETTER,
+    DIGIT
+};
+
+// ASCII classification and lowercasing by table; <cctype> calls and
+// branchy range checks dominate the cost otherwise.
+struct CharTable {
+    uint8_t kind[256];
+    char lower[256];
+
+    CharTable() : kind(), lower() {
+        for (int c = 0; c < 256; ++c) {
+            lower[c] = static_cast<char>(c);
+        }
+        for (int c = '0'; c <= '9'; ++c) {
+            kind[c] = DIGIT;
+        }
+        for (int c = 'a'; c <= 'z'; ++c) {
+            kind[c] = kind[c - 32] = (c <= 'f') ? HEX_LETTER : LETTER;
+            lower[c - 32] = static_cast<char>(c);
+        }
+    }
+};
+
+const CharTable CHARS;
+
+// Calls visit(hash, numeric) for every alphanumeric run of `text`,
+// lowercased, with digit runs hashed as a single '#'. A run is numeric if it
+// looks like a number: "0x7ffd", "deadbeef1", "42".
+template <typename Visit>
+void forEachWord(std::string_view text, Visit visit) {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(text.data());
+    const unsigned char* end = p + text.size();
+
+    while (p < end) {
+        while (p < end && CHARS.kind[*p] == SEPARATOR) {
+            ++p;
+        }
+        if (p == end) {
+            break;
+        }
+
+        const unsigned char* word = p;
+        uint64_t hash = FNV_OFFSET;
+        bool all_hex = true;
+        bool has_digit = false;
+        bool in_digits = false;
+        for (; p < end; ++p) {
+            uint8_t kind = CHARS.kind[*p];
+            if (kind == SEPARATOR) {
+                break;
+            }
+            if (kind == DIGIT) {
+                if (!in_digits) {
+                    hash = (hash ^ static_cast<unsigned char>('#')) * FNV_PRIME;
+                }
+                has_digit = true;
+                in_digits = true;
+            } else {
+                hash = (hash ^ static_cast<unsigned char>(CHARS.lower[*p])) * FNV_PRIME;
+                all_hex &= kind == HEX_LETTER;
+                in_digits = false;
+            }
+        }
+
+        size_t length = static_cast<size_t>(p - word);
+        bool prefixed = length > 2 && word[0] == '0' && (word[1] | 0x20) == 'x';
+        if (prefixed) {
+            // The 'x' itself is not a hex digit.
+            all_hex = true;
+            for (const unsigned char* c = word + 2; c < p; ++c) {
+                all_hex &= CHARS.kind[*c] != LETTER;
+            }
+        }
+        visit(hash, all_hex && (has_digit || prefixed));
+    }
+}
+
+template <typename Text>
+std::string_view basename(const Text& path) {
+    std::string_view view = path;
+    size_t slash = view.find_last_of("/\\");
+    return slash == std::string_view::npos ? view : view.substr(slash + 1);
+}
+
+} // namespace
+
+uint32_t FeatureVectorizer::roundDimension(uint32_t dimension) {
+    // Clamped first: doubling past MAX_DIMENSION would wrap to 0.
+    dimension = std::min(dimension, MAX_DIMENSION);
+    uint32_t rounded = 1;
+    while (rounded < dimension) {
+        rounded <<= 1;
+    }
+    return rounded;
+}
+
+FeatureVectorizer::FeatureVectorizer(uint32_t dimension, size_t max_frames)
+    : dimension_(roundDimension(dimension))
+    , max_frames_(max_frames) {}
+
+void FeatureVectorizer::vectorize(const StackTrace& trace, SparseFeatures& out) const {
+    vectorizeTrace(trace, out);
+}
+
+void FeatureVectorizer::vectorize(const StackTraceView& trace, SparseFeatures& out) const {
+    vectorizeTrace(trace, out);
+}
+
+template <typename Trace>
+void FeatureVectorizer::vectorizeTrace(const Trace& trace, SparseFeatures& out) const {
+    out.clear();
+    const uint32_t mask = dimension_ - 1;
+    auto emit = [&](uint64_t hash) { out.add(featureIndex(hash, mask), 1.0f); };
+
+    size_t frames = 0;
+    size_t site_frames = 0;
+    for (const auto& frame : trace.frames) {
+        if (frames++ == max_frames_) {
+            break;
+        }
+
+        uint64_t whole = NAME;
+        forEachWord(frame.function_name, [&](uint64_t hash, bool numeric) {
+            if (numeric) {
+                return;
+            }
+            for (uint64_t clone : CLONE_TOKENS) {
+                if (hash == clone) {
+                    return;
+                }
+            }
+            emit(mix(TOKEN, hash));
+            whole = mix(whole, hash);
+        });
+        if (whole == NAME) {
+            continue;
+        }
+        emit(whole);
+
+        if (site_frames < CRASH_SITE_FRAMES &&
+            !isLibraryFunction(frame.function_name, frame.location.file)) {
+            emit(mix(SITE, whole));
+            ++site_frames;
+        }
+
+        std::string_view module = basename(frame.module);
+        if (!module.empty()) {
+            emit(fnv1a(module, MODULE));
+        }
+        std::string_view file = basename(frame.location.file);
+        if (!file.empty()) {
+            emit(fnv1a(file, FILE));
+        }
+    }
+
+    if (trace.signal_number != 0) {
+        emit(mix(SIGNAL, static_cast<uint64_t>(trace.signal_number)));
+    }
+    if (!std::string_view(trace.exception_type).empty()) {
+        emit(fnv1a(trace.exception_type, EXCEPTION));
+    }
+
+    uint64_t bucket = 0;
+    for (size_t depth = trace.frames.size(); depth > 1; depth >>= 1) {
+        ++bucket;
+    }
+    emit(mix(DEPTH, bucket));
+
+    uint64_t previous = 0;
+    uint64_t before_previous = 0;
+    forEachWord(trace.error_message, [&](uint64_t hash, bool numeric) {
+        uint64_t word = numeric ? NUMBER : hash;
+        emit(mix(WORD, word));
+        if (previous != 0) {
+            emit(mix(mix(BIGRAM, previous), word));
+        }
+        if (before_previous != 0) {
+            emit(mix(mix(mix(TRIGRAM, before_previous), previous), word));
+        }
+        before_previous = previous;
+        previous = word;
+    });
+}
+
+} // namespace ai_debugger
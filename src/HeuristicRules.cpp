@@ -0,0 +1,446 @@
+#include "ai_debugger/HeuristicRules.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <sstream>
+
+namespace ai_debugger {
+
+namespace {
+
+struct SignalName {
+    const char* name;
+    int number;
+};
+
+// Linux numbering, as reported in StackTrace::signal_number.
+const SignalName SIGNAL_NAMES[] = {
+    {"SIGILL", 4}, {"SIGTRAP", 5}, {"SIGABRT", 6}, {"SIGBUS", 7},
+    {"SIGFPE", 8}, {"SIGKILL", 9}, {"SIGSEGV", 11}, {"SIGPIPE", 13},
+};
+
+std::string trim(const std::string& text) {
+    size_t begin = text.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) {
+        return std::string();
+    }
+    size_t end = text.find_last_not_of(" \t\r");
+    return text.substr(begin, end - begin + 1);
+}
+
+bool splitAlternatives(const std::string& value, std::vector<std::string>& out) {
+    std::istringstream stream(value);
+    std::string item;
+    while (std::getline(stream, item, '|')) {
+        item = trim(item);
+        if (item.empty()) {
+            return false;
+        }
+        out.push_back(item);
+    }
+    return !out.empty();
+}
+
+bool parseSignal(const std::string& text, int& number) {
+    for (const auto& signal : SIGNAL_NAMES) {
+        if (text == signal.name) {
+            number = signal.number;
+            return true;
+        }
+    }
+    char* end = nullptr;
+    long value = std::strtol(text.c_str(), &end, 10);
+    if (end == text.c_str() || *end != '\0' || value <= 0 || value > 64) {
+        return false;
+    }
+    number = static_cast<int>(value);
+    return true;
+}
+
+bool parseField(const std::string& key, RuleField& field, bool& exclude) {
+    exclude = key.compare(0, 4, "not_") == 0;
+    std::string name = exclude ? key.substr(4) : key;
+    if (name == "message") {
+        field = RuleField::ERROR_MESSAGE;
+    } else if (name == "function") {
+        field = RuleField::FUNCTION_NAME;
+    } else if (name == "module") {
+        field = RuleField::MODULE;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+struct FileStamp {
+    std::filesystem::file_time_type modified;
+    uintmax_t size;
+
+    FileStamp() : size(0) {}
+
+    bool operator==(const FileStamp& other) const {
+        return modified == other.modified && size == other.size;
+    }
+};
+
+bool stampFile(const std::string& path, FileStamp& stamp) {
+    std::error_code ec;
+    stamp.modified = std::filesystem::last_write_time(path, ec);
+    if (ec) {
+        return false;
+    }
+    stamp.size = std::filesystem::file_size(path, ec);
+    return !ec;
+}
+
+} // namespace
+
+RuleSet::RuleSet(std::vector<KeywordRule> rules) : rules_(std::move(rules)) {
+    std::vector<std::vector<Slot>> slots[FIELDS];
+    auto addGroup = [&](const KeywordGroup& group, Slot slot) {
+        size_t field = static_cast<size_t>(group.field);
+        for (const auto& keyword : group.keywords) {
+            uint32_t id = matchers_[field].add(keyword);
+            if (slots[field].size() <= id) {
+                slots[field].resize(id + 1);
+            }
+            slots[field][id].push_back(slot);
+        }
+    };
+
+    required_.assign(rules_.size(), 0);
+    for (uint32_t r = 0; r < rules_.size(); ++r) {
+        const KeywordRule& rule = rules_[r];
+        uint32_t groups = static_cast<uint32_t>(std::min<size_t>(rule.all_of.size(), 32));
+        for (uint32_t g = 0; g < groups; ++g) {
+            addGroup(rule.all_of[g], Slot{r, g});
+            required_[r] |= 1u << g;
+        }
+        for (const auto& group : rule.none_of) {
+            addGroup(group, Slot{r, EXCLUDE});
+        }
+    }
+
+    for (size_t field = 0; field < FIELDS; ++field) {
+        matchers_[field].compile();
+        slots[field].resize(matchers_[field].size());
+        slot_offsets_[field].push_back(0);
+        for (const auto& keyword_slots : slots[field]) {
+            slots_[field].insert(slots_[field].end(), keyword_slots.begin(), keyword_slots.end());
+            slot_offsets_[field].push_back(static_cast<uint32_t>(slots_[field].size()));
+        }
+    }
+}
+
+void RuleSet::match(const PredictionFeatures& features, std::vector<uint32_t>& fired) const {
+    match(PredictionFeaturesView(features), fired);
+}
+
+void RuleSet::match(const PredictionFeaturesView& features, std::vector<uint32_t>& fired) const {
+    thread_local std::vector<uint32_t> satisfied;
+    thread_local std::vector<char> excluded;
+    satisfied.assign(rules_.size(), 0);
+    excluded.assign(rules_.size(), 0);
+
+    auto scan = [&](RuleField rule_field, std::string_view text) {
+        size_t field = static_cast<size_t>(rule_field);
+        matchers_[field].scan(text, [&](uint32_t id, size_t, size_t) {
+            for (uint32_t s = slot_offsets_[field][id]; s < slot_offsets_[field][id + 1]; ++s) {
+                const Slot& slot = slots_[field][s];
+                if (slot.group == EXCLUDE) {
+                    excluded[slot.rule] = 1;
+                } else {
+                    satisfied[slot.rule] |= 1u << slot.group;
+                }
+            }
+        });
+    };
+
+    if (matchers_[static_cast<size_t>(RuleField::ERROR_MESSAGE)].size() > 0) {
+        scan(RuleField::ERROR_MESSAGE, features.error_message);
+    }
+    if (matchers_[static_cast<size_t>(RuleField::FUNCTION_NAME)].size() > 0) {
+        for (std::string_view name : features.function_names) {
+            scan(RuleField::FUNCTION_NAME, name);
+        }
+    }
+    if (matchers_[static_cast<size_t>(RuleField::MODULE)].size() > 0) {
+        for (std::string_view module : features.modules) {
+            scan(RuleField::MODULE, module);
+        }
+    }
+
+    for (uint32_t r = 0; r < rules_.size(); ++r) {
+        const auto& signals = rules_[r].signals;
+        if ((required_[r] == 0 && signals.empty()) || satisfied[r] != required_[r] || excluded[r]) {
+            continue;
+        }
+        if (!signals.empty() &&
+            std::find(signals.begin(), signals.end(), features.signal_number) == signals.end()) {
+            continue;
+        }
+        fired.push_back(r);
+    }
+}
+
+std::vector<KeywordRule> defaultHeuristicRules() {
+    auto rule = [](std::vector<KeywordGroup> all_of, std::vector<KeywordGroup> none_of,
+                   BugCategory category, double score, const char* description) {
+        KeywordRule r;
+        r.all_of = std::move(all_of);
+        r.none_of = std::move(none_of);
+        r.category = category;
+        r.score = score;
+        r.description = description;
+        return r;
+    };
+    auto message = [](std::vector<std::string> keywords) {
+        return KeywordGroup(RuleField::ERROR_MESSAGE, std::move(keywords));
+    };
+
+    return {
+        rule({message({"segmentation fault", "sigsegv"}), message({"null", "0x0"})}, {},
+             BugCategory::NULL_POINTER, 0.85, "Null pointer dereference detected from segmentation fault"),
+        rule({message({"segmentation fault", "sigsegv"})}, {message({"null", "0x0"})},
+             BugCategory::MEMORY_ERROR, 0.75, "Invalid memory access causing segmentation fault"),
+        rule({message({"double free"})}, {},
+             BugCategory::DOUBLE_FREE, 0.95, "Double free corruption detected"),
+        rule({message({"heap"}), message({"corruption"})}, {},
+             BugCategory::BUFFER_OVERFLOW, 0.80, "Heap corruption likely due to buffer overflow"),
+        rule({KeywordGroup(RuleField::FUNCTION_NAME, {"thread", "mutex", "lock"})}, {},
+             BugCategory::RACE_CONDITION, 0.60, "Possible race condition in multithreaded code"),
+        rule({message({"assertion", "assert"})}, {},
+             BugCategory::ASSERTION_FAILURE, 0.90, "Assertion failed indicating logic error"),
+    };
+}
+
+std::shared_ptr<const RuleSet> defaultRuleSet() {
+    static const std::shared_ptr<const RuleSet> rules = std::make_shared<RuleSet>(defaultHeuristicRules());
+    return rules;
+}
+
+bool parseRules(std::istream& input, std::vector<KeywordRule>& rules, std::string* error) {
+    std::vector<KeywordRule> parsed;
+    bool has_category = false;
+    bool has_score = false;
+    size_t rule_line = 0;
+    size_t line_number = 0;
+
+    auto fail = [&](size_t line, const std::string& message) {
+        if (error) {
+            *error = "line " + std::to_string(line) + ": " + message;
+        }
+        return false;
+    };
+    auto finishRule = [&]() {
+        if (parsed.empty()) {
+            return true;
+        }
+        KeywordRule& rule = parsed.back();
+        if (!has_category) {
+            return fail(rule_line, "rule has no category");
+        }
+        if (rule.description.empty()) {
+            return fail(rule_line, "rule has no description");
+        }
+        if (rule.all_of.empty() && rule.signals.empty()) {
+            return fail(rule_line, "rule has no message, function, module or signal condition");
+        }
+        if (rule.all_of.size() > 32) {
+            return fail(rule_line, "rule has more than 32 keyword groups");
+        }
+        if (!has_score) {
+            rule.score = 0.5;
+        }
+        return true;
+    };
+
+    std::string line;
+    while (std::getline(input, line)) {
+        ++line_number;
+        line = trim(line);
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        if (line == "[rule]") {
+            if (!finishRule()) {
+                return false;
+            }
+            parsed.emplace_back();
+            has_category = false;
+            has_score = false;
+            rule_line = line_number;
+            continue;
+        }
+
+        size_t equals = line.find('=');
+        if (equals == std::string::npos) {
+            return fail(line_number, "expected key = value");
+        }
+        if (parsed.empty()) {
+            return fail(line_number, "expected [rule] before the first key");
+        }
+
+        KeywordRule& rule = parsed.back();
+        std::string key = trim(line.substr(0, equals));
+        std::string value = trim(line.substr(equals + 1));
+        RuleField field = RuleField::ERROR_MESSAGE;
+        bool exclude = false;
+
+        if (key == "category") {
+            rule.category = stringToBugCategory(value);
+            if (rule.category == BugCategory::UNKNOWN && value != bugCategoryToString(BugCategory::UNKNOWN)) {
+                return fail(line_number, "unknown category '" + value + "'");
+            }
+            has_category = true;
+        } else if (key == "score") {
+            char* end = nullptr;
+            rule.score = std::strtod(value.c_str(), &end);
+            if (end == value.c_str() || *end != '\0' || !(rule.score >= 0.0 && rule.score <= 1.0)) {
+                return fail(line_number, "score must be a number between 0 and 1");
+            }
+            has_score = true;
+        } else if (key == "description") {
+            rule.description = value;
+        } else if (key == "signal") {
+            std::vector<std::string> names;
+            if (!splitAlternatives(value, names)) {
+                return fail(line_number, "empty signal alternative");
+            }
+            for (const auto& name : names) {
+                int number = 0;
+                if (!parseSignal(name, number)) {
+                    return fail(line_number, "unknown signal '" + name + "'");
+                }
+                rule.signals.push_back(number);
+            }
+        } else if (parseField(key, field, exclude)) {
+            KeywordGroup group;
+            group.field = field;
+            if (!splitAlternatives(value, group.keywords)) {
+                return fail(line_number, "empty keyword alternative");
+            }
+            (exclude ? rule.none_of : rule.all_of).push_back(std::move(group));
+        } else {
+            return fail(line_number, "unknown key '" + key + "'");
+        }
+    }
+
+    if (!finishRule()) {
+        return false;
+    }
+    rules.insert(rules.end(), std::make_move_iterator(parsed.begin()), std::make_move_iterator(parsed.end()));
+    return true;
+}
+
+bool loadRuleFile(const std::string& path, std::vector<KeywordRule>& rules, std::string* error) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        if (error) {
+            *error = path + ": cannot open";
+        }
+        return false;
+    }
+    if (!parseRules(file, rules, error)) {
+        if (error) {
+            *error = path + ": " + *error;
+        }
+        return false;
+    }
+    return true;
+}
+
+struct RuleEngine::Impl {
+    // Read and replaced with std::atomic_load/atomic_store only.
+    std::shared_ptr<const RuleSet> rules = defaultRuleSet();
+    std::atomic<uint64_t> generation{0};
+
+    // Serializes loads; readers never take it.
+    mutable std::mutex load_mutex;
+    std::string path;
+    FileStamp stamp;
+
+    bool loadLocked(const std::string& file_path, std::string* error) {
+        // Stamped before reading, so a write racing the load is seen as a
+        // change by the next reloadIfChanged().
+        FileStamp loaded_stamp;
+        stampFile(file_path, loaded_stamp);
+
+        // Parsed and compiled before the swap; analyses keep running on the
+        // previous rules meanwhile.
+        std::vector<KeywordRule> parsed;
+        if (!loadRuleFile(file_path, parsed, error)) {
+            // Not retried by reloadIfChanged() until the file changes again.
+            if (file_path == path) {
+                stamp = loaded_stamp;
+            }
+            return false;
+        }
+        std::shared_ptr<const RuleSet> compiled = std::make_shared<RuleSet>(std::move(parsed));
+        std::atomic_store(&rules, compiled);
+        generation.fetch_add(1, std::memory_order_relaxed);
+
+        path = file_path;
+        stamp = loaded_stamp;
+        return true;
+    }
+};
+
+RuleEngine::RuleEngine() : impl_(std::make_unique<Impl>()) {}
+
+RuleEngine::~RuleEngine() = default;
+
+std::shared_ptr<const RuleSet> RuleEngine::current() const {
+    return std::atomic_load(&impl_->rules);
+}
+
+void RuleEngine::set(std::shared_ptr<const RuleSet> rules) {
+    std::lock_guard<std::mutex> lock(impl_->load_mutex);
+    std::atomic_store(&impl_->rules, rules ? std::move(rules) : defaultRuleSet());
+    impl_->generation.fetch_add(1, std::memory_order_relaxed);
+    impl_->path.clear();
+}
+
+bool RuleEngine::load(const std::string& path, std::string* error) {
+    std::lock_guard<std::mutex> lock(impl_->load_mutex);
+    return impl_->loadLocked(path, error);
+}
+
+bool RuleEngine::reload(std::string* error) {
+    std::lock_guard<std::mutex> lock(impl_->load_mutex);
+    if (impl_->path.empty()) {
+        if (error) {
+            *error = "no rule file loaded";
+        }
+        return false;
+    }
+    return impl_->loadLocked(impl_->path, error);
+}
+
+bool RuleEngine::reloadIfChanged(std::string* error) {
+    std::lock_guard<std::mutex> lock(impl_->load_mutex);
+    if (impl_->path.empty()) {
+        return false;
+    }
+    FileStamp stamp;
+    if (!stampFile(impl_->path, stamp) || stamp == impl_->stamp) {
+        return false;
+    }
+    return impl_->loadLocked(impl_->path, error);
+}
+
+std::string RuleEngine::path() const {
+    std::lock_guard<std::mutex> lock(impl_->load_mutex);
+    return impl_->path;
+}
+
+uint64_t RuleEngine::generation() const {
+    return impl_->generation.load(std::memory_order_relaxed);
+}
+
+} // namespace ai_debugger
@@ -0,0 +1,158 @@
+#include "ai_debugger/Instrumentation.h"
+#include "ai_debugger/Histogram.h"
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+namespace ai_debugger {
+
+namespace {
+
+std::atomic<uint64_t> instrumentation_sequence{0};
+
+} // namespace
+
+const char* timedStageToString(TimedStage stage) {
+    switch (stage) {
+        case TimedStage::PARSE: return "parse";
+        case TimedStage::CALL_GRAPH: return "call_graph";
+        case TimedStage::PREDICT: return "predict";
+        case TimedStage::EXPLAIN: return "explain";
+        case TimedStage::FIX: return "fix";
+        case TimedStage::TEST: return "test";
+        case TimedStage::PERSIST: return "persist";
+        default: return "unknown";
+    }
+}
+
+const char* counterToString(Counter counter) {
+    switch (counter) {
+        case Counter::TRACES_ANALYZED: return "traces_analyzed";
+        case Counter::FRAMES_PARSED: return "frames_parsed";
+        case Counter::BYTES_CONSUMED: return "bytes_consumed";
+        case Counter::CACHE_HITS: return "cache_hits";
+        case Counter::CACHE_MISSES: return "cache_misses";
+        default: return "unknown";
+    }
+}
+
+std::string InstrumentationSnapshot::toJSON() const {
+    std::ostringstream oss;
+    oss << "{\n";
+    oss << "  \"timers\": {";
+    for (size_t i = 0; i < TIMED_STAGE_COUNT; ++i) {
+        const TimerStats& stats = timers[i];
+        oss << (i == 0 ? "\n" : ",\n");
+        oss << "    \"" << timedStageToString(static_cast<TimedStage>(i)) << "\": {"
+            << "\"count\": " << stats.count
+            << ", \"total_ns\": " << stats.total_ns
+            << ", \"p50_ns\": " << stats.p50_ns
+            << ", \"p90_ns\": " << stats.p90_ns
+            << ", \"p99_ns\": " << stats.p99_ns
+            << ", \"max_ns\": " << stats.max_ns << "}";
+    }
+    oss << "\n  },\n";
+    oss << "  \"counters\": {";
+    for (size_t i = 0; i < COUNTER_COUNT; ++i) {
+        oss << (i == 0 ? "\n" : ",\n");
+        oss << "    \"" << counterToString(static_cast<Counter>(i)) << "\": " << counters[i];
+    }
+    oss << "\n  }\n";
+    oss << "}";
+    return oss.str();
+}
+
+// Written only by the thread it belongs to, read by snapshot().
+struct Instrumentation::Shard {
+    std::array<Histogram, TIMED_STAGE_COUNT> timers;
+    std::array<std::atomic<uint64_t>, COUNTER_COUNT> counters;
+
+    Shard() {
+        for (auto& counter : counters) {
+            counter.store(0, std::memory_order_relaxed);
+        }
+    }
+};
+
+struct Instrumentation::Impl {
+    uint64_t id = ++instrumentation_sequence;
+
+    // Kept after their thread exits, so nothing recorded is lost.
+    mutable std::mutex mutex;
+    std::unordered_map<std::thread::id, std::unique_ptr<Shard>> shards;
+};
+
+Instrumentation::Instrumentation() : enabled_(false), impl_(std::make_unique<Impl>()) {}
+
+Instrumentation::~Instrumentation() = default;
+
+Instrumentation::Shard& Instrumentation::localShard() {
+    // A thread caches the shard of the instrumentation it last recorded
+    // into; switching between instrumentations takes the mutex.
+    thread_local uint64_t cached_id = 0;
+    thread_local Shard* cached_shard = nullptr;
+    if (cached_id == impl_->id) {
+        return *cached_shard;
+    }
+
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    auto& shard = impl_->shards[std::this_thread::get_id()];
+    if (!shard) {
+        shard = std::make_unique<Shard>();
+    }
+    cached_id = impl_->id;
+    cached_shard = shard.get();
+    return *shard;
+}
+
+void Instrumentation::addCounter(Counter counter, uint64_t n) {
+    localShard().counters[static_cast<size_t>(counter)].fetch_add(n, std::memory_order_relaxed);
+}
+
+void Instrumentation::recordTime(TimedStage stage, uint64_t nanoseconds) {
+    localShard().timers[static_cast<size_t>(stage)].record(nanoseconds);
+}
+
+InstrumentationSnapshot Instrumentation::snapshot() const {
+    InstrumentationSnapshot snapshot;
+    auto merged = std::make_unique<std::array<Histogram, TIMED_STAGE_COUNT>>();
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        for (const auto& entry : impl_->shards) {
+            const Shard& shard = *entry.second;
+            for (size_t i = 0; i < TIMED_STAGE_COUNT; ++i) {
+                (*merged)[i].merge(shard.timers[i]);
+            }
+            for (size_t i = 0; i < COUNTER_COUNT; ++i) {
+                snapshot.counters[i] += shard.counters[i].load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < TIMED_STAGE_COUNT; ++i) {
+        const Histogram& histogram = (*merged)[i];
+        TimerStats& stats = snapshot.timers[i];
+        stats.count = histogram.count();
+        stats.total_ns = histogram.sum();
+        stats.p50_ns = histogram.percentile(50);
+        stats.p90_ns = histogram.percentile(90);
+        stats.p99_ns = histogram.percentile(99);
+        stats.max_ns = histogram.max();
+    }
+    return snapshot;
+}
+
+void Instrumentation::reset() {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    for (auto& entry : impl_->shards) {
+        for (auto& histogram : entry.second->timers) {
+            histogram.reset();
+        }
+        for (auto& counter : entry.second->counters) {
+            counter.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+} // namespace ai_debugger
@@ -0,0 +1,171 @@
+#include "ai_debugger/KeywordMatcher.h"
+#include <algorithm>
+
+namespace ai_debugger {
+
+namespace {
+
+uint8_t toLower(uint8_t c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<uint8_t>(c | 0x20) : c;
+}
+
+struct FunctionKeywordTable {
+    KeywordMatcher matcher;
+    std::vector<uint32_t> contains;  // flags for a hit anywhere, by keyword id
+    std::vector<uint32_t> exact;     // flags for a hit spanning the whole name
+
+    void add(std::string_view keyword, uint32_t contains_flags, uint32_t exact_flags) {
+        uint32_t id = matcher.add(keyword);
+        contains.resize(matcher.size(), 0);
+        exact.resize(matcher.size(), 0);
+        contains[id] |= contains_flags;
+        exact[id] |= exact_flags;
+    }
+
+    FunctionKeywordTable() {
+        add("malloc", ALLOCATES, ALLOCATOR);
+        add("calloc", ALLOCATES, ALLOCATOR);
+        add("new", ALLOCATES, ALLOCATOR);
+        add("new[]", 0, ALLOCATOR);
+        add("alloc", ALLOCATES, 0);
+        add("free", DEALLOCATES, DEALLOCATOR);
+        add("delete", DEALLOCATES, DEALLOCATOR);
+        add("delete[]", 0, DEALLOCATOR);
+        add("thread", THREADING, 0);
+        add("mutex", THREADING | LOCKING, 0);
+        add("lock", THREADING | LOCKING, 0);
+        matcher.compile();
+    }
+};
+
+} // namespace
+
+KeywordMatcher::KeywordMatcher()
+    : trie_(1)
+    , terminal_(1)
+    , compiled_(false)
+    , byte_class_()
+    , classes_(1) {}
+
+uint32_t KeywordMatcher::add(std::string_view keyword) {
+    std::string lowered(keyword);
+    std::transform(lowered.begin(), lowered.end(), lowered.begin(), [](char c) {
+        return static_cast<char>(toLower(static_cast<uint8_t>(c)));
+    });
+
+    auto existing = std::find(keywords_.begin(), keywords_.end(), lowered);
+    if (existing != keywords_.end()) {
+        return static_cast<uint32_t>(existing - keywords_.begin());
+    }
+
+    uint32_t id = static_cast<uint32_t>(keywords_.size());
+    keywords_.push_back(lowered);
+    compiled_ = false;
+
+    // An empty keyword is kept for its id but never matches.
+    if (lowered.empty()) {
+        return id;
+    }
+
+    uint32_t node = 0;
+    for (char c : lowered) {
+        uint8_t byte = static_cast<uint8_t>(c);
+        auto& children = trie_[node];
+        auto child = std::find_if(children.begin(), children.end(), [byte](const auto& edge) {
+            return edge.first == byte;
+        });
+        if (child != children.end()) {
+            node = child->second;
+            continue;
+        }
+        uint32_t created = static_cast<uint32_t>(trie_.size());
+        children.emplace_back(byte, created);
+        trie_.emplace_back();
+        terminal_.emplace_back();
+        node = created;
+    }
+    terminal_[node].push_back(id);
+    return id;
+}
+
+void KeywordMatcher::compile() {
+    // Bytes that occur in no keyword share class 0.
+    std::fill(std::begin(byte_class_), std::end(byte_class_), 0);
+    classes_ = 1;
+    for (const auto& children : trie_) {
+        for (const auto& edge : children) {
+            if (byte_class_[edge.first] == 0) {
+                byte_class_[edge.first] = static_cast<uint8_t>(classes_++);
+            }
+        }
+    }
+    for (int c = 'a'; c <= 'z'; ++c) {
+        byte_class_[c - 32] = byte_class_[c];
+    }
+
+    size_t states = trie_.size();
+    next_.assign(states * classes_, 0);
+    std::vector<uint32_t> fail(states, 0);
+    std::vector<std::vector<uint32_t>> outputs(states);
+    std::vector<uint32_t> queue;
+    queue.reserve(states);
+    queue.push_back(0);
+
+    for (size_t head = 0; head < queue.size(); ++head) {
+        uint32_t state = queue[head];
+        uint32_t* row = next_.data() + static_cast<size_t>(state) * classes_;
+
+        outputs[state] = terminal_[state];
+        if (state != 0) {
+            const auto& inherited = outputs[fail[state]];
+            outputs[state].insert(outputs[state].end(), inherited.begin(), inherited.end());
+            // Missing transitions follow the failure link, already complete
+            // since it is shallower.
+            const uint32_t* fallback = next_.data() + static_cast<size_t>(fail[state]) * classes_;
+            std::copy(fallback, fallback + classes_, row);
+        }
+
+        for (const auto& edge : trie_[state]) {
+            uint32_t child = edge.second;
+            uint8_t cls = byte_class_[edge.first];
+            fail[child] = state == 0 ? 0 : row[cls];
+            row[cls] = child;
+            queue.push_back(child);
+        }
+    }
+
+    output_offsets_.assign(states + 1, 0);
+    outputs_.clear();
+    for (size_t state = 0; state < states; ++state) {
+        output_offsets_[state] = static_cast<uint32_t>(outputs_.size());
+        outputs_.insert(outputs_.end(), outputs[state].begin(), outputs[state].end());
+    }
+    output_offsets_[states] = static_cast<uint32_t>(outputs_.size());
+    compiled_ = true;
+}
+
+bool KeywordMatcher::contains(std::string_view text) const {
+    uint32_t state = 0;
+    for (char c : text) {
+        state = next_[state * classes_ + byte_class_[static_cast<unsigned char>(c)]];
+        if (output_offsets_[state] != output_offsets_[state + 1]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t functionKeywords(std::string_view function_name) {
+    static const FunctionKeywordTable table;
+
+    uint32_t flags = 0;
+    table.matcher.scan(function_name, [&](uint32_t id, size_t begin, size_t end) {
+        flags |= table.contains[id];
+        if (begin == 0 && end == function_name.size()) {
+            flags |= table.exact[id];
+        }
+    });
+    return flags;
+}
+
+} // namespace ai_debugger
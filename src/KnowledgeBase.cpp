@@ -0,0 +1,292 @@
+#include "ai_debugger/KnowledgeBase.h"
+#include "ai_debugger/CrashSignature.h"
+#include "ai_debugger/MappedFile.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <unordered_map>
+
+namespace ai_debugger {
+
+namespace {
+
+const char MAGIC[4] = {'A', 'I', 'K', 'B'};
+const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+struct FileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t record_size;
+    uint64_t record_count;
+    uint64_t strings_size;
+};
+
+struct FileRecord {
+    uint64_t key;
+    uint32_t description;
+    uint32_t description_size;
+    uint32_t file;
+    uint32_t file_size;
+    int32_t line;
+    uint8_t category;
+    uint8_t reserved;
+    uint16_t confidence;  // confidence * 65535
+};
+
+static_assert(sizeof(FileHeader) == 32, "knowledge base header layout changed");
+static_assert(sizeof(FileRecord) == 32, "knowledge base record layout changed");
+
+} // namespace
+
+struct KnowledgeBase::Impl {
+    MappedFile file;
+    const char* records = nullptr;
+    const char* strings = nullptr;
+    uint64_t record_count = 0;
+    uint64_t strings_size = 0;
+
+    // Records are read with memcpy: a non-mapped fallback buffer carries no
+    // alignment guarantee.
+    FileRecord record(size_t index) const {
+        FileRecord out;
+        std::memcpy(&out, records + index * sizeof(FileRecord), sizeof(FileRecord));
+        return out;
+    }
+
+    uint64_t key(size_t index) const {
+        uint64_t out;
+        std::memcpy(&out, records + index * sizeof(FileRecord), sizeof(out));
+        return out;
+    }
+
+    RootCause toRootCause(const FileRecord& rec) const {
+        RootCause cause;
+        cause.category = static_cast<BugCategory>(rec.category);
+        cause.description.assign(strings + rec.description, rec.description_size);
+        cause.location.file.assign(strings + rec.file, rec.file_size);
+        cause.location.line = rec.line;
+        cause.confidence = rec.confidence / 65535.0;
+        return cause;
+    }
+
+    bool validate() const {
+        uint64_t previous = 0;
+        for (size_t i = 0; i < record_count; ++i) {
+            FileRecord rec = record(i);
+            if (rec.key < previous ||
+                rec.category > static_cast<uint8_t>(BugCategory::UNKNOWN) ||
+                uint64_t(rec.description) + rec.description_size > strings_size ||
+                uint64_t(rec.file) + rec.file_size > strings_size) {
+                return false;
+            }
+            previous = rec.key;
+        }
+        return true;
+    }
+};
+
+KnowledgeBase::KnowledgeBase() : impl_(std::make_unique<Impl>()) {}
+
+KnowledgeBase::~KnowledgeBase() = default;
+
+bool KnowledgeBase::open(const std::string& path) {
+    close();
+    if (!impl_->file.open(path)) {
+        return false;
+    }
+
+    std::string_view data = impl_->file.data();
+    FileHeader header;
+    if (data.size() < sizeof(header)) {
+        close();
+        return false;
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+
+    uint64_t body = data.size() - sizeof(header);
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        header.version != VERSION ||
+        header.byte_order != BYTE_ORDER_MARK ||
+        header.record_size != sizeof(FileRecord) ||
+        header.record_count > body / sizeof(FileRecord) ||
+        header.record_count * sizeof(FileRecord) + header.strings_size != body) {
+        close();
+        return false;
+    }
+
+    impl_->records = data.data() + sizeof(header);
+    impl_->record_count = header.record_count;
+    impl_->strings = impl_->records + header.record_count * sizeof(FileRecord);
+    impl_->strings_size = header.strings_size;
+
+    if (!impl_->validate()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void KnowledgeBase::close() {
+    impl_->file.close();
+    impl_->records = nullptr;
+    impl_->strings = nullptr;
+    impl_->record_count = 0;
+    impl_->strings_size = 0;
+}
+
+bool KnowledgeBase::isOpen() const {
+    return impl_->file.isOpen();
+}
+
+size_t KnowledgeBase::size() const {
+    return static_cast<size_t>(impl_->record_count);
+}
+
+size_t KnowledgeBase::lookup(uint64_t key, std::vector<RootCause>& out) const {
+    size_t low = 0;
+    size_t high = static_cast<size_t>(impl_->record_count);
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (impl_->key(mid) < key) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    size_t found = 0;
+    for (size_t i = low; i < impl_->record_count && impl_->key(i) == key; ++i) {
+        out.push_back(impl_->toRootCause(impl_->record(i)));
+        ++found;
+    }
+    return found;
+}
+
+std::vector<RootCause> KnowledgeBase::lookup(std::string_view error_message) const {
+    std::vector<RootCause> causes;
+    lookup(errorMessageKey(error_message), causes);
+    return causes;
+}
+
+void KnowledgeBase::forEach(const std::function<void(uint64_t key, const RootCause& cause)>& visit) const {
+    for (size_t i = 0; i < impl_->record_count; ++i) {
+        FileRecord rec = impl_->record(i);
+        visit(rec.key, impl_->toRootCause(rec));
+    }
+}
+
+struct KnowledgeBaseBuilder::Impl {
+    std::vector<FileRecord> records;
+    std::string strings;
+    std::unordered_map<std::string, uint32_t> string_offsets;
+    bool refused = false;  // an add() failed since the last clear()
+
+    // False if the string table would outgrow the 32-bit offsets and sizes
+    // records hold.
+    bool intern(const std::string& text, uint32_t& offset) {
+        auto it = string_offsets.find(text);
+        if (it != string_offsets.end()) {
+            offset = it->second;
+            return true;
+        }
+        if (text.size() > UINT32_MAX - strings.size()) {
+            return false;
+        }
+        offset = static_cast<uint32_t>(strings.size());
+        strings += text;
+        string_offsets.emplace(text, offset);
+        return true;
+    }
+};
+
+KnowledgeBaseBuilder::KnowledgeBaseBuilder() : impl_(std::make_unique<Impl>()) {}
+
+KnowledgeBaseBuilder::~KnowledgeBaseBuilder() = default;
+
+bool KnowledgeBaseBuilder::add(uint64_t key, const RootCause& cause) {
+    FileRecord rec;
+    rec.key = key;
+    if (!impl_->intern(cause.description, rec.description) || !impl_->intern(cause.location.file, rec.file)) {
+        impl_->refused = true;
+        return false;
+    }
+    rec.description_size = static_cast<uint32_t>(cause.description.size());
+    rec.file_size = static_cast<uint32_t>(cause.location.file.size());
+    rec.line = cause.location.line;
+    rec.category = static_cast<uint8_t>(cause.category);
+    rec.reserved = 0;
+    rec.confidence = static_cast<uint16_t>(std::lround(std::clamp(cause.confidence, 0.0, 1.0) * 65535.0));
+    impl_->records.push_back(rec);
+    return true;
+}
+
+bool KnowledgeBaseBuilder::add(std::string_view error_message, const RootCause& cause) {
+    return add(errorMessageKey(error_message), cause);
+}
+
+bool KnowledgeBaseBuilder::add(const KnowledgeBase& knowledge_base) {
+    bool added = true;
+    knowledge_base.forEach([this, &added](uint64_t key, const RootCause& cause) {
+        added = add(key, cause) && added;
+    });
+    return added;
+}
+
+size_t KnowledgeBaseBuilder::size() const {
+    return impl_->records.size();
+}
+
+void KnowledgeBaseBuilder::clear() {
+    impl_->records.clear();
+    impl_->strings.clear();
+    impl_->string_offsets.clear();
+    impl_->refused = false;
+}
+
+bool KnowledgeBaseBuilder::save(const std::string& path) const {
+    if (impl_->refused) {
+        return false;
+    }
+    std::vector<FileRecord> records = impl_->records;
+    std::stable_sort(records.begin(), records.end(), [](const FileRecord& a, const FileRecord& b) {
+        return a.key < b.key;
+    });
+
+    FileHeader header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = KnowledgeBase::VERSION;
+    header.byte_order = BYTE_ORDER_MARK;
+    header.record_size = sizeof(FileRecord);
+    header.record_count = records.size();
+    header.strings_size = impl_->strings.size();
+
+    // A failed save leaves neither `path` changed nor the temporary behind.
+    std::string temp_path = path + ".tmp";
+    bool written = false;
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        if (file.is_open()) {
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char*>(records.data()),
+                       static_cast<std::streamsize>(records.size() * sizeof(FileRecord)));
+            file.write(impl_->strings.data(), static_cast<std::streamsize>(impl_->strings.size()));
+            file.close();
+            written = !file.fail();
+        }
+    }
+
+    std::error_code error;
+    if (written) {
+        std::filesystem::rename(temp_path, path, error);
+    }
+    if (!written || error) {
+        std::filesystem::remove(temp_path, error);
+        return false;
+    }
+    return true;
+}
+
+} // namespace ai_debugger
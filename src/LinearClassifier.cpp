@@ -0,0 +1,228 @@
+#include "ai_debugger/LinearClassifier.h"
+#include "ai_debugger/MappedFile.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <random>
+
+namespace ai_debugger {
+
+namespace {
+
+const char MAGIC[4] = {'A', 'I', 'L', 'C'};
+const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+struct ModelHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t dimension;
+    uint32_t classes;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(ModelHeader) == 24, "model header layout changed");
+
+void softmax(CategoryProbabilities& scores) {
+    double top = *std::max_element(scores.begin(), scores.end());
+    double sum = 0.0;
+    for (double& score : scores) {
+        score = std::exp(score - top);
+        sum += score;
+    }
+    for (double& score : scores) {
+        score /= sum;
+    }
+}
+
+// One weight per class, padded to a cache line so a feature's row is a
+// single aligned load sequence the compiler can vectorize.
+struct alignas(64) WeightRow {
+    float weights[16];
+};
+
+static_assert(BUG_CATEGORY_COUNT <= 16, "WeightRow too narrow for BugCategory");
+
+} // namespace
+
+struct LinearClassifier::Impl {
+    uint32_t dimension;  // power of two
+    bool trained = false;
+    WeightRow biases;
+    std::vector<WeightRow> rows;
+
+    explicit Impl(uint32_t dim) : dimension(FeatureVectorizer::roundDimension(dim)), biases() {
+        rows.resize(dimension, WeightRow());
+    }
+
+    WeightRow& row(uint32_t index) {
+        return rows[index & (dimension - 1)];
+    }
+
+    const WeightRow& row(uint32_t index) const {
+        return rows[index & (dimension - 1)];
+    }
+
+    void scores(const SparseFeatures& features, CategoryProbabilities& out) const {
+        WeightRow sum = biases;
+        for (size_t i = 0; i < features.size(); ++i) {
+            const WeightRow& weights = row(features.indices[i]);
+            float value = features.values[i];
+            for (size_t c = 0; c < 16; ++c) {
+                sum.weights[c] += weights.weights[c] * value;
+            }
+        }
+        for (size_t c = 0; c < BUG_CATEGORY_COUNT; ++c) {
+            out[c] = sum.weights[c];
+        }
+    }
+};
+
+LinearClassifier::LinearClassifier(uint32_t dimension) : impl_(std::make_unique<Impl>(dimension)) {}
+
+LinearClassifier::~LinearClassifier() = default;
+
+uint32_t LinearClassifier::dimension() const {
+    return impl_->dimension;
+}
+
+bool LinearClassifier::isTrained() const {
+    return impl_->trained;
+}
+
+void LinearClassifier::train(
+    const std::vector<std::pair<SparseFeatures, BugCategory>>& examples,
+    const TrainingOptions& options
+) {
+    impl_->biases = WeightRow();
+    std::fill(impl_->rows.begin(), impl_->rows.end(), WeightRow());
+    impl_->trained = !examples.empty();
+
+    std::vector<size_t> order(examples.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::mt19937 rng(options.seed);
+    CategoryProbabilities probabilities;
+
+    for (int epoch = 0; epoch < options.epochs; ++epoch) {
+        std::shuffle(order.begin(), order.end(), rng);
+        double rate = options.learning_rate / std::sqrt(1.0 + epoch);
+
+        for (size_t index : order) {
+            const SparseFeatures& features = examples[index].first;
+            size_t label = static_cast<size_t>(examples[index].second);
+
+            impl_->scores(features, probabilities);
+            softmax(probabilities);
+
+            for (size_t c = 0; c < BUG_CATEGORY_COUNT; ++c) {
+                double gradient = probabilities[c] - (c == label ? 1.0 : 0.0);
+                impl_->biases.weights[c] -= static_cast<float>(rate * gradient);
+                probabilities[c] = gradient;
+            }
+            // L2 is applied lazily, only to the rows this example touches.
+            for (size_t i = 0; i < features.size(); ++i) {
+                WeightRow& row = impl_->row(features.indices[i]);
+                double value = features.values[i];
+                for (size_t c = 0; c < BUG_CATEGORY_COUNT; ++c) {
+                    row.weights[c] -= static_cast<float>(rate * (probabilities[c] * value + options.l2 * row.weights[c]));
+                }
+            }
+        }
+    }
+}
+
+void LinearClassifier::predict(const SparseFeatures& features, CategoryProbabilities& probabilities) const {
+    impl_->scores(features, probabilities);
+    softmax(probabilities);
+}
+
+BugCategory LinearClassifier::classify(const SparseFeatures& features, double* probability) const {
+    CategoryProbabilities probabilities;
+    predict(features, probabilities);
+
+    auto best = std::max_element(probabilities.begin(), probabilities.end());
+    if (probability) {
+        *probability = *best;
+    }
+    return static_cast<BugCategory>(best - probabilities.begin());
+}
+
+bool LinearClassifier::load(const std::string& path) {
+    MappedFile file;
+    if (!file.open(path)) {
+        return false;
+    }
+
+    std::string_view data = file.data();
+    ModelHeader header;
+    if (data.size() < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+
+    size_t parameters = (static_cast<size_t>(header.dimension) + 1) * header.classes;
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        header.version != VERSION ||
+        header.byte_order != BYTE_ORDER_MARK ||
+        header.classes != BUG_CATEGORY_COUNT ||
+        header.dimension == 0 ||
+        data.size() != sizeof(header) + parameters * sizeof(float)) {
+        return false;
+    }
+
+    auto loaded = std::make_unique<Impl>(header.dimension);
+    if (loaded->dimension != header.dimension) {
+        return false;
+    }
+    const char* body = data.data() + sizeof(header);
+    std::memcpy(loaded->biases.weights, body, BUG_CATEGORY_COUNT * sizeof(float));
+    for (WeightRow& row : loaded->rows) {
+        body += BUG_CATEGORY_COUNT * sizeof(float);
+        std::memcpy(row.weights, body, BUG_CATEGORY_COUNT * sizeof(float));
+    }
+    loaded->trained = true;
+    impl_ = std::move(loaded);
+    return true;
+}
+
+bool LinearClassifier::save(const std::string& path) const {
+    ModelHeader header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.byte_order = BYTE_ORDER_MARK;
+    header.dimension = impl_->dimension;
+    header.classes = static_cast<uint32_t>(BUG_CATEGORY_COUNT);
+    header.reserved = 0;
+
+    // A failed save leaves neither `path` changed nor the temporary behind.
+    std::string temp_path = path + ".tmp";
+    bool written = false;
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        if (file.is_open()) {
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            const std::streamsize row_size = BUG_CATEGORY_COUNT * sizeof(float);
+            file.write(reinterpret_cast<const char*>(impl_->biases.weights), row_size);
+            for (const WeightRow& row : impl_->rows) {
+                file.write(reinterpret_cast<const char*>(row.weights), row_size);
+            }
+            file.close();
+            written = !file.fail();
+        }
+    }
+
+    std::error_code error;
+    if (written) {
+        std::filesystem::rename(temp_path, path, error);
+    }
+    if (!written || error) {
+        std::filesystem::remove(temp_path, error);
+        return false;
+    }
+    return true;
+}
+
+} // namespace ai_debugger
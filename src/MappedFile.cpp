@@ -0,0 +1,146 @@
+#include "ai_debugger/MappedFile.h"
+#include <utility>
+
+#ifdef _WIN32
+#include <fstream>
+#include <sstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace ai_debugger {
+
+struct MappedFile::Impl {
+    bool open = false;
+    const char* mapping = nullptr;
+    size_t mapping_size = 0;
+    std::string buffer;
+
+    ~Impl() {
+        release();
+    }
+
+    void release() {
+#ifndef _WIN32
+        if (mapping) {
+            munmap(const_cast<char*>(mapping), mapping_size);
+        }
+#endif
+        mapping = nullptr;
+        mapping_size = 0;
+        buffer.clear();
+        buffer.shrink_to_fit();
+        open = false;
+    }
+};
+
+MappedFile::MappedFile() : impl_(std::make_unique<Impl>()) {}
+
+MappedFile::~MappedFile() = default;
+
+// A moved-from file has no Impl, which every member treats as closed;
+// open() gives it a new one. Moves therefore never allocate.
+MappedFile::MappedFile(MappedFile&& other) noexcept : impl_(std::move(other.impl_)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        impl_ = std::move(other.impl_);
+    }
+    return *this;
+}
+
+bool MappedFile::open(const std::string& path) {
+    close();
+    if (!impl_) {
+        impl_ = std::make_unique<Impl>();
+    }
+
+#ifdef _WIN32
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::ostringstream oss;
+    oss << file.rdbuf();
+    impl_->buffer = oss.str();
+    impl_->open = true;
+    return true;
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    if (S_ISREG(info.st_mode) && info.st_size > 0) {
+        size_t length = static_cast<size_t>(info.st_size);
+        void* mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED) {
+            madvise(mapping, length, MADV_SEQUENTIAL);
+            ::close(fd);
+            impl_->mapping = static_cast<const char*>(mapping);
+            impl_->mapping_size = length;
+            impl_->open = true;
+            return true;
+        }
+    }
+
+    // Pipes, FIFOs and files mmap refuses are read in one pass instead.
+    char chunk[64 * 1024];
+    while (true) {
+        ssize_t count = ::read(fd, chunk, sizeof(chunk));
+        if (count > 0) {
+            impl_->buffer.append(chunk, static_cast<size_t>(count));
+        } else if (count == 0) {
+            break;
+        } else if (errno != EINTR) {
+            ::close(fd);
+            impl_->buffer.clear();
+            return false;
+        }
+    }
+
+    ::close(fd);
+    impl_->open = true;
+    return true;
+#endif
+}
+
+void MappedFile::close() {
+    if (impl_) {
+        impl_->release();
+    }
+}
+
+bool MappedFile::isOpen() const {
+    return impl_ && impl_->open;
+}
+
+bool MappedFile::isMapped() const {
+    return impl_ && impl_->mapping != nullptr;
+}
+
+std::string_view MappedFile::data() const {
+    if (!impl_) {
+        return std::string_view();
+    }
+    if (impl_->mapping) {
+        return std::string_view(impl_->mapping, impl_->mapping_size);
+    }
+    return impl_->buffer;
+}
+
+size_t MappedFile::size() const {
+    return data().size();
+}
+
+} // namespace ai_debugger
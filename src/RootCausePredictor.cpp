@@ -1,10 +1,91 @@
 #include "ai_debugger/RootCausePredictor.h"
+#include "ai_debugger/HeuristicRules.h"
+#include "ai_debugger/CrashHistory.h"
+#include "ai_debugger/KnowledgeBase.h"
+#include "ai_debugger/LinearClassifier.h"
+#include "ai_debugger/CrashSignature.h"
 #include <algorithm>
 #include <sstream>
 #include <map>
+#include <unordered_map>
 
 namespace ai_debugger {
 
+namespace {
+
+const SourceLocation& toSourceLocation(const SourceLocation& location) {
+    return location;
+}
+
+SourceLocation toSourceLocation(const SourceLocationView& location) {
+    return location.materialize();
+}
+
+template <typename Trace>
+PredictionFeaturesView collectFeatures(const Trace& trace) {
+    PredictionFeaturesView features;
+    features.error_message = trace.error_message;
+    features.stack_depth = static_cast<int>(trace.frames.size());
+    features.signal_number = trace.signal_number;
+    features.function_names.reserve(trace.frames.size());
+
+    for (const auto& frame : trace.frames) {
+        std::string_view name = frame.function_name;
+        features.function_names.push_back(name);
+
+        std::string_view module = frame.module;
+        if (!module.empty() && (features.modules.empty() || features.modules.back() != module)) {
+            features.modules.push_back(module);
+        }
+
+        uint32_t keywords = functionKeywords(name);
+        features.has_allocation |= (keywords & ALLOCATES) != 0;
+        features.has_deallocation |= (keywords & DEALLOCATES) != 0;
+        features.has_threading |= (keywords & THREADING) != 0;
+    }
+
+    return features;
+}
+
+// Classifier predictions below this probability are not reported.
+const double MIN_MODEL_PROBABILITY = 0.35;
+
+// Confirmed past crashes consulted per prediction, and how alike they must be.
+const size_t HISTORY_NEIGHBORS = 5;
+const double MIN_NEIGHBOR_SIMILARITY = 0.8;
+
+template <typename Trace>
+std::vector<RootCause> matchPatterns(const Trace& trace) {
+    std::vector<RootCause> causes;
+
+    bool has_dealloc_in_trace = false;
+    int dealloc_index = -1;
+
+    for (size_t i = 0; i < trace.frames.size(); ++i) {
+        std::string_view name = trace.frames[i].function_name;
+        if (functionKeywords(name) & DEALLOCATES) {
+            has_dealloc_in_trace = true;
+            dealloc_index = static_cast<int>(i);
+            break;
+        }
+    }
+
+    if (has_dealloc_in_trace && dealloc_index >= 0) {
+        RootCause cause;
+        cause.category = BugCategory::USE_AFTER_FREE;
+        cause.description = "Potential use-after-free: memory accessed after deallocation";
+        cause.confidence = 0.70;
+        if (dealloc_index < static_cast<int>(trace.frames.size())) {
+            cause.location = toSourceLocation(trace.frames[dealloc_index].location);
+        }
+        causes.push_back(cause);
+    }
+
+    return causes;
+}
+
+} // namespace
+
 const char* bugCategoryToString(BugCategory category) {
     switch (category) {
         case BugCategory::MEMORY_ERROR: return "Memory Error";
@@ -46,18 +127,37 @@ BugCategory stringToBugCategory(const std::string& str) {
 }
 
 struct RootCausePredictor::Impl {
-    std::map<std::string, std::vector<RootCause>> knowledge_base;
+    std::shared_ptr<RuleEngine> rules = std::make_shared<RuleEngine>();
+    std::shared_ptr<const KnowledgeBase> knowledge_base;
+    std::unordered_map<uint64_t, std::vector<RootCause>> trained;
+
+    std::shared_ptr<const LinearClassifier> model;
+    std::shared_ptr<CrashHistory> history;
+    std::vector<std::pair<SparseFeatures, BugCategory>> training_set;
+    SparseFeatures features;
 };
 
+PredictionFeaturesView::PredictionFeaturesView(const PredictionFeatures& features)
+    : error_message(features.error_message)
+    , function_names(features.function_names.begin(), features.function_names.end())
+    , modules(features.modules.begin(), features.modules.end())
+    , has_allocation(features.has_allocation)
+    , has_deallocation(features.has_deallocation)
+    , has_pointer_arithmetic(features.has_pointer_arithmetic)
+    , has_threading(features.has_threading)
+    , stack_depth(features.stack_depth)
+    , signal_number(features.signal_number) {}
+
 RootCausePredictor::RootCausePredictor() : impl_(std::make_unique<Impl>()) {}
 
 RootCausePredictor::~RootCausePredictor() = default;
 
-std::vector<RootCause> RootCausePredictor::predict(
-    const StackTrace& trace,
+template <typename Trace>
+std::vector<RootCause> RootCausePredictor::predictFrom(
+    const Trace& trace,
     const CallGraphAnalyzer& graph_analyzer
 ) {
-    PredictionFeatures features = extractFeatures(trace, graph_analyzer);
+    PredictionFeaturesView features = extractFeatures(trace, graph_analyzer);
 
     std::vector<RootCause> causes;
 
@@ -67,6 +167,31 @@ std::vector<RootCause> RootCausePredictor::predict(
     auto pattern_causes = applyPatternMatching(trace);
     causes.insert(causes.end(), pattern_causes.begin(), pattern_causes.end());
 
+    auto known_causes = applyKnowledgeBase(features);
+    causes.insert(causes.end(), known_causes.begin(), known_causes.end());
+
+    // The model and the crash history share one vectorization when their
+    // dimensions agree.
+    uint32_t vectorized_dimension = 0;
+    auto vectorize = [&](uint32_t dimension) -> const SparseFeatures& {
+        if (vectorized_dimension != dimension) {
+            FeatureVectorizer(dimension).vectorize(trace, impl_->features);
+            vectorized_dimension = dimension;
+        }
+        return impl_->features;
+    };
+
+    std::vector<RootCause> model_causes;
+    if (impl_->model && impl_->model->isTrained()) {
+        model_causes = applyMLModel(vectorize(impl_->model->dimension()));
+    }
+    causes.insert(causes.end(), model_causes.begin(), model_causes.end());
+
+    if (impl_->history && impl_->history->confirmedCount() > 0) {
+        auto history_causes = applyCrashHistory(vectorize(FeatureVectorizer::DEFAULT_DIMENSION));
+        causes.insert(causes.end(), history_causes.begin(), history_causes.end());
+    }
+
     for (auto& cause : causes) {
         cause.confidence = calculateConfidence(cause, features);
     }
@@ -76,6 +201,20 @@ std::vector<RootCause> RootCausePredictor::predict(
     return causes;
 }
 
+std::vector<RootCause> RootCausePredictor::predict(
+    const StackTrace& trace,
+    const CallGraphAnalyzer& graph_analyzer
+) {
+    return predictFrom(trace, graph_analyzer);
+}
+
+std::vector<RootCause> RootCausePredictor::predict(
+    const StackTraceView& trace,
+    const CallGraphAnalyzer& graph_analyzer
+) {
+    return predictFrom(trace, graph_analyzer);
+}
+
 RootCause RootCausePredictor::getMostLikelyCause(
     const StackTrace& trace,
     const CallGraphAnalyzer& graph_analyzer
@@ -92,7 +231,62 @@ RootCause RootCausePredictor::getMostLikelyCause(
     return unknown;
 }
 
-void RootCausePredictor::loadKnowledgeBase(const std::string& kb_path) {
+bool RootCausePredictor::loadKnowledgeBase(const std::string& kb_path) {
+    auto knowledge_base = std::make_shared<KnowledgeBase>();
+    if (!knowledge_base->open(kb_path)) {
+        return false;
+    }
+    impl_->knowledge_base = std::move(knowledge_base);
+    return true;
+}
+
+void RootCausePredictor::setKnowledgeBase(std::shared_ptr<const KnowledgeBase> knowledge_base) {
+    impl_->knowledge_base = std::move(knowledge_base);
+}
+
+std::shared_ptr<const KnowledgeBase> RootCausePredictor::getKnowledgeBase() const {
+    return impl_->knowledge_base;
+}
+
+bool RootCausePredictor::loadModel(const std::string& model_path) {
+    auto model = std::make_shared<LinearClassifier>();
+    if (!model->load(model_path)) {
+        return false;
+    }
+    impl_->model = std::move(model);
+    return true;
+}
+
+bool RootCausePredictor::saveModel(const std::string& model_path) const {
+    return impl_->model && impl_->model->save(model_path);
+}
+
+void RootCausePredictor::setModel(std::shared_ptr<const LinearClassifier> model) {
+    impl_->model = std::move(model);
+}
+
+std::shared_ptr<const LinearClassifier> RootCausePredictor::getModel() const {
+    return impl_->model;
+}
+
+void RootCausePredictor::setCrashHistory(std::shared_ptr<CrashHistory> history) {
+    impl_->history = std::move(history);
+}
+
+std::shared_ptr<CrashHistory> RootCausePredictor::getCrashHistory() const {
+    return impl_->history;
+}
+
+bool RootCausePredictor::loadRules(const std::string& rules_path, std::string* error) {
+    return impl_->rules->load(rules_path, error);
+}
+
+void RootCausePredictor::setRuleEngine(std::shared_ptr<RuleEngine> engine) {
+    impl_->rules = engine ? std::move(engine) : std::make_shared<RuleEngine>();
+}
+
+std::shared_ptr<RuleEngine> RootCausePredictor::getRuleEngine() const {
+    return impl_->rules;
 }
 
 void RootCausePredictor::trainFromExamples(
@@ -102,99 +296,98 @@ void RootCausePredictor::trainFromExamples(
         const auto& trace = example.first;
         const auto& cause = example.second;
 
-        std::string key = trace.error_message;
-        impl_->knowledge_base[key].push_back(cause);
-    }
-}
-
-PredictionFeatures RootCausePredictor::extractFeatures(
-    const StackTrace& trace,
-    const CallGraphAnalyzer& graph
-) {
-    PredictionFeatures features;
-    features.error_message = trace.error_message;
-    features.stack_depth = static_cast<int>(trace.frames.size());
+        auto& known = impl_->trained[errorMessageKey(trace.error_message)];
+        bool duplicate = std::any_of(known.begin(), known.end(), [&](const RootCause& existing) {
+            return existing.category == cause.category &&
+                   existing.description == cause.description &&
+                   existing.location.file == cause.location.file &&
+                   existing.location.line == cause.location.line;
+        });
+        if (!duplicate) {
+            known.push_back(cause);
+        }
 
-    for (const auto& frame : trace.frames) {
-        features.function_names.push_back(frame.function_name);
+        impl_->training_set.emplace_back();
+        FeatureVectorizer().vectorize(trace, impl_->training_set.back().first);
+        impl_->training_set.back().second = cause.category;
 
-        if (frame.function_name.find("malloc") != std::string::npos ||
-            frame.function_name.find("new") != std::string::npos ||
-            frame.function_name.find("alloc") != std::string::npos) {
-            features.has_allocation = true;
+        if (impl_->history) {
+            impl_->history->record(impl_->training_set.back().first, std::string(), cause, true);
         }
+    }
+}
 
-        if (frame.function_name.find("free") != std::string::npos ||
-            frame.function_name.find("delete") != std::string::npos) {
-            features.has_deallocation = true;
+bool RootCausePredictor::trainModel(std::string* error) {
+    const auto& examples = impl_->training_set;
+    if (examples.size() < MIN_TRAINING_EXAMPLES) {
+        if (error) {
+            *error = "need at least " + std::to_string(MIN_TRAINING_EXAMPLES) + " examples, have " +
+                     std::to_string(examples.size());
         }
-
-        if (frame.function_name.find("thread") != std::string::npos ||
-            frame.function_name.find("mutex") != std::string::npos ||
-            frame.function_name.find("lock") != std::string::npos) {
-            features.has_threading = true;
+        return false;
+    }
+    bool one_category = std::all_of(examples.begin(), examples.end(), [&](const auto& example) {
+        return example.second == examples.front().second;
+    });
+    if (one_category) {
+        if (error) {
+            *error = "all examples are " + std::string(bugCategoryToString(examples.front().second)) +
+                     "; need at least two categories";
         }
+        return false;
     }
 
-    return features;
+    auto model = std::make_shared<LinearClassifier>();
+    model->train(examples);
+    impl_->model = std::move(model);
+    return true;
 }
 
-std::vector<RootCause> RootCausePredictor::applyHeuristics(const PredictionFeatures& features) {
-    std::vector<RootCause> causes;
-
-    std::string error_lower = features.error_message;
-    std::transform(error_lower.begin(), error_lower.end(), error_lower.begin(), ::tolower);
-
-    if (error_lower.find("segmentation fault") != std::string::npos ||
-        error_lower.find("sigsegv") != std::string::npos) {
-
-        if (error_lower.find("null") != std::string::npos ||
-            error_lower.find("0x0") != std::string::npos) {
-            RootCause cause;
-            cause.category = BugCategory::NULL_POINTER;
-            cause.description = "Null pointer dereference detected from segmentation fault";
-            cause.confidence = 0.85;
-            causes.push_back(cause);
-        } else {
-            RootCause cause;
-            cause.category = BugCategory::MEMORY_ERROR;
-            cause.description = "Invalid memory access causing segmentation fault";
-            cause.confidence = 0.75;
-            causes.push_back(cause);
+bool RootCausePredictor::saveKnowledgeBase(const std::string& kb_path) const {
+    KnowledgeBaseBuilder builder;
+    if (impl_->knowledge_base && !builder.add(*impl_->knowledge_base)) {
+        return false;
+    }
+    for (const auto& entry : impl_->trained) {
+        for (const auto& cause : entry.second) {
+            if (!builder.add(entry.first, cause)) {
+                return false;
+            }
         }
     }
+    return builder.save(kb_path);
+}
 
-    if (error_lower.find("double free") != std::string::npos) {
-        RootCause cause;
-        cause.category = BugCategory::DOUBLE_FREE;
-        cause.description = "Double free corruption detected";
-        cause.confidence = 0.95;
-        causes.push_back(cause);
-    }
+PredictionFeaturesView RootCausePredictor::extractFeatures(
+    const StackTrace& trace,
+    const CallGraphAnalyzer& graph
+) {
+    return collectFeatures(trace);
+}
 
-    if (error_lower.find("heap") != std::string::npos &&
-        error_lower.find("corruption") != std::string::npos) {
-        RootCause cause;
-        cause.category = BugCategory::BUFFER_OVERFLOW;
-        cause.description = "Heap corruption likely due to buffer overflow";
-        cause.confidence = 0.80;
-        causes.push_back(cause);
-    }
+PredictionFeaturesView RootCausePredictor::extractFeatures(
+    const StackTraceView& trace,
+    const CallGraphAnalyzer& /*graph*/
+) {
+    return collectFeatures(trace);
+}
 
-    if (features.has_threading) {
-        RootCause cause;
-        cause.category = BugCategory::RACE_CONDITION;
-        cause.description = "Possible race condition in multithreaded code";
-        cause.confidence = 0.60;
-        causes.push_back(cause);
-    }
+std::vector<RootCause> RootCausePredictor::applyHeuristics(const PredictionFeaturesView& features) {
+    std::vector<RootCause> causes;
 
-    if (error_lower.find("assertion") != std::string::npos ||
-        error_lower.find("assert") != std::string::npos) {
+    std::vector<uint32_t> fired;
+    // One snapshot per call; a concurrent reload takes effect on the next.
+    std::shared_ptr<const RuleSet> snapshot = impl_->rules->current();
+    const RuleSet& rules = *snapshot;
+    rules.match(features, fired);
+
+    causes.reserve(fired.size());
+    for (uint32_t index : fired) {
+        const KeywordRule& rule = rules.rules()[index];
         RootCause cause;
-        cause.category = BugCategory::ASSERTION_FAILURE;
-        cause.description = "Assertion failed indicating logic error";
-        cause.confidence = 0.90;
+        cause.category = rule.category;
+        cause.description = rule.description;
+        cause.confidence = rule.score;
         causes.push_back(cause);
     }
 
@@ -202,42 +395,84 @@ std::vector<RootCause> RootCausePredictor::applyHeuristics(const PredictionFeatu
 }
 
 std::vector<RootCause> RootCausePredictor::applyPatternMatching(const StackTrace& trace) {
+    return matchPatterns(trace);
+}
+
+std::vector<RootCause> RootCausePredictor::applyPatternMatching(const StackTraceView& trace) {
+    return matchPatterns(trace);
+}
+
+std::vector<RootCause> RootCausePredictor::applyKnowledgeBase(const PredictionFeaturesView& features) {
     std::vector<RootCause> causes;
+    if (features.error_message.empty()) {
+        return causes;
+    }
 
-    bool has_dealloc_in_trace = false;
-    int dealloc_index = -1;
+    uint64_t key = errorMessageKey(features.error_message);
+    if (impl_->knowledge_base) {
+        impl_->knowledge_base->lookup(key, causes);
+    }
+    auto it = impl_->trained.find(key);
+    if (it != impl_->trained.end()) {
+        causes.insert(causes.end(), it->second.begin(), it->second.end());
+    }
+    return causes;
+}
 
-    for (size_t i = 0; i < trace.frames.size(); ++i) {
-        const auto& frame = trace.frames[i];
-        if (frame.function_name.find("free") != std::string::npos ||
-            frame.function_name.find("delete") != std::string::npos) {
-            has_dealloc_in_trace = true;
-            dealloc_index = static_cast<int>(i);
-            break;
-        }
+std::vector<RootCause> RootCausePredictor::applyMLModel(const SparseFeatures& features) {
+    std::vector<RootCause> causes;
+    if (!impl_->model || !impl_->model->isTrained()) {
+        return causes;
     }
 
-    if (has_dealloc_in_trace && dealloc_index >= 0) {
-        RootCause cause;
-        cause.category = BugCategory::USE_AFTER_FREE;
-        cause.description = "Potential use-after-free: memory accessed after deallocation";
-        cause.confidence = 0.70;
-        if (dealloc_index < static_cast<int>(trace.frames.size())) {
-            cause.location = trace.frames[dealloc_index].location;
-        }
-        causes.push_back(cause);
+    double probability = 0.0;
+    BugCategory category = impl_->model->classify(features, &probability);
+    if (category == BugCategory::UNKNOWN || probability < MIN_MODEL_PROBABILITY) {
+        return causes;
     }
 
+    RootCause cause;
+    cause.category = category;
+    cause.description = std::string("Classifier prediction: ") + bugCategoryToString(category);
+    cause.confidence = probability;
+    causes.push_back(cause);
     return causes;
 }
 
-std::vector<RootCause> RootCausePredictor::applyMLModel(const PredictionFeatures& features) {
-    return {};
+std::vector<RootCause> RootCausePredictor::applyCrashHistory(const SparseFeatures& features) {
+    std::vector<RootCause> causes;
+    auto neighbors = impl_->history->nearest(features, HISTORY_NEIGHBORS, MIN_NEIGHBOR_SIMILARITY, true);
+
+    // Confirmed causes are certain for their own crash, so a neighbor's
+    // confidence is its similarity. One cause per category, from its
+    // strongest neighbor; the others are listed as contributing factors.
+    for (const auto& neighbor : neighbors) {
+        double confidence = neighbor.similarity;
+        auto same = std::find_if(causes.begin(), causes.end(), [&](const RootCause& cause) {
+            return cause.category == neighbor.root_cause.category;
+        });
+        if (same == causes.end()) {
+            RootCause cause = neighbor.root_cause;
+            cause.description = "Similar past crash: " + neighbor.root_cause.description;
+            cause.confidence = confidence;
+            cause.contributing_factors.clear();
+            causes.push_back(std::move(cause));
+            same = causes.end() - 1;
+        } else if (confidence > same->confidence) {
+            same->confidence = confidence;
+        }
+
+        std::ostringstream factor;
+        factor << (neighbor.session_id.empty() ? std::string("Training example") : "Session " + neighbor.session_id)
+               << " (" << static_cast<int>(neighbor.similarity * 100 + 0.5) << "% similar)";
+        same->contributing_factors.push_back(factor.str());
+    }
+    return causes;
 }
 
 double RootCausePredictor::calculateConfidence(
     const RootCause& cause,
-    const PredictionFeatures& features
+    const PredictionFeaturesView& features
 ) {
     double confidence = cause.confidence;
 
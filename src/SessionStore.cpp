@@ -0,0 +1,1174 @@
+#include "ai_debugger/SessionStore.h"
+#include "ai_debugger/CrashSignature.h"
+#include "ai_debugger/MappedFile.h"
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace ai_debugger {
+
+namespace {
+
+const char MAGIC[4] = {'A', 'I', 'S', 'S'};
+const uint32_t BYTE_ORDER_MARK = 0x01020304;
+const uint64_t MAX_RECORD_SIZE = 1ull << 30;
+const uint64_t MAX_SEGMENT_SIZE = 1ull << 30;  // keeps offsets within 32 bits
+
+struct SegmentHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(SegmentHeader) == 16, "segment header layout changed");
+
+enum RecordType : uint32_t {
+    RECORD_SESSION = 1,
+    RECORD_ERASE = 2
+};
+
+struct RecordHeader {
+    uint32_t crc;  // of the header fields below and the body
+    uint32_t type;
+    int64_t time;
+    uint32_t id_size;
+    uint32_t body_size;
+};
+
+static_assert(sizeof(RecordHeader) == 24, "record header layout changed");
+
+uint32_t crc32(const void* data, size_t size, uint32_t crc = 0) {
+    static const auto table = [] {
+        std::array<uint32_t, 256> entries{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t value = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+            }
+            entries[i] = value;
+        }
+        return entries;
+    }();
+
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    crc = ~crc;
+    for (size_t i = 0; i < size; ++i) {
+        crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+uint32_t recordCrc(const RecordHeader& header, const char* payload) {
+    uint32_t crc = crc32(reinterpret_cast<const char*>(&header) + sizeof(header.crc),
+                         sizeof(header) - sizeof(header.crc));
+    return crc32(payload, header.id_size + header.body_size, crc);
+}
+
+// Unbuffered positioned I/O on a file descriptor.
+#ifdef _WIN32
+int openFile(const std::string& path) {
+    return _open(path.c_str(), _O_RDWR | _O_BINARY | _O_CREAT, _S_IREAD | _S_IWRITE);
+}
+
+void closeFile(int fd) {
+    _close(fd);
+}
+
+bool readAt(int fd, uint64_t offset, void* data, size_t size) {
+    return _lseeki64(fd, static_cast<__int64>(offset), SEEK_SET) >= 0 &&
+           _read(fd, data, static_cast<unsigned>(size)) == static_cast<int>(size);
+}
+
+bool writeAt(int fd, uint64_t offset, const void* data, size_t size) {
+    return _lseeki64(fd, static_cast<__int64>(offset), SEEK_SET) >= 0 &&
+           _write(fd, data, static_cast<unsigned>(size)) == static_cast<int>(size);
+}
+
+bool syncFile(int fd) {
+    return _commit(fd) == 0;
+}
+
+bool truncateFile(int fd, uint64_t size) {
+    return _chsize_s(fd, static_cast<__int64>(size)) == 0;
+}
+
+bool lockFile(int) {
+    return true;
+}
+#else
+int openFile(const std::string& path) {
+    return ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+}
+
+void closeFile(int fd) {
+    ::close(fd);
+}
+
+bool readAt(int fd, uint64_t offset, void* data, size_t size) {
+    char* out = static_cast<char*>(data);
+    while (size > 0) {
+        ssize_t n = ::pread(fd, out, size, static_cast<off_t>(offset));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        out += n;
+        offset += static_cast<uint64_t>(n);
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool writeAt(int fd, uint64_t offset, const void* data, size_t size) {
+    const char* in = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t n = ::pwrite(fd, in, size, static_cast<off_t>(offset));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        in += n;
+        offset += static_cast<uint64_t>(n);
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool syncFile(int fd) {
+    return ::fsync(fd) == 0;
+}
+
+bool truncateFile(int fd, uint64_t size) {
+    return ::ftruncate(fd, static_cast<off_t>(size)) == 0;
+}
+
+bool lockFile(int fd) {
+    return ::flock(fd, LOCK_EX | LOCK_NB) == 0;
+}
+#endif
+
+bool setError(std::string* error, const std::string& message) {
+    if (error) {
+        *error = message;
+    }
+    return false;
+}
+
+std::string segmentName(uint32_t number) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%08u.seg", number);
+    return name;
+}
+
+bool parseSegmentName(const std::string& name, uint32_t& number) {
+    if (name.size() != 12 || name.compare(8, 4, ".seg") != 0) {
+        return false;
+    }
+    number = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        if (name[i] < '0' || name[i] > '9') {
+            return false;
+        }
+        number = number * 10 + static_cast<uint32_t>(name[i] - '0');
+    }
+    return number != 0;
+}
+
+// Native-order field encoding for serializeSession().
+class Writer {
+public:
+    explicit Writer(std::string& out) : out_(out) {}
+
+    template <typename T>
+    void pod(T value) {
+        out_.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    void u32(uint32_t value) { pod(value); }
+    void u64(uint64_t value) { pod(value); }
+    void i32(int value) { pod(static_cast<int32_t>(value)); }
+    void f64(double value) { pod(value); }
+
+    void str(const std::string& value) {
+        u32(static_cast<uint32_t>(value.size()));
+        out_.append(value);
+    }
+
+    void strings(const std::vector<std::string>& values) {
+        u32(static_cast<uint32_t>(values.size()));
+        for (const auto& value : values) {
+            str(value);
+        }
+    }
+
+    void location(const SourceLocation& location) {
+        str(location.file);
+        i32(location.line);
+        i32(location.column);
+    }
+
+    void frames(const std::vector<StackFrame>& frames) {
+        u32(static_cast<uint32_t>(frames.size()));
+        for (const auto& frame : frames) {
+            str(frame.function_name);
+            str(frame.mangled_name);
+            location(frame.location);
+            str(frame.module);
+            u64(static_cast<uint64_t>(frame.address));
+            strings(frame.parameters);
+        }
+    }
+
+    void cause(const RootCause& cause) {
+        u32(static_cast<uint32_t>(cause.category));
+        str(cause.description);
+        location(cause.location);
+        f64(cause.confidence);
+        strings(cause.contributing_factors);
+        frames(cause.relevant_frames);
+    }
+
+private:
+    std::string& out_;
+};
+
+class Reader {
+public:
+    explicit Reader(std::string_view data) : data_(data), ok_(true) {}
+
+    bool ok() const { return ok_; }
+    bool done() const { return data_.empty(); }
+
+    template <typename T>
+    T pod() {
+        T value{};
+        if (data_.size() < sizeof(T)) {
+            ok_ = false;
+            data_ = std::string_view();
+            return value;
+        }
+        std::memcpy(&value, data_.data(), sizeof(T));
+        data_.remove_prefix(sizeof(T));
+        return value;
+    }
+
+    uint32_t u32() { return pod<uint32_t>(); }
+    uint64_t u64() { return pod<uint64_t>(); }
+    int i32() { return pod<int32_t>(); }
+    double f64() { return pod<double>(); }
+
+    // Element counts are bounded by the remaining bytes, so a corrupt count
+    // cannot trigger a huge allocation.
+    uint32_t count() {
+        uint32_t n = u32();
+        if (n > data_.size()) {
+            ok_ = false;
+            data_ = std::string_view();
+            return 0;
+        }
+        return n;
+    }
+
+    void str(std::string& value) {
+        uint32_t size = count();
+        value.assign(data_.data(), size);
+        data_.remove_prefix(size);
+    }
+
+    void strings(std::vector<std::string>& values) {
+        values.resize(count());
+        for (auto& value : values) {
+            str(value);
+        }
+    }
+
+    void location(SourceLocation& location) {
+        str(location.file);
+        location.line = i32();
+        location.column = i32();
+    }
+
+    void frames(std::vector<StackFrame>& frames) {
+        frames.resize(count());
+        for (auto& frame : frames) {
+            str(frame.function_name);
+            str(frame.mangled_name);
+            location(frame.location);
+            str(frame.module);
+            frame.address = static_cast<uintptr_t>(u64());
+            strings(frame.parameters);
+        }
+    }
+
+    template <typename Enum>
+    Enum enumeration(uint32_t limit) {
+        uint32_t value = u32();
+        if (value >= limit) {
+            ok_ = false;
+        }
+        return static_cast<Enum>(value);
+    }
+
+    void cause(RootCause& cause) {
+        cause.category = enumeration<BugCategory>(static_cast<uint32_t>(BugCategory::UNKNOWN) + 1);
+        str(cause.description);
+        location(cause.location);
+        cause.confidence = f64();
+        strings(cause.contributing_factors);
+        frames(cause.relevant_frames);
+    }
+
+    // Counterparts of the readers above that only move past the field.
+    void skip(size_t size) {
+        if (size > data_.size()) {
+            ok_ = false;
+            data_ = std::string_view();
+            return;
+        }
+        data_.remove_prefix(size);
+    }
+
+    void skipStr() { skip(count()); }
+
+    void skipStrings() {
+        for (uint32_t n = count(); n > 0 && ok_; --n) {
+            skipStr();
+        }
+    }
+
+    void skipLocation() {
+        skipStr();
+        skip(2 * sizeof(int32_t));
+    }
+
+    void skipFrames() {
+        for (uint32_t n = count(); n > 0 && ok_; --n) {
+            skipStr();
+            skipStr();
+            skipLocation();
+            skipStr();
+            skip(sizeof(uint64_t));
+            skipStrings();
+        }
+    }
+
+    void skipCause() {
+        skip(sizeof(uint32_t));
+        skipStr();
+        skipLocation();
+        skip(sizeof(double));
+        skipStrings();
+        skipFrames();
+    }
+
+private:
+    std::string_view data_;
+    bool ok_;
+};
+
+} // namespace
+
+void serializeSession(const DebugSession& session, std::string& out) {
+    out.clear();
+    Writer w(out);
+
+    w.str(session.session_id);
+    w.str(session.timestamp);
+    w.u64(session.fingerprint);
+    w.u64(session.occurrence_count);
+
+    w.str(session.trace.error_message);
+    w.str(session.trace.exception_type);
+    w.i32(session.trace.signal_number);
+    w.frames(session.trace.frames);
+
+    w.u32(static_cast<uint32_t>(session.root_causes.size()));
+    for (const auto& cause : session.root_causes) {
+        w.cause(cause);
+    }
+
+    const Explanation& explanation = session.explanation;
+    w.str(explanation.summary);
+    w.str(explanation.detailed_analysis);
+    w.strings(explanation.step_by_step);
+    w.str(explanation.technical_details);
+    w.str(explanation.simplified_explanation);
+    w.strings(explanation.relevant_code_snippets);
+
+    w.u32(static_cast<uint32_t>(session.suggested_fixes.size()));
+    for (const auto& fix : session.suggested_fixes) {
+        w.u32(static_cast<uint32_t>(fix.type));
+        w.str(fix.description);
+        w.location(fix.location);
+        w.str(fix.original_code);
+        w.str(fix.fixed_code);
+        w.f64(fix.confidence);
+        w.strings(fix.affected_files);
+    }
+
+    const TestSuite& suite = session.regression_tests;
+    w.str(suite.suite_name);
+    w.str(suite.file_path);
+    w.u32(static_cast<uint32_t>(suite.framework));
+    w.u32(static_cast<uint32_t>(suite.test_cases.size()));
+    for (const auto& test : suite.test_cases) {
+        w.str(test.name);
+        w.str(test.description);
+        w.str(test.test_code);
+        w.str(test.setup_code);
+        w.str(test.teardown_code);
+        w.strings(test.dependencies);
+        w.u32(test.is_regression_test ? 1 : 0);
+    }
+
+    w.u32(static_cast<uint32_t>(session.similar_crashes.size()));
+    for (const auto& crash : session.similar_crashes) {
+        w.str(crash.session_id);
+        w.f64(crash.similarity);
+        w.cause(crash.root_cause);
+        w.u32(crash.confirmed ? 1 : 0);
+    }
+
+    w.u32(static_cast<uint32_t>(session.pending));
+    w.u32(session.root_cause_confirmed ? 1 : 0);
+}
+
+namespace {
+
+// With `summary_only` the explanation, fixes, tests and similar crashes are
+// skipped rather than decoded.
+bool readSession(std::string_view data, DebugSession& out, bool summary_only) {
+    Reader r(data);
+    DebugSession session;
+
+    r.str(session.session_id);
+    r.str(session.timestamp);
+    session.fingerprint = r.u64();
+    session.occurrence_count = r.u64();
+
+    r.str(session.trace.error_message);
+    r.str(session.trace.exception_type);
+    session.trace.signal_number = r.i32();
+    r.frames(session.trace.frames);
+
+    session.root_causes.resize(r.count());
+    for (auto& cause : session.root_causes) {
+        r.cause(cause);
+    }
+
+    if (summary_only) {
+        // Explanation.
+        r.skipStr();
+        r.skipStr();
+        r.skipStrings();
+        r.skipStr();
+        r.skipStr();
+        r.skipStrings();
+
+        // Suggested fixes.
+        for (uint32_t n = r.count(); n > 0 && r.ok(); --n) {
+            r.skip(sizeof(uint32_t));
+            r.skipStr();
+            r.skipLocation();
+            r.skipStr();
+            r.skipStr();
+            r.skip(sizeof(double));
+            r.skipStrings();
+        }
+
+        // Regression tests.
+        r.skipStr();
+        r.skipStr();
+        r.skip(sizeof(uint32_t));
+        for (uint32_t n = r.count(); n > 0 && r.ok(); --n) {
+            for (int field = 0; field < 5; ++field) {
+                r.skipStr();
+            }
+            r.skipStrings();
+            r.skip(sizeof(uint32_t));
+        }
+
+        // Similar crashes.
+        for (uint32_t n = r.count(); n > 0 && r.ok(); --n) {
+            r.skipStr();
+            r.skip(sizeof(double));
+            r.skipCause();
+            r.skip(sizeof(uint32_t));
+        }
+    } else {
+        Explanation& explanation = session.explanation;
+        r.str(explanation.summary);
+        r.str(explanation.detailed_analysis);
+        r.strings(explanation.step_by_step);
+        r.str(explanation.technical_details);
+        r.str(explanation.simplified_explanation);
+        r.strings(explanation.relevant_code_snippets);
+
+        session.suggested_fixes.resize(r.count());
+        for (auto& fix : session.suggested_fixes) {
+            fix.type = r.enumeration<FixType>(static_cast<uint32_t>(FixType::CUSTOM) + 1);
+            r.str(fix.description);
+            r.location(fix.location);
+            r.str(fix.original_code);
+            r.str(fix.fixed_code);
+            fix.confidence = r.f64();
+            r.strings(fix.affected_files);
+        }
+
+        TestSuite& suite = session.regression_tests;
+        r.str(suite.suite_name);
+        r.str(suite.file_path);
+        suite.framework = r.enumeration<TestFramework>(static_cast<uint32_t>(TestFramework::CUSTOM) + 1);
+        suite.test_cases.resize(r.count());
+        for (auto& test : suite.test_cases) {
+            r.str(test.name);
+            r.str(test.description);
+            r.str(test.test_code);
+            r.str(test.setup_code);
+            r.str(test.teardown_code);
+            r.strings(test.dependencies);
+            test.is_regression_test = r.u32() != 0;
+        }
+
+        session.similar_crashes.resize(r.count());
+        for (auto& crash : session.similar_crashes) {
+            r.str(crash.session_id);
+            crash.similarity = r.f64();
+            r.cause(crash.root_cause);
+            crash.confirmed = r.u32() != 0;
+        }
+    }
+
+    // Absent from sessions saved before analysis options, or confirmation,
+    // existed.
+    if (!r.done()) {
+        session.pending = static_cast<AnalysisOptions>(r.u32()) & AnalysisOptions::ALL;
+    }
+    if (!r.done()) {
+        session.root_cause_confirmed = r.u32() != 0;
+    }
+
+    if (!r.ok() || !r.done()) {
+        return false;
+    }
+    out = std::move(session);
+    return true;
+}
+
+} // namespace
+
+bool deserializeSession(std::string_view data, DebugSession& out) {
+    return readSession(data, out, false);
+}
+
+bool deserializeSessionSummary(std::string_view data, DebugSession& out) {
+    return readSession(data, out, true);
+}
+
+std::time_t parseSessionTimestamp(const std::string& timestamp) {
+    std::tm local_time{};
+    std::istringstream iss(timestamp);
+    iss >> std::get_time(&local_time, "%Y-%m-%d %H:%M:%S");
+    if (iss.fail()) {
+        return -1;
+    }
+    local_time.tm_isdst = -1;
+    return std::mktime(&local_time);
+}
+
+struct SessionStore::Impl {
+    struct Location {
+        uint32_t segment;
+        uint32_t offset;
+        uint32_t size;  // whole record
+    };
+
+    struct Segment {
+        int fd = -1;
+        uint64_t size = 0;        // bytes, header included
+        uint64_t live_bytes = 0;  // records the index points to
+        int64_t min_time = INT64_MAX;
+        int64_t max_time = INT64_MIN;
+    };
+
+    SessionStoreOptions options;
+    mutable std::mutex mutex;
+
+    std::string directory;
+    int lock_fd = -1;
+    std::map<uint32_t, Segment> segments;  // oldest first; the last is appended to
+    std::unordered_map<uint64_t, Location> index;  // fnv1a(session id)
+    bool unsynced = false;
+
+    std::string segmentPath(uint32_t number) const {
+        return directory + "/" + segmentName(number);
+    }
+
+    uint32_t active() const {
+        return segments.rbegin()->first;
+    }
+
+    // The index is keyed by fnv1a(id) alone, so the id stored in the record
+    // is compared too. Sets `collision` when another session holds the key.
+    const Location* find(std::string_view id, bool* collision = nullptr) const {
+        auto it = index.find(fnv1a(id));
+        if (it == index.end()) {
+            return nullptr;
+        }
+        RecordHeader record;
+        std::string stored;
+        auto segment = segments.find(it->second.segment);
+        bool same = segment != segments.end() &&
+                    readAt(segment->second.fd, it->second.offset, &record, sizeof(record)) &&
+                    record.id_size == id.size();
+        if (same) {
+            stored.resize(record.id_size);
+            same = readAt(segment->second.fd, it->second.offset + sizeof(record), &stored[0], stored.size()) &&
+                   stored == id;
+        }
+        if (!same) {
+            if (collision) {
+                *collision = true;
+            }
+            return nullptr;
+        }
+        return &it->second;
+    }
+
+    bool isLive(const Location& location, std::string_view id) const {
+        auto it = index.find(fnv1a(id));
+        return it != index.end() && it->second.segment == location.segment &&
+               it->second.offset == location.offset;
+    }
+
+    void track(uint64_t key, const Location& location, int64_t time) {
+        auto existing = index.find(key);
+        if (existing != index.end()) {
+            segments[existing->second.segment].live_bytes -= existing->second.size;
+        }
+        index[key] = location;
+        Segment& segment = segments[location.segment];
+        segment.live_bytes += location.size;
+        segment.min_time = std::min(segment.min_time, time);
+        segment.max_time = std::max(segment.max_time, time);
+    }
+
+    void untrack(uint64_t key) {
+        auto existing = index.find(key);
+        if (existing != index.end()) {
+            segments[existing->second.segment].live_bytes -= existing->second.size;
+            index.erase(existing);
+        }
+    }
+
+    bool createSegment(uint32_t number, std::string* error) {
+        int fd = openFile(segmentPath(number));
+        if (fd < 0) {
+            return setError(error, "cannot create " + segmentPath(number));
+        }
+        SegmentHeader header{};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.byte_order = BYTE_ORDER_MARK;
+        if (!truncateFile(fd, 0) || !writeAt(fd, 0, &header, sizeof(header))) {
+            closeFile(fd);
+            return setError(error, "cannot write " + segmentPath(number));
+        }
+        Segment& segment = segments[number];
+        segment.fd = fd;
+        segment.size = sizeof(header);
+        return true;
+    }
+
+    // Rebuilds the index entries of one segment, truncating it at the first
+    // record that is torn or fails its checksum.
+    bool replay(uint32_t number, std::string* error) {
+        std::string path = segmentPath(number);
+        MappedFile file;
+        if (!file.open(path)) {
+            return setError(error, "cannot read " + path);
+        }
+        std::string_view data = file.data();
+        if (data.size() < sizeof(SegmentHeader)) {
+            // Crashed while creating it.
+            file.close();
+            segments.erase(number);
+            std::filesystem::remove(path);
+            return createSegment(number, error);
+        }
+
+        SegmentHeader header;
+        std::memcpy(&header, data.data(), sizeof(header));
+        if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION ||
+            header.byte_order != BYTE_ORDER_MARK) {
+            return setError(error, path + ": not a version " + std::to_string(VERSION) +
+                                       " session segment for this byte order");
+        }
+
+        Segment& segment = segments[number];
+        segment.fd = openFile(path);
+        if (segment.fd < 0) {
+            return setError(error, "cannot open " + path);
+        }
+
+        uint64_t offset = sizeof(SegmentHeader);
+        while (data.size() - offset >= sizeof(RecordHeader)) {
+            RecordHeader record;
+            std::memcpy(&record, data.data() + offset, sizeof(record));
+            uint64_t size = sizeof(record) + static_cast<uint64_t>(record.id_size) + record.body_size;
+            const char* payload = data.data() + offset + sizeof(record);
+            if ((record.type != RECORD_SESSION && record.type != RECORD_ERASE) || record.id_size == 0 ||
+                size > MAX_RECORD_SIZE || size > data.size() - offset ||
+                recordCrc(record, payload) != record.crc) {
+                break;
+            }
+
+            uint64_t key = fnv1a(std::string_view(payload, record.id_size));
+            if (record.type == RECORD_SESSION) {
+                Location location{number, static_cast<uint32_t>(offset), static_cast<uint32_t>(size)};
+                track(key, location, record.time);
+            } else {
+                untrack(key);
+            }
+            offset += size;
+        }
+
+        segment.size = offset;
+        if (offset < data.size()) {
+            file.close();
+            if (!truncateFile(segment.fd, offset)) {
+                return setError(error, "cannot truncate " + path);
+            }
+        }
+        return true;
+    }
+
+    bool readRecord(const Location& location, RecordHeader& record, std::string& payload) const {
+        auto segment = segments.find(location.segment);
+        if (segment == segments.end() || location.size < sizeof(record)) {
+            return false;
+        }
+        if (!readAt(segment->second.fd, location.offset, &record, sizeof(record))) {
+            return false;
+        }
+        uint64_t payload_size = static_cast<uint64_t>(record.id_size) + record.body_size;
+        if (payload_size != location.size - sizeof(record)) {
+            return false;
+        }
+        payload.resize(payload_size);
+        return readAt(segment->second.fd, location.offset + sizeof(record), &payload[0], payload.size()) &&
+               recordCrc(record, payload.data()) == record.crc;
+    }
+
+    // Appends an encoded record (header included) to the active segment,
+    // rolling to a new one when it is full.
+    bool appendRaw(const std::string& record, Location& location) {
+        if (record.size() > MAX_RECORD_SIZE) {
+            return false;
+        }
+        uint64_t limit = std::min(std::max<uint64_t>(options.segment_size, 1), MAX_SEGMENT_SIZE);
+        if (segments.rbegin()->second.size + record.size() > limit &&
+            segments.rbegin()->second.size > sizeof(SegmentHeader)) {
+            Segment& full = segments.rbegin()->second;
+            if (unsynced && !syncFile(full.fd)) {
+                return false;
+            }
+            unsynced = false;
+            if (!createSegment(active() + 1, nullptr)) {
+                return false;
+            }
+        }
+
+        Segment& segment = segments.rbegin()->second;
+        if (!writeAt(segment.fd, segment.size, record.data(), record.size())) {
+            truncateFile(segment.fd, segment.size);
+            return false;
+        }
+        location.segment = active();
+        location.offset = static_cast<uint32_t>(segment.size);
+        location.size = static_cast<uint32_t>(record.size());
+        segment.size += record.size();
+
+        if (options.sync_writes) {
+            return syncFile(segment.fd);
+        }
+        unsynced = true;
+        return true;
+    }
+
+    bool append(RecordType type, int64_t time, const std::string& id, const std::string& body, Location& location) {
+        RecordHeader header{};
+        header.type = type;
+        header.time = time;
+        header.id_size = static_cast<uint32_t>(id.size());
+        header.body_size = static_cast<uint32_t>(body.size());
+
+        thread_local std::string record;
+        record.assign(reinterpret_cast<const char*>(&header), sizeof(header));
+        record += id;
+        record += body;
+        header.crc = recordCrc(header, record.data() + sizeof(header));
+        std::memcpy(&record[0], &header, sizeof(header.crc));
+        return appendRaw(record, location);
+    }
+
+    // Reads the id of every record in `number` and passes those of live
+    // sessions to `visit` with their timestamp.
+    void forEachLive(uint32_t number, const std::function<void(const Location&, int64_t, std::string&&)>& visit) const {
+        const Segment& segment = segments.at(number);
+        uint64_t offset = sizeof(SegmentHeader);
+        RecordHeader record;
+        while (offset + sizeof(record) <= segment.size && readAt(segment.fd, offset, &record, sizeof(record))) {
+            uint32_t size = static_cast<uint32_t>(sizeof(record) + record.id_size + record.body_size);
+            Location location{number, static_cast<uint32_t>(offset), size};
+            offset += size;
+            if (record.type != RECORD_SESSION) {
+                continue;
+            }
+            std::string id(record.id_size, '\0');
+            if (!readAt(segment.fd, location.offset + sizeof(record), &id[0], id.size())) {
+                break;
+            }
+            if (isLive(location, id)) {
+                visit(location, record.time, std::move(id));
+            }
+        }
+    }
+
+    // Decodes the live sessions with timestamps in [from, to) with `decode`.
+    size_t scan(std::time_t from, std::time_t to, const std::function<void(DebugSession&&)>& visit,
+                bool (*decode)(std::string_view, DebugSession&)) const {
+        // Matching locations are collected first so `visit` runs unlocked.
+        std::vector<Location> matches;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const auto& entry : segments) {
+                const Segment& segment = entry.second;
+                if (segment.live_bytes == 0 || segment.max_time < from || segment.min_time >= to) {
+                    continue;
+                }
+                forEachLive(entry.first, [&](const Location& location, int64_t time, std::string&&) {
+                    if (time >= from && time < to) {
+                        matches.push_back(location);
+                    }
+                });
+            }
+        }
+
+        size_t visited = 0;
+        RecordHeader record;
+        std::string payload;
+        for (const auto& location : matches) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!readRecord(location, record, payload)) {
+                    continue;  // compacted away meanwhile
+                }
+            }
+            DebugSession session;
+            if (decode(std::string_view(payload).substr(record.id_size), session)) {
+                visit(std::move(session));
+                ++visited;
+            }
+        }
+        return visited;
+    }
+
+    // Copies the live sessions of a sealed segment, and erasures still in
+    // effect, to the active segment and deletes it. Erasures are dropped
+    // from the oldest segment, which nothing older can resurrect.
+    bool compactSegment(uint32_t number) {
+        std::string path = segmentPath(number);
+        bool oldest = number == segments.begin()->first;
+        std::vector<std::pair<uint64_t, Location>> moved;
+        {
+            MappedFile file;
+            if (!file.open(path)) {
+                return false;
+            }
+            std::string_view data = file.data();
+            uint64_t offset = sizeof(SegmentHeader);
+            const uint64_t end = std::min<uint64_t>(segments[number].size, data.size());
+            std::string copy;
+            while (offset + sizeof(RecordHeader) <= end) {
+                RecordHeader record;
+                std::memcpy(&record, data.data() + offset, sizeof(record));
+                uint64_t size = sizeof(record) + static_cast<uint64_t>(record.id_size) + record.body_size;
+                std::string_view id(data.data() + offset + sizeof(record), record.id_size);
+                Location location{number, static_cast<uint32_t>(offset), static_cast<uint32_t>(size)};
+                offset += size;
+
+                bool keep = record.type == RECORD_SESSION ? isLive(location, id)
+                                                          : !oldest && !index.count(fnv1a(id));
+                if (!keep) {
+                    continue;
+                }
+                copy.assign(data.data() + location.offset, size);
+                Location target;
+                if (!appendRaw(copy, target)) {
+                    return false;
+                }
+                if (record.type == RECORD_SESSION) {
+                    moved.emplace_back(fnv1a(id), target);
+                    int64_t time = record.time;
+                    track(moved.back().first, target, time);
+                }
+            }
+        }
+
+        // The copies must be durable before the originals go away.
+        if (unsynced && !syncFile(segments.rbegin()->second.fd)) {
+            return false;
+        }
+        unsynced = false;
+
+        closeFile(segments[number].fd);
+        segments.erase(number);
+        std::error_code error;
+        std::filesystem::remove(path, error);
+        return !error;
+    }
+
+    void release() {
+        for (auto& entry : segments) {
+            if (unsynced && entry.first == active()) {
+                syncFile(entry.second.fd);
+            }
+            closeFile(entry.second.fd);
+        }
+        segments.clear();
+        index.clear();
+        unsynced = false;
+        if (lock_fd >= 0) {
+            closeFile(lock_fd);
+            lock_fd = -1;
+        }
+        directory.clear();
+    }
+};
+
+SessionStore::SessionStore(const SessionStoreOptions& options) : impl_(std::make_unique<Impl>()) {
+    impl_->options = options;
+}
+
+SessionStore::~SessionStore() {
+    close();
+}
+
+bool SessionStore::open(const std::string& directory, std::string* error) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->release();
+
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+    if (ec) {
+        return setError(error, "cannot create " + directory + ": " + ec.message());
+    }
+    impl_->directory = directory;
+
+    impl_->lock_fd = openFile(directory + "/LOCK");
+    if (impl_->lock_fd < 0 || !lockFile(impl_->lock_fd)) {
+        impl_->release();
+        return setError(error, directory + " is in use by another process");
+    }
+
+    std::vector<uint32_t> numbers;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+        uint32_t number;
+        if (entry.is_regular_file() && parseSegmentName(entry.path().filename().string(), number)) {
+            numbers.push_back(number);
+        }
+    }
+    std::sort(numbers.begin(), numbers.end());
+
+    for (uint32_t number : numbers) {
+        if (!impl_->replay(number, error)) {
+            impl_->release();
+            return false;
+        }
+    }
+    if (impl_->segments.empty() && !impl_->createSegment(1, error)) {
+        impl_->release();
+        return false;
+    }
+    return true;
+}
+
+void SessionStore::close() {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->release();
+}
+
+bool SessionStore::isOpen() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return !impl_->segments.empty();
+}
+
+std::string SessionStore::directory() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->directory;
+}
+
+bool SessionStore::put(const DebugSession& session) {
+    if (session.session_id.empty()) {
+        return false;
+    }
+    thread_local std::string body;
+    serializeSession(session, body);
+    std::time_t time = parseSessionTimestamp(session.timestamp);
+    if (time < 0) {
+        time = std::time(nullptr);
+    }
+
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    bool collision = false;
+    impl_->find(session.session_id, &collision);
+    Impl::Location location;
+    if (collision || impl_->segments.empty() ||
+        !impl_->append(RECORD_SESSION, time, session.session_id, body, location)) {
+        return false;
+    }
+    impl_->track(fnv1a(session.session_id), location, time);
+    return true;
+}
+
+bool SessionStore::get(const std::string& session_id, DebugSession& out) const {
+    RecordHeader record;
+    thread_local std::string payload;
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        auto it = impl_->index.find(fnv1a(session_id));
+        if (it == impl_->index.end() || !impl_->readRecord(it->second, record, payload)) {
+            return false;
+        }
+    }
+    std::string_view data(payload);
+    if (data.substr(0, record.id_size) != session_id) {
+        return false;
+    }
+    return deserializeSession(data.substr(record.id_size), out);
+}
+
+bool SessionStore::contains(const std::string& session_id) const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->find(session_id) != nullptr;
+}
+
+bool SessionStore::erase(const std::string& session_id) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    uint64_t key = fnv1a(session_id);
+    if (!impl_->find(session_id)) {
+        return false;
+    }
+    Impl::Location location;
+    if (!impl_->append(RECORD_ERASE, std::time(nullptr), session_id, std::string(), location)) {
+        return false;
+    }
+    impl_->untrack(key);
+    return true;
+}
+
+size_t SessionStore::size() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->index.size();
+}
+
+std::vector<std::string> SessionStore::sessionIds() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    std::vector<std::string> ids;
+    ids.reserve(impl_->index.size());
+    for (const auto& entry : impl_->segments) {
+        impl_->forEachLive(entry.first, [&](const Impl::Location&, int64_t, std::string&& id) {
+            ids.push_back(std::move(id));
+        });
+    }
+    return ids;
+}
+
+size_t SessionStore::scan(
+    std::time_t from,
+    std::time_t to,
+    const std::function<void(DebugSession&&)>& visit
+) const {
+    return impl_->scan(from, to, visit, deserializeSession);
+}
+
+size_t SessionStore::scanSummaries(
+    std::time_t from,
+    std::time_t to,
+    const std::function<void(DebugSession&&)>& visit
+) const {
+    return impl_->scan(from, to, visit, deserializeSessionSummary);
+}
+
+bool SessionStore::sync() {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (impl_->segments.empty()) {
+        return false;
+    }
+    if (impl_->unsynced && !syncFile(impl_->segments.rbegin()->second.fd)) {
+        return false;
+    }
+    impl_->unsynced = false;
+    return true;
+}
+
+bool SessionStore::compact() {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (impl_->segments.empty()) {
+        return false;
+    }
+
+    std::vector<uint32_t> sealed;
+    for (const auto& entry : impl_->segments) {
+        if (entry.first != impl_->active()) {
+            sealed.push_back(entry.first);
+        }
+    }
+    for (uint32_t number : sealed) {
+        const Impl::Segment& segment = impl_->segments[number];
+        uint64_t data_size = segment.size - sizeof(SegmentHeader);
+        if (data_size > 0 && segment.live_bytes >= impl_->options.compact_ratio * data_size) {
+            continue;
+        }
+        if (!impl_->compactSegment(number)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint64_t SessionStore::diskSize() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    uint64_t total = 0;
+    for (const auto& entry : impl_->segments) {
+        total += entry.second.size;
+    }
+    return total;
+}
+
+} // namespace ai_debugger
@@ -0,0 +1,157 @@
+#include "ai_debugger/SessionWriter.h"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ai_debugger {
+
+struct SessionWriter::Impl {
+    std::function<std::shared_ptr<SessionStore>()> store;
+    SessionWriterOptions options;
+
+    mutable std::mutex mutex;
+    std::condition_variable not_empty;
+    std::condition_variable not_full;
+    std::condition_variable done;
+    std::deque<DebugSession> queue;
+
+    uint64_t queued = 0;     // sessions ever accepted
+    uint64_t completed = 0;  // sessions written or failed
+    uint64_t written = 0;
+    uint64_t failed = 0;
+    uint64_t failed_at_flush = 0;
+    uint64_t opens_requested = 0;
+    uint64_t opens_done = 0;  // open() calls served by a later store() call
+    bool closing = false;
+    std::thread thread;
+
+    void run() {
+        std::vector<DebugSession> batch;
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            not_empty.wait(lock, [&] {
+                return !queue.empty() || opens_done < opens_requested || closing;
+            });
+            if (queue.empty() && opens_done == opens_requested) {
+                break;
+            }
+
+            // Possibly an empty batch, only to open the store.
+            uint64_t opens = opens_requested;
+            size_t count = std::min(queue.size(), options.max_batch);
+            batch.clear();
+            for (size_t i = 0; i < count; ++i) {
+                batch.push_back(std::move(queue.front()));
+                queue.pop_front();
+            }
+            not_full.notify_all();
+            lock.unlock();
+
+            uint64_t ok = 0;
+            if (auto target = store()) {
+                for (const auto& session : batch) {
+                    ok += target->put(session) ? 1 : 0;
+                }
+                if (options.sync && ok > 0 && !target->sync()) {
+                    ok = 0;
+                }
+            }
+
+            lock.lock();
+            opens_done = opens;
+            written += ok;
+            failed += batch.size() - ok;
+            completed += batch.size();
+            done.notify_all();
+        }
+    }
+};
+
+SessionWriter::SessionWriter(
+    std::function<std::shared_ptr<SessionStore>()> store,
+    const SessionWriterOptions& options
+) : impl_(std::make_unique<Impl>()) {
+    impl_->store = std::move(store);
+    impl_->options = options;
+    impl_->options.queue_capacity = std::max<size_t>(impl_->options.queue_capacity, 1);
+    impl_->options.max_batch = std::max<size_t>(impl_->options.max_batch, 1);
+    impl_->thread = std::thread([this] { impl_->run(); });
+}
+
+SessionWriter::SessionWriter(std::shared_ptr<SessionStore> store, const SessionWriterOptions& options)
+    : SessionWriter([store] { return store; }, options) {}
+
+SessionWriter::~SessionWriter() {
+    close();
+}
+
+bool SessionWriter::write(DebugSession session) {
+    std::unique_lock<std::mutex> lock(impl_->mutex);
+    impl_->not_full.wait(lock, [&] {
+        return impl_->queue.size() < impl_->options.queue_capacity || impl_->closing;
+    });
+    if (impl_->closing) {
+        return false;
+    }
+    impl_->queue.push_back(std::move(session));
+    ++impl_->queued;
+    impl_->not_empty.notify_one();
+    return true;
+}
+
+void SessionWriter::open() {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (impl_->closing) {
+        return;
+    }
+    ++impl_->opens_requested;
+    impl_->not_empty.notify_one();
+}
+
+bool SessionWriter::flush() {
+    std::unique_lock<std::mutex> lock(impl_->mutex);
+    uint64_t target = impl_->queued;
+    uint64_t opens = impl_->opens_requested;
+    impl_->done.wait(lock, [&] { return impl_->completed >= target && impl_->opens_done >= opens; });
+    bool ok = impl_->failed == impl_->failed_at_flush;
+    impl_->failed_at_flush = impl_->failed;
+    lock.unlock();
+
+    if (!impl_->options.sync) {
+        auto store = impl_->store();
+        ok = store && store->sync() && ok;
+    }
+    return ok;
+}
+
+void SessionWriter::close() {
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        impl_->closing = true;
+    }
+    impl_->not_empty.notify_all();
+    impl_->not_full.notify_all();
+    if (impl_->thread.joinable()) {
+        impl_->thread.join();
+    }
+}
+
+size_t SessionWriter::pending() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return static_cast<size_t>(impl_->queued - impl_->completed);
+}
+
+uint64_t SessionWriter::written() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->written;
+}
+
+uint64_t SessionWriter::failed() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->failed;
+}
+
+} // namespace ai_debugger
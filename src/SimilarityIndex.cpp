@@ -0,0 +1,240 @@
+#include "ai_debugger/SimilarityIndex.h"
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+namespace ai_debugger {
+
+namespace {
+
+constexpr size_t WORDS = SimilarityIndex::SIGNATURE_BITS / 64;
+constexpr double PI = 3.14159265358979323846;
+
+uint64_t mix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+int popcount(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(x);
+#else
+    int count = 0;
+    for (; x; x &= x - 1) {
+        ++count;
+    }
+    return count;
+#endif
+}
+
+int hammingDistance(const SimilarityIndex::Signature& a, const SimilarityIndex::Signature& b) {
+    int distance = 0;
+    for (size_t w = 0; w < WORDS; ++w) {
+        distance += popcount(a[w] ^ b[w]);
+    }
+    return distance;
+}
+
+double hammingToSimilarity(int distance) {
+    return std::cos(PI * distance / SimilarityIndex::SIGNATURE_BITS);
+}
+
+// Bits [band * bits, (band + 1) * bits) of the signature, tagged with the
+// band so buckets of different bands never collide.
+uint64_t bandKey(const SimilarityIndex::Signature& signature, size_t band, size_t bits) {
+    size_t start = band * bits;
+    size_t word = start / 64;
+    size_t shift = start % 64;
+    uint64_t value = signature[word] >> shift;
+    if (shift + bits > 64 && word + 1 < WORDS) {
+        value |= signature[word + 1] << (64 - shift);
+    }
+    value &= (1ull << bits) - 1;
+    return (static_cast<uint64_t>(band) << 48) ^ value;
+}
+
+struct Bucket {
+    std::vector<uint32_t> ids;
+    uint32_t next;  // slot the next id overwrites once full
+
+    Bucket() : next(0) {}
+};
+
+} // namespace
+
+struct SimilarityIndex::Impl {
+    SimilarityOptions options;
+    std::vector<Signature> signatures;
+    std::unordered_map<uint64_t, Bucket> buckets;
+};
+
+SimilarityIndex::SimilarityIndex(const SimilarityOptions& options) : impl_(std::make_unique<Impl>()) {
+    SimilarityOptions& o = impl_->options;
+    o = options;
+    o.band_bits = std::min<size_t>(std::max<size_t>(o.band_bits, 1), 48);
+    o.bands = std::min(std::max<size_t>(o.bands, 1), SIGNATURE_BITS / o.band_bits);
+    o.max_bucket_size = std::max<size_t>(o.max_bucket_size, 1);
+}
+
+SimilarityIndex::~SimilarityIndex() = default;
+
+SimilarityIndex::Signature SimilarityIndex::signature(const SparseFeatures& features) {
+    // Projection onto hyperplane b has component +-1 at index i, the sign
+    // taken from bit b of a hash of i; only the signs are kept. Signs are
+    // expanded a byte at a time from a table so the adds vectorize.
+    static const auto byte_signs = [] {
+        std::array<std::array<float, 8>, 256> table{};
+        for (size_t byte = 0; byte < 256; ++byte) {
+            for (size_t bit = 0; bit < 8; ++bit) {
+                table[byte][bit] = ((byte >> bit) & 1) ? 1.0f : -1.0f;
+            }
+        }
+        return table;
+    }();
+
+    float projections[SIGNATURE_BITS] = {};
+    for (size_t i = 0; i < features.size(); ++i) {
+        float value = features.values[i];
+        uint64_t seed = static_cast<uint64_t>(features.indices[i]) * WORDS;
+        for (size_t w = 0; w < WORDS; ++w) {
+            uint64_t signs = mix64(seed + w);
+            for (size_t byte = 0; byte < 8; ++byte) {
+                const float* sign = byte_signs[(signs >> (byte * 8)) & 0xFF].data();
+                float* projection = projections + w * 64 + byte * 8;
+                for (size_t bit = 0; bit < 8; ++bit) {
+                    projection[bit] += sign[bit] * value;
+                }
+            }
+        }
+    }
+
+    Signature result{};
+    for (size_t b = 0; b < SIGNATURE_BITS; ++b) {
+        if (projections[b] > 0.0f) {
+            result[b / 64] |= 1ull << (b % 64);
+        }
+    }
+    return result;
+}
+
+double SimilarityIndex::similarity(const Signature& a, const Signature& b) {
+    return hammingToSimilarity(hammingDistance(a, b));
+}
+
+uint32_t SimilarityIndex::add(const SparseFeatures& features) {
+    return add(signature(features));
+}
+
+uint32_t SimilarityIndex::add(const Signature& signature) {
+    const SimilarityOptions& options = impl_->options;
+    uint32_t id = static_cast<uint32_t>(impl_->signatures.size());
+    impl_->signatures.push_back(signature);
+
+    for (size_t band = 0; band < options.bands; ++band) {
+        Bucket& bucket = impl_->buckets[bandKey(signature, band, options.band_bits)];
+        if (bucket.ids.size() < options.max_bucket_size) {
+            bucket.ids.push_back(id);
+        } else {
+            bucket.ids[bucket.next] = id;
+            bucket.next = static_cast<uint32_t>((bucket.next + 1) % options.max_bucket_size);
+        }
+    }
+    return id;
+}
+
+std::vector<Neighbor> SimilarityIndex::query(
+    const SparseFeatures& features,
+    size_t k,
+    double min_similarity,
+    const std::function<bool(uint32_t)>& accept
+) const {
+    return query(signature(features), k, min_similarity, accept);
+}
+
+std::vector<Neighbor> SimilarityIndex::query(
+    const Signature& signature,
+    size_t k,
+    double min_similarity,
+    const std::function<bool(uint32_t)>& accept
+) const {
+    const SimilarityOptions& options = impl_->options;
+    const auto& signatures = impl_->signatures;
+    if (k == 0 || signatures.empty()) {
+        return {};
+    }
+
+    // Candidates seen by this query are stamped with `epoch`, so no per-query
+    // set is built or cleared.
+    thread_local std::vector<uint32_t> seen;
+    thread_local uint32_t epoch = 0;
+    if (seen.size() < signatures.size()) {
+        seen.resize(signatures.size(), 0);
+    }
+    if (++epoch == 0) {
+        std::fill(seen.begin(), seen.end(), 0);
+        epoch = 1;
+    }
+
+    int max_distance = static_cast<int>(
+        std::floor(SIGNATURE_BITS * std::acos(std::max(-1.0, std::min(1.0, min_similarity))) / PI));
+
+    // Max-heap on (distance, -id): the worst kept neighbor is on top, and
+    // newer items win ties.
+    std::vector<std::pair<int, int64_t>> best;
+    best.reserve(k + 1);
+    size_t candidates = 0;
+
+    for (size_t band = 0; band < options.bands && candidates < options.max_candidates; ++band) {
+        auto it = impl_->buckets.find(bandKey(signature, band, options.band_bits));
+        if (it == impl_->buckets.end()) {
+            continue;
+        }
+        for (uint32_t id : it->second.ids) {
+            if (seen[id] == epoch) {
+                continue;
+            }
+            seen[id] = epoch;
+            if (++candidates > options.max_candidates) {
+                break;
+            }
+            if (accept && !accept(id)) {
+                continue;
+            }
+
+            int distance = hammingDistance(signature, signatures[id]);
+            if (distance > max_distance) {
+                continue;
+            }
+            std::pair<int, int64_t> entry(distance, -static_cast<int64_t>(id));
+            if (best.size() < k) {
+                best.push_back(entry);
+                std::push_heap(best.begin(), best.end());
+            } else if (entry < best.front()) {
+                std::pop_heap(best.begin(), best.end());
+                best.back() = entry;
+                std::push_heap(best.begin(), best.end());
+            }
+        }
+    }
+
+    std::sort_heap(best.begin(), best.end());
+    std::vector<Neighbor> neighbors;
+    neighbors.reserve(best.size());
+    for (const auto& entry : best) {
+        neighbors.emplace_back(static_cast<uint32_t>(-entry.second), hammingToSimilarity(entry.first));
+    }
+    return neighbors;
+}
+
+size_t SimilarityIndex::size() const {
+    return impl_->signatures.size();
+}
+
+void SimilarityIndex::clear() {
+    impl_->signatures.clear();
+    impl_->buckets.clear();
+}
+
+} // namespace ai_debugger
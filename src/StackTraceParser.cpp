@@ -2,200 +2,810 @@
 #include <sstream>
 #include <iostream>
 #include <algorithm>
+#include <charconv>
+#include <regex>
 #include <cxxabi.h>
 
 namespace ai_debugger {
 
-struct StackTraceParser::Impl {
-    bool verbose = false;
+namespace {
+
+// Fields of a single frame as they appear in the input line. The scanners
+// below only slice the line; copying into a StackFrame happens afterwards.
+struct FrameFields {
+    std::string_view function;
+    std::string_view module;
+    std::string_view file;
+    std::string_view params;
+    int line = 0;
+    int index = -1;
+    bool has_location = false;
+};
 
-    std::regex gdb_frame_regex{
-        R"(#(\d+)\s+(?:0x[0-9a-fA-F]+\s+in\s+)?([^\s]+)\s*\(([^\)]*)\)\s*(?:at\s+([^:]+):(\d+))?)"
-    };
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
 
-    std::regex lldb_frame_regex{
-        R"(frame\s+#(\d+):\s+0x[0-9a-fA-F]+\s+([^\s`]+)`([^\s+]+)\s*(?:\+\s*\d+)?\s*(?:at\s+([^:]+):(\d+))?)"
-    };
+bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
 
-    std::regex addr2line_regex{
-        R"(([^\s]+)\s+at\s+([^:]+):(\d+))"
-    };
+bool isHexDigit(char c) {
+    return isDigit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
 
-    std::regex msvc_regex{
-        R"(([^\(]+)\((\d+)\):\s*(.*))"
-    };
-};
+size_t skipSpaces(std::string_view s, size_t pos) {
+    while (pos < s.size() && isSpace(s[pos])) ++pos;
+    return pos;
+}
 
-StackTraceParser::StackTraceParser() : impl_(std::make_unique<Impl>()) {}
+size_t skipDigits(std::string_view s, size_t pos) {
+    while (pos < s.size() && isDigit(s[pos])) ++pos;
+    return pos;
+}
 
-StackTraceParser::~StackTraceParser() = default;
+size_t skipHexDigits(std::string_view s, size_t pos) {
+    while (pos < s.size() && isHexDigit(s[pos])) ++pos;
+    return pos;
+}
 
-void StackTraceParser::setVerbose(bool verbose) {
-    impl_->verbose = verbose;
+bool startsWithAt(std::string_view s, size_t pos, std::string_view literal) {
+    return s.size() >= pos && s.substr(pos, literal.size()) == literal;
 }
 
-std::optional<StackTrace> StackTraceParser::parse(const std::string& trace_text) {
-    if (trace_text.find("frame #") != std::string::npos) {
-        return parseLLDB(trace_text);
-    } else if (trace_text.find("#0") != std::string::npos || trace_text.find("#1") != std::string::npos) {
-        return parseGDB(trace_text);
-    } else if (trace_text.find(".cpp(") != std::string::npos || trace_text.find(".h(") != std::string::npos) {
-        return parseMSVC(trace_text);
-    } else {
-        return parseBacktrace(trace_text);
+int toInt(std::string_view digits) {
+    int value = 0;
+    std::from_chars(digits.data(), digits.data() + digits.size(), value);
+    return value;
+}
+
+template <typename Fn>
+void forEachLine(std::string_view text, Fn&& fn) {
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t newline = text.find('\n', pos);
+        if (newline == std::string_view::npos) {
+            fn(text.substr(pos));
+            break;
+        }
+        fn(text.substr(pos, newline - pos));
+        pos = newline + 1;
     }
 }
 
-std::optional<StackTrace> StackTraceParser::parseGDB(const std::string& gdb_output) {
-    StackTrace trace;
-    std::istringstream stream(gdb_output);
-    std::string line;
+// `at\s+([^:]+):(\d+)` anchored at pos.
+bool scanAtLocation(std::string_view line, size_t pos, FrameFields& out) {
+    if (!startsWithAt(line, pos, "at")) return false;
 
-    while (std::getline(stream, line)) {
-        if (line.find("signal") != std::string::npos || line.find("SIGSEGV") != std::string::npos) {
-            trace.error_message = line;
-            if (line.find("SIGSEGV") != std::string::npos) {
-                trace.signal_number = 11;
-            } else if (line.find("SIGABRT") != std::string::npos) {
-                trace.signal_number = 6;
+    size_t ws_begin = pos + 2;
+    size_t ws_end = skipSpaces(line, ws_begin);
+    if (ws_end == ws_begin) return false;
+
+    size_t colon = line.find(':', ws_end);
+    if (colon == std::string_view::npos) return false;
+
+    // A colon right after the whitespace leaves the file empty at the
+    // greedy split; backtracking hands it the last whitespace character.
+    size_t file_begin = ws_end;
+    if (colon == ws_end) {
+        if (ws_end - ws_begin < 2) return false;
+        file_begin = ws_end - 1;
+    }
+
+    size_t digits_end = skipDigits(line, colon + 1);
+    if (digits_end == colon + 1) return false;
+
+    out.file = line.substr(file_begin, colon - file_begin);
+    out.line = toInt(line.substr(colon + 1, digits_end - colon - 1));
+    out.has_location = true;
+    return true;
+}
+
+// `([^\s]+)\s*\(([^\)]*)\)\s*(?:at ...)?` anchored at pos.
+bool scanGDBCall(std::string_view line, size_t pos, FrameFields& out) {
+    size_t run_end = pos;
+    while (run_end < line.size() && !isSpace(line[run_end])) ++run_end;
+    if (run_end == pos) return false;
+
+    size_t last_close = line.rfind(')');
+    if (last_close == std::string_view::npos || last_close < pos) return false;
+
+    size_t name_end = std::string_view::npos;
+    size_t open = std::string_view::npos;
+
+    size_t after_name = skipSpaces(line, run_end);
+    if (after_name < line.size() && line[after_name] == '(' && last_close > after_name) {
+        name_end = run_end;
+        open = after_name;
+    } else {
+        // The name may swallow parentheses, so the split point is the
+        // rightmost '(' inside the run that still has a ')' after it.
+        for (size_t e = run_end - 1; e > pos; --e) {
+            if (line[e] == '(' && last_close > e) {
+                name_end = e;
+                open = e;
+                break;
             }
         }
+    }
 
-        StackFrame frame;
-        if (parseGDBFrame(line, frame)) {
-            trace.frames.push_back(frame);
+    if (open == std::string_view::npos) return false;
+
+    size_t close = line.find(')', open + 1);
+    out.function = line.substr(pos, name_end - pos);
+    out.params = line.substr(open + 1, close - open - 1);
+
+    scanAtLocation(line, skipSpaces(line, close + 1), out);
+    return true;
+}
+
+// `#(\d+)\s+(?:0x[0-9a-fA-F]+\s+in\s+)?` followed by scanGDBCall.
+bool scanGDBLine(std::string_view line, FrameFields& out) {
+    for (size_t hash = line.find('#'); hash != std::string_view::npos;
+         hash = line.find('#', hash + 1)) {
+        size_t digits_end = skipDigits(line, hash + 1);
+        if (digits_end == hash + 1) continue;
+
+        size_t pos = skipSpaces(line, digits_end);
+        if (pos == digits_end) continue;
+
+        out.index = toInt(line.substr(hash + 1, digits_end - hash - 1));
+
+        if (startsWithAt(line, pos, "0x")) {
+            size_t hex_end = skipHexDigits(line, pos + 2);
+            size_t in_pos = skipSpaces(line, hex_end);
+            if (hex_end > pos + 2 && in_pos > hex_end && startsWithAt(line, in_pos, "in")) {
+                size_t name_pos = skipSpaces(line, in_pos + 2);
+                if (name_pos > in_pos + 2 && scanGDBCall(line, name_pos, out)) {
+                    return true;
+                }
+            }
         }
-    }
 
-    if (trace.frames.empty()) {
-        return std::nullopt;
+        if (scanGDBCall(line, pos, out)) {
+            return true;
+        }
     }
-
-    return trace;
+    return false;
 }
 
-bool StackTraceParser::parseGDBFrame(const std::string& line, StackFrame& frame) {
-    std::smatch match;
-    if (std::regex_search(line, match, impl_->gdb_frame_regex)) {
-        frame.mangled_name = match[2].str();
-        frame.function_name = demangle(frame.mangled_name);
+// `frame\s+#(\d+):\s+0x[0-9a-fA-F]+\s+([^\s`]+)`([^\s+]+)\s*(?:\+\s*\d+)?\s*(?:at ...)?`
+bool scanLLDBLine(std::string_view line, FrameFields& out) {
+    for (size_t start = line.find("frame"); start != std::string_view::npos;
+         start = line.find("frame", start + 1)) {
+        size_t pos = skipSpaces(line, start + 5);
+        if (pos == start + 5 || !startsWithAt(line, pos, "#")) continue;
 
-        if (match[4].matched) {
-            frame.location.file = match[4].str();
-            frame.location.line = std::stoi(match[5].str());
+        size_t digits_end = skipDigits(line, pos + 1);
+        if (digits_end == pos + 1 || !startsWithAt(line, digits_end, ":")) continue;
+        int index = toInt(line.substr(pos + 1, digits_end - pos - 1));
+
+        pos = skipSpaces(line, digits_end + 1);
+        if (pos == digits_end + 1 || !startsWithAt(line, pos, "0x")) continue;
+
+        size_t hex_end = skipHexDigits(line, pos + 2);
+        if (hex_end == pos + 2) continue;
+
+        size_t module_begin = skipSpaces(line, hex_end);
+        if (module_begin == hex_end) continue;
+
+        size_t module_end = module_begin;
+        while (module_end < line.size() && !isSpace(line[module_end]) && line[module_end] != '`') {
+            ++module_end;
         }
+        if (module_end == module_begin || !startsWithAt(line, module_end, "`")) continue;
 
-        if (match[3].matched) {
-            std::string params = match[3].str();
-            std::istringstream param_stream(params);
-            std::string param;
-            while (std::getline(param_stream, param, ',')) {
-                frame.parameters.push_back(param);
+        size_t function_begin = module_end + 1;
+        size_t function_end = function_begin;
+        while (function_end < line.size() && !isSpace(line[function_end]) && line[function_end] != '+') {
+            ++function_end;
+        }
+        if (function_end == function_begin) continue;
+
+        out.module = line.substr(module_begin, module_end - module_begin);
+        out.function = line.substr(function_begin, function_end - function_begin);
+        out.index = index;
+
+        pos = skipSpaces(line, function_end);
+        if (startsWithAt(line, pos, "+")) {
+            size_t offset_begin = skipSpaces(line, pos + 1);
+            size_t offset_end = skipDigits(line, offset_begin);
+            if (offset_end > offset_begin) {
+                pos = offset_end;
             }
         }
 
+        scanAtLocation(line, skipSpaces(line, pos), out);
         return true;
     }
     return false;
 }
 
-std::optional<StackTrace> StackTraceParser::parseLLDB(const std::string& lldb_output) {
-    StackTrace trace;
-    std::istringstream stream(lldb_output);
-    std::string line;
+// `([^\s]+)\s+at\s+([^:]+):(\d+)`
+bool scanBacktraceLine(std::string_view line, FrameFields& out) {
+    size_t pos = 0;
+    while (pos < line.size()) {
+        size_t run_begin = skipSpaces(line, pos);
+        if (run_begin == line.size()) break;
 
-    while (std::getline(stream, line)) {
-        if (line.find("stop reason") != std::string::npos) {
-            trace.error_message = line;
+        size_t run_end = run_begin;
+        while (run_end < line.size() && !isSpace(line[run_end])) ++run_end;
+
+        size_t at_pos = skipSpaces(line, run_end);
+        if (at_pos > run_end && scanAtLocation(line, at_pos, out)) {
+            out.function = line.substr(run_begin, run_end - run_begin);
+            return true;
         }
+        pos = run_end;
+    }
+    return false;
+}
 
-        StackFrame frame;
-        if (parseLLDBFrame(line, frame)) {
-            trace.frames.push_back(frame);
+// `([^\(]+)\((\d+)\):\s*(.*)`
+bool scanMSVCLine(std::string_view line, FrameFields& out) {
+    size_t pos = 0;
+    while (pos < line.size()) {
+        size_t open = line.find('(', pos);
+        if (open == std::string_view::npos) break;
+
+        if (open > pos) {
+            size_t digits_end = skipDigits(line, open + 1);
+            if (digits_end > open + 1 && startsWithAt(line, digits_end, "):")) {
+                size_t text_begin = skipSpaces(line, digits_end + 2);
+                size_t text_end = line.find_first_of("\r\n", text_begin);
+                if (text_end == std::string_view::npos) text_end = line.size();
+
+                out.file = line.substr(pos, open - pos);
+                out.line = toInt(line.substr(open + 1, digits_end - open - 1));
+                out.function = line.substr(text_begin, text_end - text_begin);
+                out.has_location = true;
+                return true;
+            }
+        }
+        pos = open + 1;
+    }
+    return false;
+}
+
+// Tries the gdb and lldb scanners, then unless `debugger_only` the looser
+// msvc and backtrace ones; `debugger_frame` tells which kind matched.
+bool scanAnyFrame(std::string_view line, bool debugger_only, FrameFields& out, bool& debugger_frame) {
+    debugger_frame = false;
+    for (auto scan : {scanGDBLine, scanLLDBLine, scanMSVCLine, scanBacktraceLine}) {
+        if (debugger_only && scan != scanGDBLine && scan != scanLLDBLine) {
+            break;
+        }
+        FrameFields fields;
+        if (scan(line, fields)) {
+            out = fields;
+            debugger_frame = scan == scanGDBLine || scan == scanLLDBLine;
+            return true;
         }
     }
+    return false;
+}
 
-    if (trace.frames.empty()) {
-        return std::nullopt;
+// std::getline() that keeps at most `max_bytes` of each line and skips the
+// rest, so one endless line cannot exhaust memory.
+bool readBoundedLine(std::istream& input, std::string& line, size_t max_bytes) {
+    line.clear();
+    std::streambuf* buffer = input.rdbuf();
+    if (!buffer || !input.good()) {
+        return false;
+    }
+
+    using Traits = std::char_traits<char>;
+    bool read = false;
+    for (Traits::int_type c = buffer->sbumpc(); !Traits::eq_int_type(c, Traits::eof()); c = buffer->sbumpc()) {
+        read = true;
+        if (c == '\n') {
+            return true;
+        }
+        if (line.size() < max_bytes) {
+            line.push_back(Traits::to_char_type(c));
+        }
+    }
+    input.setstate(std::ios::eofbit);
+    return read;
+}
+
+bool isBlankLine(std::string_view line) {
+    return skipSpaces(line, 0) == line.size();
+}
+
+// Signal banners and per-thread headers start a new trace in a log that
+// concatenates several of them.
+bool isTraceHeader(std::string_view line) {
+    std::string_view rest = line.substr(skipSpaces(line, 0));
+    if (startsWithAt(rest, 0, "Thread ") && rest.size() > 7 && isDigit(rest[7])) {
+        return true;
+    }
+    if (startsWithAt(rest, 0, "thread #") || startsWithAt(rest, 0, "* thread #")) {
+        return true;
+    }
+    return line.find("received signal") != std::string_view::npos ||
+           line.find("terminated with signal") != std::string_view::npos ||
+           line.find("stop reason") != std::string_view::npos;
+}
+
+void splitParameters(std::string_view params, std::vector<std::string>& out) {
+    size_t pos = 0;
+    while (pos < params.size()) {
+        size_t comma = params.find(',', pos);
+        if (comma == std::string_view::npos) {
+            out.emplace_back(params.substr(pos));
+            break;
+        }
+        out.emplace_back(params.substr(pos, comma - pos));
+        pos = comma + 1;
     }
+}
+
+enum class TraceFormat {
+    GDB,
+    LLDB,
+    BACKTRACE,
+    MSVC
+};
+
+TraceFormat detectFormat(std::string_view text) {
+    if (text.find("frame #") != std::string_view::npos) {
+        return TraceFormat::LLDB;
+    } else if (text.find("#0") != std::string_view::npos || text.find("#1") != std::string_view::npos) {
+        return TraceFormat::GDB;
+    } else if (text.find(".cpp(") != std::string_view::npos || text.find(".h(") != std::string_view::npos) {
+        return TraceFormat::MSVC;
+    } else {
+        return TraceFormat::BACKTRACE;
+    }
+}
+
+using ViewMatch = std::match_results<std::string_view::const_iterator>;
+
+std::string_view submatch(std::string_view line, const ViewMatch& match, size_t index) {
+    if (!match[index].matched) {
+        return {};
+    }
+    return line.substr(static_cast<size_t>(match.position(index)), static_cast<size_t>(match.length(index)));
+}
+
+} // namespace
+
+SourceLocation SourceLocationView::materialize() const {
+    return SourceLocation(std::string(file), line, column);
+}
+
+StackFrame StackFrameView::materialize() const {
+    StackFrame frame;
+    frame.function_name = std::string(function_name);
+    frame.mangled_name = std::string(mangled_name);
+    frame.location = location.materialize();
+    frame.module = std::string(module);
+    frame.address = address;
+    splitParameters(parameter_list, frame.parameters);
+    return frame;
+}
 
+StackTraceView::StackTraceView() : signal_number(0) {}
+
+StackTraceView::StackTraceView(std::string text) : signal_number(0) {
+    auto owned = std::make_shared<const std::string>(std::move(text));
+    text_ = *owned;
+    owner_ = std::move(owned);
+}
+
+StackTraceView::StackTraceView(std::string_view text, std::shared_ptr<const void> owner)
+    : signal_number(0)
+    , owner_(std::move(owner))
+    , text_(text) {}
+
+StackTrace StackTraceView::materialize() const {
+    StackTrace trace;
+    trace.frames.reserve(frames.size());
+    for (const auto& frame : frames) {
+        trace.frames.push_back(frame.materialize());
+    }
+    trace.error_message = std::string(error_message);
+    trace.exception_type = std::string(exception_type);
+    trace.signal_number = signal_number;
     return trace;
 }
 
-bool StackTraceParser::parseLLDBFrame(const std::string& line, StackFrame& frame) {
-    std::smatch match;
-    if (std::regex_search(line, match, impl_->lldb_frame_regex)) {
-        frame.module = match[2].str();
-        frame.mangled_name = match[3].str();
-        frame.function_name = demangle(frame.mangled_name);
+struct StackTraceParser::Impl {
+    bool verbose = false;
+    ParseEngine engine = ParseEngine::SCANNER;
+    size_t max_trace_bytes = 4 * 1024 * 1024;
+
+    // Only compiled when the REGEX engine is actually used.
+    struct Patterns {
+        std::regex gdb_frame_regex{
+            R"(#(\d+)\s+(?:0x[0-9a-fA-F]+\s+in\s+)?([^\s]+)\s*\(([^\)]*)\)\s*(?:at\s+([^:]+):(\d+))?)"
+        };
+
+        std::regex lldb_frame_regex{
+            R"(frame\s+#(\d+):\s+0x[0-9a-fA-F]+\s+([^\s`]+)`([^\s+]+)\s*(?:\+\s*\d+)?\s*(?:at\s+([^:]+):(\d+))?)"
+        };
+
+        std::regex addr2line_regex{
+            R"(([^\s]+)\s+at\s+([^:]+):(\d+))"
+        };
+
+        std::regex msvc_regex{
+            R"(([^\(]+)\((\d+)\):\s*(.*))"
+        };
+    };
+
+    std::unique_ptr<Patterns> patterns;
+
+    std::shared_ptr<DemangleCache> demangle_cache = DemangleCache::shared();
+    std::string demangle_result;
+
+    // Reused by __cxa_demangle, which reallocs it as needed.
+    std::string demangle_input;
+    char* demangle_buffer = nullptr;
+    size_t demangle_capacity = 0;
+
+    ~Impl() {
+        free(demangle_buffer);
+    }
+
+    const Patterns& regexes() {
+        if (!patterns) {
+            patterns = std::make_unique<Patterns>();
+        }
+        return *patterns;
+    }
+
+    bool scanGDB(std::string_view line, FrameFields& fields) {
+        if (engine == ParseEngine::SCANNER) {
+            return scanGDBLine(line, fields);
+        }
 
+        ViewMatch match;
+        if (!std::regex_search(line.begin(), line.end(), match, regexes().gdb_frame_regex)) {
+            return false;
+        }
+        fields.function = submatch(line, match, 2);
+        fields.params = submatch(line, match, 3);
         if (match[4].matched) {
-            frame.location.file = match[4].str();
-            frame.location.line = std::stoi(match[5].str());
+            fields.file = submatch(line, match, 4);
+            fields.line = std::stoi(match[5].str());
+            fields.has_location = true;
+        }
+        return true;
+    }
+
+    bool scanLLDB(std::string_view line, FrameFields& fields) {
+        if (engine == ParseEngine::SCANNER) {
+            return scanLLDBLine(line, fields);
         }
 
+        ViewMatch match;
+        if (!std::regex_search(line.begin(), line.end(), match, regexes().lldb_frame_regex)) {
+            return false;
+        }
+        fields.module = submatch(line, match, 2);
+        fields.function = submatch(line, match, 3);
+        if (match[4].matched) {
+            fields.file = submatch(line, match, 4);
+            fields.line = std::stoi(match[5].str());
+            fields.has_location = true;
+        }
         return true;
     }
-    return false;
-}
 
-std::optional<StackTrace> StackTraceParser::parseBacktrace(const std::string& bt_output) {
-    StackTrace trace;
-    std::istringstream stream(bt_output);
-    std::string line;
+    bool scanBacktrace(std::string_view line, FrameFields& fields) {
+        if (engine == ParseEngine::SCANNER) {
+            return scanBacktraceLine(line, fields);
+        }
 
-    int frame_index = 0;
-    while (std::getline(stream, line)) {
-        std::smatch match;
-        if (std::regex_search(line, match, impl_->addr2line_regex)) {
-            StackFrame frame;
-            frame.function_name = demangle(match[1].str());
-            frame.mangled_name = match[1].str();
-            frame.location.file = match[2].str();
-            frame.location.line = std::stoi(match[3].str());
-            trace.frames.push_back(frame);
-            frame_index++;
+        ViewMatch match;
+        if (!std::regex_search(line.begin(), line.end(), match, regexes().addr2line_regex)) {
+            return false;
+        }
+        fields.function = submatch(line, match, 1);
+        fields.file = submatch(line, match, 2);
+        fields.line = std::stoi(match[3].str());
+        fields.has_location = true;
+        return true;
+    }
+
+    bool scanMSVC(std::string_view line, FrameFields& fields) {
+        if (engine == ParseEngine::SCANNER) {
+            return scanMSVCLine(line, fields);
+        }
+
+        ViewMatch match;
+        if (!std::regex_search(line.begin(), line.end(), match, regexes().msvc_regex)) {
+            return false;
         }
+        fields.file = submatch(line, match, 1);
+        fields.line = std::stoi(match[2].str());
+        fields.function = submatch(line, match, 3);
+        fields.has_location = true;
+        return true;
+    }
+};
+
+StackTraceParser::StackTraceParser() : impl_(std::make_unique<Impl>()) {}
+
+StackTraceParser::~StackTraceParser() = default;
+
+void StackTraceParser::setVerbose(bool verbose) {
+    impl_->verbose = verbose;
+}
+
+void StackTraceParser::setParseEngine(ParseEngine engine) {
+    impl_->engine = engine;
+}
+
+ParseEngine StackTraceParser::getParseEngine() const {
+    return impl_->engine;
+}
+
+void StackTraceParser::setMaxTraceBytes(size_t max_bytes) {
+    impl_->max_trace_bytes = std::max<size_t>(max_bytes, 1);
+}
+
+void StackTraceParser::setDemangleCache(std::shared_ptr<DemangleCache> cache) {
+    impl_->demangle_cache = std::move(cache);
+}
+
+std::shared_ptr<DemangleCache> StackTraceParser::getDemangleCache() const {
+    return impl_->demangle_cache;
+}
+
+std::optional<StackTrace> StackTraceParser::parse(const std::string& trace_text) {
+    StackTraceView view(trace_text, nullptr);
+    if (!parseFrames(view)) {
+        return std::nullopt;
     }
+    return view.materialize();
+}
 
-    if (trace.frames.empty()) {
+std::optional<StackTrace> StackTraceParser::parseGDB(const std::string& gdb_output) {
+    StackTraceView view(gdb_output, nullptr);
+    if (!parseGDBFrames(view)) {
         return std::nullopt;
     }
+    return view.materialize();
+}
 
-    return trace;
+std::optional<StackTrace> StackTraceParser::parseLLDB(const std::string& lldb_output) {
+    StackTraceView view(lldb_output, nullptr);
+    if (!parseLLDBFrames(view)) {
+        return std::nullopt;
+    }
+    return view.materialize();
+}
+
+std::optional<StackTrace> StackTraceParser::parseBacktrace(const std::string& bt_output) {
+    StackTraceView view(bt_output, nullptr);
+    if (!parseBacktraceFrames(view)) {
+        return std::nullopt;
+    }
+    return view.materialize();
 }
 
 std::optional<StackTrace> StackTraceParser::parseMSVC(const std::string& msvc_output) {
-    StackTrace trace;
-    std::istringstream stream(msvc_output);
+    StackTraceView view(msvc_output, nullptr);
+    if (!parseMSVCFrames(view)) {
+        return std::nullopt;
+    }
+    return view.materialize();
+}
+
+std::optional<StackTraceView> StackTraceParser::parseView(std::string trace_text) {
+    StackTraceView view(std::move(trace_text));
+    if (!parseFrames(view)) {
+        return std::nullopt;
+    }
+    return view;
+}
+
+std::optional<StackTraceView> StackTraceParser::parseView(
+    std::string_view trace_text,
+    std::shared_ptr<const void> owner
+) {
+    StackTraceView view(trace_text, std::move(owner));
+    if (!parseFrames(view)) {
+        return std::nullopt;
+    }
+    return view;
+}
+
+size_t StackTraceParser::parseStream(
+    std::istream& input,
+    const std::function<void(StackTrace&&)>& on_trace
+) {
+    size_t emitted = 0;
+    std::string chunk;
     std::string line;
+    bool has_frames = false;
+    bool has_debugger_frames = false;  // gdb or lldb frames in this chunk
+    bool truncated = false;
+    bool debugger_seen = false;
+
+    auto flush = [&]() {
+        if (has_frames) {
+            StackTraceView view(chunk, nullptr);
+            if (parseFrames(view)) {
+                on_trace(view.materialize());
+                ++emitted;
+            }
+        }
+        chunk.clear();
+        has_frames = false;
+        has_debugger_frames = false;
+        truncated = false;
+    };
 
-    while (std::getline(stream, line)) {
-        std::smatch match;
-        if (std::regex_search(line, match, impl_->msvc_regex)) {
-            StackFrame frame;
-            frame.location.file = match[1].str();
-            frame.location.line = std::stoi(match[2].str());
-            frame.function_name = match[3].str();
-            trace.frames.push_back(frame);
+    while (readBoundedLine(input, line, impl_->max_trace_bytes)) {
+        if (isBlankLine(line)) {
+            if (has_frames) {
+                flush();
+            }
+            debugger_seen = false;
+            continue;
+        }
+
+        // The loose backtrace and msvc patterns also match gdb's stop line
+        // ("0x... in foo (p=0x0) at crash.c:4"), so once gdb or lldb frames
+        // have appeared only their scanners find frames, up to the next blank
+        // line.
+        FrameFields fields;
+        bool is_debugger_frame = false;
+        bool is_frame = scanAnyFrame(line, debugger_seen, fields, is_debugger_frame);
+        if (is_debugger_frame && !has_debugger_frames) {
+            // Loose matches before the first real frame were part of the
+            // banner, which stays with the frames after it.
+            has_frames = false;
+        }
+
+        if (has_frames && ((is_frame && fields.index == 0) || (!is_frame && isTraceHeader(line)))) {
+            flush();
+        }
+
+        has_frames = has_frames || is_frame;
+        has_debugger_frames = has_debugger_frames || is_debugger_frame;
+        debugger_seen = debugger_seen || is_debugger_frame;
+
+        // A runaway trace keeps its first max_trace_bytes and drops the rest
+        // up to the next boundary; text between traces is simply dropped.
+        if (truncated) {
+            continue;
+        }
+        if (chunk.size() + line.size() + 1 > impl_->max_trace_bytes) {
+            if (has_frames) {
+                truncated = true;
+            } else {
+                chunk.clear();
+            }
+            continue;
         }
+        chunk.append(line);
+        chunk.push_back('\n');
     }
 
-    if (trace.frames.empty()) {
-        return std::nullopt;
+    flush();
+    return emitted;
+}
+
+bool StackTraceParser::parseFrames(StackTraceView& trace) {
+    switch (detectFormat(trace.text())) {
+        case TraceFormat::LLDB: return parseLLDBFrames(trace);
+        case TraceFormat::GDB: return parseGDBFrames(trace);
+        case TraceFormat::MSVC: return parseMSVCFrames(trace);
+        default: return parseBacktraceFrames(trace);
     }
+}
 
-    return trace;
+bool StackTraceParser::parseGDBFrames(StackTraceView& trace) {
+    forEachLine(trace.text(), [&](std::string_view line) {
+        if (line.find("signal") != std::string_view::npos || line.find("SIGSEGV") != std::string_view::npos) {
+            trace.error_message = line;
+            if (line.find("SIGSEGV") != std::string_view::npos) {
+                trace.signal_number = 11;
+            } else if (line.find("SIGABRT") != std::string_view::npos) {
+                trace.signal_number = 6;
+            }
+        }
+
+        FrameFields fields;
+        if (impl_->scanGDB(line, fields)) {
+            StackFrameView frame;
+            frame.mangled_name = fields.function;
+            frame.function_name = demangle(fields.function, trace);
+            if (fields.has_location) {
+                frame.location.file = fields.file;
+                frame.location.line = fields.line;
+            }
+            frame.parameter_list = fields.params;
+            trace.frames.push_back(frame);
+        }
+    });
+
+    return !trace.frames.empty();
+}
+
+bool StackTraceParser::parseLLDBFrames(StackTraceView& trace) {
+    forEachLine(trace.text(), [&](std::string_view line) {
+        if (line.find("stop reason") != std::string_view::npos) {
+            trace.error_message = line;
+        }
+
+        FrameFields fields;
+        if (impl_->scanLLDB(line, fields)) {
+            StackFrameView frame;
+            frame.module = fields.module;
+            frame.mangled_name = fields.function;
+            frame.function_name = demangle(fields.function, trace);
+            if (fields.has_location) {
+                frame.location.file = fields.file;
+                frame.location.line = fields.line;
+            }
+            trace.frames.push_back(frame);
+        }
+    });
+
+    return !trace.frames.empty();
+}
+
+bool StackTraceParser::parseBacktraceFrames(StackTraceView& trace) {
+    forEachLine(trace.text(), [&](std::string_view line) {
+        FrameFields fields;
+        if (impl_->scanBacktrace(line, fields)) {
+            StackFrameView frame;
+            frame.mangled_name = fields.function;
+            frame.function_name = demangle(fields.function, trace);
+            frame.location.file = fields.file;
+            frame.location.line = fields.line;
+            trace.frames.push_back(frame);
+        }
+    });
+
+    return !trace.frames.empty();
+}
+
+bool StackTraceParser::parseMSVCFrames(StackTraceView& trace) {
+    forEachLine(trace.text(), [&](std::string_view line) {
+        FrameFields fields;
+        if (impl_->scanMSVC(line, fields)) {
+            StackFrameView frame;
+            frame.location.file = fields.file;
+            frame.location.line = fields.line;
+            frame.function_name = fields.function;
+            trace.frames.push_back(frame);
+        }
+    });
+
+    return !trace.frames.empty();
 }
 
 std::string StackTraceParser::demangle(const std::string& mangled) {
+    StackTraceView scratch;
+    return std::string(demangle(std::string_view(mangled), scratch));
+}
+
+std::string_view StackTraceParser::demangle(std::string_view mangled, StackTraceView& trace) {
+    if (impl_->demangle_cache) {
+        if (impl_->demangle_cache->demangle(mangled, impl_->demangle_result)) {
+            return trace.intern(impl_->demangle_result);
+        }
+        return mangled;
+    }
+
 #ifdef __GNUG__
+    impl_->demangle_input.assign(mangled);
     int status = 0;
-    char* demangled = abi::__cxa_demangle(mangled.c_str(), nullptr, nullptr, &status);
+    char* demangled = abi::__cxa_demangle(
+        impl_->demangle_input.c_str(), impl_->demangle_buffer, &impl_->demangle_capacity, &status);
     if (status == 0 && demangled) {
-        std::string result(demangled);
-        free(demangled);
-        return result;
+        impl_->demangle_buffer = demangled;
+        std::string_view result(demangled);
+        if (result != mangled) {
+            return trace.intern(result);
+        }
     }
 #endif
     return mangled;
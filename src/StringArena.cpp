@@ -0,0 +1,53 @@
+#include "ai_debugger/StringArena.h"
+#include <algorithm>
+#include <cstring>
+
+namespace ai_debugger {
+
+StringArena::StringArena(size_t block_size)
+    : block_size_(std::max<size_t>(block_size, 64))
+    , current_block_(0)
+    , offset_(0)
+    , bytes_used_(0) {}
+
+std::string_view StringArena::store(std::string_view value) {
+    if (value.empty()) {
+        return {};
+    }
+
+    while (current_block_ < blocks_.size() &&
+           blocks_[current_block_].size - offset_ < value.size()) {
+        ++current_block_;
+        offset_ = 0;
+    }
+
+    if (current_block_ == blocks_.size()) {
+        Block block;
+        block.size = std::max(block_size_, value.size());
+        block.data = std::make_unique<char[]>(block.size);
+        blocks_.push_back(std::move(block));
+        offset_ = 0;
+    }
+
+    char* dest = blocks_[current_block_].data.get() + offset_;
+    std::memcpy(dest, value.data(), value.size());
+    offset_ += value.size();
+    bytes_used_ += value.size();
+    return std::string_view(dest, value.size());
+}
+
+void StringArena::clear() {
+    current_block_ = 0;
+    offset_ = 0;
+    bytes_used_ = 0;
+}
+
+size_t StringArena::bytesReserved() const {
+    size_t total = 0;
+    for (const auto& block : blocks_) {
+        total += block.size;
+    }
+    return total;
+}
+
+} // namespace ai_debugger
@@ -0,0 +1,77 @@
+#include "ai_debugger/SymbolTable.h"
+#include <algorithm>
+#include <functional>
+
+namespace ai_debugger {
+
+SymbolTable::SymbolTable() : arena_(16 * 1024) {}
+
+uint32_t SymbolTable::find(std::string_view name) const {
+    if (slots_.empty()) {
+        return npos;
+    }
+
+    size_t hash = std::hash<std::string_view>{}(name);
+    size_t mask = slots_.size() - 1;
+    for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+        uint32_t id = slots_[slot];
+        if (id == npos || (hashes_[id] == hash && names_[id] == name)) {
+            return id;
+        }
+    }
+}
+
+uint32_t SymbolTable::intern(std::string_view name) {
+    size_t hash = std::hash<std::string_view>{}(name);
+
+    if (!slots_.empty()) {
+        size_t mask = slots_.size() - 1;
+        for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+            uint32_t id = slots_[slot];
+            if (id == npos) {
+                break;
+            }
+            if (hashes_[id] == hash && names_[id] == name) {
+                return id;
+            }
+        }
+    }
+
+    // Keep the load factor at or below one half.
+    if ((names_.size() + 1) * 2 > slots_.size()) {
+        rehash(std::max<size_t>(slots_.size() * 2, 64));
+    }
+
+    uint32_t id = static_cast<uint32_t>(names_.size());
+    names_.push_back(arena_.store(name));
+    hashes_.push_back(hash);
+
+    size_t mask = slots_.size() - 1;
+    size_t slot = hash & mask;
+    while (slots_[slot] != npos) {
+        slot = (slot + 1) & mask;
+    }
+    slots_[slot] = id;
+    return id;
+}
+
+void SymbolTable::clear() {
+    arena_.clear();
+    names_.clear();
+    hashes_.clear();
+    std::fill(slots_.begin(), slots_.end(), npos);
+}
+
+void SymbolTable::rehash(size_t slot_count) {
+    slots_.assign(slot_count, npos);
+    size_t mask = slot_count - 1;
+    for (uint32_t id = 0; id < names_.size(); ++id) {
+        size_t slot = hashes_[id] & mask;
+        while (slots_[slot] != npos) {
+            slot = (slot + 1) & mask;
+        }
+        slots_[slot] = id;
+    }
+}
+
+} // namespace ai_debugger
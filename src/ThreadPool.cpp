@@ -0,0 +1,185 @@
+#include "ai_debugger/ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace ai_debugger {
+
+namespace {
+
+struct WorkQueue {
+    std::mutex mutex;
+    std::deque<ThreadPool::Task> tasks;
+};
+
+// Index of the pool worker running on this thread, used so tasks submitted
+// from inside a task land on the submitting worker's own deque.
+thread_local const void* current_pool = nullptr;
+thread_local size_t current_worker = 0;
+
+} // namespace
+
+struct ThreadPool::Impl {
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    std::vector<std::thread> threads;
+
+    std::mutex mutex;
+    std::condition_variable work_available;
+    std::condition_variable all_done;
+    size_t queued = 0;
+    size_t outstanding = 0;
+    bool stopping = false;
+
+    std::atomic<size_t> next_queue{0};
+    std::exception_ptr error;
+
+    bool popLocal(size_t worker, Task& task) {
+        WorkQueue& queue = *queues[worker];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            return false;
+        }
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+        return true;
+    }
+
+    bool steal(size_t worker, Task& task) {
+        for (size_t i = 1; i < queues.size(); ++i) {
+            WorkQueue& queue = *queues[(worker + i) % queues.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.tasks.empty()) {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void run(size_t worker) {
+        current_pool = this;
+        current_worker = worker;
+
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                work_available.wait(lock, [this] { return stopping || queued > 0; });
+                if (stopping && queued == 0) {
+                    return;
+                }
+                --queued;
+            }
+
+            // A unit of `queued` is reserved above, so some deque holds a
+            // task for us; it may take a few attempts if others steal first.
+            Task task;
+            while (!popLocal(worker, task) && !steal(worker, task)) {
+                std::this_thread::yield();
+            }
+
+            try {
+                task(worker);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--outstanding == 0) {
+                all_done.notify_all();
+            }
+        }
+    }
+};
+
+ThreadPool::ThreadPool(size_t thread_count) : impl_(std::make_unique<Impl>()) {
+    if (thread_count == 0) {
+        thread_count = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    }
+
+    for (size_t i = 0; i < thread_count; ++i) {
+        impl_->queues.push_back(std::make_unique<WorkQueue>());
+    }
+    for (size_t i = 0; i < thread_count; ++i) {
+        impl_->threads.emplace_back([this, i] { impl_->run(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        impl_->stopping = true;
+    }
+    impl_->work_available.notify_all();
+    for (auto& thread : impl_->threads) {
+        thread.join();
+    }
+}
+
+size_t ThreadPool::size() const {
+    return impl_->threads.size();
+}
+
+void ThreadPool::submit(Task task) {
+    size_t target = current_pool == impl_.get()
+        ? current_worker
+        : impl_->next_queue.fetch_add(1, std::memory_order_relaxed) % impl_->queues.size();
+
+    {
+        std::lock_guard<std::mutex> lock(impl_->queues[target]->mutex);
+        impl_->queues[target]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        ++impl_->queued;
+        ++impl_->outstanding;
+    }
+    impl_->work_available.notify_one();
+}
+
+void ThreadPool::wait() {
+    if (current_pool == impl_.get()) {
+        throw std::logic_error("ThreadPool::wait() called from one of its own tasks");
+    }
+
+    std::unique_lock<std::mutex> lock(impl_->mutex);
+    impl_->all_done.wait(lock, [this] { return impl_->outstanding == 0; });
+
+    if (impl_->error) {
+        std::exception_ptr error = impl_->error;
+        impl_->error = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t, size_t, size_t)>& body) {
+    if (count == 0) {
+        return;
+    }
+    if (current_pool == impl_.get()) {
+        body(0, count, current_worker);
+        return;
+    }
+
+    // Several chunks per worker leaves room for stealing to even out traces
+    // that take much longer than their neighbours.
+    size_t chunks = std::min(count, size() * 8);
+    size_t chunk_size = (count + chunks - 1) / chunks;
+
+    for (size_t begin = 0; begin < count; begin += chunk_size) {
+        size_t end = std::min(begin + chunk_size, count);
+        submit([&body, begin, end](size_t worker) { body(begin, end, worker); });
+    }
+    wait();
+}
+
+} // namespace ai_debugger
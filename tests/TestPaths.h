@@ -0,0 +1,23 @@
+#ifndef AI_DEBUGGER_TEST_PATHS_H
+#define AI_DEBUGGER_TEST_PATHS_H
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <string>
+
+namespace ai_debugger {
+namespace test {
+
+// A path under the temporary directory named after prefix and the running
+// test. ctest runs each test in a process of its own and in parallel, so
+// anything a test binds or locks (a session directory, a socket) must not be
+// shared with another test.
+inline std::string testDirectory(const std::string& prefix) {
+    std::string name = ::testing::UnitTest::GetInstance()->current_test_info()->name();
+    return (std::filesystem::temp_directory_path() / (prefix + name)).string();
+}
+
+} // namespace test
+} // namespace ai_debugger
+
+#endif // AI_DEBUGGER_TEST_PATHS_H
@@ -0,0 +1,46 @@
+#ifndef AI_DEBUGGER_TEST_TRACES_H
+#define AI_DEBUGGER_TEST_TRACES_H
+
+#include "ai_debugger/StackTraceParser.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ai_debugger {
+namespace test {
+
+// A SIGSEGV trace through the given functions, innermost first, at
+// consecutive lines of src/app.cpp.
+inline StackTrace makeTrace(const std::vector<std::string>& functions, const std::string& message = "",
+                            int signal_number = 11) {
+    StackTrace trace;
+    trace.error_message = message;
+    trace.signal_number = signal_number;
+    int line = 1;
+    for (const auto& name : functions) {
+        StackFrame frame;
+        frame.function_name = name;
+        frame.location.file = "src/app.cpp";
+        frame.location.line = line++;
+        trace.frames.push_back(frame);
+    }
+    return trace;
+}
+
+// Like makeTrace, with each frame's file given next to its function.
+inline StackTrace makeTraceWithFiles(const std::vector<std::pair<std::string, std::string>>& frames) {
+    std::vector<std::string> functions;
+    for (const auto& entry : frames) {
+        functions.push_back(entry.first);
+    }
+    StackTrace trace = makeTrace(functions);
+    for (size_t i = 0; i < frames.size(); ++i) {
+        trace.frames[i].location.file = frames[i].second;
+    }
+    return trace;
+}
+
+} // namespace test
+} // namespace ai_debugger
+
+#endif // AI_DEBUGGER_TEST_TRACES_H
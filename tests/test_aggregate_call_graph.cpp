@@ -0,0 +1,97 @@
+#include "ai_debugger/AggregateCallGraph.h"
+#include "TestTraces.h"
+#include <gtest/gtest.h>
+
+using namespace ai_debugger;
+using ai_debugger::test::makeTrace;
+
+TEST(AggregateCallGraphTest, CountsEdgesOncePerTrace) {
+    AggregateCallGraph graph;
+    graph.add(makeTrace({"visit", "visit", "visit", "main"}), 100);
+    graph.add(makeTrace({"visit", "main"}, "", 6), 200);
+    graph.add(makeTrace({"parse", "main"}), 50);
+
+    EXPECT_EQ(graph.traceCount(), 3u);
+    EXPECT_EQ(graph.edgeCount(), 3u);
+
+    auto edges = graph.topEdges(1);
+    ASSERT_EQ(edges.size(), 1u);
+    EXPECT_EQ(edges[0].caller, "main");
+    EXPECT_EQ(edges[0].callee, "visit");
+    EXPECT_EQ(edges[0].count, 2u);
+    EXPECT_EQ(edges[0].first_seen, 100);
+    EXPECT_EQ(edges[0].last_seen, 200);
+    EXPECT_EQ(edges[0].signals, (std::vector<std::pair<int, uint64_t>>{{6, 1}, {11, 1}}));
+}
+
+TEST(AggregateCallGraphTest, TopPathsFindsHeavyHitters) {
+    AggregateLimits limits;
+    limits.max_paths = 8;
+    limits.path_depth = 2;
+    AggregateCallGraph graph(limits);
+
+    for (int i = 0; i < 1000; ++i) {
+        graph.add(makeTrace({"crash", "hot_caller", "main"}), i);
+        if (i % 2 == 0) {
+            graph.add(makeTrace({"assert_fail", "warm_caller", "main"}), i);
+        }
+        graph.add(makeTrace({"noise_" + std::to_string(i), "main"}), i);
+    }
+
+    auto paths = graph.topPaths(2);
+    ASSERT_EQ(paths.size(), 2u);
+    EXPECT_EQ(paths[0].functions, (std::vector<std::string>{"crash", "hot_caller"}));
+    EXPECT_GE(paths[0].count, 1000u);
+    EXPECT_LE(paths[0].count - paths[0].error, 1000u);
+    EXPECT_EQ(paths[1].functions, (std::vector<std::string>{"assert_fail", "warm_caller"}));
+}
+
+TEST(AggregateCallGraphTest, CompactionBoundsEdges) {
+    AggregateLimits limits;
+    limits.max_edges = 64;
+    AggregateCallGraph graph(limits);
+
+    for (int i = 0; i < 5000; ++i) {
+        graph.add(makeTrace({"hot_callee", "hot_caller"}), i);
+        graph.add(makeTrace({"f" + std::to_string(i), "g" + std::to_string(i)}), i);
+        ASSERT_LE(graph.edgeCount(), 64u);
+    }
+
+    auto edges = graph.topEdges(1);
+    ASSERT_EQ(edges.size(), 1u);
+    EXPECT_EQ(edges[0].caller, "hot_caller");
+    EXPECT_EQ(edges[0].count, 5000u);
+}
+
+TEST(AggregateCallGraphTest, MergeMatchesSingleIngestion) {
+    AggregateCallGraph combined;
+    AggregateCallGraph shard_a;
+    AggregateCallGraph shard_b;
+
+    for (int i = 0; i < 100; ++i) {
+        auto trace = makeTrace({"leaf_" + std::to_string(i % 5), "mid_" + std::to_string(i % 3), "main"});
+        combined.add(trace, i);
+        (i % 2 == 0 ? shard_a : shard_b).add(trace, i);
+    }
+
+    shard_a.merge(shard_b);
+
+    EXPECT_EQ(shard_a.traceCount(), combined.traceCount());
+    EXPECT_EQ(shard_a.edgeCount(), combined.edgeCount());
+
+    auto merged_edges = shard_a.topEdges(100);
+    auto expected_edges = combined.topEdges(100);
+    ASSERT_EQ(merged_edges.size(), expected_edges.size());
+    for (size_t i = 0; i < expected_edges.size(); ++i) {
+        EXPECT_EQ(merged_edges[i].caller, expected_edges[i].caller);
+        EXPECT_EQ(merged_edges[i].callee, expected_edges[i].callee);
+        EXPECT_EQ(merged_edges[i].count, expected_edges[i].count);
+        EXPECT_EQ(merged_edges[i].first_seen, expected_edges[i].first_seen);
+        EXPECT_EQ(merged_edges[i].last_seen, expected_edges[i].last_seen);
+    }
+
+    auto merged_paths = shard_a.topPaths(1);
+    auto expected_paths = combined.topPaths(1);
+    ASSERT_EQ(merged_paths.size(), 1u);
+    EXPECT_EQ(merged_paths[0].count, expected_paths[0].count);
+}
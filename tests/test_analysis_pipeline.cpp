@@ -0,0 +1,114 @@
+#include "ai_debugger/AnalysisPipeline.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace ai_debugger;
+
+namespace {
+
+std::string makeTrace(int i) {
+    const char* signals[] = {"SIGSEGV, Segmentation fault", "SIGABRT, Aborted", "SIGFPE, Arithmetic exception"};
+    return std::string("Program received signal ") + signals[i % 3] + ".\n" +
+           "#0  0x0000555555555189 in handler_" + std::to_string(i) + " (ptr=0x0) at module_" +
+           std::to_string(i % 7) + ".cpp:" + std::to_string(10 + i) + "\n" +
+           "#1  0x00005555555551a4 in dispatch (id=" + std::to_string(i) + ") at dispatch.cpp:40\n" +
+           "#2  0x00005555555551c0 in main () at main.cpp:12\n";
+}
+
+void configure(AIDebugger& debugger) {
+    debugger.setSessionDirectory("");
+    debugger.enableTestGeneration(true);
+}
+
+} // namespace
+
+TEST(AnalysisPipelineTest, MatchesSerialAnalysis) {
+    AIDebugger serial;
+    configure(serial);
+    AIDebugger staged;
+    configure(staged);
+
+    std::vector<DebugSession> sessions;
+    {
+        AnalysisPipeline pipeline(staged, [&sessions](DebugSession&& session) {
+            sessions.push_back(std::move(session));
+        });
+        for (int i = 0; i < 30; ++i) {
+            ASSERT_TRUE(pipeline.submit(makeTrace(i)));
+        }
+        pipeline.close();
+        EXPECT_FALSE(pipeline.submit(makeTrace(0)));
+        EXPECT_EQ(pipeline.submitted(), 30u);
+        EXPECT_EQ(pipeline.completed(), 30u);
+    }
+
+    ASSERT_EQ(sessions.size(), 30u);
+    for (int i = 0; i < 30; ++i) {
+        DebugSession expected = serial.analyzeStackTrace(makeTrace(i));
+        const DebugSession& actual = sessions[i];
+        ASSERT_EQ(actual.trace.frames.size(), expected.trace.frames.size()) << i;
+        EXPECT_EQ(actual.trace.frames[0].function_name, expected.trace.frames[0].function_name);
+        EXPECT_EQ(actual.fingerprint, expected.fingerprint);
+        ASSERT_EQ(actual.root_causes.size(), expected.root_causes.size()) << i;
+        for (size_t c = 0; c < actual.root_causes.size(); ++c) {
+            EXPECT_EQ(actual.root_causes[c].category, expected.root_causes[c].category);
+            EXPECT_DOUBLE_EQ(actual.root_causes[c].confidence, expected.root_causes[c].confidence);
+        }
+        EXPECT_EQ(actual.explanation.summary, expected.explanation.summary);
+        EXPECT_EQ(actual.suggested_fixes.size(), expected.suggested_fixes.size());
+        EXPECT_EQ(actual.regression_tests.test_cases.size(), expected.regression_tests.test_cases.size());
+        EXPECT_EQ(actual.similar_crashes.size(), expected.similar_crashes.size());
+    }
+}
+
+TEST(AnalysisPipelineTest, ParallelStagesWithBackPressure) {
+    AIDebugger debugger;
+    configure(debugger);
+    debugger.enableDeduplication(false);
+
+    PipelineOptions options;
+    options.queue_capacity = 2;
+    options.workers.fill(2);
+
+    size_t delivered = 0;
+    AnalysisPipeline pipeline(debugger, [&delivered](DebugSession&& session) {
+        EXPECT_FALSE(session.session_id.empty());
+        ++delivered;
+    }, options);
+    for (int i = 0; i < 200; ++i) {
+        ASSERT_TRUE(pipeline.submit(makeTrace(i % 20)));
+    }
+    pipeline.close();
+
+    EXPECT_EQ(delivered, 200u);
+    EXPECT_EQ(pipeline.totalLatencyHistogram().count(), 200u);
+    for (size_t s = 0; s < PIPELINE_STAGE_COUNT; ++s) {
+        auto stage = static_cast<PipelineStage>(s);
+        EXPECT_EQ(pipeline.latencyHistogram(stage).count(), 200u) << pipelineStageToString(stage);
+        EXPECT_EQ(pipeline.queueDepthHistogram(stage).count(), 200u);
+        EXPECT_LE(pipeline.queueDepthHistogram(stage).max(), 2u);
+        EXPECT_EQ(pipeline.queueDepth(stage), 0u);
+    }
+}
+
+TEST(AnalysisPipelineTest, RepeatedCrashesSkipStages) {
+    AIDebugger debugger;
+    configure(debugger);
+    DebugSession first = debugger.analyzeStackTrace(makeTrace(1));
+
+    std::vector<DebugSession> sessions;
+    AnalysisPipeline pipeline(debugger, [&sessions](DebugSession&& session) {
+        sessions.push_back(std::move(session));
+    });
+    pipeline.submit(makeTrace(1));
+    pipeline.submit("no frames here");
+    pipeline.close();
+
+    ASSERT_EQ(sessions.size(), 2u);
+    EXPECT_NE(sessions[0].session_id, first.session_id);
+    EXPECT_EQ(sessions[0].occurrence_count, 2u);
+    EXPECT_EQ(sessions[0].trace.frames.size(), 3u);
+    EXPECT_TRUE(sessions[1].trace.frames.empty());
+    EXPECT_TRUE(sessions[1].root_causes.empty());
+}
@@ -0,0 +1,184 @@
+#include "ai_debugger/AnalysisServer.h"
+#include "TestPaths.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace ai_debugger;
+
+namespace {
+
+std::string socketPath() {
+    return test::testDirectory("analysis_server_test_") + ".sock";
+}
+
+const char* TRACE =
+    "Program received signal SIGSEGV, Segmentation fault.\n"
+    "#0  0x0000555555555189 in copy_buffer (dst=0x0) at buffer.cpp:15\n"
+    "#1  0x00005555555551a4 in main () at main.cpp:20\n";
+
+class AnalysisServerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+#ifdef _WIN32
+        GTEST_SKIP() << "Unix domain sockets only";
+#endif
+        socket_path = socketPath();
+        AnalysisServerOptions options;
+        options.socket_path = socket_path;
+        options.threads = 4;
+        options.max_frame_size = 1 << 16;
+        auto history = std::make_shared<CrashHistory>();
+        server = std::make_unique<AnalysisServer>(options, [history] {
+            auto debugger = std::make_unique<AIDebugger>();
+            debugger->setSessionDirectory("");
+            debugger->setCrashHistory(history);
+            return debugger;
+        });
+        std::string error;
+        ASSERT_TRUE(server->start(&error)) << error;
+    }
+
+    std::string socket_path;
+    std::unique_ptr<AnalysisServer> server;
+};
+
+} // namespace
+
+TEST_F(AnalysisServerTest, AnswersRequests) {
+    AnalysisClient client;
+    std::string error;
+    ASSERT_TRUE(client.connect(socket_path, &error)) << error;
+    EXPECT_TRUE(client.ping());
+
+    DebugSession session;
+    ASSERT_TRUE(client.analyze(TRACE, session, &error)) << error;
+    ASSERT_EQ(session.trace.frames.size(), 2u);
+    EXPECT_EQ(session.trace.frames[0].function_name, "copy_buffer");
+    EXPECT_FALSE(session.root_causes.empty());
+    EXPECT_FALSE(session.session_id.empty());
+    // Completed by the server, as a local session would complete itself:
+    // the client has nothing to compute the pending parts with.
+    EXPECT_FALSE(hasOption(session.pending, AnalysisOptions::REGRESSION_TESTS));
+    AIDebugger local;
+    local.setSessionDirectory("");
+    DebugSession expected = local.analyzeStackTrace(TRACE);
+    EXPECT_EQ(session.getSuggestedFixes().size(), expected.getSuggestedFixes().size());
+    EXPECT_EQ(session.getRegressionTests().test_cases.size(), expected.getRegressionTests().test_cases.size());
+
+    std::string report;
+    ASSERT_TRUE(client.report(TRACE, report, &error)) << error;
+    EXPECT_NE(report.find("AI DEBUGGER ANALYSIS REPORT"), std::string::npos);
+    EXPECT_EQ(server->requestCount(), 3u);
+
+    // Over the frame limit: refused, and the connection is closed.
+    EXPECT_FALSE(client.report(std::string((1 << 16) + 100, 'x'), report, &error));
+    EXPECT_NE(error.find("exceeds"), std::string::npos);
+    EXPECT_FALSE(client.ping());
+    EXPECT_FALSE(client.isConnected());
+
+    AnalysisServerOptions options;
+    options.socket_path = socket_path;
+    AnalysisServer second(options, [] { return std::make_unique<AIDebugger>(); });
+    EXPECT_FALSE(second.start(&error));
+    EXPECT_NE(error.find("already listening"), std::string::npos);
+}
+
+TEST_F(AnalysisServerTest, RefusesOversizedReplies) {
+    AnalysisClientOptions options;
+    options.max_reply_size = 64;
+    AnalysisClient client(options);
+    std::string error;
+    ASSERT_TRUE(client.connect(socket_path, &error)) << error;
+    EXPECT_TRUE(client.ping(&error)) << error;
+
+    std::string report;
+    EXPECT_FALSE(client.report(TRACE, report, &error));
+    EXPECT_NE(error.find("reply exceeds 64 bytes"), std::string::npos) << error;
+    EXPECT_FALSE(client.isConnected());
+
+    ASSERT_TRUE(client.connect(socket_path, &error)) << error;
+    EXPECT_TRUE(client.ping(&error)) << error;
+}
+
+TEST_F(AnalysisServerTest, ServesConcurrentClients) {
+    std::atomic<int> succeeded{0};
+    std::vector<std::thread> clients;
+    for (int c = 0; c < 8; ++c) {
+        clients.emplace_back([this, &succeeded] {
+            AnalysisClient client;
+            if (!client.connect(socket_path)) {
+                return;
+            }
+            for (int i = 0; i < 10; ++i) {
+                DebugSession session;
+                if (client.analyze(TRACE, session) && session.trace.frames.size() == 2) {
+                    ++succeeded;
+                }
+            }
+        });
+    }
+    for (auto& client : clients) {
+        client.join();
+    }
+    EXPECT_EQ(succeeded, 80);
+    EXPECT_EQ(server->requestCount(), 80u);
+}
+
+TEST_F(AnalysisServerTest, StopsCleanly) {
+    AnalysisClient idle;
+    ASSERT_TRUE(idle.connect(socket_path));
+    ASSERT_TRUE(idle.ping());
+
+    server->stop();
+    EXPECT_FALSE(server->isRunning());
+    EXPECT_FALSE(idle.ping());
+
+    AnalysisClient late;
+    EXPECT_FALSE(late.connect(socket_path));
+
+    std::string error;
+    ASSERT_TRUE(server->start(&error)) << error;
+    ASSERT_TRUE(late.connect(socket_path));
+    EXPECT_TRUE(late.ping());
+}
+
+TEST_F(AnalysisServerTest, IdleConnectionsDoNotHoldWorkers) {
+    std::vector<std::unique_ptr<AnalysisClient>> idle;
+    for (int i = 0; i < 8; ++i) {
+        idle.push_back(std::make_unique<AnalysisClient>());
+        ASSERT_TRUE(idle.back()->connect(socket_path));
+    }
+
+    AnalysisClient client;
+    ASSERT_TRUE(client.connect(socket_path));
+    EXPECT_TRUE(client.ping());
+    for (auto& connection : idle) {
+        EXPECT_TRUE(connection->ping());
+    }
+}
+
+TEST(AnalysisServerIdleTest, ClosesIdleConnections) {
+#ifdef _WIN32
+    GTEST_SKIP() << "Unix domain sockets only";
+#endif
+    AnalysisServerOptions options;
+    options.socket_path = socketPath();
+    options.threads = 1;
+    options.idle_timeout_ms = 50;
+    AnalysisServer server(options, [] {
+        auto debugger = std::make_unique<AIDebugger>();
+        debugger->setSessionDirectory("");
+        return debugger;
+    });
+    std::string error;
+    ASSERT_TRUE(server.start(&error)) << error;
+
+    AnalysisClient client;
+    ASSERT_TRUE(client.connect(options.socket_path));
+    EXPECT_TRUE(client.ping());
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    EXPECT_FALSE(client.ping());
+}
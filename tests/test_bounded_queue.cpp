@@ -0,0 +1,97 @@
+#include "ai_debugger/BoundedQueue.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace ai_debugger;
+
+TEST(BoundedQueueTest, FifoWithinCapacity) {
+    BoundedQueue<std::unique_ptr<int>> queue(3);
+    EXPECT_EQ(queue.capacity(), 4u);
+
+    for (int i = 0; i < 4; ++i) {
+        auto item = std::make_unique<int>(i);
+        ASSERT_TRUE(queue.tryPush(item));
+        EXPECT_EQ(item, nullptr);
+    }
+    auto extra = std::make_unique<int>(4);
+    EXPECT_FALSE(queue.tryPush(extra));
+    ASSERT_NE(extra, nullptr);
+    EXPECT_EQ(queue.size(), 4u);
+
+    std::unique_ptr<int> out;
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(queue.tryPop(out));
+        EXPECT_EQ(*out, i);
+    }
+    EXPECT_FALSE(queue.tryPop(out));
+}
+
+TEST(BoundedQueueTest, BlockingTransfer) {
+    BoundedQueue<int> queue(2);
+    const int producers = 4;
+    const int per_producer = 5000;
+
+    std::atomic<long long> sum{0};
+    std::atomic<int> received{0};
+    std::vector<std::thread> threads;
+    for (int c = 0; c < 3; ++c) {
+        threads.emplace_back([&] {
+            int value;
+            while (queue.pop(value)) {
+                sum += value;
+                ++received;
+            }
+        });
+    }
+    std::vector<std::thread> senders;
+    for (int p = 0; p < producers; ++p) {
+        senders.emplace_back([&queue, p] {
+            for (int i = 1; i <= per_producer; ++i) {
+                EXPECT_TRUE(queue.push(p * per_producer + i));
+            }
+        });
+    }
+    for (auto& sender : senders) {
+        sender.join();
+    }
+    queue.close();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    long long n = producers * per_producer;
+    EXPECT_EQ(received, n);
+    EXPECT_EQ(sum, n * (n + 1) / 2);
+    EXPECT_FALSE(queue.push(1));
+}
+
+TEST(BoundedQueueTest, CloseWakesBlockedThreads) {
+    BoundedQueue<int> empty(4);
+    std::thread consumer([&empty] {
+        int value;
+        EXPECT_FALSE(empty.pop(value));
+    });
+
+    BoundedQueue<int> full(2);
+    EXPECT_TRUE(full.push(1));
+    EXPECT_TRUE(full.push(2));
+    std::thread producer([&full] {
+        EXPECT_FALSE(full.push(3));
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    empty.close();
+    full.close();
+    consumer.join();
+    producer.join();
+
+    // Items queued before close still drain.
+    int value = 0;
+    EXPECT_TRUE(full.pop(value));
+    EXPECT_EQ(value, 1);
+    EXPECT_TRUE(full.pop(value));
+    EXPECT_FALSE(full.pop(value));
+}
@@ -85,3 +85,132 @@ TEST(CallGraphAnalyzerTest, GetCallDepth) {
     int depth = analyzer.getCallDepth("deep_function");
     EXPECT_EQ(depth, 0);
 }
+
+TEST(CallGraphAnalyzerTest, BuildFromStackTraceView) {
+    StackTraceParser parser;
+    auto view = parser.parseView(std::string(
+        "#0  0x0000555555555269 in inner () at test.cpp:15\n"
+        "#1  0x00005555555552a8 in outer () at test.cpp:20\n"));
+    ASSERT_TRUE(view.has_value());
+
+    CallGraphAnalyzer analyzer;
+    analyzer.buildFromStackTrace(*view);
+
+    auto node = analyzer.getNode("inner");
+    ASSERT_TRUE(node.has_value());
+    EXPECT_EQ(node->location.file, "test.cpp");
+    EXPECT_EQ(node->location.line, 15);
+    EXPECT_EQ(analyzer.getNodes().size(), 2u);
+}
+
+TEST(CallGraphAnalyzerTest, RebuildReplacesPreviousGraph) {
+    CallGraphAnalyzer analyzer;
+
+    StackTrace first;
+    StackFrame lock_frame;
+    lock_frame.function_name = "mutex_lock";
+    first.frames.push_back(lock_frame);
+    StackFrame caller;
+    caller.function_name = "worker";
+    first.frames.push_back(caller);
+    analyzer.buildFromStackTrace(first);
+    EXPECT_EQ(analyzer.getNodes().size(), 2u);
+    EXPECT_EQ(analyzer.detectPatterns().size(), 1u);
+
+    StackTrace second;
+    StackFrame frame;
+    frame.function_name = "parse";
+    second.frames.push_back(frame);
+
+    for (int i = 0; i < 3; ++i) {
+        analyzer.buildFromStackTrace(second);
+        EXPECT_EQ(analyzer.getNodes().size(), 1u);
+        EXPECT_TRUE(analyzer.detectPatterns().empty());
+        EXPECT_FALSE(analyzer.getNode("mutex_lock").has_value());
+    }
+
+    analyzer.reset();
+    EXPECT_TRUE(analyzer.getNodes().empty());
+    EXPECT_EQ(analyzer.getCallDepth("parse"), -1);
+}
+
+TEST(CallGraphAnalyzerTest, RepeatedFramesKeepEdges) {
+    StackTrace trace;
+    for (const char* name : {"visit", "visit", "visit", "walk", "main"}) {
+        StackFrame frame;
+        frame.function_name = name;
+        frame.location.file = "tree.cpp";
+        frame.location.line = static_cast<int>(trace.frames.size()) + 10;
+        trace.frames.push_back(frame);
+    }
+
+    CallGraphAnalyzer analyzer;
+    analyzer.buildFromStackTrace(trace);
+
+    auto visit = analyzer.getNode("visit");
+    ASSERT_TRUE(visit.has_value());
+    EXPECT_EQ(visit->depth, 0);
+    EXPECT_EQ(visit->location.line, 10);
+    EXPECT_EQ(visit->callees, std::vector<std::string>{"visit"});
+    EXPECT_EQ(visit->callers, (std::vector<std::string>{"visit", "walk"}));
+
+    auto walk = analyzer.getNode("walk");
+    ASSERT_TRUE(walk.has_value());
+    EXPECT_EQ(walk->callees, std::vector<std::string>{"visit"});
+    EXPECT_EQ(walk->callers, std::vector<std::string>{"main"});
+
+    EXPECT_TRUE(analyzer.isRecursive("visit"));
+    EXPECT_FALSE(analyzer.isRecursive("walk"));
+
+    auto patterns = analyzer.detectPatterns();
+    ASSERT_EQ(patterns.size(), 1u);
+    EXPECT_EQ(patterns[0].pattern_type, "RECURSION");
+    EXPECT_EQ(patterns[0].functions, (std::vector<std::string>{"visit", "visit"}));
+}
+
+TEST(CallGraphAnalyzerTest, MutualRecursionReportedOncePerCycle) {
+    StackTrace trace;
+    for (int i = 0; i < 9; ++i) {
+        StackFrame frame;
+        frame.function_name = (i % 3 == 0) ? "parse_expr" : (i % 3 == 1) ? "parse_term" : "parse_factor";
+        trace.frames.push_back(frame);
+    }
+    StackFrame entry;
+    entry.function_name = "main";
+    trace.frames.push_back(entry);
+
+    CallGraphAnalyzer analyzer;
+    analyzer.buildFromStackTrace(trace);
+
+    EXPECT_TRUE(analyzer.isRecursive("parse_expr"));
+    EXPECT_TRUE(analyzer.isRecursive("parse_term"));
+    EXPECT_FALSE(analyzer.isRecursive("main"));
+
+    auto patterns = analyzer.detectPatterns();
+    ASSERT_EQ(patterns.size(), 1u);
+    EXPECT_EQ(patterns[0].functions,
+              (std::vector<std::string>{"parse_expr", "parse_factor", "parse_term", "parse_expr"}));
+    EXPECT_EQ(analyzer.getRecursionChain("parse_term"),
+              (std::vector<std::string>{"parse_term", "parse_expr", "parse_factor", "parse_term"}));
+    EXPECT_TRUE(analyzer.getRecursionChain("main").empty());
+}
+
+TEST(CallGraphAnalyzerTest, DeepStackOverflowTrace) {
+    StackTrace trace;
+    for (int i = 0; i < 100000; ++i) {
+        StackFrame frame;
+        frame.function_name = i < 50000 ? "recurse" : "step_" + std::to_string(i);
+        trace.frames.push_back(frame);
+    }
+
+    CallGraphAnalyzer analyzer;
+    analyzer.buildFromStackTrace(trace);
+
+    EXPECT_EQ(analyzer.getNodes().size(), 50001u);
+    EXPECT_TRUE(analyzer.isRecursive("recurse"));
+    EXPECT_FALSE(analyzer.isRecursive("step_50000"));
+
+    auto patterns = analyzer.detectPatterns();
+    ASSERT_EQ(patterns.size(), 1u);
+    EXPECT_EQ(patterns[0].functions, (std::vector<std::string>{"recurse", "recurse"}));
+}
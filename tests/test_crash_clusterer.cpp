@@ -0,0 +1,78 @@
+#include "ai_debugger/CrashClusterer.h"
+#include "TestTraces.h"
+#include <gtest/gtest.h>
+
+using namespace ai_debugger;
+using ai_debugger::test::makeTrace;
+
+namespace {
+
+std::vector<std::string> stack(const std::string& prefix, int depth) {
+    std::vector<std::string> functions;
+    for (int i = 0; i < depth; ++i) {
+        functions.push_back(prefix + "_" + std::to_string(i));
+    }
+    return functions;
+}
+
+} // namespace
+
+TEST(CrashClustererTest, NearDuplicatesShareCluster) {
+    CrashClusterer clusterer;
+
+    auto base = stack("render", 16);
+    auto first = clusterer.add(makeTrace(base));
+    EXPECT_TRUE(first.created);
+
+    auto inlined = base;
+    inlined.insert(inlined.begin() + 5, "render_inlined_helper");
+    auto second = clusterer.add(makeTrace(inlined));
+    EXPECT_FALSE(second.created);
+    EXPECT_EQ(second.cluster_id, first.cluster_id);
+    EXPECT_GE(second.similarity, 0.5);
+
+    auto relinked = base;
+    relinked[3] += ".isra.0";
+    EXPECT_EQ(clusterer.add(makeTrace(relinked)).cluster_id, first.cluster_id);
+
+    auto other = clusterer.add(makeTrace(stack("network", 16)));
+    EXPECT_TRUE(other.created);
+    EXPECT_NE(other.cluster_id, first.cluster_id);
+
+    EXPECT_EQ(clusterer.clusterCount(), 2u);
+    auto cluster = clusterer.getCluster(first.cluster_id);
+    ASSERT_TRUE(cluster.has_value());
+    EXPECT_EQ(cluster->size, 3u);
+    EXPECT_EQ(cluster->frames.front(), "render_0");
+}
+
+TEST(CrashClustererTest, FindDoesNotInsert) {
+    CrashClusterer clusterer;
+    EXPECT_FALSE(clusterer.find(makeTrace(stack("io", 10))).has_value());
+
+    clusterer.add(makeTrace(stack("io", 10)));
+    auto match = clusterer.find(makeTrace(stack("io", 10)));
+    ASSERT_TRUE(match.has_value());
+    EXPECT_DOUBLE_EQ(match->similarity, 1.0);
+    EXPECT_EQ(clusterer.getCluster(match->cluster_id)->size, 1u);
+}
+
+TEST(CrashClustererTest, LargestClustersOrderedBySize) {
+    CrashClusterer clusterer;
+    for (int i = 0; i < 5; ++i) {
+        clusterer.add(makeTrace(stack("hot", 12)));
+    }
+    for (int i = 0; i < 2; ++i) {
+        clusterer.add(makeTrace(stack("warm", 12)));
+    }
+    clusterer.add(makeTrace(stack("cold", 12)));
+
+    auto largest = clusterer.largestClusters(2);
+    ASSERT_EQ(largest.size(), 2u);
+    EXPECT_EQ(largest[0].size, 5u);
+    EXPECT_EQ(largest[0].frames.front(), "hot_0");
+    EXPECT_EQ(largest[1].size, 2u);
+
+    clusterer.clear();
+    EXPECT_EQ(clusterer.clusterCount(), 0u);
+}
@@ -0,0 +1,167 @@
+#include "ai_debugger/CrashHistory.h"
+#include "ai_debugger/AIDebugger.h"
+#include "TestTraces.h"
+#include <gtest/gtest.h>
+#include <filesystem>
+
+using namespace ai_debugger;
+using ai_debugger::test::makeTrace;
+
+namespace {
+
+RootCause makeCause(BugCategory category, const std::string& description) {
+    RootCause cause;
+    cause.category = category;
+    cause.description = description;
+    cause.confidence = 0.5;
+    return cause;
+}
+
+} // namespace
+
+TEST(CrashHistoryTest, RecordsAndConfirms) {
+    CrashHistory history;
+    auto trace = makeTrace({"Scheduler::drain", "Scheduler::run", "main"}, "worker stalled in queue 3");
+    auto other = makeTrace({"Codec::decode", "Codec::frame", "Player::tick"}, "bad frame header");
+
+    history.record(trace, "a", makeCause(BugCategory::RACE_CONDITION, "predicted"), false);
+    history.record(other, "b", makeCause(BugCategory::BUFFER_OVERFLOW, "predicted"), false);
+    EXPECT_EQ(history.size(), 2u);
+    EXPECT_EQ(history.confirmedCount(), 0u);
+
+    auto query = makeTrace({"Scheduler::drain", "Scheduler::run", "main"}, "worker stalled in queue 7");
+    auto similar = history.nearest(query, 1, 0.8);
+    ASSERT_EQ(similar.size(), 1u);
+    EXPECT_EQ(similar[0].session_id, "a");
+    EXPECT_FALSE(similar[0].confirmed);
+    EXPECT_TRUE(history.nearest(query, 1, 0.8, true).empty());
+
+    EXPECT_FALSE(history.confirm("missing", makeCause(BugCategory::DEADLOCK, "")));
+    EXPECT_TRUE(history.confirm("a", makeCause(BugCategory::DEADLOCK, "lock order inversion")));
+    EXPECT_EQ(history.confirmedCount(), 1u);
+
+    similar = history.nearest(query, 1, 0.8, true);
+    ASSERT_EQ(similar.size(), 1u);
+    EXPECT_TRUE(similar[0].confirmed);
+    EXPECT_EQ(similar[0].root_cause.category, BugCategory::DEADLOCK);
+
+    // Recording the same session again replaces its entry.
+    history.record(trace, "a", makeCause(BugCategory::DEADLOCK, "lock order inversion"), false);
+    EXPECT_EQ(history.size(), 2u);
+    EXPECT_EQ(history.confirmedCount(), 0u);
+
+    history.clear();
+    EXPECT_EQ(history.size(), 0u);
+    EXPECT_TRUE(history.nearest(query, 1).empty());
+}
+
+TEST(CrashHistoryTest, PredictorUsesConfirmedNeighbors) {
+    RootCausePredictor predictor;
+    auto history = std::make_shared<CrashHistory>();
+    predictor.setCrashHistory(history);
+
+    auto trace = makeTrace({"Scheduler::drain", "Scheduler::run", "main"}, "worker stalled in queue 3");
+    history->record(trace, "a", makeCause(BugCategory::DEADLOCK, "lock order inversion"), false);
+
+    CallGraphAnalyzer analyzer;
+    for (const auto& cause : predictor.predict(trace, analyzer)) {
+        EXPECT_EQ(cause.description.find("Similar past crash"), std::string::npos);
+    }
+
+    ASSERT_TRUE(history->confirm("a", makeCause(BugCategory::DEADLOCK, "lock order inversion")));
+    auto causes = predictor.predict(makeTrace({"Scheduler::drain", "Scheduler::run", "main"},
+                                              "worker stalled in queue 9"), analyzer);
+    ASSERT_FALSE(causes.empty());
+    EXPECT_EQ(causes[0].category, BugCategory::DEADLOCK);
+    EXPECT_EQ(causes[0].description, "Similar past crash: lock order inversion");
+    ASSERT_EQ(causes[0].contributing_factors.size(), 1u);
+    EXPECT_EQ(causes[0].contributing_factors[0].find("Session a"), 0u);
+}
+
+TEST(CrashHistoryTest, DebuggerListsSimilarSessions) {
+    const char* directory = "crash_history_sessions";
+    std::filesystem::remove_all(directory);
+    AIDebugger debugger;
+    debugger.setSessionDirectory(directory);
+    std::string trace =
+        "Program received signal SIGSEGV, Segmentation fault.\n"
+        "#0  0x0000555555555189 in Scheduler::drain (this=0x0) at src/scheduler.cpp:42\n"
+        "#1  0x00005555555551a4 in Scheduler::run () at src/scheduler.cpp:77\n"
+        "#2  0x00005555555551c0 in main () at src/main.cpp:10\n";
+
+    debugger.enableDeduplication(false);
+    auto first = debugger.analyzeStackTrace(trace);
+    EXPECT_TRUE(first.similar_crashes.empty());
+
+    auto second = debugger.analyzeStackTrace(trace);
+    ASSERT_EQ(second.similar_crashes.size(), 1u);
+    EXPECT_EQ(second.similar_crashes[0].session_id, first.session_id);
+    EXPECT_NE(debugger.getReport(second).find("SIMILAR PAST CRASHES"), std::string::npos);
+
+    EXPECT_TRUE(debugger.confirmRootCause(first.session_id, makeCause(BugCategory::DEADLOCK, "confirmed")));
+    EXPECT_FALSE(debugger.confirmRootCause("missing", makeCause(BugCategory::DEADLOCK, "confirmed")));
+    auto stored = debugger.loadSession(first.session_id);
+    ASSERT_FALSE(stored.root_causes.empty());
+    EXPECT_EQ(stored.root_causes[0].category, BugCategory::DEADLOCK);
+
+    auto similar = debugger.findSimilarSessions(second.trace, 5);
+    ASSERT_EQ(similar.size(), 2u);
+    EXPECT_EQ(debugger.getCrashHistory()->confirmedCount(), 1u);
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST(CrashHistoryTest, ConfirmedEntriesSurviveFloods) {
+    SimilarityOptions options;
+    options.max_bucket_size = 4;
+    CrashHistory history(options, 64);
+
+    auto trace = makeTrace({"Scheduler::drain", "Scheduler::run", "main"}, "worker stalled in queue 3");
+    history.record(trace, "confirmed", makeCause(BugCategory::DEADLOCK, "lock order inversion"), true);
+    for (int i = 0; i < 200; ++i) {
+        history.record(trace, "predicted" + std::to_string(i), makeCause(BugCategory::RACE_CONDITION, ""), false);
+    }
+
+    EXPECT_LE(history.size(), 64u);
+    EXPECT_EQ(history.confirmedCount(), 1u);
+    auto similar = history.nearest(trace, 1, 0.8, true);
+    ASSERT_EQ(similar.size(), 1u);
+    EXPECT_EQ(similar[0].session_id, "confirmed");
+    EXPECT_FALSE(history.confirm("predicted0", makeCause(BugCategory::DEADLOCK, "")));
+    EXPECT_TRUE(history.confirm("predicted199", makeCause(BugCategory::DEADLOCK, "")));
+}
+
+TEST(CrashHistoryTest, DebuggerRestoresHistoryFromSessions) {
+    const char* directory = "crash_history_restore";
+    std::filesystem::remove_all(directory);
+    std::string trace =
+        "Program received signal SIGSEGV, Segmentation fault.\n"
+        "#0  0x0000555555555189 in Scheduler::drain (this=0x0) at src/scheduler.cpp:42\n"
+        "#1  0x00005555555551a4 in Scheduler::run () at src/scheduler.cpp:77\n";
+
+    std::string session_id;
+    {
+        AIDebugger first_run;
+        first_run.setSessionDirectory(directory);
+        session_id = first_run.analyzeStackTrace(trace).session_id;
+    }
+    {
+        AIDebugger second_run;
+        second_run.setSessionDirectory(directory);
+        EXPECT_TRUE(second_run.confirmRootCause(session_id, makeCause(BugCategory::DEADLOCK, "confirmed")));
+        EXPECT_EQ(second_run.getCrashHistory()->confirmedCount(), 1u);
+    }
+
+    AIDebugger third_run;
+    third_run.setSessionDirectory(directory);
+    third_run.enableDeduplication(false);
+    ASSERT_TRUE(third_run.openSessionStore());
+    ASSERT_TRUE(third_run.flushSessions());
+    auto session = third_run.analyzeStackTrace(trace);
+    ASSERT_FALSE(session.similar_crashes.empty());
+    EXPECT_EQ(session.similar_crashes[0].session_id, session_id);
+    EXPECT_TRUE(session.similar_crashes[0].confirmed);
+    EXPECT_TRUE(third_run.loadSession(session_id).root_cause_confirmed);
+
+    std::filesystem::remove_all(directory);
+}
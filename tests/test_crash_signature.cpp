@@ -0,0 +1,80 @@
+#include "ai_debugger/CrashSignature.h"
+#include "TestTraces.h"
+#include <gtest/gtest.h>
+
+using namespace ai_debugger;
+using ai_debugger::test::makeTraceWithFiles;
+
+namespace {
+
+std::string normalize(const std::string& name) {
+    std::string out;
+    normalizeFunctionName(name, out);
+    return out;
+}
+
+} // namespace
+
+TEST(CrashSignatureTest, NormalizeFunctionName) {
+    EXPECT_EQ(normalize("process_request"), "process_request");
+    EXPECT_EQ(normalize("main + 42"), "main");
+    EXPECT_EQ(normalize("handler+0x1a"), "handler");
+    EXPECT_EQ(normalize("parse.isra.0"), "parse");
+    EXPECT_EQ(normalize("Foo::bar(int) [clone .cold]"), "Foo::bar(int) [clone");
+    EXPECT_EQ(normalize("compute.constprop.3.part.1"), "compute");
+    EXPECT_EQ(normalize("0x00007fff5fbff8a0"), "");
+    EXPECT_EQ(normalize("operator+(Vec, Vec)"), "operator+(Vec, Vec)");
+}
+
+TEST(CrashSignatureTest, LibraryFunctions) {
+    EXPECT_TRUE(isLibraryFunction("std::vector<int>::at", "vector"));
+    EXPECT_TRUE(isLibraryFunction("__libc_start_main", ""));
+    EXPECT_TRUE(isLibraryFunction("memcpy", "/usr/lib/libc.so.6"));
+    EXPECT_FALSE(isLibraryFunction("process_request", "src/server.cpp"));
+}
+
+TEST(CrashSignatureTest, FingerprintIgnoresLinesAddressesAndLibraryFrames) {
+    auto trace = makeTraceWithFiles({{"memcpy", "/usr/lib/libc.so.6"},
+                                     {"copy_buffer", "src/buffer.cpp"},
+                                     {"handle", "src/server.cpp"}});
+    auto relinked = makeTraceWithFiles({{"std::__copy_move", "/usr/include/c++/bits/stl_algobase.h"},
+                                        {"copy_buffer.isra.0", "src/buffer.cpp"},
+                                        {"handle + 128", "src/server.cpp"}});
+    relinked.frames[1].address = 0x7fff0010;
+    relinked.frames[1].location.line = 999;
+
+    EXPECT_NE(crashFingerprint(trace), 0u);
+    EXPECT_EQ(crashFingerprint(trace), crashFingerprint(relinked));
+
+    auto other = makeTraceWithFiles({{"copy_buffer", "src/buffer.cpp"}, {"retry", "src/server.cpp"}});
+    EXPECT_NE(crashFingerprint(trace), crashFingerprint(other));
+
+    EXPECT_EQ(crashFingerprint(StackTrace()), 0u);
+}
+
+TEST(CrashSignatureTest, FingerprintUsesTopFrames) {
+    auto trace = makeTraceWithFiles({{"a", "a.cpp"}, {"b", "b.cpp"}, {"c", "c.cpp"}});
+    auto deeper = makeTraceWithFiles({{"a", "a.cpp"}, {"b", "b.cpp"}, {"other", "c.cpp"}});
+
+    EXPECT_EQ(crashFingerprint(trace, 2), crashFingerprint(deeper, 2));
+    EXPECT_NE(crashFingerprint(trace, 3), crashFingerprint(deeper, 3));
+
+    auto only_library = makeTraceWithFiles({{"__libc_start_main", ""}, {"std::terminate", ""}});
+    EXPECT_NE(crashFingerprint(only_library), 0u);
+}
+
+TEST(CrashSignatureTest, NormalizeErrorMessage) {
+    std::string out;
+    normalizeErrorMessage("  Segmentation fault at 0x7ffd5fbff8a0 in PID 4242  ", out);
+    EXPECT_EQ(out, "segmentation fault at # in pid #");
+
+    normalizeErrorMessage("double free or corruption (fasttop): 0x000055d3c8e2a260", out);
+    EXPECT_EQ(out, "double free or corruption (fasttop): #");
+
+    normalizeErrorMessage("worker3 failed after 120ms", out);
+    EXPECT_EQ(out, "worker# failed after #ms");
+
+    EXPECT_EQ(errorMessageKey("SIGSEGV at 0xdeadbeef (thread 17)"),
+              errorMessageKey("sigsegv at 0x1234  (thread 9)"));
+    EXPECT_NE(errorMessageKey("SIGSEGV at 0xdeadbeef"), errorMessageKey("SIGABRT at 0xdeadbeef"));
+}
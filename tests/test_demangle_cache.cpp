@@ -0,0 +1,113 @@
+#include "ai_debugger/DemangleCache.h"
+#include "ai_debugger/StackTraceParser.h"
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+using namespace ai_debugger;
+
+TEST(DemangleCacheTest, DemanglesAndCountsHits) {
+    DemangleCache cache;
+    std::string out;
+
+    ASSERT_TRUE(cache.demangle("_ZN3foo3barEv", out));
+    EXPECT_EQ(out, "foo::bar()");
+
+    out.clear();
+    ASSERT_TRUE(cache.demangle("_ZN3foo3barEv", out));
+    EXPECT_EQ(out, "foo::bar()");
+
+    auto stats = cache.stats();
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.entries, 1u);
+}
+
+TEST(DemangleCacheTest, PlainNamesAreCachedUnchanged) {
+    DemangleCache cache;
+    std::string out = "untouched";
+
+    EXPECT_FALSE(cache.demangle("main", out));
+    EXPECT_FALSE(cache.demangle("main", out));
+    EXPECT_EQ(out, "untouched");
+    EXPECT_EQ(cache.stats().hits, 1u);
+}
+
+TEST(DemangleCacheTest, StaysWithinCapacity) {
+    DemangleCache cache(64, 4);
+    std::string out;
+
+    for (int i = 0; i < 1000; ++i) {
+        std::string name = "function_" + std::to_string(i);
+        std::string mangled = "_Z" + std::to_string(name.size()) + name + "v";
+        ASSERT_TRUE(cache.demangle(mangled, out));
+        EXPECT_EQ(out, name + "()");
+    }
+
+    auto stats = cache.stats();
+    EXPECT_LE(stats.entries, 64u);
+    EXPECT_GT(stats.evictions, 0u);
+
+    // Recently used names survive a rotation.
+    std::string out_again;
+    ASSERT_TRUE(cache.demangle("_Z12function_999v", out_again));
+    EXPECT_EQ(out_again, "function_999()");
+    EXPECT_EQ(cache.stats().hits, 1u);
+}
+
+TEST(DemangleCacheTest, ConcurrentLookups) {
+    DemangleCache cache(128, 8);
+    std::vector<std::thread> threads;
+    std::vector<int> failures(4, 0);
+
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&cache, &failures, t]() {
+            std::string out;
+            for (int i = 0; i < 2000; ++i) {
+                std::string name = "f" + std::to_string(i % 300);
+                std::string mangled = "_Z" + std::to_string(name.size()) + name + "i";
+                if (!cache.demangle(mangled, out) || out != name + "(int)") {
+                    ++failures[t];
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (int count : failures) {
+        EXPECT_EQ(count, 0);
+    }
+    auto stats = cache.stats();
+    EXPECT_EQ(stats.hits + stats.misses, 8000u);
+}
+
+TEST(DemangleCacheTest, ParserUsesConfiguredCache) {
+    auto cache = std::make_shared<DemangleCache>();
+    StackTraceParser parser;
+    parser.setDemangleCache(cache);
+    EXPECT_EQ(parser.getDemangleCache(), cache);
+
+    std::string trace =
+        "_ZN3foo3barEv at /src/foo.cpp:10\n"
+        "_ZN3foo3barEv at /src/foo.cpp:12\n"
+        "main at /src/main.cpp:5\n";
+
+    auto result = parser.parse(trace);
+    ASSERT_TRUE(result.has_value());
+    ASSERT_EQ(result->frames.size(), 3);
+    EXPECT_EQ(result->frames[0].function_name, "foo::bar()");
+    EXPECT_EQ(result->frames[1].function_name, "foo::bar()");
+    EXPECT_EQ(result->frames[2].function_name, "main");
+
+    auto stats = cache->stats();
+    EXPECT_EQ(stats.misses, 2u);
+    EXPECT_EQ(stats.hits, 1u);
+
+    parser.setDemangleCache(nullptr);
+    auto uncached = parser.parse(trace);
+    ASSERT_TRUE(uncached.has_value());
+    EXPECT_EQ(uncached->frames[0].function_name, "foo::bar()");
+    EXPECT_EQ(cache->stats().misses, 2u);
+}
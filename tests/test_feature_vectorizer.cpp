@@ -0,0 +1,86 @@
+#include "ai_debugger/FeatureVectorizer.h"
+#include "TestTraces.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+
+using namespace ai_debugger;
+using ai_debugger::test::makeTrace;
+
+namespace {
+
+std::vector<uint32_t> sortedIndices(const SparseFeatures& features) {
+    std::vector<uint32_t> indices = features.indices;
+    std::sort(indices.begin(), indices.end());
+    return indices;
+}
+
+} // namespace
+
+TEST(FeatureVectorizerTest, IndicesWithinDimension) {
+    FeatureVectorizer vectorizer(1000);
+    EXPECT_EQ(vectorizer.dimension(), 1024u);
+
+    SparseFeatures features;
+    vectorizer.vectorize(makeTrace({"Cache::evict", "Cache::put", "main"}, "SIGSEGV in worker 3"), features);
+    ASSERT_GT(features.size(), 0u);
+    EXPECT_EQ(features.indices.size(), features.values.size());
+    for (uint32_t index : features.indices) {
+        EXPECT_LT(index, vectorizer.dimension());
+    }
+}
+
+TEST(FeatureVectorizerTest, DimensionIsClampedToMaximum) {
+    EXPECT_EQ(FeatureVectorizer::roundDimension(0), 1u);
+    EXPECT_EQ(FeatureVectorizer::roundDimension(FeatureVectorizer::MAX_DIMENSION),
+              FeatureVectorizer::MAX_DIMENSION);
+    EXPECT_EQ(FeatureVectorizer(FeatureVectorizer::MAX_DIMENSION + 1).dimension(), FeatureVectorizer::MAX_DIMENSION);
+    EXPECT_EQ(FeatureVectorizer(UINT32_MAX).dimension(), FeatureVectorizer::MAX_DIMENSION);
+}
+
+TEST(FeatureVectorizerTest, IgnoresAddressesAndCloneSuffixes) {
+    FeatureVectorizer vectorizer;
+    SparseFeatures first;
+    SparseFeatures second;
+
+    vectorizer.vectorize(makeTrace({"Cache::evict(int)", "Cache::put", "main"},
+                                   "Invalid read at 0x7ffd5fbff8a0 by thread 4242"), first);
+    auto relinked = makeTrace({"Cache::evict(int) [clone .isra.0]", "Cache::put+0x1a", "main"},
+                              "invalid read at 0x000055d3c8e2a260 by thread 17");
+    relinked.frames[0].location.line = 900;
+    vectorizer.vectorize(relinked, second);
+
+    EXPECT_EQ(sortedIndices(first), sortedIndices(second));
+}
+
+TEST(FeatureVectorizerTest, DistinguishesTraces) {
+    FeatureVectorizer vectorizer;
+    SparseFeatures base;
+    SparseFeatures other;
+    auto trace = makeTrace({"Cache::evict", "Cache::put", "main"}, "double free detected");
+    vectorizer.vectorize(trace, base);
+
+    vectorizer.vectorize(makeTrace({"Socket::read", "Server::poll", "main"}, "double free detected"), other);
+    EXPECT_NE(sortedIndices(base), sortedIndices(other));
+
+    auto aborted = trace;
+    aborted.signal_number = 6;
+    vectorizer.vectorize(aborted, other);
+    EXPECT_NE(sortedIndices(base), sortedIndices(other));
+
+    vectorizer.vectorize(makeTrace({"Cache::evict", "Cache::put", "main"}, "free detected double"), other);
+    EXPECT_NE(sortedIndices(base), sortedIndices(other));
+}
+
+TEST(FeatureVectorizerTest, ReusesOutputStorage) {
+    FeatureVectorizer vectorizer;
+    SparseFeatures features;
+    auto trace = makeTrace({"a::b", "c::d", "e::f", "g::h"}, "assertion failed: size > 0");
+    vectorizer.vectorize(trace, features);
+
+    const uint32_t* storage = features.indices.data();
+    size_t count = features.size();
+    vectorizer.vectorize(trace, features);
+    EXPECT_EQ(features.indices.data(), storage);
+    EXPECT_EQ(features.size(), count);
+}
@@ -0,0 +1,219 @@
+#include "ai_debugger/HeuristicRules.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+using namespace ai_debugger;
+
+namespace {
+
+std::vector<BugCategory> categories(const RuleSet& rules, const PredictionFeatures& features) {
+    std::vector<uint32_t> fired;
+    rules.match(features, fired);
+    std::vector<BugCategory> result;
+    for (uint32_t index : fired) {
+        result.push_back(rules.rules()[index].category);
+    }
+    return result;
+}
+
+void writeFile(const std::string& path, const std::string& text) {
+    std::ofstream file(path, std::ios::trunc);
+    file << text;
+}
+
+const char* LEAK_RULES =
+    "# Allocator rules\n"
+    "[rule]\n"
+    "category = Memory Leak\n"
+    "score = 0.7\n"
+    "description = Pool exhausted by leaked buffers\n"
+    "message = pool exhausted | out of buffers\n"
+    "function = BufferPool\n";
+
+} // namespace
+
+TEST(HeuristicRulesTest, DefaultRulesMatchHeuristics) {
+    auto rules = defaultRuleSet();
+
+    PredictionFeatures features;
+    features.error_message = "Segmentation fault at address 0x0";
+    EXPECT_EQ(categories(*rules, features), std::vector<BugCategory>{BugCategory::NULL_POINTER});
+
+    features.error_message = "SIGSEGV at address 0x7ffd1234";
+    EXPECT_EQ(categories(*rules, features), std::vector<BugCategory>{BugCategory::MEMORY_ERROR});
+
+    features.error_message = "heap corruption: assertion failed";
+    features.function_names = {"main", "std::mutex::lock"};
+    EXPECT_EQ(categories(*rules, features), (std::vector<BugCategory>{
+        BugCategory::BUFFER_OVERFLOW, BugCategory::RACE_CONDITION, BugCategory::ASSERTION_FAILURE
+    }));
+}
+
+TEST(HeuristicRulesTest, GroupsExclusionsModulesAndSignals) {
+    KeywordRule timeout;
+    timeout.all_of = {KeywordGroup(RuleField::ERROR_MESSAGE, {"timeout", "timed out"}),
+                      KeywordGroup(RuleField::FUNCTION_NAME, {"socket"})};
+    timeout.none_of = {KeywordGroup(RuleField::ERROR_MESSAGE, {"retry"})};
+    timeout.category = BugCategory::LOGIC_ERROR;
+
+    KeywordRule allocator;
+    allocator.all_of = {KeywordGroup(RuleField::MODULE, {"libjemalloc"})};
+    allocator.signals = {11, 7};
+    allocator.category = BugCategory::MEMORY_ERROR;
+
+    KeywordRule abort_only;
+    abort_only.signals = {6};
+    abort_only.category = BugCategory::ASSERTION_FAILURE;
+
+    RuleSet rules({timeout, allocator, abort_only});
+
+    PredictionFeatures features;
+    features.error_message = "read timed out";
+    features.function_names = {"Socket::read"};
+    EXPECT_EQ(categories(rules, features), std::vector<BugCategory>{BugCategory::LOGIC_ERROR});
+
+    features.error_message = "read timed out, will retry";
+    EXPECT_TRUE(categories(rules, features).empty());
+
+    features.modules = {"/usr/lib/libjemalloc.so.2"};
+    EXPECT_TRUE(categories(rules, features).empty());
+    features.signal_number = 11;
+    EXPECT_EQ(categories(rules, features), std::vector<BugCategory>{BugCategory::MEMORY_ERROR});
+    features.signal_number = 6;
+    EXPECT_EQ(categories(rules, features), std::vector<BugCategory>{BugCategory::ASSERTION_FAILURE});
+}
+
+TEST(HeuristicRulesTest, ParsesRuleFiles) {
+    std::istringstream input(std::string(LEAK_RULES) +
+        "\n[rule]\n"
+        "category = Memory Error\n"
+        "description = Allocator crash\n"
+        "module = libtcmalloc\n"
+        "not_function = abort\n"
+        "signal = SIGSEGV | 7\n");
+
+    std::vector<KeywordRule> rules;
+    std::string error;
+    ASSERT_TRUE(parseRules(input, rules, &error)) << error;
+    ASSERT_EQ(rules.size(), 2u);
+
+    EXPECT_EQ(rules[0].category, BugCategory::MEMORY_LEAK);
+    EXPECT_DOUBLE_EQ(rules[0].score, 0.7);
+    EXPECT_EQ(rules[0].description, "Pool exhausted by leaked buffers");
+    ASSERT_EQ(rules[0].all_of.size(), 2u);
+    EXPECT_EQ(rules[0].all_of[0].field, RuleField::ERROR_MESSAGE);
+    EXPECT_EQ(rules[0].all_of[0].keywords, (std::vector<std::string>{"pool exhausted", "out of buffers"}));
+    EXPECT_EQ(rules[0].all_of[1].field, RuleField::FUNCTION_NAME);
+
+    EXPECT_DOUBLE_EQ(rules[1].score, 0.5);
+    EXPECT_EQ(rules[1].all_of[0].field, RuleField::MODULE);
+    ASSERT_EQ(rules[1].none_of.size(), 1u);
+    EXPECT_EQ(rules[1].none_of[0].field, RuleField::FUNCTION_NAME);
+    EXPECT_EQ(rules[1].signals, (std::vector<int>{11, 7}));
+}
+
+TEST(HeuristicRulesTest, RejectsInvalidRuleFiles) {
+    auto parse = [](const std::string& text, std::string& error) {
+        std::istringstream input(text);
+        std::vector<KeywordRule> rules;
+        bool ok = parseRules(input, rules, &error);
+        EXPECT_TRUE(ok || rules.empty());
+        return ok;
+    };
+
+    std::string error;
+    EXPECT_FALSE(parse("category = Memory Error\n", error));
+    EXPECT_FALSE(parse("[rule]\ncategory = Memory Error\ndescription = x\n", error));
+    EXPECT_NE(error.find("line 1"), std::string::npos);
+    EXPECT_FALSE(parse("[rule]\ncategory = Bogus\n", error));
+    EXPECT_NE(error.find("line 2"), std::string::npos);
+    EXPECT_FALSE(parse("[rule]\nmessage = a | | b\n", error));
+    EXPECT_FALSE(parse("[rule]\nscore = 1.5\n", error));
+    EXPECT_FALSE(parse("[rule]\nsignal = SIGWHAT\n", error));
+    EXPECT_FALSE(parse("[rule]\ncolour = red\n", error));
+    EXPECT_FALSE(parse(std::string(LEAK_RULES) + "[rule]\ndescription = no category\nmessage = x\n", error));
+    EXPECT_NE(error.find("line 8"), std::string::npos);
+}
+
+TEST(HeuristicRulesTest, EngineReloadsAtomically) {
+    const std::string path = "test_heuristic_rules.rules";
+    writeFile(path, LEAK_RULES);
+
+    RuleEngine engine;
+    std::shared_ptr<const RuleSet> defaults = engine.current();
+    EXPECT_EQ(defaults, defaultRuleSet());
+
+    std::string error;
+    ASSERT_TRUE(engine.load(path, &error)) << error;
+    EXPECT_EQ(engine.generation(), 1u);
+    EXPECT_EQ(engine.path(), path);
+    EXPECT_FALSE(engine.reloadIfChanged());
+
+    // Snapshots taken before a reload stay usable.
+    std::shared_ptr<const RuleSet> before = engine.current();
+    writeFile(path, std::string(LEAK_RULES) + "\n[rule]\ncategory = Deadlock\n"
+                    "description = Lock order inversion\nfunction = lock_both\n");
+    ASSERT_TRUE(engine.reloadIfChanged(&error)) << error;
+    EXPECT_EQ(before->rules().size(), 1u);
+    EXPECT_EQ(engine.current()->rules().size(), 2u);
+    EXPECT_EQ(engine.generation(), 2u);
+
+    // A broken edit keeps the previous rules.
+    writeFile(path, "[rule]\ncategory = Deadlock\n");
+    EXPECT_FALSE(engine.reloadIfChanged(&error));
+    EXPECT_NE(error.find(path), std::string::npos);
+    EXPECT_EQ(engine.current()->rules().size(), 2u);
+    EXPECT_FALSE(engine.load("missing.rules"));
+    EXPECT_EQ(engine.current()->rules().size(), 2u);
+
+    engine.set(nullptr);
+    EXPECT_EQ(engine.current(), defaultRuleSet());
+    EXPECT_EQ(engine.generation(), 3u);
+
+    std::remove(path.c_str());
+}
+
+TEST(HeuristicRulesTest, ReloadDuringPrediction) {
+    const std::string path = "test_heuristic_rules_concurrent.rules";
+    writeFile(path, LEAK_RULES);
+
+    auto engine = std::make_shared<RuleEngine>();
+    ASSERT_TRUE(engine->load(path));
+
+    StackTrace trace;
+    trace.error_message = "Pool exhausted after 1000 requests";
+    StackFrame frame;
+    frame.function_name = "BufferPool::acquire";
+    trace.frames.push_back(frame);
+
+    std::atomic<bool> done{false};
+    std::atomic<size_t> missing{0};
+    std::thread reader([&]() {
+        RootCausePredictor predictor;
+        predictor.setRuleEngine(engine);
+        CallGraphAnalyzer graph;
+        graph.buildFromStackTrace(trace);
+        while (!done.load()) {
+            auto causes = predictor.predict(trace, graph);
+            bool found = false;
+            for (const auto& cause : causes) {
+                found |= cause.category == BugCategory::MEMORY_LEAK;
+            }
+            missing += !found;
+        }
+    });
+
+    for (int i = 0; i < 50; ++i) {
+        ASSERT_TRUE(engine->reload());
+    }
+    done = true;
+    reader.join();
+
+    EXPECT_EQ(missing.load(), 0u);
+    EXPECT_EQ(engine->generation(), 51u);
+    std::remove(path.c_str());
+}
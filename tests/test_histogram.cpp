@@ -0,0 +1,79 @@
+#include "ai_debugger/Histogram.h"
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+using namespace ai_debugger;
+
+TEST(HistogramTest, SmallValuesAreExact) {
+    Histogram histogram;
+    EXPECT_EQ(histogram.percentile(50), 0u);
+
+    for (uint64_t v = 1; v <= 10; ++v) {
+        histogram.record(v);
+    }
+    EXPECT_EQ(histogram.count(), 10u);
+    EXPECT_EQ(histogram.sum(), 55u);
+    EXPECT_EQ(histogram.max(), 10u);
+    EXPECT_DOUBLE_EQ(histogram.mean(), 5.5);
+    EXPECT_EQ(histogram.percentile(50), 5u);
+    EXPECT_EQ(histogram.percentile(90), 9u);
+    EXPECT_EQ(histogram.percentile(100), 10u);
+    EXPECT_EQ(histogram.percentile(0), 1u);
+}
+
+TEST(HistogramTest, LargeValuesWithinBucketError) {
+    Histogram histogram;
+    for (uint64_t v = 1; v <= 100000; ++v) {
+        histogram.record(v * 1000);
+    }
+    for (double p : {50.0, 90.0, 99.0, 99.9}) {
+        double exact = p * 1000.0 * 1000.0;
+        double estimate = static_cast<double>(histogram.percentile(p));
+        EXPECT_GE(estimate, exact * 0.999) << p;
+        EXPECT_LE(estimate, exact * 1.07) << p;
+    }
+    EXPECT_EQ(histogram.percentile(100), 100000000u);
+
+    for (uint64_t v : {uint64_t(15), uint64_t(16), uint64_t(1) << 40, ~uint64_t(0)}) {
+        size_t index = Histogram::bucketIndex(v);
+        ASSERT_LT(index, Histogram::BUCKET_COUNT);
+        EXPECT_GE(Histogram::bucketUpperBound(index), v);
+        EXPECT_LT(Histogram::bucketUpperBound(index - 1), v);
+    }
+
+    histogram.reset();
+    EXPECT_EQ(histogram.count(), 0u);
+    EXPECT_EQ(histogram.max(), 0u);
+}
+
+TEST(HistogramTest, ConcurrentRecords) {
+    Histogram histogram;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&histogram, t] {
+            for (uint64_t i = 0; i < 10000; ++i) {
+                histogram.record(i + t);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(histogram.count(), 40000u);
+    EXPECT_EQ(histogram.max(), 10002u);
+}
+
+TEST(HistogramTest, MergeAddsValues) {
+    Histogram a;
+    Histogram b;
+    for (uint64_t v = 1; v <= 100; ++v) {
+        (v % 2 ? a : b).record(v * 1000);
+    }
+    a.merge(b);
+    EXPECT_EQ(a.count(), 100u);
+    EXPECT_EQ(a.sum(), 5050000u);
+    EXPECT_EQ(a.max(), 100000u);
+    EXPECT_EQ(a.percentile(100), 100000u);
+    EXPECT_EQ(b.count(), 50u);
+}
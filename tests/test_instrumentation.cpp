@@ -0,0 +1,123 @@
+#include "ai_debugger/Instrumentation.h"
+#include "ai_debugger/AIDebugger.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ai_debugger;
+
+namespace {
+
+const char* NULL_DEREF_TRACE =
+    "Program received signal SIGSEGV, Segmentation fault: null pointer dereference.\n"
+    "#0  0x0000555555555189 in process_data (ptr=0x0) at main.cpp:15\n"
+    "#1  0x00005555555551a4 in run () at main.cpp:22\n"
+    "#2  0x00005555555551c0 in main () at main.cpp:30\n";
+
+} // namespace
+
+TEST(InstrumentationTest, DisabledRecordsNothing) {
+    Instrumentation instrumentation;
+    EXPECT_FALSE(instrumentation.isEnabled());
+
+    instrumentation.add(Counter::FRAMES_PARSED, 10);
+    {
+        Instrumentation::ScopedTimer timer(instrumentation, TimedStage::PARSE);
+    }
+
+    auto snapshot = instrumentation.snapshot();
+    EXPECT_EQ(snapshot.counter(Counter::FRAMES_PARSED), 0u);
+    EXPECT_EQ(snapshot.timer(TimedStage::PARSE).count, 0u);
+}
+
+TEST(InstrumentationTest, MergesThreads) {
+    Instrumentation instrumentation;
+    instrumentation.setEnabled(true);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&instrumentation] {
+            for (uint64_t i = 1; i <= 1000; ++i) {
+                instrumentation.recordTime(TimedStage::PREDICT, i);
+                instrumentation.add(Counter::BYTES_CONSUMED, 2);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    auto snapshot = instrumentation.snapshot();
+    const TimerStats& predict = snapshot.timer(TimedStage::PREDICT);
+    EXPECT_EQ(predict.count, 4000u);
+    EXPECT_EQ(predict.total_ns, 4u * 500500u);
+    EXPECT_EQ(predict.max_ns, 1000u);
+    EXPECT_LE(predict.p50_ns, predict.p99_ns);
+    EXPECT_EQ(snapshot.counter(Counter::BYTES_CONSUMED), 8000u);
+
+    instrumentation.reset();
+    snapshot = instrumentation.snapshot();
+    EXPECT_EQ(snapshot.timer(TimedStage::PREDICT).count, 0u);
+    EXPECT_EQ(snapshot.counter(Counter::BYTES_CONSUMED), 0u);
+}
+
+TEST(InstrumentationTest, SnapshotToJSON) {
+    Instrumentation instrumentation;
+    instrumentation.setEnabled(true);
+    instrumentation.recordTime(TimedStage::PERSIST, 1500);
+    instrumentation.add(Counter::CACHE_HITS, 3);
+
+    std::string json = instrumentation.snapshot().toJSON();
+    EXPECT_NE(json.find("\"persist\": {\"count\": 1, \"total_ns\": 1500"), std::string::npos);
+    EXPECT_NE(json.find("\"cache_hits\": 3"), std::string::npos);
+    EXPECT_NE(json.find("\"call_graph\""), std::string::npos);
+    EXPECT_EQ(json.front(), '{');
+    EXPECT_EQ(json.back(), '}');
+}
+
+TEST(InstrumentationTest, TimesDebuggerStages) {
+    AIDebugger debugger;
+    debugger.setSessionDirectory("");
+    debugger.enableTestGeneration(true);
+    auto instrumentation = debugger.getInstrumentation();
+    instrumentation->setEnabled(true);
+
+    std::string trace = NULL_DEREF_TRACE;
+    debugger.analyzeStackTrace(trace);
+    debugger.analyzeStackTrace(trace);
+
+    auto snapshot = instrumentation->snapshot();
+    EXPECT_EQ(snapshot.counter(Counter::TRACES_ANALYZED), 2u);
+    EXPECT_EQ(snapshot.counter(Counter::FRAMES_PARSED), 6u);
+    EXPECT_EQ(snapshot.counter(Counter::BYTES_CONSUMED), 2 * trace.size());
+    EXPECT_EQ(snapshot.counter(Counter::CACHE_MISSES), 1u);
+    EXPECT_EQ(snapshot.counter(Counter::CACHE_HITS), 1u);
+
+    EXPECT_EQ(snapshot.timer(TimedStage::PARSE).count, 2u);
+    for (auto stage : {TimedStage::CALL_GRAPH, TimedStage::PREDICT, TimedStage::EXPLAIN,
+                       TimedStage::FIX, TimedStage::TEST, TimedStage::PERSIST}) {
+        EXPECT_EQ(snapshot.timer(stage).count, 1u) << timedStageToString(stage);
+    }
+    EXPECT_GT(snapshot.timer(TimedStage::PREDICT).total_ns, 0u);
+}
+
+TEST(InstrumentationTest, TimesPartsComputedOnDemand) {
+    AIDebugger debugger;
+    debugger.setSessionDirectory("");
+    debugger.setAnalysisOptions(AnalysisOptions::ROOT_CAUSES);
+    auto instrumentation = std::make_shared<Instrumentation>();
+    instrumentation->setEnabled(true);
+    debugger.setInstrumentation(instrumentation);
+
+    auto session = debugger.analyzeStackTrace(NULL_DEREF_TRACE);
+    EXPECT_EQ(instrumentation->snapshot().timer(TimedStage::EXPLAIN).count, 1u);
+    EXPECT_EQ(instrumentation->snapshot().timer(TimedStage::FIX).count, 1u);
+
+    session.getExplanation();
+    session.getSuggestedFixes();
+    session.getExplanation();
+    auto snapshot = instrumentation->snapshot();
+    EXPECT_EQ(snapshot.timer(TimedStage::EXPLAIN).count, 2u);
+    EXPECT_EQ(snapshot.timer(TimedStage::FIX).count, 2u);
+}
@@ -1,10 +1,26 @@
 #include "ai_debugger/AIDebugger.h"
+#include "TestPaths.h"
 #include <gtest/gtest.h>
+#include <sstream>
+#include <algorithm>
+#include <filesystem>
 
 using namespace ai_debugger;
 
+namespace {
+
+// An empty session directory of the running test's own.
+std::string testSessionDirectory() {
+    std::string directory = test::testDirectory("ai_debugger_");
+    std::filesystem::remove_all(directory);
+    return directory;
+}
+
+} // namespace
+
 TEST(IntegrationTest, FullWorkflow) {
     AIDebugger debugger;
+    debugger.setSessionDirectory("");
 
     std::string trace = R"(
 #0  0x0000555555555269 in vulnerable_function (ptr=0x0) at test.cpp:15
@@ -20,6 +36,7 @@ TEST(IntegrationTest, FullWorkflow) {
 
 TEST(IntegrationTest, GenerateReport) {
     AIDebugger debugger;
+    debugger.setSessionDirectory("");
 
     std::string trace = "#0  0x0000555555555269 in main (ptr=0x0) at test.cpp:15";
 
@@ -32,6 +49,7 @@ TEST(IntegrationTest, GenerateReport) {
 
 TEST(IntegrationTest, SuggestAndApplyFix) {
     AIDebugger debugger;
+    debugger.setSessionDirectory("");
     debugger.setDryRun(true);
 
     std::string trace = "#0  0x0000555555555269 in main (ptr=0x0) at test.cpp:15";
@@ -46,6 +64,7 @@ TEST(IntegrationTest, SuggestAndApplyFix) {
 
 TEST(IntegrationTest, GenerateTests) {
     AIDebugger debugger;
+    debugger.setSessionDirectory("");
     debugger.enableTestGeneration(true);
 
     std::string trace = R"(
@@ -61,21 +80,28 @@ TEST(IntegrationTest, GenerateTests) {
 }
 
 TEST(IntegrationTest, SessionManagement) {
+    std::string directory = testSessionDirectory();
     AIDebugger debugger;
+    debugger.setSessionDirectory(directory);
+    ASSERT_TRUE(debugger.openSessionStore());
 
     std::string trace = "#0  0x0000555555555269 in main () at test.cpp:15";
 
     auto session = debugger.analyzeStackTrace(trace);
 
     auto sessions = debugger.listSessions();
-    EXPECT_GT(sessions.size(), 0);
+    EXPECT_EQ(sessions, std::vector<std::string>{session.session_id});
 
     auto loaded = debugger.loadSession(session.session_id);
     EXPECT_EQ(loaded.session_id, session.session_id);
+
+    debugger.setSessionDirectory("");
+    std::filesystem::remove_all(directory);
 }
 
 TEST(IntegrationTest, VerboseMode) {
     AIDebugger debugger;
+    debugger.setSessionDirectory("");
     debugger.setVerbose(true);
 
     std::string trace = "#0  0x0000555555555269 in main () at test.cpp:15";
@@ -94,3 +120,162 @@ TEST(IntegrationTest, ConfigSaveLoad) {
     bool saved = config.save("test_config.txt");
     EXPECT_TRUE(saved || true);
 }
+
+TEST(IntegrationTest, AnalyzeStream) {
+    AIDebugger debugger;
+    debugger.setSessionDirectory("");
+
+    std::istringstream log(
+        "#0  0x0000555555555269 in first (ptr=0x0) at test.cpp:15\n"
+        "#1  0x00005555555552a8 in main () at test.cpp:20\n"
+        "\n"
+        "#0  0x0000555555555269 in second () at other.cpp:7\n");
+
+    std::vector<std::string> functions;
+    size_t count = debugger.analyzeStream(log, [&](DebugSession&& session) {
+        ASSERT_FALSE(session.trace.frames.empty());
+        functions.push_back(session.trace.frames[0].function_name);
+    });
+
+    EXPECT_EQ(count, 2u);
+    ASSERT_EQ(functions.size(), 2u);
+    EXPECT_EQ(functions[0], "first");
+    EXPECT_EQ(functions[1], "second");
+}
+
+TEST(IntegrationTest, AnalyzeBatch) {
+    std::string directory = testSessionDirectory();
+    AIDebugger debugger;
+    debugger.setSessionDirectory(directory);
+    debugger.setMaxParallelTasks(4);
+
+    std::vector<std::string> traces;
+    for (int i = 0; i < 40; ++i) {
+        traces.push_back("#0  0x0000555555555269 in handler_" + std::to_string(i) +
+                         " (ptr=0x0) at test.cpp:" + std::to_string(i + 1) + "\n"
+                         "#1  0x00005555555552a8 in main () at test.cpp:100\n");
+    }
+    traces.push_back("not a stack trace");
+
+    auto sessions = debugger.analyzeBatch(traces);
+
+    ASSERT_EQ(sessions.size(), traces.size());
+    for (int i = 0; i < 40; ++i) {
+        ASSERT_EQ(sessions[i].trace.frames.size(), 2);
+        EXPECT_EQ(sessions[i].trace.frames[0].function_name, "handler_" + std::to_string(i));
+        EXPECT_EQ(sessions[i].trace.frames[0].location.line, i + 1);
+    }
+    EXPECT_TRUE(sessions.back().trace.frames.empty());
+
+    auto ids = debugger.listSessions();
+    std::sort(ids.begin(), ids.end());
+    EXPECT_EQ(std::unique(ids.begin(), ids.end()), ids.end());
+
+    // Resizing the pool, including back to one worker per hardware thread.
+    for (int tasks : {0, 1, 4}) {
+        debugger.setMaxParallelTasks(tasks);
+        sessions = debugger.analyzeBatch(traces);
+        ASSERT_EQ(sessions.size(), traces.size());
+        EXPECT_EQ(sessions[39].trace.frames[0].function_name, "handler_39");
+    }
+
+    debugger.setSessionDirectory("");
+    std::filesystem::remove_all(directory);
+}
+
+TEST(IntegrationTest, DeduplicatesRepeatedCrashes) {
+    AIDebugger debugger;
+    debugger.setSessionDirectory("");
+
+    auto first = debugger.analyzeStackTrace(
+        "Program received signal SIGSEGV, Segmentation fault.\n"
+        "#0  0x0000555555555269 in copy_buffer (dst=0x0) at buffer.cpp:15\n"
+        "#1  0x00005555555552a8 in main () at main.cpp:20\n");
+    auto repeat = debugger.analyzeStackTrace(
+        "Program received signal SIGSEGV, Segmentation fault.\n"
+        "#0  0x00007f0000001269 in copy_buffer (dst=0x0) at buffer.cpp:17\n"
+        "#1  0x00007f00000012a8 in main () at main.cpp:20\n");
+
+    EXPECT_NE(first.fingerprint, 0u);
+    EXPECT_EQ(repeat.fingerprint, first.fingerprint);
+    EXPECT_NE(repeat.session_id, first.session_id);
+    EXPECT_EQ(first.occurrence_count, 1u);
+    EXPECT_EQ(repeat.occurrence_count, 2u);
+    EXPECT_EQ(repeat.root_causes.size(), first.root_causes.size());
+    EXPECT_EQ(repeat.explanation.summary, first.explanation.summary);
+    ASSERT_EQ(repeat.trace.frames.size(), 2);
+    EXPECT_EQ(repeat.trace.frames[0].location.line, 17);
+
+    // Same frames, different failure: analyzed on its own.
+    auto abort = debugger.analyzeStackTrace(
+        "Program received signal SIGABRT, Aborted: assertion `count > 0' failed.\n"
+        "#0  0x0000555555555269 in copy_buffer (dst=0x0) at buffer.cpp:15\n"
+        "#1  0x00005555555552a8 in main () at main.cpp:20\n");
+    EXPECT_EQ(abort.fingerprint, first.fingerprint);
+    EXPECT_EQ(abort.occurrence_count, 1u);
+    AIDebugger reference;
+    reference.setSessionDirectory("");
+    auto expected = reference.analyzeStackTrace(
+        "Program received signal SIGABRT, Aborted: assertion `count > 0' failed.\n"
+        "#0  0x0000555555555269 in copy_buffer (dst=0x0) at buffer.cpp:15\n"
+        "#1  0x00005555555552a8 in main () at main.cpp:20\n");
+    ASSERT_FALSE(abort.root_causes.empty());
+    ASSERT_FALSE(expected.root_causes.empty());
+    EXPECT_EQ(abort.root_causes[0].category, expected.root_causes[0].category);
+    EXPECT_EQ(abort.root_causes[0].description, expected.root_causes[0].description);
+
+    debugger.enableDeduplication(false);
+    auto fresh = debugger.analyzeStackTrace(
+        "#0  0x0000555555555269 in copy_buffer (dst=0x0) at buffer.cpp:15\n"
+        "#1  0x00005555555552a8 in main () at main.cpp:20\n");
+    EXPECT_NE(fresh.session_id, first.session_id);
+    EXPECT_EQ(fresh.occurrence_count, 1u);
+}
+
+TEST(IntegrationTest, ComputesSkippedPartsOnDemand) {
+    const char* trace =
+        "Program received signal SIGSEGV, Segmentation fault: null pointer dereference.\n"
+        "#0  0x0000555555555269 in copy_buffer (dst=0x0) at buffer.cpp:15\n"
+        "#1  0x00005555555552a8 in main () at main.cpp:20\n";
+    std::string directory = testSessionDirectory();
+
+    AIDebugger eager;
+    eager.setSessionDirectory("");
+    eager.enableTestGeneration(true);
+    auto expected = eager.analyzeStackTrace(trace);
+    ASSERT_FALSE(expected.suggested_fixes.empty());
+    EXPECT_EQ(expected.pending, AnalysisOptions::ROOT_CAUSES);
+
+    AIDebugger triage;
+    triage.setSessionDirectory(directory);
+    triage.setAnalysisOptions(AnalysisOptions::ROOT_CAUSES);
+    auto session = triage.analyzeStackTrace(trace);
+    ASSERT_EQ(session.root_causes.size(), expected.root_causes.size());
+    EXPECT_EQ(session.root_causes[0].category, expected.root_causes[0].category);
+    EXPECT_TRUE(session.explanation.summary.empty());
+    EXPECT_TRUE(session.suggested_fixes.empty());
+    EXPECT_TRUE(hasOption(session.pending, AnalysisOptions::EXPLANATION));
+    EXPECT_TRUE(session.similar_crashes.empty());
+
+    // The report fills in what it shows without touching the session.
+    EXPECT_NE(triage.getReport(session).find("SUGGESTED FIXES"), std::string::npos);
+    EXPECT_TRUE(session.suggested_fixes.empty());
+
+    EXPECT_EQ(session.getExplanation().summary, expected.explanation.summary);
+    EXPECT_EQ(session.getRegressionTests().test_cases.size(), expected.regression_tests.test_cases.size());
+    EXPECT_EQ(session.suggested_fixes.size(), expected.suggested_fixes.size());
+    EXPECT_EQ(session.pending, AnalysisOptions::ROOT_CAUSES);
+
+    // Sessions loaded back can still complete themselves.
+    triage.setAnalysisOptions(AnalysisOptions::EXPLANATION);
+    auto partial = triage.analyzeStackTrace(
+        "Program received signal SIGSEGV, Segmentation fault: null pointer dereference.\n"
+        "#0  0x0000555555555269 in parse_header (buf=0x0) at header.cpp:42\n");
+    EXPECT_FALSE(partial.explanation.summary.empty());
+    auto loaded = triage.loadSession(partial.session_id);
+    EXPECT_EQ(loaded.pending, AnalysisOptions::FIXES | AnalysisOptions::REGRESSION_TESTS);
+    EXPECT_FALSE(loaded.getSuggestedFixes().empty());
+
+    triage.setSessionDirectory("");
+    std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,65 @@
+#include "ai_debugger/KeywordMatcher.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <tuple>
+
+using namespace ai_debugger;
+
+namespace {
+
+using Match = std::tuple<std::string, size_t, size_t>;
+
+std::vector<Match> scanAll(const KeywordMatcher& matcher, std::string_view text) {
+    std::vector<Match> matches;
+    matcher.scan(text, [&](uint32_t id, size_t begin, size_t end) {
+        matches.emplace_back(matcher.keyword(id), begin, end);
+    });
+    return matches;
+}
+
+} // namespace
+
+TEST(KeywordMatcherTest, FindsOverlappingKeywords) {
+    KeywordMatcher matcher;
+    matcher.add("he");
+    matcher.add("she");
+    matcher.add("his");
+    matcher.add("hers");
+    matcher.compile();
+
+    std::vector<Match> expected = {
+        Match("she", 1, 4), Match("he", 2, 4), Match("hers", 2, 6)
+    };
+    EXPECT_EQ(scanAll(matcher, "ushers"), expected);
+    EXPECT_TRUE(matcher.contains("this"));
+    EXPECT_FALSE(matcher.contains("xyz"));
+    EXPECT_FALSE(matcher.contains(""));
+}
+
+TEST(KeywordMatcherTest, CaseInsensitiveAndDeduplicated) {
+    KeywordMatcher matcher;
+    uint32_t fault = matcher.add("Segmentation Fault");
+    EXPECT_EQ(matcher.add("segmentation fault"), fault);
+    uint32_t sigsegv = matcher.add("SIGSEGV");
+    uint32_t empty = matcher.add("");
+    matcher.compile();
+
+    EXPECT_EQ(matcher.size(), 3u);
+    EXPECT_EQ(matcher.keyword(sigsegv), "sigsegv");
+
+    std::vector<uint32_t> ids;
+    matcher.scan("Received SigSegv: SEGMENTATION FAULT", [&](uint32_t id, size_t, size_t) {
+        ids.push_back(id);
+    });
+    EXPECT_EQ(ids, (std::vector<uint32_t>{sigsegv, fault}));
+    EXPECT_EQ(std::count(ids.begin(), ids.end(), empty), 0);
+}
+
+TEST(KeywordMatcherTest, FunctionKeywords) {
+    EXPECT_EQ(functionKeywords("malloc"), ALLOCATES | ALLOCATOR);
+    EXPECT_EQ(functionKeywords("xmalloc"), static_cast<uint32_t>(ALLOCATES));
+    EXPECT_EQ(functionKeywords("operator delete[]"), static_cast<uint32_t>(DEALLOCATES));
+    EXPECT_EQ(functionKeywords("delete[]"), DEALLOCATES | DEALLOCATOR);
+    EXPECT_EQ(functionKeywords("pthread_mutex_lock"), THREADING | LOCKING);
+    EXPECT_EQ(functionKeywords("process_request"), 0u);
+}
@@ -0,0 +1,144 @@
+#include "ai_debugger/KnowledgeBase.h"
+#include "ai_debugger/CrashSignature.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+using namespace ai_debugger;
+
+namespace {
+
+RootCause makeCause(BugCategory category, const std::string& description, double confidence) {
+    RootCause cause;
+    cause.category = category;
+    cause.description = description;
+    cause.confidence = confidence;
+    cause.location.file = "src/cache.cpp";
+    cause.location.line = 88;
+    return cause;
+}
+
+} // namespace
+
+TEST(KnowledgeBaseTest, SaveAndLookup) {
+    std::string path = "knowledge_base_test.kb";
+
+    KnowledgeBaseBuilder builder;
+    builder.add("double free or corruption (fasttop): 0x000055d3c8e2a260",
+                makeCause(BugCategory::DOUBLE_FREE, "Cache entry released twice", 0.9));
+    builder.add("double free or corruption (fasttop): 0x000055d3c8e2a260",
+                makeCause(BugCategory::USE_AFTER_FREE, "Iterator outlives eviction", 0.4));
+    builder.add("Assertion `index < size' failed in worker 12",
+                makeCause(BugCategory::ASSERTION_FAILURE, "Stale index after resize", 0.7));
+    ASSERT_TRUE(builder.save(path));
+
+    KnowledgeBase knowledge_base;
+    ASSERT_TRUE(knowledge_base.open(path));
+    EXPECT_EQ(knowledge_base.size(), 3u);
+
+    // Different address and PID, same normalized message.
+    auto causes = knowledge_base.lookup("Double free or corruption (fasttop): 0x00007f0011223344");
+    ASSERT_EQ(causes.size(), 2u);
+    EXPECT_EQ(causes[0].category, BugCategory::DOUBLE_FREE);
+    EXPECT_EQ(causes[0].description, "Cache entry released twice");
+    EXPECT_EQ(causes[0].location.file, "src/cache.cpp");
+    EXPECT_EQ(causes[0].location.line, 88);
+    EXPECT_NEAR(causes[0].confidence, 0.9, 1e-4);
+    EXPECT_EQ(causes[1].category, BugCategory::USE_AFTER_FREE);
+
+    EXPECT_EQ(knowledge_base.lookup("Assertion `index < size' failed in worker 3").size(), 1u);
+    EXPECT_TRUE(knowledge_base.lookup("Segmentation fault").empty());
+
+    std::remove(path.c_str());
+}
+
+TEST(KnowledgeBaseTest, FailedSaveLeavesNoTemporary) {
+    // A directory in the way makes the final rename fail.
+    std::string path = "knowledge_base_save_target";
+    std::filesystem::create_directory(path);
+
+    KnowledgeBaseBuilder builder;
+    builder.add("Segmentation fault", makeCause(BugCategory::NULL_POINTER, "Null config", 0.8));
+    EXPECT_FALSE(builder.save(path));
+    EXPECT_FALSE(std::filesystem::exists(path + ".tmp"));
+    EXPECT_TRUE(std::filesystem::is_directory(path));
+
+    std::filesystem::remove(path);
+}
+
+TEST(KnowledgeBaseTest, RejectsInvalidFiles) {
+    std::string path = "knowledge_base_invalid.kb";
+    KnowledgeBase knowledge_base;
+    EXPECT_FALSE(knowledge_base.open("does_not_exist.kb"));
+
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "not a knowledge base file at all, just some text";
+    }
+    EXPECT_FALSE(knowledge_base.open(path));
+    EXPECT_FALSE(knowledge_base.isOpen());
+
+    KnowledgeBaseBuilder builder;
+    builder.add(uint64_t(42), makeCause(BugCategory::DEADLOCK, "Lock order inversion", 0.8));
+    ASSERT_TRUE(builder.save(path));
+    ASSERT_TRUE(knowledge_base.open(path));
+
+    std::string contents;
+    {
+        std::ifstream in(path, std::ios::binary);
+        contents.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    // Truncated.
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(contents.data(), static_cast<std::streamsize>(contents.size() - 3));
+    }
+    EXPECT_FALSE(knowledge_base.open(path));
+
+    // Future version.
+    std::string future = contents;
+    future[4] = static_cast<char>(KnowledgeBase::VERSION + 1);
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out << future;
+    }
+    EXPECT_FALSE(knowledge_base.open(path));
+
+    std::remove(path.c_str());
+}
+
+TEST(KnowledgeBaseTest, PredictorUsesTrainedAndLoadedCauses) {
+    std::string path = "knowledge_base_predictor.kb";
+
+    StackTrace trace;
+    trace.error_message = "Resource limit hit: 4096 open descriptors in PID 991";
+    StackFrame frame;
+    frame.function_name = "open_connection";
+    trace.frames.push_back(frame);
+
+    CallGraphAnalyzer graph;
+    graph.buildFromStackTrace(trace);
+
+    RootCausePredictor trained;
+    trained.trainFromExamples({{trace, makeCause(BugCategory::RESOURCE_EXHAUSTION,
+                                                 "Connections never closed", 0.8)}});
+
+    StackTrace repeat = trace;
+    repeat.error_message = "Resource limit hit: 1024 open descriptors in PID 17";
+    auto causes = trained.predict(repeat, graph);
+    ASSERT_FALSE(causes.empty());
+    EXPECT_EQ(causes[0].category, BugCategory::RESOURCE_EXHAUSTION);
+    ASSERT_TRUE(trained.saveKnowledgeBase(path));
+
+    RootCausePredictor loaded;
+    EXPECT_TRUE(loaded.predict(repeat, graph).empty());
+    ASSERT_TRUE(loaded.loadKnowledgeBase(path));
+    ASSERT_NE(loaded.getKnowledgeBase(), nullptr);
+    causes = loaded.predict(repeat, graph);
+    ASSERT_FALSE(causes.empty());
+    EXPECT_EQ(causes[0].description, "Connections never closed");
+
+    std::remove(path.c_str());
+}
@@ -0,0 +1,154 @@
+#include "ai_debugger/LinearClassifier.h"
+#include "TestTraces.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+
+using namespace ai_debugger;
+using ai_debugger::test::makeTrace;
+
+namespace {
+
+SparseFeatures makeFeatures(std::initializer_list<uint32_t> indices) {
+    SparseFeatures features;
+    for (uint32_t index : indices) {
+        features.add(index, 1.0f);
+    }
+    return features;
+}
+
+std::vector<std::pair<SparseFeatures, BugCategory>> makeExamples() {
+    return {
+        {makeFeatures({1, 2, 10}), BugCategory::NULL_POINTER},
+        {makeFeatures({1, 3, 11}), BugCategory::NULL_POINTER},
+        {makeFeatures({2, 3, 12}), BugCategory::NULL_POINTER},
+        {makeFeatures({4, 5, 10}), BugCategory::DEADLOCK},
+        {makeFeatures({4, 6, 11}), BugCategory::DEADLOCK},
+        {makeFeatures({5, 6, 12}), BugCategory::DEADLOCK},
+    };
+}
+
+RootCause makeCause(BugCategory category) {
+    RootCause cause;
+    cause.category = category;
+    cause.description = bugCategoryToString(category);
+    cause.confidence = 0.9;
+    return cause;
+}
+
+} // namespace
+
+TEST(LinearClassifierTest, LearnsSeparableCategories) {
+    LinearClassifier classifier(64);
+    EXPECT_FALSE(classifier.isTrained());
+    classifier.train(makeExamples());
+    EXPECT_TRUE(classifier.isTrained());
+
+    double probability = 0.0;
+    EXPECT_EQ(classifier.classify(makeFeatures({1, 2, 3}), &probability), BugCategory::NULL_POINTER);
+    EXPECT_GT(probability, 0.5);
+    EXPECT_EQ(classifier.classify(makeFeatures({4, 5, 6})), BugCategory::DEADLOCK);
+
+    CategoryProbabilities probabilities;
+    classifier.predict(makeFeatures({10}), probabilities);
+    EXPECT_NEAR(std::accumulate(probabilities.begin(), probabilities.end(), 0.0), 1.0, 1e-9);
+}
+
+TEST(LinearClassifierTest, SaveAndLoadRoundTrip) {
+    std::string path = "linear_classifier_test.model";
+
+    LinearClassifier trained(64);
+    trained.train(makeExamples());
+    ASSERT_TRUE(trained.save(path));
+
+    LinearClassifier loaded;
+    ASSERT_TRUE(loaded.load(path));
+    EXPECT_EQ(loaded.dimension(), 64u);
+    EXPECT_TRUE(loaded.isTrained());
+
+    CategoryProbabilities expected;
+    CategoryProbabilities actual;
+    trained.predict(makeFeatures({1, 5, 11}), expected);
+    loaded.predict(makeFeatures({1, 5, 11}), actual);
+    for (size_t c = 0; c < BUG_CATEGORY_COUNT; ++c) {
+        EXPECT_DOUBLE_EQ(actual[c], expected[c]);
+    }
+
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out << "AILC but not a model";
+    }
+    EXPECT_FALSE(loaded.load(path));
+    EXPECT_EQ(loaded.dimension(), 64u);
+    EXPECT_TRUE(loaded.isTrained());
+
+    std::remove(path.c_str());
+}
+
+TEST(LinearClassifierTest, FailedSaveLeavesNoTemporary) {
+    // A directory in the way makes the final rename fail.
+    std::string path = "linear_classifier_save_target";
+    std::filesystem::create_directory(path);
+
+    LinearClassifier trained(64);
+    trained.train(makeExamples());
+    EXPECT_FALSE(trained.save(path));
+    EXPECT_FALSE(std::filesystem::exists(path + ".tmp"));
+
+    std::filesystem::remove(path);
+}
+
+TEST(LinearClassifierTest, PredictorUsesTrainedModel) {
+    RootCausePredictor predictor;
+    std::vector<std::pair<StackTrace, RootCause>> examples;
+    for (int i = 0; i < 4; ++i) {
+        std::string id = std::to_string(i);
+        examples.push_back({makeTrace({"Journal::waitForFlush", "Writer::commit" + id},
+                                      "request " + id + " timed out waiting on journal"),
+                            makeCause(BugCategory::DEADLOCK)});
+        examples.push_back({makeTrace({"Pool::reserve", "Tenant::admit" + id},
+                                      "quota exceeded for tenant " + id),
+                            makeCause(BugCategory::RESOURCE_EXHAUSTION)});
+    }
+    predictor.trainFromExamples(examples);
+    EXPECT_EQ(predictor.getModel(), nullptr);
+    ASSERT_TRUE(predictor.trainModel());
+    ASSERT_NE(predictor.getModel(), nullptr);
+
+    // Unseen message; only the classifier can match it.
+    auto trace = makeTrace({"Journal::waitForFlush", "Writer::commit9"}, "journal stalled during commit");
+    CallGraphAnalyzer graph;
+    graph.buildFromStackTrace(trace);
+
+    auto causes = predictor.predict(trace, graph);
+    ASSERT_FALSE(causes.empty());
+    EXPECT_EQ(causes[0].category, BugCategory::DEADLOCK);
+    EXPECT_NE(causes[0].description.find("Classifier"), std::string::npos);
+}
+
+TEST(LinearClassifierTest, PredictorNeedsVariedExamplesToTrain) {
+    RootCausePredictor predictor;
+    auto loaded = std::make_shared<LinearClassifier>();
+    predictor.setModel(loaded);
+
+    std::vector<std::pair<StackTrace, RootCause>> examples;
+    for (int i = 0; i < 8; ++i) {
+        examples.push_back({makeTrace({"Journal::waitForFlush"}, "request timed out waiting on journal"),
+                            makeCause(BugCategory::DEADLOCK)});
+    }
+    predictor.trainFromExamples(examples);
+    EXPECT_EQ(predictor.getModel(), loaded);
+
+    std::string error;
+    EXPECT_FALSE(predictor.trainModel(&error));
+    EXPECT_NE(error.find("two categories"), std::string::npos);
+    EXPECT_EQ(predictor.getModel(), loaded);
+
+    RootCausePredictor few;
+    few.trainFromExamples({{makeTrace({"Pool::reserve"}, "quota exceeded"), makeCause(BugCategory::RESOURCE_EXHAUSTION)},
+                           {makeTrace({"Config::get"}, "null config"), makeCause(BugCategory::NULL_POINTER)}});
+    EXPECT_FALSE(few.trainModel());
+    EXPECT_EQ(few.getModel(), nullptr);
+}
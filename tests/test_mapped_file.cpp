@@ -0,0 +1,127 @@
+#include "ai_debugger/MappedFile.h"
+#include "ai_debugger/AIDebugger.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace ai_debugger;
+
+TEST(MappedFileTest, MapsRegularFile) {
+    std::string path = "mapped_file_test.txt";
+    std::string contents = "#0  0x0000555555555269 in main () at test.cpp:15\n";
+    {
+        std::ofstream out(path);
+        out << contents;
+    }
+
+    MappedFile file;
+    ASSERT_TRUE(file.open(path));
+    EXPECT_TRUE(file.isOpen());
+    EXPECT_EQ(file.data(), contents);
+    EXPECT_EQ(file.size(), contents.size());
+#ifndef _WIN32
+    EXPECT_TRUE(file.isMapped());
+#endif
+
+    file.close();
+    EXPECT_FALSE(file.isOpen());
+    EXPECT_TRUE(file.data().empty());
+
+    std::remove(path.c_str());
+}
+
+TEST(MappedFileTest, EmptyAndMissingFiles) {
+    std::string path = "mapped_file_empty.txt";
+    { std::ofstream out(path); }
+
+    MappedFile file;
+    ASSERT_TRUE(file.open(path));
+    EXPECT_TRUE(file.data().empty());
+    EXPECT_FALSE(file.isMapped());
+    std::remove(path.c_str());
+
+    EXPECT_FALSE(file.open("does_not_exist.txt"));
+    EXPECT_FALSE(file.isOpen());
+}
+
+TEST(MappedFileTest, MovedFromFileIsClosed) {
+    std::string path = "mapped_file_move.txt";
+    std::string contents = "#0  0x0000555555555269 in main () at test.cpp:15\n";
+    {
+        std::ofstream out(path);
+        out << contents;
+    }
+
+    MappedFile file;
+    ASSERT_TRUE(file.open(path));
+    MappedFile moved(std::move(file));
+    EXPECT_EQ(moved.data(), contents);
+    EXPECT_FALSE(file.isOpen());
+    EXPECT_TRUE(file.data().empty());
+    EXPECT_FALSE(file.isMapped());
+    file.close();
+
+    MappedFile assigned;
+    assigned = std::move(moved);
+    EXPECT_EQ(assigned.data(), contents);
+    EXPECT_FALSE(moved.isOpen());
+    EXPECT_EQ(moved.size(), 0u);
+
+    ASSERT_TRUE(moved.open(path));
+    EXPECT_EQ(moved.data(), contents);
+    moved.close();
+
+    std::remove(path.c_str());
+}
+
+#ifndef _WIN32
+TEST(MappedFileTest, FallsBackToReadForPipes) {
+    std::string path = "mapped_file_fifo";
+    std::remove(path.c_str());
+    ASSERT_EQ(mkfifo(path.c_str(), 0600), 0);
+
+    std::string contents = "#0  0x0000555555555269 in main () at test.cpp:15\n";
+    std::thread writer([&]() {
+        std::ofstream out(path);
+        out << contents;
+    });
+
+    MappedFile file;
+    bool opened = file.open(path);
+    writer.join();
+
+    ASSERT_TRUE(opened);
+    EXPECT_FALSE(file.isMapped());
+    EXPECT_EQ(file.data(), contents);
+
+    unlink(path.c_str());
+}
+#endif
+
+TEST(MappedFileTest, AnalyzeFromMappedFile) {
+    std::string path = "mapped_file_trace.txt";
+    {
+        std::ofstream out(path);
+        out << "Program received signal SIGSEGV, Segmentation fault.\n"
+            << "#0  0x0000555555555269 in process (ptr=0x0) at test.cpp:15\n"
+            << "#1  0x00005555555552a8 in main () at test.cpp:20\n";
+    }
+
+    AIDebugger debugger;
+    debugger.setSessionDirectory("");
+    auto session = debugger.analyzeFromFile(path);
+
+    ASSERT_EQ(session.trace.frames.size(), 2);
+    EXPECT_EQ(session.trace.frames[0].function_name, "process");
+    EXPECT_EQ(session.trace.frames[0].location.file, "test.cpp");
+    EXPECT_EQ(session.trace.signal_number, 11);
+    EXPECT_FALSE(session.session_id.empty());
+
+    std::remove(path.c_str());
+}
@@ -80,3 +80,27 @@ TEST(RootCausePredictorTest, ConfidenceRanking) {
         EXPECT_GE(causes[i - 1].confidence, causes[i].confidence);
     }
 }
+
+TEST(RootCausePredictorTest, PredictFromView) {
+    StackTraceParser parser;
+    std::string text =
+        "Program received signal SIGSEGV, Segmentation fault (null pointer).\n"
+        "#0  0x0000555555555269 in process (ptr=0x0) at test.cpp:15\n";
+
+    auto view = parser.parseView(text);
+    auto owned = parser.parse(text);
+    ASSERT_TRUE(view.has_value());
+    ASSERT_TRUE(owned.has_value());
+
+    RootCausePredictor predictor;
+    CallGraphAnalyzer analyzer;
+
+    auto from_view = predictor.predict(*view, analyzer);
+    auto from_owned = predictor.predict(*owned, analyzer);
+
+    ASSERT_EQ(from_view.size(), from_owned.size());
+    ASSERT_GT(from_view.size(), 0u);
+    EXPECT_EQ(from_view[0].category, BugCategory::NULL_POINTER);
+    EXPECT_EQ(from_view[0].category, from_owned[0].category);
+    EXPECT_DOUBLE_EQ(from_view[0].confidence, from_owned[0].confidence);
+}
@@ -0,0 +1,283 @@
+#include "ai_debugger/SessionStore.h"
+#include "TestPaths.h"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+
+using namespace ai_debugger;
+
+namespace {
+
+std::string storeDir() {
+    return test::testDirectory("session_store_test_");
+}
+
+DebugSession makeSession(const std::string& id, const std::string& timestamp = "2024-03-01 12:00:00") {
+    DebugSession session;
+    session.session_id = id;
+    session.timestamp = timestamp;
+    session.fingerprint = 0x1234abcdULL;
+    session.occurrence_count = 3;
+
+    session.trace.error_message = "Segmentation fault in " + id;
+    session.trace.signal_number = 11;
+    StackFrame frame;
+    frame.function_name = "Cache::evict";
+    frame.location = SourceLocation("src/cache.cpp", 42, 7);
+    frame.module = "libcache.so";
+    frame.address = 0x7fff1234;
+    frame.parameters = {"this=0x0", "key=3"};
+    session.trace.frames = {frame, frame};
+
+    RootCause cause;
+    cause.category = BugCategory::NULL_POINTER;
+    cause.description = "null dereference";
+    cause.confidence = 0.75;
+    cause.contributing_factors = {"this is null"};
+    cause.relevant_frames = {frame};
+    session.root_causes = {cause};
+
+    session.explanation.summary = "summary";
+    session.explanation.step_by_step = {"one", "two"};
+
+    CodeFix fix;
+    fix.type = FixType::NULL_CHECK;
+    fix.fixed_code = "if (!p) return;";
+    fix.confidence = 0.5;
+    session.suggested_fixes = {fix};
+
+    TestCase test;
+    test.name = "Regression";
+    test.is_regression_test = true;
+    session.regression_tests.suite_name = "Suite";
+    session.regression_tests.framework = TestFramework::CATCH2;
+    session.regression_tests.test_cases = {test};
+
+    SimilarCrash similar;
+    similar.session_id = "older";
+    similar.similarity = 0.9;
+    similar.confirmed = true;
+    session.similar_crashes = {similar};
+    session.root_cause_confirmed = true;
+    return session;
+}
+
+class SessionStoreTest : public ::testing::Test {
+protected:
+    void SetUp() override { std::filesystem::remove_all(storeDir()); }
+    void TearDown() override { std::filesystem::remove_all(storeDir()); }
+};
+
+} // namespace
+
+TEST_F(SessionStoreTest, RoundTripsSessions) {
+    std::string encoded;
+    DebugSession decoded;
+    serializeSession(makeSession("a"), encoded);
+    ASSERT_TRUE(deserializeSession(encoded, decoded));
+    EXPECT_FALSE(deserializeSession(std::string_view(encoded).substr(0, encoded.size() - 1), decoded));
+
+    {
+        SessionStore store;
+        ASSERT_TRUE(store.open(storeDir()));
+        ASSERT_TRUE(store.put(makeSession("a")));
+        ASSERT_TRUE(store.put(makeSession("b")));
+        EXPECT_EQ(store.size(), 2u);
+        EXPECT_TRUE(store.contains("a"));
+        EXPECT_FALSE(store.contains("c"));
+    }
+
+    SessionStore store;
+    ASSERT_TRUE(store.open(storeDir()));
+    EXPECT_EQ(store.size(), 2u);
+
+    DebugSession session;
+    ASSERT_TRUE(store.get("b", session));
+    EXPECT_EQ(session.session_id, "b");
+    EXPECT_EQ(session.fingerprint, 0x1234abcdULL);
+    EXPECT_EQ(session.occurrence_count, 3u);
+    EXPECT_EQ(session.trace.error_message, "Segmentation fault in b");
+    ASSERT_EQ(session.trace.frames.size(), 2u);
+    EXPECT_EQ(session.trace.frames[1].location.line, 42);
+    EXPECT_EQ(session.trace.frames[1].address, 0x7fff1234u);
+    EXPECT_EQ(session.trace.frames[1].parameters.size(), 2u);
+    ASSERT_EQ(session.root_causes.size(), 1u);
+    EXPECT_EQ(session.root_causes[0].category, BugCategory::NULL_POINTER);
+    EXPECT_DOUBLE_EQ(session.root_causes[0].confidence, 0.75);
+    EXPECT_EQ(session.root_causes[0].relevant_frames.size(), 1u);
+    EXPECT_EQ(session.explanation.step_by_step.size(), 2u);
+    ASSERT_EQ(session.suggested_fixes.size(), 1u);
+    EXPECT_EQ(session.suggested_fixes[0].type, FixType::NULL_CHECK);
+    EXPECT_EQ(session.regression_tests.framework, TestFramework::CATCH2);
+    ASSERT_EQ(session.regression_tests.test_cases.size(), 1u);
+    EXPECT_TRUE(session.regression_tests.test_cases[0].is_regression_test);
+    ASSERT_EQ(session.similar_crashes.size(), 1u);
+    EXPECT_TRUE(session.similar_crashes[0].confirmed);
+    EXPECT_TRUE(session.root_cause_confirmed);
+
+    EXPECT_FALSE(store.get("missing", session));
+
+    SessionStore second;
+    std::string error;
+    EXPECT_FALSE(second.open(storeDir(), &error));
+    EXPECT_NE(error.find("in use"), std::string::npos);
+}
+
+TEST_F(SessionStoreTest, ReplacesAndErases) {
+    {
+        SessionStore store;
+        ASSERT_TRUE(store.open(storeDir()));
+        DebugSession session = makeSession("a");
+        ASSERT_TRUE(store.put(session));
+        session.occurrence_count = 9;
+        ASSERT_TRUE(store.put(session));
+        ASSERT_TRUE(store.put(makeSession("b")));
+        EXPECT_EQ(store.size(), 2u);
+
+        EXPECT_TRUE(store.erase("b"));
+        EXPECT_FALSE(store.erase("b"));
+        EXPECT_EQ(store.sessionIds(), std::vector<std::string>{"a"});
+    }
+
+    SessionStore store;
+    ASSERT_TRUE(store.open(storeDir()));
+    EXPECT_EQ(store.sessionIds(), std::vector<std::string>{"a"});
+    DebugSession session;
+    ASSERT_TRUE(store.get("a", session));
+    EXPECT_EQ(session.occurrence_count, 9u);
+    EXPECT_FALSE(store.contains("b"));
+}
+
+TEST_F(SessionStoreTest, TruncatesTornWrites) {
+    {
+        SessionStore store;
+        ASSERT_TRUE(store.open(storeDir()));
+        for (const char* id : {"a", "b", "c"}) {
+            ASSERT_TRUE(store.put(makeSession(id)));
+        }
+    }
+
+    // Chop the last record short, as a crash mid-write would.
+    std::string segment = storeDir() + "/00000001.seg";
+    auto size = std::filesystem::file_size(segment);
+    std::filesystem::resize_file(segment, size - 10);
+
+    {
+        SessionStore store;
+        ASSERT_TRUE(store.open(storeDir()));
+        EXPECT_EQ(store.size(), 2u);
+        EXPECT_FALSE(store.contains("c"));
+        ASSERT_TRUE(store.put(makeSession("d")));
+    }
+
+    // A flipped byte fails the checksum.
+    {
+        std::fstream file(segment, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(-5, std::ios::end);
+        file.put('\x7f');
+    }
+
+    SessionStore store;
+    ASSERT_TRUE(store.open(storeDir()));
+    EXPECT_EQ(store.size(), 2u);
+    EXPECT_TRUE(store.contains("a"));
+    EXPECT_TRUE(store.contains("b"));
+}
+
+TEST_F(SessionStoreTest, ScansByTimestamp) {
+    SessionStore store;
+    ASSERT_TRUE(store.open(storeDir()));
+    ASSERT_TRUE(store.put(makeSession("jan", "2024-01-15 08:00:00")));
+    ASSERT_TRUE(store.put(makeSession("feb", "2024-02-15 08:00:00")));
+    ASSERT_TRUE(store.put(makeSession("mar", "2024-03-15 08:00:00")));
+
+    std::time_t from = parseSessionTimestamp("2024-02-01 00:00:00");
+    std::time_t to = parseSessionTimestamp("2024-04-01 00:00:00");
+    ASSERT_GT(from, 0);
+    EXPECT_EQ(parseSessionTimestamp("yesterday"), -1);
+
+    std::vector<std::string> ids;
+    size_t visited = store.scan(from, to, [&](DebugSession&& session) {
+        ids.push_back(session.session_id);
+    });
+    EXPECT_EQ(visited, 2u);
+    EXPECT_EQ(ids, (std::vector<std::string>{"feb", "mar"}));
+
+    EXPECT_EQ(store.scan(to, to + 3600, [](DebugSession&&) {}), 0u);
+}
+
+TEST_F(SessionStoreTest, ScansSummaries) {
+    std::string encoded;
+    DebugSession summary;
+    serializeSession(makeSession("a"), encoded);
+    ASSERT_TRUE(deserializeSessionSummary(encoded, summary));
+    EXPECT_EQ(summary.session_id, "a");
+    EXPECT_EQ(summary.trace.frames.size(), 2u);
+    ASSERT_EQ(summary.root_causes.size(), 1u);
+    EXPECT_EQ(summary.root_causes[0].category, BugCategory::NULL_POINTER);
+    EXPECT_TRUE(summary.root_cause_confirmed);
+    EXPECT_TRUE(summary.explanation.summary.empty());
+    EXPECT_TRUE(summary.suggested_fixes.empty());
+    EXPECT_TRUE(summary.similar_crashes.empty());
+    EXPECT_FALSE(deserializeSessionSummary(std::string_view(encoded).substr(0, encoded.size() - 1), summary));
+
+    SessionStore store;
+    ASSERT_TRUE(store.open(storeDir()));
+    ASSERT_TRUE(store.put(makeSession("a")));
+    ASSERT_TRUE(store.put(makeSession("b")));
+    std::vector<std::string> ids;
+    store.scanSummaries(0, std::numeric_limits<std::time_t>::max(), [&](DebugSession&& session) {
+        ids.push_back(session.session_id);
+    });
+    EXPECT_EQ(ids, (std::vector<std::string>{"a", "b"}));
+}
+
+TEST_F(SessionStoreTest, CompactsDeadSegments) {
+    SessionStoreOptions options;
+    options.segment_size = 4096;
+
+    uint64_t before = 0;
+    {
+        SessionStore store(options);
+        ASSERT_TRUE(store.open(storeDir()));
+        for (int round = 0; round < 20; ++round) {
+            for (int i = 0; i < 5; ++i) {
+                DebugSession session = makeSession("s" + std::to_string(i));
+                session.occurrence_count = round;
+                ASSERT_TRUE(store.put(session));
+            }
+        }
+        ASSERT_TRUE(store.erase("s4"));
+        ASSERT_TRUE(store.put(makeSession("s5")));
+
+        before = store.diskSize();
+        ASSERT_TRUE(store.compact());
+        EXPECT_LT(store.diskSize(), before / 4);
+        EXPECT_EQ(store.size(), 5u);
+    }
+
+    SessionStore store(options);
+    ASSERT_TRUE(store.open(storeDir()));
+    EXPECT_EQ(store.size(), 5u);
+    EXPECT_FALSE(store.contains("s4"));
+    DebugSession session;
+    ASSERT_TRUE(store.get("s3", session));
+    EXPECT_EQ(session.occurrence_count, 19u);
+    EXPECT_TRUE(store.get("s5", session));
+}
+
+TEST_F(SessionStoreTest, DebuggerReportsLockedDirectory) {
+    SessionStore holder;
+    ASSERT_TRUE(holder.open(storeDir()));
+
+    AIDebugger debugger;
+    debugger.setSessionDirectory(storeDir());
+    std::string error;
+    EXPECT_FALSE(debugger.openSessionStore(&error));
+    EXPECT_NE(error.find("in use"), std::string::npos);
+
+    holder.close();
+    debugger.setSessionDirectory(storeDir());
+    EXPECT_TRUE(debugger.openSessionStore(&error));
+}
@@ -0,0 +1,115 @@
+#include "ai_debugger/SessionWriter.h"
+#include "TestPaths.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <filesystem>
+#include <future>
+#include <thread>
+
+using namespace ai_debugger;
+
+namespace {
+
+std::string storeDir() {
+    return test::testDirectory("session_writer_test_");
+}
+
+DebugSession makeSession(int i) {
+    DebugSession session;
+    session.session_id = "session_" + std::to_string(i);
+    session.timestamp = "2024-03-01 12:00:00";
+    session.trace.error_message = "crash " + std::to_string(i);
+    return session;
+}
+
+class SessionWriterTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        std::filesystem::remove_all(storeDir());
+        store = std::make_shared<SessionStore>();
+        ASSERT_TRUE(store->open(storeDir()));
+    }
+
+    void TearDown() override {
+        store.reset();
+        std::filesystem::remove_all(storeDir());
+    }
+
+    std::shared_ptr<SessionStore> store;
+};
+
+} // namespace
+
+TEST_F(SessionWriterTest, WritesInBatches) {
+    SessionWriter writer(store);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&writer, t] {
+            for (int i = 0; i < 250; ++i) {
+                EXPECT_TRUE(writer.write(makeSession(t * 1000 + i)));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_TRUE(writer.flush());
+    EXPECT_EQ(writer.pending(), 0u);
+    EXPECT_EQ(writer.written(), 1000u);
+    EXPECT_EQ(store->size(), 1000u);
+
+    DebugSession session;
+    ASSERT_TRUE(store->get("session_3249", session));
+    EXPECT_EQ(session.trace.error_message, "crash 3249");
+}
+
+TEST_F(SessionWriterTest, BlocksWhenQueueIsFull) {
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    SessionWriterOptions options;
+    options.queue_capacity = 2;
+    options.max_batch = 1;
+
+    auto target = store;
+    SessionWriter writer([target, released] {
+        released.wait();
+        return target;
+    }, options);
+
+    // The stalled writer holds one session and the queue two, so the
+    // producer cannot get all five in.
+    std::atomic<bool> returned{false};
+    std::thread producer([&] {
+        for (int i = 0; i < 5; ++i) {
+            EXPECT_TRUE(writer.write(makeSession(i)));
+        }
+        returned = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(returned);
+
+    release.set_value();
+    producer.join();
+    EXPECT_TRUE(returned);
+    EXPECT_TRUE(writer.flush());
+    EXPECT_EQ(store->size(), 5u);
+}
+
+TEST_F(SessionWriterTest, CloseDrainsQueue) {
+    {
+        SessionWriter writer(store);
+        for (int i = 0; i < 100; ++i) {
+            writer.write(makeSession(i));
+        }
+        writer.close();
+        EXPECT_EQ(writer.written(), 100u);
+        EXPECT_FALSE(writer.write(makeSession(100)));
+    }
+    EXPECT_EQ(store->size(), 100u);
+
+    SessionWriter orphan([] { return std::shared_ptr<SessionStore>(); });
+    orphan.write(makeSession(0));
+    EXPECT_FALSE(orphan.flush());
+    EXPECT_EQ(orphan.failed(), 1u);
+}
@@ -0,0 +1,86 @@
+#include "ai_debugger/SimilarityIndex.h"
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace ai_debugger;
+
+namespace {
+
+SparseFeatures randomFeatures(std::mt19937& rng, size_t count) {
+    SparseFeatures features;
+    for (size_t i = 0; i < count; ++i) {
+        features.add(rng() % 65536, 1.0f);
+    }
+    return features;
+}
+
+// Keeps the first `keep` entries of `base` and replaces the rest.
+SparseFeatures perturb(std::mt19937& rng, const SparseFeatures& base, size_t keep) {
+    SparseFeatures features;
+    for (size_t i = 0; i < base.size(); ++i) {
+        features.add(i < keep ? base.indices[i] : rng() % 65536, 1.0f);
+    }
+    return features;
+}
+
+} // namespace
+
+TEST(SimilarityIndexTest, SignatureEstimatesCosine) {
+    std::mt19937 rng(1);
+    SparseFeatures base = randomFeatures(rng, 64);
+
+    auto same = SimilarityIndex::signature(base);
+    EXPECT_EQ(same, SimilarityIndex::signature(base));
+    EXPECT_DOUBLE_EQ(SimilarityIndex::similarity(same, same), 1.0);
+
+    double near = SimilarityIndex::similarity(same, SimilarityIndex::signature(perturb(rng, base, 56)));
+    double far = SimilarityIndex::similarity(same, SimilarityIndex::signature(randomFeatures(rng, 64)));
+    EXPECT_GT(near, 0.7);
+    EXPECT_LT(far, 0.4);
+}
+
+TEST(SimilarityIndexTest, QueryRanksNearestFirst) {
+    std::mt19937 rng(2);
+    SimilarityIndex index;
+    SparseFeatures base = randomFeatures(rng, 64);
+
+    for (int i = 0; i < 500; ++i) {
+        index.add(randomFeatures(rng, 64));
+    }
+    uint32_t closer = index.add(perturb(rng, base, 60));
+    uint32_t close = index.add(perturb(rng, base, 48));
+    EXPECT_EQ(index.size(), 502u);
+
+    auto neighbors = index.query(base, 2);
+    ASSERT_EQ(neighbors.size(), 2u);
+    EXPECT_EQ(neighbors[0].id, closer);
+    EXPECT_EQ(neighbors[1].id, close);
+    EXPECT_GE(neighbors[0].similarity, neighbors[1].similarity);
+
+    EXPECT_EQ(index.query(base, 5, 0.95).size(), 0u);
+
+    auto filtered = index.query(base, 1, 0.0, [&](uint32_t id) { return id != closer; });
+    ASSERT_EQ(filtered.size(), 1u);
+    EXPECT_EQ(filtered[0].id, close);
+
+    index.clear();
+    EXPECT_EQ(index.size(), 0u);
+    EXPECT_TRUE(index.query(base, 2).empty());
+}
+
+TEST(SimilarityIndexTest, BucketsKeepNewestIds) {
+    SimilarityOptions options;
+    options.max_bucket_size = 4;
+    SimilarityIndex index(options);
+
+    std::mt19937 rng(3);
+    SparseFeatures features = randomFeatures(rng, 32);
+    for (int i = 0; i < 10; ++i) {
+        index.add(features);
+    }
+
+    auto neighbors = index.query(features, 10);
+    ASSERT_EQ(neighbors.size(), 4u);
+    EXPECT_EQ(neighbors[0].id, 9u);
+    EXPECT_EQ(neighbors[3].id, 6u);
+}
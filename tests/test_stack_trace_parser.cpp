@@ -1,5 +1,6 @@
 #include "ai_debugger/StackTraceParser.h"
 #include <gtest/gtest.h>
+#include <sstream>
 
 using namespace ai_debugger;
 
@@ -71,3 +72,261 @@ TEST(StackTraceParserTest, InvalidTrace) {
 
     EXPECT_FALSE(result.has_value());
 }
+
+namespace {
+
+void expectSameTrace(const std::optional<StackTrace>& scanned,
+                     const std::optional<StackTrace>& reference,
+                     const std::string& input) {
+    ASSERT_EQ(scanned.has_value(), reference.has_value()) << input;
+    if (!scanned) {
+        return;
+    }
+
+    EXPECT_EQ(scanned->error_message, reference->error_message) << input;
+    EXPECT_EQ(scanned->signal_number, reference->signal_number) << input;
+    ASSERT_EQ(scanned->frames.size(), reference->frames.size()) << input;
+
+    for (size_t i = 0; i < scanned->frames.size(); ++i) {
+        const auto& a = scanned->frames[i];
+        const auto& b = reference->frames[i];
+        EXPECT_EQ(a.function_name, b.function_name) << input;
+        EXPECT_EQ(a.mangled_name, b.mangled_name) << input;
+        EXPECT_EQ(a.module, b.module) << input;
+        EXPECT_EQ(a.address, b.address) << input;
+        EXPECT_EQ(a.location.file, b.location.file) << input;
+        EXPECT_EQ(a.location.line, b.location.line) << input;
+        EXPECT_EQ(a.location.column, b.location.column) << input;
+        EXPECT_EQ(a.parameters, b.parameters) << input;
+    }
+}
+
+} // namespace
+
+TEST(StackTraceParserTest, ScannerMatchesRegexEngine) {
+    const std::vector<std::string> inputs = {
+        // GDB
+        "#0  0x00007ffff7a3d428 in __GI_raise (sig=sig@entry=6) at ../sysdeps/unix/sysv/linux/raise.c:54",
+        "#1  0x00007ffff7a3f02a in __GI_abort () at abort.c:89",
+        "#2  main () at test.cpp:15",
+        "#3  0x0000555555555269 in vulnerable_function(char*) (input=0x7fffffffe0a0, n=3) at test.cpp:15",
+        "#4  0x0000555555555269 in _ZN3foo3barEv () from /usr/lib/libfoo.so",
+        "#5  0x0000555555555269 in foo(int)",
+        "#6  0x0000555555555269 in (anonymous namespace)::run (x=1) at a.cpp:3",
+        "#7  0x00005555 in f (a,,b,) at  :12",
+        "#8  0x00005555 in f (a) at   :12",
+        "#9  0x00005555 in f(x)(y) attr at file.cpp:9",
+        "#10 0xFFFFFFFFFFFFFFFF in g (x=1) at g.cpp:21:14",
+        "#11 0x0 in h () at h.cpp:3:",
+        "Thread 1 #12 #13  g() at x.cpp:abc",
+        "Program received signal SIGSEGV, Segmentation fault.",
+        "Program received signal SIGABRT, Aborted.",
+        "#0 0xdeadbeef in",
+        "#x  0x1 in f ()",
+        // LLDB
+        "frame #0: 0x00007fff20394a16 libsystem_kernel.dylib`__pthread_kill + 10",
+        "frame #1: 0x00007fff203c3487 libsystem_pthread.dylib`pthread_kill + 285",
+        "  * frame #2: 0x0000000100000f5a test`main at test.cpp:42",
+        "frame #3: 0x0000000100000f5a a.out`main(argc=1) + 4 at main.cpp:5:3",
+        "frame #4: 0x0000000100000f5a a.out`foo +  at main.cpp:7",
+        "frame #5: 0x0000000100000f5a a.out`_Z3fooi at foo.cpp:11",
+        "frame frame #6: 0x1 mod`fn",
+        "* thread #1, stop reason = EXC_BAD_ACCESS (code=1, address=0x0)",
+        // addr2line
+        "main at test.cpp:20",
+        "  in   _ZN3foo3barEv   at   /src/foo.cpp:77 extra",
+        "foo at src/with space.cpp:8",
+        "at at at x:1",
+        "foo at bar",
+        // MSVC
+        "test.cpp(42): main",
+        "  c:\\src\\widget.h(7):   Widget::draw\r",
+        "(12): nothing",
+        "x(y) z.cpp(3):\tfn(int)",
+        "a.cpp(1a): bad",
+    };
+
+    StackTraceParser scanner;
+    StackTraceParser reference;
+    reference.setParseEngine(ParseEngine::REGEX);
+
+    std::string all_lines;
+    for (const auto& input : inputs) {
+        expectSameTrace(scanner.parseGDB(input), reference.parseGDB(input), input);
+        expectSameTrace(scanner.parseLLDB(input), reference.parseLLDB(input), input);
+        expectSameTrace(scanner.parseBacktrace(input), reference.parseBacktrace(input), input);
+        expectSameTrace(scanner.parseMSVC(input), reference.parseMSVC(input), input);
+        all_lines += input + "\n";
+    }
+
+    expectSameTrace(scanner.parse(all_lines), reference.parse(all_lines), all_lines);
+}
+
+TEST(StackTraceParserTest, DefaultEngineIsScanner) {
+    StackTraceParser parser;
+    EXPECT_EQ(parser.getParseEngine(), ParseEngine::SCANNER);
+
+    parser.setParseEngine(ParseEngine::REGEX);
+    EXPECT_EQ(parser.getParseEngine(), ParseEngine::REGEX);
+}
+
+TEST(StackTraceParserTest, ParseViewMaterializesToOwnedTrace) {
+    StackTraceParser parser;
+
+    std::string gdb_trace =
+        "Program received signal SIGSEGV, Segmentation fault.\n"
+        "#0  0x0000555555555269 in _ZN3foo3barEi (x=1, y=2) at foo.cpp:15\n"
+        "#1  0x00005555555552a8 in main () at main.cpp:20\n";
+
+    auto view = parser.parseView(gdb_trace);
+    auto owned = parser.parse(gdb_trace);
+
+    ASSERT_TRUE(view.has_value());
+    ASSERT_TRUE(owned.has_value());
+    ASSERT_EQ(view->frames.size(), 2u);
+    EXPECT_EQ(view->frames[0].mangled_name, "_ZN3foo3barEi");
+    EXPECT_EQ(view->frames[0].function_name, "foo::bar(int)");
+    EXPECT_EQ(view->frames[0].location.file, "foo.cpp");
+    EXPECT_EQ(view->signal_number, 11);
+
+    auto materialized = view->materialize();
+    ASSERT_EQ(materialized.frames.size(), owned->frames.size());
+    EXPECT_EQ(materialized.error_message, owned->error_message);
+    EXPECT_EQ(materialized.frames[0].function_name, owned->frames[0].function_name);
+    EXPECT_EQ(materialized.frames[0].parameters, owned->frames[0].parameters);
+    EXPECT_EQ(materialized.frames[1].location.line, owned->frames[1].location.line);
+}
+
+TEST(StackTraceParserTest, ParseViewKeepsTextAliveAcrossMoves) {
+    StackTraceParser parser;
+
+    auto text = std::make_shared<const std::string>("frame #0: 0x0000000100000f5a test`main at test.cpp:42");
+    auto view = parser.parseView(*text, text);
+    text.reset();
+
+    ASSERT_TRUE(view.has_value());
+    StackTraceView moved = std::move(*view);
+
+    ASSERT_EQ(moved.frames.size(), 1u);
+    EXPECT_EQ(moved.frames[0].module, "test");
+    EXPECT_EQ(moved.frames[0].function_name, "main");
+    EXPECT_EQ(moved.frames[0].location.line, 42);
+}
+
+TEST(StackTraceParserTest, ParseStreamSplitsConcatenatedTraces) {
+    StackTraceParser parser;
+
+    std::istringstream log(
+        "Program received signal SIGSEGV, Segmentation fault.\n"
+        "#0  0x0000555555555269 in crash_a () at a.cpp:5\n"
+        "#1  0x00005555555552a8 in main () at a.cpp:10\n"
+        "\n"
+        "Thread 2 (Thread 0x7ffff6fff700 (LWP 1235)):\n"
+        "#0  0x00007ffff7bc3a0d in __lll_lock_wait () at lowlevellock.S:135\n"
+        "#1  0x0000555555555300 in worker () at b.cpp:22\n"
+        "Thread 1 (Thread 0x7ffff7fe6740 (LWP 1234)):\n"
+        "#0  0x0000555555555400 in joiner () at b.cpp:40\n"
+        "#0  0x0000555555555500 in crash_c () at c.cpp:1\n"
+        "#1  0x0000555555555501 in main () at c.cpp:2\n"
+        "frame #0: 0x0000000100000f5a test`crash_d at d.cpp:42\n"
+        "frame #1: 0x0000000100000f70 test`main at d.cpp:50\n");
+
+    std::vector<StackTrace> traces;
+    size_t count = parser.parseStream(log, [&](StackTrace&& trace) {
+        traces.push_back(std::move(trace));
+    });
+
+    ASSERT_EQ(count, 5u);
+    ASSERT_EQ(traces.size(), 5u);
+    EXPECT_EQ(traces[0].frames.size(), 2u);
+    EXPECT_EQ(traces[0].signal_number, 11);
+    EXPECT_EQ(traces[1].frames[1].function_name, "worker");
+    EXPECT_EQ(traces[2].frames.size(), 1u);
+    EXPECT_EQ(traces[3].frames[0].function_name, "crash_c");
+    EXPECT_EQ(traces[4].frames[0].module, "test");
+    EXPECT_EQ(traces[4].frames.size(), 2u);
+}
+
+TEST(StackTraceParserTest, ParseStreamBoundsBufferedTrace) {
+    StackTraceParser parser;
+    parser.setMaxTraceBytes(256);
+
+    std::string text;
+    for (int i = 0; i < 100; ++i) {
+        text += "#" + std::to_string(i + 1) + "  0x0000555555555269 in f" + std::to_string(i) + " () at x.cpp:1\n";
+    }
+    std::istringstream log(text);
+
+    size_t frames = 0;
+    size_t count = parser.parseStream(log, [&](StackTrace&& trace) {
+        frames += trace.frames.size();
+    });
+
+    EXPECT_EQ(count, 1u);
+    EXPECT_GT(frames, 0u);
+    EXPECT_LT(frames, 100u);
+}
+
+TEST(StackTraceParserTest, ParseStreamBoundsLineLength) {
+    StackTraceParser parser;
+    parser.setMaxTraceBytes(256);
+    std::istringstream log(
+        "#0  0x0000555555555269 in crash () at x.cpp:1\n" + std::string(100000, 'x') + "\n"
+        "#1  0x0000555555555300 in main () at x.cpp:9\n");
+
+    std::vector<StackTrace> traces;
+    parser.parseStream(log, [&](StackTrace&& trace) {
+        traces.push_back(std::move(trace));
+    });
+
+    ASSERT_EQ(traces.size(), 1u);
+    ASSERT_EQ(traces[0].frames.size(), 1u);
+    EXPECT_EQ(traces[0].frames[0].function_name, "crash");
+}
+
+TEST(StackTraceParserTest, ParseStreamKeepsGDBSessionTogether) {
+    StackTraceParser parser;
+    std::istringstream log(
+        "Program received signal SIGSEGV, Segmentation fault.\n"
+        "0x000055555555513d in foo (p=0x0) at crash.c:4\n"
+        "4\t  *p = 1;\n"
+        "(gdb) bt\n"
+        "#0  0x000055555555513d in foo (p=0x0) at crash.c:4\n"
+        "#1  0x0000555555555160 in main () at crash.c:9\n");
+
+    std::vector<StackTrace> traces;
+    size_t count = parser.parseStream(log, [&](StackTrace&& trace) {
+        traces.push_back(std::move(trace));
+    });
+
+    ASSERT_EQ(count, 1u);
+    ASSERT_EQ(traces[0].frames.size(), 2u);
+    EXPECT_EQ(traces[0].frames[0].function_name, "foo");
+    EXPECT_EQ(traces[0].frames[1].function_name, "main");
+    EXPECT_EQ(traces[0].signal_number, 11);
+    EXPECT_FALSE(traces[0].error_message.empty());
+}
+
+TEST(StackTraceParserTest, ParseStreamMixesFormatsAfterGDB) {
+    StackTraceParser parser;
+    std::istringstream log(
+        "#0  0x000055555555513d in foo (p=0x0) at a.c:4\n"
+        "#1  0x0000555555555160 in main () at a.c:9\n"
+        "\n"
+        "bar at b.cpp:11\n"
+        "main at b.cpp:30\n"
+        "\n"
+        "c:\\src\\w.cpp(42): Widget::draw\n");
+
+    std::vector<StackTrace> traces;
+    size_t count = parser.parseStream(log, [&](StackTrace&& trace) {
+        traces.push_back(std::move(trace));
+    });
+
+    ASSERT_EQ(count, 3u);
+    EXPECT_EQ(traces[0].frames.size(), 2u);
+    ASSERT_EQ(traces[1].frames.size(), 2u);
+    EXPECT_EQ(traces[1].frames[0].function_name, "bar");
+    ASSERT_EQ(traces[2].frames.size(), 1u);
+    EXPECT_EQ(traces[2].frames[0].function_name, "Widget::draw");
+}
@@ -0,0 +1,42 @@
+#include "ai_debugger/SymbolTable.h"
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace ai_debugger;
+
+TEST(SymbolTableTest, InternAssignsDenseIds) {
+    SymbolTable table;
+
+    EXPECT_EQ(table.intern("main"), 0u);
+    EXPECT_EQ(table.intern("worker"), 1u);
+    EXPECT_EQ(table.intern("main"), 0u);
+    EXPECT_EQ(table.size(), 2u);
+
+    EXPECT_EQ(table.name(1), "worker");
+    EXPECT_EQ(table.find("worker"), 1u);
+    EXPECT_EQ(table.find("missing"), SymbolTable::npos);
+}
+
+TEST(SymbolTableTest, NamesOutliveSourceStrings) {
+    SymbolTable table;
+    {
+        std::string temporary = "std::vector<int>::push_back(int const&)";
+        table.intern(temporary);
+    }
+    EXPECT_EQ(table.name(0), "std::vector<int>::push_back(int const&)");
+}
+
+TEST(SymbolTableTest, GrowsAndClears) {
+    SymbolTable table;
+    for (int i = 0; i < 5000; ++i) {
+        ASSERT_EQ(table.intern("fn_" + std::to_string(i)), static_cast<uint32_t>(i));
+    }
+    for (int i = 0; i < 5000; ++i) {
+        ASSERT_EQ(table.find("fn_" + std::to_string(i)), static_cast<uint32_t>(i));
+    }
+
+    table.clear();
+    EXPECT_TRUE(table.empty());
+    EXPECT_EQ(table.find("fn_0"), SymbolTable::npos);
+    EXPECT_EQ(table.intern("fn_42"), 0u);
+}
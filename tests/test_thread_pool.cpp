@@ -0,0 +1,88 @@
+#include "ai_debugger/ThreadPool.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+using namespace ai_debugger;
+
+TEST(ThreadPoolTest, RunsEverySubmittedTask) {
+    ThreadPool pool(4);
+    EXPECT_EQ(pool.size(), 4);
+
+    std::atomic<int> count{0};
+    for (int i = 0; i < 1000; ++i) {
+        pool.submit([&count](size_t worker) {
+            EXPECT_LT(worker, 4u);
+            ++count;
+        });
+    }
+    pool.wait();
+
+    EXPECT_EQ(count.load(), 1000);
+}
+
+TEST(ThreadPoolTest, TasksCanSubmitMoreWork) {
+    ThreadPool pool(3);
+    std::atomic<int> count{0};
+
+    for (int i = 0; i < 10; ++i) {
+        pool.submit([&pool, &count](size_t) {
+            for (int j = 0; j < 10; ++j) {
+                pool.submit([&count](size_t) { ++count; });
+            }
+        });
+    }
+    pool.wait();
+
+    EXPECT_EQ(count.load(), 100);
+}
+
+TEST(ThreadPoolTest, ParallelForCoversRangeOnce) {
+    ThreadPool pool(4);
+    std::vector<int> hits(10007, 0);
+
+    pool.parallelFor(hits.size(), [&hits](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; ++i) {
+            ++hits[i];
+        }
+    });
+
+    for (int value : hits) {
+        ASSERT_EQ(value, 1);
+    }
+
+    pool.parallelFor(0, [](size_t, size_t, size_t) { FAIL(); });
+}
+
+TEST(ThreadPoolTest, WaitRethrowsTaskException) {
+    ThreadPool pool(2);
+    pool.submit([](size_t) { throw std::runtime_error("task failed"); });
+    EXPECT_THROW(pool.wait(), std::runtime_error);
+
+    std::atomic<int> count{0};
+    pool.submit([&count](size_t) { ++count; });
+    EXPECT_NO_THROW(pool.wait());
+    EXPECT_EQ(count.load(), 1);
+}
+
+TEST(ThreadPoolTest, NestedCallsDoNotDeadlock) {
+    ThreadPool pool(2);
+    std::atomic<int> count{0};
+    std::atomic<int> wait_errors{0};
+
+    pool.parallelFor(4, [&](size_t, size_t, size_t outer) {
+        pool.parallelFor(100, [&](size_t begin, size_t end, size_t inner) {
+            EXPECT_EQ(inner, outer);
+            count += static_cast<int>(end - begin);
+        });
+        try {
+            pool.wait();
+        } catch (const std::logic_error&) {
+            ++wait_errors;
+        }
+    });
+
+    EXPECT_EQ(count.load(), 400);
+    EXPECT_EQ(wait_errors.load(), 4);
+}